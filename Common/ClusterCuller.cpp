@@ -0,0 +1,176 @@
+//***************************************************************************************
+// ClusterCuller.cpp
+//***************************************************************************************
+
+#include "ClusterCuller.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	XMFLOAT3 TransformPoint(const XMFLOAT3& p, const XMFLOAT4X4& m)
+	{
+		return XMFLOAT3(
+			p.x * m.m[0][0] + p.y * m.m[1][0] + p.z * m.m[2][0] + m.m[3][0],
+			p.x * m.m[0][1] + p.y * m.m[1][1] + p.z * m.m[2][1] + m.m[3][1],
+			p.x * m.m[0][2] + p.y * m.m[1][2] + p.z * m.m[2][2] + m.m[3][2]);
+	}
+
+	XMFLOAT3 TransformVector(const XMFLOAT3& v, const XMFLOAT4X4& m)
+	{
+		return XMFLOAT3(
+			v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0],
+			v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1],
+			v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2]);
+	}
+
+	float Length(const XMFLOAT3& v)
+	{
+		return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+	}
+
+	float MaxScale(const XMFLOAT4X4& m)
+	{
+		float sx = m.m[0][0] * m.m[0][0] + m.m[0][1] * m.m[0][1] + m.m[0][2] * m.m[0][2];
+		float sy = m.m[1][0] * m.m[1][0] + m.m[1][1] * m.m[1][1] + m.m[1][2] * m.m[1][2];
+		float sz = m.m[2][0] * m.m[2][0] + m.m[2][1] * m.m[2][1] + m.m[2][2] * m.m[2][2];
+		return std::sqrt(std::max(sx, std::max(sy, sz)));
+	}
+}
+
+void ClusterCuller::SetView(const XMFLOAT4 planes[6], const XMFLOAT3& eyePos)
+{
+	for(int i = 0; i < 6; ++i)
+		mPlanes[i] = planes[i];
+
+	mEyePos = eyePos;
+}
+
+void ClusterCuller::SetRangeLimits(std::uint32_t maxRanges, std::uint32_t minGapTriangles)
+{
+	mMaxRanges = maxRanges;
+	mMinGapTriangles = minGapTriangles;
+}
+
+std::uint32_t ClusterCuller::Cull(const Meshlet* meshlets, std::uint32_t meshletCount,
+	const XMFLOAT4X4* worlds, const std::uint32_t* instances, std::uint32_t instanceCount,
+	std::vector<ClusterRange>& ranges, ClusterCullStats& stats)
+{
+	mKeep.assign(meshletCount, 0);
+
+	std::uint64_t meshTriangles = 0;
+	for(std::uint32_t i = 0; i < meshletCount; ++i)
+		meshTriangles += meshlets[i].TriangleCount;
+
+	for(std::uint32_t k = 0; k < instanceCount; ++k)
+	{
+		const XMFLOAT4X4& world = worlds[instances[k]];
+		const float scale = MaxScale(world);
+
+		for(std::uint32_t i = 0; i < meshletCount; ++i)
+		{
+			const Meshlet& meshlet = meshlets[i];
+			stats.Tested++;
+
+			XMFLOAT3 center = TransformPoint(meshlet.Center, world);
+			float radius = meshlet.Radius * scale;
+
+			bool outside = false;
+			for(int p = 0; p < 6 && !outside; ++p)
+			{
+				const XMFLOAT4& plane = mPlanes[p];
+				outside = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius;
+			}
+
+			if(outside)
+			{
+				stats.FrustumCulled++;
+				continue;
+			}
+
+			if(meshlet.ConeCutoff <= 1.0f)
+			{
+				XMFLOAT3 apex = TransformPoint(meshlet.ConeApex, world);
+				XMFLOAT3 axis = TransformVector(meshlet.ConeAxis, world);
+				XMFLOAT3 view(apex.x - mEyePos.x, apex.y - mEyePos.y, apex.z - mEyePos.z);
+
+				float axisLength = Length(axis);
+				float viewLength = Length(view);
+				float d = view.x * axis.x + view.y * axis.y + view.z * axis.z;
+
+				if(d >= meshlet.ConeCutoff * viewLength * axisLength)
+				{
+					stats.BackfaceCulled++;
+					continue;
+				}
+			}
+
+			mKeep[i] = 1;
+		}
+	}
+
+	// Merge kept meshlets that are back to back in the index buffer.
+	mRanges.clear();
+	std::uint64_t keptTriangles = 0;
+	for(std::uint32_t i = 0; i < meshletCount; ++i)
+	{
+		if(!mKeep[i])
+			continue;
+
+		const Meshlet& meshlet = meshlets[i];
+		keptTriangles += meshlet.TriangleCount;
+
+		if(!mRanges.empty() && mRanges.back().StartIndex + mRanges.back().IndexCount == meshlet.StartIndex)
+			mRanges.back().IndexCount += meshlet.TriangleCount * 3;
+		else
+			mRanges.push_back({ meshlet.StartIndex, meshlet.TriangleCount * 3 });
+	}
+
+	// Gap g lies between ranges g and g+1.  Close the small ones, then the smallest of
+	// the rest until the range count fits.
+	const std::uint32_t gapCount = mRanges.empty() ? 0 : (std::uint32_t)mRanges.size() - 1;
+	mGaps.clear();
+	for(std::uint32_t g = 0; g < gapCount; ++g)
+	{
+		std::uint32_t gapIndices = mRanges[g + 1].StartIndex - (mRanges[g].StartIndex + mRanges[g].IndexCount);
+		mGaps.push_back(std::make_pair(gapIndices / 3, g));
+	}
+	std::sort(mGaps.begin(), mGaps.end());
+
+	mCloseGap.assign(gapCount, 0);
+	std::uint32_t rangeCount = (std::uint32_t)mRanges.size();
+	for(const auto& gap : mGaps)
+	{
+		bool overLimit = mMaxRanges != 0 && rangeCount > mMaxRanges;
+		if(gap.first > mMinGapTriangles && !overLimit)
+			break;
+
+		mCloseGap[gap.second] = 1;
+		rangeCount--;
+	}
+
+	std::uint32_t appended = 0;
+	std::uint64_t drawnTriangles = 0;
+	for(std::uint32_t r = 0; r < (std::uint32_t)mRanges.size(); ++r)
+	{
+		const ClusterRange& range = mRanges[r];
+		if(r > 0 && mCloseGap[r - 1])
+			ranges.back().IndexCount = range.StartIndex + range.IndexCount - ranges.back().StartIndex;
+		else
+		{
+			ranges.push_back(range);
+			appended++;
+		}
+	}
+	for(std::uint32_t r = 0; r < appended; ++r)
+		drawnTriangles += ranges[ranges.size() - appended + r].IndexCount / 3;
+
+	stats.Triangles += meshTriangles * instanceCount;
+	stats.TrianglesSkipped += (meshTriangles - drawnTriangles) * instanceCount;
+	stats.GapTriangles += (drawnTriangles - keptTriangles) * instanceCount;
+
+	return appended;
+}
@@ -0,0 +1,82 @@
+//***************************************************************************************
+// ClusterCuller.h
+//
+// Rejects meshlets (see MeshletBuilder.h) that are outside the view frustum or whose
+// triangles all face away from the eye, before draw submission.
+//
+// Meshlets are tested once per instance of a mesh; a meshlet is kept if any instance
+// can see it, since every instance of a group shares the same draw.  Kept meshlets
+// that are adjacent in the index buffer are merged into a single index range.
+//
+// A draw call costs more than a few culled triangles, so ranges are also merged
+// across small gaps of culled meshlets, and then across the smallest remaining gaps
+// until a mesh needs no more than a fixed number of ranges.  Culling a dense mesh
+// seen up close then costs a handful of draws instead of one per visible patch.
+//
+// Instance transforms are assumed to have uniform scale, as in the vertex shader's
+// normal transform.
+//***************************************************************************************
+
+#pragma once
+
+#include "MeshletBuilder.h"
+
+struct ClusterRange
+{
+	// Relative to the mesh's first index, like Meshlet::StartIndex.
+	std::uint32_t StartIndex = 0;
+	std::uint32_t IndexCount = 0;
+};
+
+struct ClusterCullStats
+{
+	// Meshlet tests, one per meshlet per instance.
+	std::uint32_t Tested = 0;
+	std::uint32_t FrustumCulled = 0;
+	std::uint32_t BackfaceCulled = 0;
+
+	// Triangles of the tested instances, and those not submitted.
+	std::uint64_t Triangles = 0;
+	std::uint64_t TrianglesSkipped = 0;
+
+	// Culled triangles submitted anyway because their gap was merged over.
+	std::uint64_t GapTriangles = 0;
+};
+
+class ClusterCuller
+{
+public:
+	///<summary>
+	/// planes are the world-space frustum planes as in FrustumCuller::SetPlanes.
+	///</summary>
+	void SetView(const DirectX::XMFLOAT4 planes[6], const DirectX::XMFLOAT3& eyePos);
+
+	///<summary>
+	/// Gaps of at most minGapTriangles culled triangles are always merged over, and
+	/// larger ones, smallest first, until a mesh has at most maxRanges ranges.
+	/// maxRanges of 0 means no limit.
+	///</summary>
+	void SetRangeLimits(std::uint32_t maxRanges, std::uint32_t minGapTriangles);
+
+	///<summary>
+	/// Culls the meshlets of one mesh for the instances whose world matrices are
+	/// worlds[instances[0..instanceCount)].  Appends the ranges to draw to ranges
+	/// and returns how many were appended.
+	///</summary>
+	std::uint32_t Cull(const Meshlet* meshlets, std::uint32_t meshletCount,
+		const DirectX::XMFLOAT4X4* worlds, const std::uint32_t* instances, std::uint32_t instanceCount,
+		std::vector<ClusterRange>& ranges, ClusterCullStats& stats);
+
+private:
+	DirectX::XMFLOAT4 mPlanes[6] = {};
+	DirectX::XMFLOAT3 mEyePos = { 0.0f, 0.0f, 0.0f };
+
+	std::uint32_t mMaxRanges = 8;
+	std::uint32_t mMinGapTriangles = 64;
+
+	// Scratch: kept meshlets, ranges before gap merging, and gaps by size.
+	std::vector<std::uint8_t> mKeep;
+	std::vector<ClusterRange> mRanges;
+	std::vector<std::uint8_t> mCloseGap;
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> mGaps;
+};
@@ -0,0 +1,65 @@
+//***************************************************************************************
+// CommandListPool.cpp
+//***************************************************************************************
+
+#include "CommandListPool.h"
+
+using Microsoft::WRL::ComPtr;
+
+CommandAllocatorPool::CommandAllocatorPool(ID3D12Device* device) :
+	md3dDevice(device)
+{
+}
+
+void CommandAllocatorPool::Reset()
+{
+	for(UINT i = 0; i < mUsed; ++i)
+		ThrowIfFailed(mAllocators[i]->Reset());
+
+	mUsed = 0;
+}
+
+ID3D12CommandAllocator* CommandAllocatorPool::Acquire()
+{
+	if(mUsed == mAllocators.size())
+	{
+		ComPtr<ID3D12CommandAllocator> allocator;
+		ThrowIfFailed(md3dDevice->CreateCommandAllocator(
+			D3D12_COMMAND_LIST_TYPE_DIRECT,
+			IID_PPV_ARGS(allocator.GetAddressOf())));
+		mAllocators.push_back(allocator);
+	}
+
+	return mAllocators[mUsed++].Get();
+}
+
+CommandListPool::CommandListPool(ID3D12Device* device) :
+	md3dDevice(device)
+{
+}
+
+void CommandListPool::Reset()
+{
+	mUsed = 0;
+}
+
+ID3D12GraphicsCommandList* CommandListPool::Acquire(ID3D12CommandAllocator* allocator)
+{
+	if(mUsed == mLists.size())
+	{
+		// Created open on the allocator, so it is ready to record right away.
+		ComPtr<ID3D12GraphicsCommandList> list;
+		ThrowIfFailed(md3dDevice->CreateCommandList(
+			0,
+			D3D12_COMMAND_LIST_TYPE_DIRECT,
+			allocator,
+			nullptr,
+			IID_PPV_ARGS(list.GetAddressOf())));
+		mLists.push_back(list);
+		return mLists[mUsed++].Get();
+	}
+
+	ID3D12GraphicsCommandList* list = mLists[mUsed++].Get();
+	ThrowIfFailed(list->Reset(allocator, nullptr));
+	return list;
+}
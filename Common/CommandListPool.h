@@ -0,0 +1,69 @@
+//***************************************************************************************
+// CommandListPool.h
+//
+// Command allocators and lists for recording on several threads.
+//
+// CommandAllocatorPool belongs to one frame resource: its allocators hold the commands
+// of that frame until the GPU has executed them, so Reset may only be called once the
+// frame's fence has completed.  Allocators are created on first use and kept.
+//
+// CommandListPool hands out closed-then-reset command lists, one per recording thread.
+// A list may be reset as soon as it has been submitted, so the lists are shared by all
+// frames and only the allocators are per frame.
+//
+// Acquire calls are not thread-safe; acquire every list on the owning thread before
+// recording starts.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class CommandAllocatorPool
+{
+public:
+	explicit CommandAllocatorPool(ID3D12Device* device);
+	CommandAllocatorPool(const CommandAllocatorPool& rhs) = delete;
+	CommandAllocatorPool& operator=(const CommandAllocatorPool& rhs) = delete;
+
+	///<summary>
+	/// Resets every allocator handed out since the last Reset.  The GPU must be done
+	/// with the commands recorded through them.
+	///</summary>
+	void Reset();
+
+	ID3D12CommandAllocator* Acquire();
+
+	UINT Size()const { return (UINT)mAllocators.size(); }
+
+private:
+	ID3D12Device* md3dDevice = nullptr;
+	std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> mAllocators;
+	UINT mUsed = 0;
+};
+
+class CommandListPool
+{
+public:
+	explicit CommandListPool(ID3D12Device* device);
+	CommandListPool(const CommandListPool& rhs) = delete;
+	CommandListPool& operator=(const CommandListPool& rhs) = delete;
+
+	///<summary>
+	/// Starts handing out lists from the front again.  Lists from the previous call
+	/// must have been submitted (or closed).
+	///</summary>
+	void Reset();
+
+	///<summary>
+	/// Returns a list reset onto allocator and ready to record.
+	///</summary>
+	ID3D12GraphicsCommandList* Acquire(ID3D12CommandAllocator* allocator);
+
+	UINT Size()const { return (UINT)mLists.size(); }
+
+private:
+	ID3D12Device* md3dDevice = nullptr;
+	std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>> mLists;
+	UINT mUsed = 0;
+};
@@ -0,0 +1,59 @@
+//***************************************************************************************
+// CommandRecorder.h
+//
+// The subset of a graphics command list that a frame uses, as an interface, so code
+// that builds the frame (uploads, clears, state filtering, partitioning, parallel
+// recording) does not depend on a device.  D3D12CommandRecorder forwards to an
+// ID3D12GraphicsCommandList; MemoryCommandRecorder stores the commands in memory.
+//
+// Arguments use the D3D12 structure types, which are plain data, so this header only
+// needs d3d12.h and builds off Windows against the stand-in in Tests/Headless.
+//***************************************************************************************
+
+#pragma once
+
+#include <d3d12.h>
+
+class CommandRecorder
+{
+public:
+	virtual ~CommandRecorder() = default;
+
+	virtual void SetPipelineState(ID3D12PipelineState* pso) = 0;
+	virtual void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature) = 0;
+	virtual void SetGraphicsRootConstantBufferView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address) = 0;
+	virtual void SetGraphicsRootShaderResourceView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address) = 0;
+	virtual void SetGraphicsRoot32BitConstants(UINT rootParameter, UINT count, const void* data, UINT destOffset) = 0;
+
+	virtual void IASetVertexBuffer(const D3D12_VERTEX_BUFFER_VIEW& view) = 0;
+	virtual void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view) = 0;
+	virtual void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology) = 0;
+
+	virtual void RSSetViewport(const D3D12_VIEWPORT& viewport) = 0;
+	virtual void RSSetScissorRect(const D3D12_RECT& rect) = 0;
+	virtual void OMSetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, D3D12_CPU_DESCRIPTOR_HANDLE depthStencil) = 0;
+
+	virtual void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance) = 0;
+
+	virtual void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers) = 0;
+	virtual void ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, const FLOAT color[4]) = 0;
+	virtual void ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE depthStencil, D3D12_CLEAR_FLAGS flags, FLOAT depth, UINT8 stencil) = 0;
+	virtual void CopyBufferRegion(ID3D12Resource* dest, UINT64 destOffset, ID3D12Resource* src, UINT64 srcOffset, UINT64 byteSize) = 0;
+};
+
+///<summary>
+/// Transition of every subresource of resource, as CD3DX12_RESOURCE_BARRIER::Transition
+/// builds it, for code that does not include d3dx12.h.
+///</summary>
+inline D3D12_RESOURCE_BARRIER TransitionBarrier(ID3D12Resource* resource,
+	D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter)
+{
+	D3D12_RESOURCE_BARRIER barrier = {};
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barrier.Transition.pResource = resource;
+	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barrier.Transition.StateBefore = stateBefore;
+	barrier.Transition.StateAfter = stateAfter;
+	return barrier;
+}
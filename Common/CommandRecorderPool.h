@@ -0,0 +1,41 @@
+//***************************************************************************************
+// CommandRecorderPool.h
+//
+// Hands out one CommandRecorder per command list a frame records, and submits them.
+// A frame acquires its lists in submission order (setup, draw ranges, end), records
+// them, possibly on several threads, then submits all of them at once.
+//
+// D3D12RecorderPool records into pooled command lists with per-frame allocators.
+// MemoryRecorderPool records into MemoryCommandRecorders and keeps the submitted
+// streams and their counts, so a frame can be recorded and measured without a device.
+//
+// Acquire is not thread-safe; acquire every recorder on the owning thread before
+// recording starts.  Recorders stay valid until the next BeginFrame.
+//***************************************************************************************
+
+#pragma once
+
+#include "CommandRecorder.h"
+
+class CommandRecorderPool
+{
+public:
+	virtual ~CommandRecorderPool() = default;
+
+	///<summary>
+	/// Starts recording frame resource frameIndex.  The GPU must have finished the lists
+	/// submitted the last time this frame index was used.
+	///</summary>
+	virtual void BeginFrame(UINT frameIndex) = 0;
+
+	///<summary>
+	/// Returns a recorder for a new command list, submitted after the ones acquired
+	/// before it.
+	///</summary>
+	virtual CommandRecorder& Acquire() = 0;
+
+	///<summary>
+	/// Closes and submits every list acquired since BeginFrame, in acquire order.
+	///</summary>
+	virtual void Submit() = 0;
+};
@@ -0,0 +1,197 @@
+//***************************************************************************************
+// CommandStateCache.cpp
+//***************************************************************************************
+
+#include "CommandStateCache.h"
+
+UINT CommandStateStats::Issued()const
+{
+	return PipelineStates.Issued + RootSignatures.Issued + RootDescriptors.Issued + RootConstants.Issued +
+		VertexBuffers.Issued + IndexBuffers.Issued + Topologies.Issued;
+}
+
+UINT CommandStateStats::Skipped()const
+{
+	return PipelineStates.Skipped + RootSignatures.Skipped + RootDescriptors.Skipped + RootConstants.Skipped +
+		VertexBuffers.Skipped + IndexBuffers.Skipped + Topologies.Skipped;
+}
+
+void CommandStateCache::Begin(CommandRecorder* recorder)
+{
+	mRecorder = recorder;
+
+	mPipelineState = nullptr;
+	mRootSignature = nullptr;
+	ForgetRootArguments();
+
+	mHasVertexBuffer = false;
+	mHasIndexBuffer = false;
+	mTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+
+	mStats = CommandStateStats();
+}
+
+void CommandStateCache::SetPipelineState(ID3D12PipelineState* pso)
+{
+	if(pso == mPipelineState)
+	{
+		mStats.PipelineStates.Skipped++;
+		return;
+	}
+
+	mPipelineState = pso;
+	mStats.PipelineStates.Issued++;
+	if(mRecorder != nullptr)
+		mRecorder->SetPipelineState(pso);
+}
+
+void CommandStateCache::SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)
+{
+	if(rootSignature == mRootSignature)
+	{
+		mStats.RootSignatures.Skipped++;
+		return;
+	}
+
+	// A new root signature invalidates every root argument.
+	mRootSignature = rootSignature;
+	ForgetRootArguments();
+
+	mStats.RootSignatures.Issued++;
+	if(mRecorder != nullptr)
+		mRecorder->SetGraphicsRootSignature(rootSignature);
+}
+
+void CommandStateCache::SetGraphicsRootConstantBufferView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	if(SetRootDescriptor(rootParameter, RootKind::ConstantBufferView, address) && mRecorder != nullptr)
+		mRecorder->SetGraphicsRootConstantBufferView(rootParameter, address);
+}
+
+void CommandStateCache::SetGraphicsRootShaderResourceView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	if(SetRootDescriptor(rootParameter, RootKind::ShaderResourceView, address) && mRecorder != nullptr)
+		mRecorder->SetGraphicsRootShaderResourceView(rootParameter, address);
+}
+
+void CommandStateCache::SetGraphicsRoot32BitConstants(UINT rootParameter, UINT count, const void* data, UINT destOffset)
+{
+	const UINT* values = static_cast<const UINT*>(data);
+
+	if(rootParameter < MaxRootParameters && destOffset + count <= MaxRootConstants)
+	{
+		RootArgument& argument = mRootArguments[rootParameter];
+
+		bool same = true;
+		for(UINT i = 0; i < count && same; ++i)
+		{
+			UINT slot = destOffset + i;
+			same = (argument.ConstantMask & (1u << slot)) != 0 && argument.Constants[slot] == values[i];
+		}
+
+		if(same)
+		{
+			mStats.RootConstants.Skipped++;
+			return;
+		}
+
+		for(UINT i = 0; i < count; ++i)
+		{
+			argument.Constants[destOffset + i] = values[i];
+			argument.ConstantMask |= 1u << (destOffset + i);
+		}
+	}
+
+	mStats.RootConstants.Issued++;
+	if(mRecorder != nullptr)
+		mRecorder->SetGraphicsRoot32BitConstants(rootParameter, count, data, destOffset);
+}
+
+void CommandStateCache::IASetVertexBuffer(const D3D12_VERTEX_BUFFER_VIEW& view)
+{
+	if(mHasVertexBuffer &&
+		view.BufferLocation == mVertexBuffer.BufferLocation &&
+		view.SizeInBytes == mVertexBuffer.SizeInBytes &&
+		view.StrideInBytes == mVertexBuffer.StrideInBytes)
+	{
+		mStats.VertexBuffers.Skipped++;
+		return;
+	}
+
+	mHasVertexBuffer = true;
+	mVertexBuffer = view;
+
+	mStats.VertexBuffers.Issued++;
+	if(mRecorder != nullptr)
+		mRecorder->IASetVertexBuffer(view);
+}
+
+void CommandStateCache::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view)
+{
+	if(mHasIndexBuffer &&
+		view.BufferLocation == mIndexBuffer.BufferLocation &&
+		view.SizeInBytes == mIndexBuffer.SizeInBytes &&
+		view.Format == mIndexBuffer.Format)
+	{
+		mStats.IndexBuffers.Skipped++;
+		return;
+	}
+
+	mHasIndexBuffer = true;
+	mIndexBuffer = view;
+
+	mStats.IndexBuffers.Issued++;
+	if(mRecorder != nullptr)
+		mRecorder->IASetIndexBuffer(view);
+}
+
+void CommandStateCache::IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+{
+	if(topology == mTopology)
+	{
+		mStats.Topologies.Skipped++;
+		return;
+	}
+
+	mTopology = topology;
+
+	mStats.Topologies.Issued++;
+	if(mRecorder != nullptr)
+		mRecorder->IASetPrimitiveTopology(topology);
+}
+
+void CommandStateCache::DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+{
+	mStats.Draws++;
+	if(mRecorder != nullptr)
+		mRecorder->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+bool CommandStateCache::SetRootDescriptor(UINT rootParameter, RootKind kind, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	if(rootParameter < MaxRootParameters)
+	{
+		RootArgument& argument = mRootArguments[rootParameter];
+		if(argument.Kind == kind && argument.Address == address)
+		{
+			mStats.RootDescriptors.Skipped++;
+			return false;
+		}
+
+		argument.Kind = kind;
+		argument.Address = address;
+	}
+
+	mStats.RootDescriptors.Issued++;
+	return true;
+}
+
+void CommandStateCache::ForgetRootArguments()
+{
+	for(RootArgument& argument : mRootArguments)
+	{
+		argument.Kind = RootKind::None;
+		argument.Address = 0;
+		argument.ConstantMask = 0;
+	}
+}
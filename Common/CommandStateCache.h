@@ -0,0 +1,100 @@
+//***************************************************************************************
+// CommandStateCache.h
+//
+// Sits in front of a CommandRecorder and drops state-setting calls that would
+// set what is already bound: the same pipeline state, root signature, root descriptor
+// or root constants, vertex/index buffer views or topology.  Every call is counted as
+// issued or skipped, so the effect of a submission order can be measured.
+//
+// A command list starts with no state, so Begin must be called for every list.
+// Changing the root signature forgets the root arguments, as D3D12 does.  With a null
+// recorder nothing is forwarded and only the counts are kept, which records what a
+// submission order would cost without a device.
+//***************************************************************************************
+
+#pragma once
+
+#include "CommandRecorder.h"
+
+struct CommandCount
+{
+	UINT Issued = 0;
+	UINT Skipped = 0;
+};
+
+struct CommandStateStats
+{
+	CommandCount PipelineStates;
+	CommandCount RootSignatures;
+	CommandCount RootDescriptors;
+	CommandCount RootConstants;
+	CommandCount VertexBuffers;
+	CommandCount IndexBuffers;
+	CommandCount Topologies;
+	UINT Draws = 0;
+
+	UINT Issued()const;
+	UINT Skipped()const;
+};
+
+class CommandStateCache
+{
+public:
+	static const UINT MaxRootParameters = 8;
+	static const UINT MaxRootConstants = 32;
+
+	///<summary>
+	/// Starts a command list: forgets all bound state and clears the counts.
+	///</summary>
+	void Begin(CommandRecorder* recorder);
+
+	void SetPipelineState(ID3D12PipelineState* pso);
+	void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature);
+	void SetGraphicsRootConstantBufferView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address);
+	void SetGraphicsRootShaderResourceView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address);
+	void SetGraphicsRoot32BitConstants(UINT rootParameter, UINT count, const void* data, UINT destOffset);
+
+	void IASetVertexBuffer(const D3D12_VERTEX_BUFFER_VIEW& view);
+	void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view);
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology);
+
+	void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance);
+
+	const CommandStateStats& Stats()const { return mStats; }
+
+private:
+	enum class RootKind
+	{
+		None,
+		ConstantBufferView,
+		ShaderResourceView,
+	};
+
+	struct RootArgument
+	{
+		RootKind Kind = RootKind::None;
+		D3D12_GPU_VIRTUAL_ADDRESS Address = 0;
+
+		// Constants written so far; a bit per 32-bit value.
+		UINT ConstantMask = 0;
+		UINT Constants[MaxRootConstants] = {};
+	};
+
+	bool SetRootDescriptor(UINT rootParameter, RootKind kind, D3D12_GPU_VIRTUAL_ADDRESS address);
+	void ForgetRootArguments();
+
+private:
+	CommandRecorder* mRecorder = nullptr;
+
+	ID3D12PipelineState* mPipelineState = nullptr;
+	ID3D12RootSignature* mRootSignature = nullptr;
+	RootArgument mRootArguments[MaxRootParameters];
+
+	bool mHasVertexBuffer = false;
+	D3D12_VERTEX_BUFFER_VIEW mVertexBuffer = {};
+	bool mHasIndexBuffer = false;
+	D3D12_INDEX_BUFFER_VIEW mIndexBuffer = {};
+	D3D12_PRIMITIVE_TOPOLOGY mTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+
+	CommandStateStats mStats;
+};
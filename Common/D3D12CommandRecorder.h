@@ -0,0 +1,106 @@
+//***************************************************************************************
+// D3D12CommandRecorder.h
+//
+// CommandRecorder that forwards every call to an ID3D12GraphicsCommandList.  Kept
+// apart from CommandRecorder.h so the interface does not pull in the device headers.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include "CommandRecorder.h"
+
+class D3D12CommandRecorder : public CommandRecorder
+{
+public:
+	explicit D3D12CommandRecorder(ID3D12GraphicsCommandList* cmdList = nullptr) :
+		mCmdList(cmdList)
+	{
+	}
+
+	void SetCommandList(ID3D12GraphicsCommandList* cmdList) { mCmdList = cmdList; }
+	ID3D12GraphicsCommandList* CommandList()const { return mCmdList; }
+
+	void SetPipelineState(ID3D12PipelineState* pso)override
+	{
+		mCmdList->SetPipelineState(pso);
+	}
+
+	void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)override
+	{
+		mCmdList->SetGraphicsRootSignature(rootSignature);
+	}
+
+	void SetGraphicsRootConstantBufferView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)override
+	{
+		mCmdList->SetGraphicsRootConstantBufferView(rootParameter, address);
+	}
+
+	void SetGraphicsRootShaderResourceView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)override
+	{
+		mCmdList->SetGraphicsRootShaderResourceView(rootParameter, address);
+	}
+
+	void SetGraphicsRoot32BitConstants(UINT rootParameter, UINT count, const void* data, UINT destOffset)override
+	{
+		mCmdList->SetGraphicsRoot32BitConstants(rootParameter, count, data, destOffset);
+	}
+
+	void IASetVertexBuffer(const D3D12_VERTEX_BUFFER_VIEW& view)override
+	{
+		mCmdList->IASetVertexBuffers(0, 1, &view);
+	}
+
+	void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view)override
+	{
+		mCmdList->IASetIndexBuffer(&view);
+	}
+
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)override
+	{
+		mCmdList->IASetPrimitiveTopology(topology);
+	}
+
+	void RSSetViewport(const D3D12_VIEWPORT& viewport)override
+	{
+		mCmdList->RSSetViewports(1, &viewport);
+	}
+
+	void RSSetScissorRect(const D3D12_RECT& rect)override
+	{
+		mCmdList->RSSetScissorRects(1, &rect);
+	}
+
+	void OMSetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, D3D12_CPU_DESCRIPTOR_HANDLE depthStencil)override
+	{
+		mCmdList->OMSetRenderTargets(1, &renderTarget, true, &depthStencil);
+	}
+
+	void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)override
+	{
+		mCmdList->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+	}
+
+	void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers)override
+	{
+		mCmdList->ResourceBarrier(count, barriers);
+	}
+
+	void ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, const FLOAT color[4])override
+	{
+		mCmdList->ClearRenderTargetView(renderTarget, color, 0, nullptr);
+	}
+
+	void ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE depthStencil, D3D12_CLEAR_FLAGS flags, FLOAT depth, UINT8 stencil)override
+	{
+		mCmdList->ClearDepthStencilView(depthStencil, flags, depth, stencil, 0, nullptr);
+	}
+
+	void CopyBufferRegion(ID3D12Resource* dest, UINT64 destOffset, ID3D12Resource* src, UINT64 srcOffset, UINT64 byteSize)override
+	{
+		mCmdList->CopyBufferRegion(dest, destOffset, src, srcOffset, byteSize);
+	}
+
+private:
+	ID3D12GraphicsCommandList* mCmdList = nullptr;
+};
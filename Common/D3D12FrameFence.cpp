@@ -0,0 +1,34 @@
+//***************************************************************************************
+// D3D12FrameFence.cpp
+//***************************************************************************************
+
+#include "D3D12FrameFence.h"
+
+D3D12FrameFence::D3D12FrameFence(ID3D12Device* device, ID3D12CommandQueue* queue) :
+	mQueue(queue)
+{
+	ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+}
+
+UINT64 D3D12FrameFence::CompletedValue()const
+{
+	return mFence->GetCompletedValue();
+}
+
+void D3D12FrameFence::Wait(UINT64 value)
+{
+	if(mFence->GetCompletedValue() < value)
+	{
+		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
+
+		ThrowIfFailed(mFence->SetEventOnCompletion(value, eventHandle));
+
+		WaitForSingleObject(eventHandle, INFINITE);
+		CloseHandle(eventHandle);
+	}
+}
+
+void D3D12FrameFence::SignalValue(UINT64 value)
+{
+	ThrowIfFailed(mQueue->Signal(mFence.Get(), value));
+}
@@ -0,0 +1,28 @@
+//***************************************************************************************
+// D3D12FrameFence.h
+//
+// FrameFence over an ID3D12Fence signalled on one command queue.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include "FrameFence.h"
+
+class D3D12FrameFence : public FrameFence
+{
+public:
+	D3D12FrameFence(ID3D12Device* device, ID3D12CommandQueue* queue);
+
+	UINT64 CompletedValue()const override;
+	void Wait(UINT64 value)override;
+
+	ID3D12Fence* Fence()const { return mFence.Get(); }
+
+protected:
+	void SignalValue(UINT64 value)override;
+
+private:
+	ID3D12CommandQueue* mQueue = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12Fence> mFence;
+};
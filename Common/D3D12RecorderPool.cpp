@@ -0,0 +1,46 @@
+//***************************************************************************************
+// D3D12RecorderPool.cpp
+//***************************************************************************************
+
+#include "D3D12RecorderPool.h"
+
+D3D12RecorderPool::D3D12RecorderPool(ID3D12Device* device, ID3D12CommandQueue* queue, UINT frameCount) :
+	mQueue(queue),
+	mLists(device)
+{
+	for(UINT i = 0; i < frameCount; ++i)
+		mFrameAllocators.push_back(std::make_unique<CommandAllocatorPool>(device));
+}
+
+void D3D12RecorderPool::BeginFrame(UINT frameIndex)
+{
+	// The lists were submitted last frame and may be reset; the allocators of this
+	// frame index are protected by its fence.
+	mAllocators = mFrameAllocators[frameIndex].get();
+	mAllocators->Reset();
+	mLists.Reset();
+	mUsed = 0;
+}
+
+CommandRecorder& D3D12RecorderPool::Acquire()
+{
+	if(mUsed == mRecorders.size())
+		mRecorders.emplace_back();
+
+	D3D12CommandRecorder& recorder = mRecorders[mUsed++];
+	recorder.SetCommandList(mLists.Acquire(mAllocators->Acquire()));
+	return recorder;
+}
+
+void D3D12RecorderPool::Submit()
+{
+	mSubmitLists.clear();
+	for(UINT i = 0; i < mUsed; ++i)
+	{
+		ThrowIfFailed(mRecorders[i].CommandList()->Close());
+		mSubmitLists.push_back(mRecorders[i].CommandList());
+	}
+
+	if(!mSubmitLists.empty())
+		mQueue->ExecuteCommandLists((UINT)mSubmitLists.size(), mSubmitLists.data());
+}
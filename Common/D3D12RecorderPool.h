@@ -0,0 +1,38 @@
+//***************************************************************************************
+// D3D12RecorderPool.h
+//
+// CommandRecorderPool over a CommandListPool, with a CommandAllocatorPool per frame
+// resource.  Submit closes the lists and executes them in one call on the queue.
+//***************************************************************************************
+
+#pragma once
+
+#include "CommandListPool.h"
+#include "CommandRecorderPool.h"
+#include "D3D12CommandRecorder.h"
+#include <deque>
+
+class D3D12RecorderPool : public CommandRecorderPool
+{
+public:
+	D3D12RecorderPool(ID3D12Device* device, ID3D12CommandQueue* queue, UINT frameCount);
+	D3D12RecorderPool(const D3D12RecorderPool& rhs) = delete;
+	D3D12RecorderPool& operator=(const D3D12RecorderPool& rhs) = delete;
+
+	void BeginFrame(UINT frameIndex)override;
+	CommandRecorder& Acquire()override;
+	void Submit()override;
+
+private:
+	ID3D12CommandQueue* mQueue = nullptr;
+
+	std::vector<std::unique_ptr<CommandAllocatorPool>> mFrameAllocators;
+	CommandAllocatorPool* mAllocators = nullptr;
+	CommandListPool mLists;
+
+	// Recorders keep their addresses as more are acquired.
+	std::deque<D3D12CommandRecorder> mRecorders;
+	UINT mUsed = 0;
+
+	std::vector<ID3D12CommandList*> mSubmitLists;
+};
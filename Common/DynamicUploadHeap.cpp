@@ -0,0 +1,36 @@
+//***************************************************************************************
+// DynamicUploadHeap.cpp
+//***************************************************************************************
+
+#include "DynamicUploadHeap.h"
+
+DynamicUploadHeap::DynamicUploadHeap(ID3D12Device* device, UINT64 pageSize) :
+	UploadHeap(pageSize),
+	md3dDevice(device)
+{
+}
+
+DynamicUploadHeap::~DynamicUploadHeap()
+{
+	for(auto& resource : mPageResources)
+		resource->Unmap(0, nullptr);
+}
+
+UploadAllocation DynamicUploadHeap::CreatePage(UINT64 byteSize)
+{
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+	ThrowIfFailed(md3dDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(byteSize),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&resource)));
+
+	UploadAllocation page;
+	ThrowIfFailed(resource->Map(0, nullptr, reinterpret_cast<void**>(&page.CpuAddress)));
+	page.GpuAddress = resource->GetGPUVirtualAddress();
+
+	mPageResources.push_back(resource);
+	return page;
+}
@@ -0,0 +1,24 @@
+//***************************************************************************************
+// DynamicUploadHeap.h
+//
+// UploadHeap whose pages are persistently mapped UPLOAD-heap buffers.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include "UploadHeap.h"
+
+class DynamicUploadHeap : public UploadHeap
+{
+public:
+	DynamicUploadHeap(ID3D12Device* device, UINT64 pageSize);
+	~DynamicUploadHeap();
+
+protected:
+	UploadAllocation CreatePage(UINT64 byteSize)override;
+
+private:
+	ID3D12Device* md3dDevice = nullptr;
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> mPageResources;
+};
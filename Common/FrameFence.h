@@ -0,0 +1,92 @@
+//***************************************************************************************
+// FrameFence.h
+//
+// The fence a frame loop signals after submitting each frame and waits on before
+// reusing that frame's resources.  Values increase by one per Signal.
+//
+// D3D12FrameFence signals an ID3D12Fence on a command queue.  MemoryFence stands in
+// for it without a device: a signalled value completes once latency later values have
+// been signalled, or when it is waited on, like a GPU that runs a fixed number of
+// frames behind the CPU.
+//***************************************************************************************
+
+#pragma once
+
+#include <d3d12.h>
+#include <deque>
+
+class FrameFence
+{
+public:
+	virtual ~FrameFence() = default;
+
+	///<summary>
+	/// Signals the next value once everything submitted so far has executed, and
+	/// returns it.
+	///</summary>
+	UINT64 Signal()
+	{
+		mCurrentValue++;
+		SignalValue(mCurrentValue);
+		return mCurrentValue;
+	}
+
+	///<summary>
+	/// The last value signalled.
+	///</summary>
+	UINT64 CurrentValue()const { return mCurrentValue; }
+
+	virtual UINT64 CompletedValue()const = 0;
+
+	///<summary>
+	/// Blocks until CompletedValue() >= value.
+	///</summary>
+	virtual void Wait(UINT64 value) = 0;
+
+	///<summary>
+	/// Waits for everything submitted so far.
+	///</summary>
+	void Flush() { Wait(Signal()); }
+
+protected:
+	virtual void SignalValue(UINT64 value) = 0;
+
+private:
+	UINT64 mCurrentValue = 0;
+};
+
+class MemoryFence : public FrameFence
+{
+public:
+	explicit MemoryFence(UINT latency = 1) :
+		mLatency(latency)
+	{
+	}
+
+	UINT64 CompletedValue()const override { return mCompleted; }
+
+	void Wait(UINT64 value)override
+	{
+		while(mCompleted < value && !mPending.empty())
+			CompleteOldest();
+	}
+
+protected:
+	void SignalValue(UINT64 value)override
+	{
+		mPending.push_back(value);
+		while(mPending.size() > mLatency)
+			CompleteOldest();
+	}
+
+private:
+	void CompleteOldest()
+	{
+		mCompleted = mPending.front();
+		mPending.pop_front();
+	}
+
+	UINT mLatency = 1;
+	UINT64 mCompleted = 0;
+	std::deque<UINT64> mPending;
+};
@@ -0,0 +1,52 @@
+//***************************************************************************************
+// FrameRing.h
+//
+// Fence bookkeeping for an N-deep ring of frame resources.  The CPU may record frame
+// N+1 while the GPU still executes frame N; a slot only has to be waited on when the
+// CPU laps the GPU and comes back to a slot whose fence has not completed yet.
+//
+// Holds plain fence values only, so it can be driven by a simulated fence.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class FrameRing
+{
+public:
+	explicit FrameRing(int frameCount) :
+		mFences(frameCount, 0)
+	{
+	}
+
+	int Count()const { return (int)mFences.size(); }
+	int CurrentIndex()const { return mCurrent; }
+
+	///<summary>
+	/// Moves to the next slot.  Returns the fence value the GPU has to reach before the
+	/// slot's resources may be reused, or 0 if completedFenceValue already covers it.
+	///</summary>
+	std::uint64_t Advance(std::uint64_t completedFenceValue)
+	{
+		mCurrent = (mCurrent + 1) % Count();
+
+		std::uint64_t fence = mFences[mCurrent];
+		return fence > completedFenceValue ? fence : 0;
+	}
+
+	///<summary>
+	/// Records the fence value signalled after the current slot's commands.
+	///</summary>
+	void Signal(std::uint64_t fenceValue)
+	{
+		mFences[mCurrent] = fenceValue;
+	}
+
+	std::uint64_t CurrentFence()const { return mFences[mCurrent]; }
+
+private:
+	std::vector<std::uint64_t> mFences;
+	int mCurrent = 0;
+};
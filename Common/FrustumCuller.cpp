@@ -0,0 +1,173 @@
+//***************************************************************************************
+// FrustumCuller.cpp
+//***************************************************************************************
+
+#include "FrustumCuller.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <xmmintrin.h>
+
+using namespace DirectX;
+
+FrustumCuller::FrustumCuller(JobSystem* jobs, std::uint32_t chunkSize) :
+	mJobs(jobs),
+	mChunkSize((chunkSize + 3) & ~3u)
+{
+	if(mChunkSize == 0)
+		mChunkSize = 4;
+
+	for(int i = 0; i < 6; ++i)
+		mPlanes[i] = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void FrustumCuller::SetCamera(FXMMATRIX view, CXMMATRIX proj)
+{
+	// Planes of the view-projection matrix (Gribb/Hartmann).  With row vectors,
+	// clip = p * M, so each clip coordinate is p dotted with a column of M; the
+	// columns of M are the rows of its transpose.  D3D clip space has 0 <= z <= w.
+	XMMATRIX m = XMMatrixTranspose(XMMatrixMultiply(view, proj));
+
+	XMVECTOR planes[6] =
+	{
+		XMVectorAdd(m.r[3], m.r[0]),		// left
+		XMVectorSubtract(m.r[3], m.r[0]),	// right
+		XMVectorAdd(m.r[3], m.r[1]),		// bottom
+		XMVectorSubtract(m.r[3], m.r[1]),	// top
+		m.r[2],								// near
+		XMVectorSubtract(m.r[3], m.r[2]),	// far
+	};
+
+	for(int i = 0; i < 6; ++i)
+		XMStoreFloat4(&mPlanes[i], XMPlaneNormalize(planes[i]));
+}
+
+void FrustumCuller::SetPlanes(const XMFLOAT4 planes[6])
+{
+	for(int i = 0; i < 6; ++i)
+		mPlanes[i] = planes[i];
+}
+
+CullStats FrustumCuller::Cull(const BoundingSphere* spheres, const BoundingBox* boxes,
+	std::uint32_t count, std::vector<std::uint8_t>& visible,
+	std::vector<std::uint32_t>* visibleList)
+{
+	visible.resize(count);
+
+	std::uint32_t chunkCount = JobSystem::ChunkCount(count, mChunkSize);
+	if(mChunkLists.size() < chunkCount)
+		mChunkLists.resize(chunkCount);
+
+	auto cullChunk = [&](std::uint32_t chunk, std::uint32_t begin, std::uint32_t end)
+	{
+		mChunkLists[chunk].clear();
+		CullChunk(spheres, boxes, begin, end, visible.data(), mChunkLists[chunk]);
+	};
+
+	if(mJobs != nullptr)
+		mJobs->ParallelFor(count, mChunkSize, cullChunk);
+	else
+	{
+		for(std::uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+			cullChunk(chunk, chunk * mChunkSize, std::min(count, (chunk + 1) * mChunkSize));
+	}
+
+	// Each chunk wrote only its own list, so the merge needs no locking; concatenating
+	// in chunk order keeps the indices sorted.
+	CullStats stats;
+	for(std::uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+		stats.Visible += (std::uint32_t)mChunkLists[chunk].size();
+	stats.Culled = count - stats.Visible;
+
+	if(visibleList != nullptr)
+	{
+		visibleList->clear();
+		visibleList->reserve(stats.Visible);
+		for(std::uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+			visibleList->insert(visibleList->end(), mChunkLists[chunk].begin(), mChunkLists[chunk].end());
+	}
+
+	return stats;
+}
+
+void FrustumCuller::CullChunk(const BoundingSphere* spheres, const BoundingBox* boxes,
+	std::uint32_t begin, std::uint32_t end, std::uint8_t* visible,
+	std::vector<std::uint32_t>& survivors)const
+{
+	static_assert(sizeof(BoundingSphere) == 4 * sizeof(float), "BoundingSphere must be {x, y, z, r}.");
+
+	__m128 px[6], py[6], pz[6], pw[6];
+	for(int p = 0; p < 6; ++p)
+	{
+		px[p] = _mm_set1_ps(mPlanes[p].x);
+		py[p] = _mm_set1_ps(mPlanes[p].y);
+		pz[p] = _mm_set1_ps(mPlanes[p].z);
+		pw[p] = _mm_set1_ps(mPlanes[p].w);
+	}
+
+	for(std::uint32_t i = begin; i < end; i += 4)
+	{
+		std::uint32_t lanes = end - i < 4 ? end - i : 4;
+
+		// The last group of a chunk may be short; pad it with copies of its first
+		// sphere so every sphere goes through the same arithmetic.
+		BoundingSphere group[4];
+		for(std::uint32_t k = 0; k < 4; ++k)
+			group[k] = spheres[i + (k < lanes ? k : 0)];
+
+		__m128 x = _mm_loadu_ps(&group[0].Center.x);
+		__m128 y = _mm_loadu_ps(&group[1].Center.x);
+		__m128 z = _mm_loadu_ps(&group[2].Center.x);
+		__m128 r = _mm_loadu_ps(&group[3].Center.x);
+		_MM_TRANSPOSE4_PS(x, y, z, r);
+
+		__m128 negR = _mm_sub_ps(_mm_setzero_ps(), r);
+		__m128 outside = _mm_setzero_ps();
+		__m128 inside = _mm_cmpeq_ps(r, r);
+
+		for(int p = 0; p < 6; ++p)
+		{
+			__m128 d = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(x, px[p]), _mm_mul_ps(y, py[p])),
+				_mm_add_ps(_mm_mul_ps(z, pz[p]), pw[p]));
+
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(d, negR));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(d, r));
+		}
+
+		int outsideMask = _mm_movemask_ps(outside);
+		int insideMask = _mm_movemask_ps(inside);
+
+		for(std::uint32_t k = 0; k < lanes; ++k)
+		{
+			bool isVisible;
+			if(outsideMask & (1 << k))
+				isVisible = false;
+			else if(insideMask & (1 << k))
+				isVisible = true;
+			else
+				isVisible = BoxVisible(boxes[i + k]);
+
+			visible[i + k] = isVisible ? 1 : 0;
+			if(isVisible)
+				survivors.push_back(i + k);
+		}
+	}
+}
+
+bool FrustumCuller::BoxVisible(const BoundingBox& box)const
+{
+	for(int p = 0; p < 6; ++p)
+	{
+		const XMFLOAT4& plane = mPlanes[p];
+
+		float d = box.Center.x * plane.x + box.Center.y * plane.y + box.Center.z * plane.z + plane.w;
+		float r = box.Extents.x * std::fabs(plane.x) + box.Extents.y * std::fabs(plane.y) + box.Extents.z * std::fabs(plane.z);
+
+		if(d < -r)
+			return false;
+	}
+
+	return true;
+}
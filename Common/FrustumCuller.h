@@ -0,0 +1,72 @@
+//***************************************************************************************
+// FrustumCuller.h
+//
+// Tests world-space bounding volumes against the six camera frustum planes before
+// draw submission.  Spheres are tested four at a time with SSE; only spheres that
+// straddle a plane are refined with their box.  Large inputs are split into
+// fixed-size chunks across a JobSystem, each chunk compacting its survivors into its
+// own list, and the lists are concatenated in chunk order afterwards.  The output is
+// therefore identical for any number of threads.
+//
+// Uses only DirectXMath and SSE, so it can be exercised on the CPU without a device.
+//***************************************************************************************
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+struct CullStats
+{
+	std::uint32_t Visible = 0;
+	std::uint32_t Culled = 0;
+};
+
+class FrustumCuller
+{
+public:
+	///<summary>
+	/// jobs may be null to cull on the calling thread.  chunkSize is rounded up to a
+	/// multiple of 4 so chunks always start on a SIMD group.
+	///</summary>
+	explicit FrustumCuller(JobSystem* jobs = nullptr, std::uint32_t chunkSize = 1024);
+
+	///<summary>
+	/// Extracts the world-space frustum planes from the camera's view and projection.
+	///</summary>
+	void SetCamera(DirectX::FXMMATRIX view, DirectX::CXMMATRIX proj);
+
+	///<summary>
+	/// Sets the planes directly: (n, d) with n pointing into the frustum, normalized.
+	///</summary>
+	void SetPlanes(const DirectX::XMFLOAT4 planes[6]);
+	const DirectX::XMFLOAT4* Planes()const { return mPlanes; }
+
+	///<summary>
+	/// Sets visible[i] to 1 for every object whose bounds touch the frustum and 0
+	/// otherwise.  If visibleList is given it receives the visible indices in
+	/// ascending order.
+	///</summary>
+	CullStats Cull(const DirectX::BoundingSphere* spheres, const DirectX::BoundingBox* boxes,
+		std::uint32_t count, std::vector<std::uint8_t>& visible,
+		std::vector<std::uint32_t>* visibleList = nullptr);
+
+private:
+	void CullChunk(const DirectX::BoundingSphere* spheres, const DirectX::BoundingBox* boxes,
+		std::uint32_t begin, std::uint32_t end, std::uint8_t* visible,
+		std::vector<std::uint32_t>& survivors)const;
+	bool BoxVisible(const DirectX::BoundingBox& box)const;
+
+private:
+	DirectX::XMFLOAT4 mPlanes[6];
+
+	JobSystem* mJobs = nullptr;
+	std::uint32_t mChunkSize = 1024;
+
+	// Survivors per chunk, kept between frames to avoid reallocating.
+	std::vector<std::vector<std::uint32_t>> mChunkLists;
+};
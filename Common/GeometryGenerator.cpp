@@ -3,13 +3,31 @@
 //***************************************************************************************
 
 #include "GeometryGenerator.h"
+#include "JobSystem.h"
 #include <algorithm>
 
 using namespace DirectX;
 
+void GeometryGenerator::ForEachRow(uint32 rowCount, uint32 rowWidth, const std::function<void(uint32, uint32)>& fn)
+{
+	// About 4k vertices per chunk keeps the per-chunk overhead small next to the work.
+	uint32 rowsPerChunk = std::max(1u, 4096u / std::max(1u, rowWidth));
+
+	if(mJobs == nullptr)
+	{
+		fn(0, rowCount);
+		return;
+	}
+
+	mJobs->ParallelFor(rowCount, rowsPerChunk, [&](uint32, uint32 begin, uint32 end)
+	{
+		fn(begin, end);
+	});
+}
+
 GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float height, float depth, uint32 numSubdivisions)
 {
-    MeshData meshData;
+    MeshData meshData(mScratch);
 
     //
 	// Create the vertices.
@@ -102,7 +120,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float heig
 
 GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32 sliceCount, uint32 stackCount)
 {
-    MeshData meshData;
+    MeshData meshData(mScratch);
 
 	//
 	// Compute the vertices stating at the top pole and moving down the stacks.
@@ -114,111 +132,120 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 	Vertex topVertex(0.0f, +radius, 0.0f, 0.0f, +1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
 	Vertex bottomVertex(0.0f, -radius, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
 
-	meshData.Vertices.push_back( topVertex );
-
 	float phiStep   = XM_PI/stackCount;
 	float thetaStep = 2.0f*XM_PI/sliceCount;
 
-	// Compute vertices for each stack ring (do not count the poles as rings).
-	for(uint32 i = 1; i <= stackCount-1; ++i)
-	{
-		float phi = i*phiStep;
-
-		// Vertices of ring.
-        for(uint32 j = 0; j <= sliceCount; ++j)
-		{
-			float theta = j*thetaStep;
-
-			Vertex v;
-
-			// spherical to cartesian
-			v.Position.x = radius*sinf(phi)*cosf(theta);
-			v.Position.y = radius*cosf(phi);
-			v.Position.z = radius*sinf(phi)*sinf(theta);
-
-			// Partial derivative of P with respect to theta
-			v.TangentU.x = -radius*sinf(phi)*sinf(theta);
-			v.TangentU.y = 0.0f;
-			v.TangentU.z = +radius*sinf(phi)*cosf(theta);
-
-			XMVECTOR T = XMLoadFloat3(&v.TangentU);
-			XMStoreFloat3(&v.TangentU, XMVector3Normalize(T));
-
-			XMVECTOR p = XMLoadFloat3(&v.Position);
-			XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
-
-			v.TexC.x = theta / XM_2PI;
-			v.TexC.y = phi / XM_PI;
-
-			meshData.Vertices.push_back( v );
-		}
-	}
+	// Layout: top pole, one ring per stack boundary (the poles are not rings), bottom
+	// pole.  Index layout: top stack fan, inner stacks, bottom stack fan.
+    uint32 ringVertexCount = sliceCount + 1;
+	uint32 southPoleIndex = 1 + (stackCount-1)*ringVertexCount;
+	uint32 innerIndexBase = 3*sliceCount;
+	uint32 bottomIndexBase = innerIndexBase + (stackCount-2)*6*sliceCount;
 
-	meshData.Vertices.push_back( bottomVertex );
+	meshData.Vertices.resize(southPoleIndex + 1);
+	meshData.Indices32.resize(bottomIndexBase + 3*sliceCount);
 
-	//
-	// Compute indices for top stack.  The top stack was written first to the vertex buffer
-	// and connects the top pole to the first ring.
-	//
+	Vertex* vertices = meshData.Vertices.data();
+	uint32* indices = meshData.Indices32.data();
 
-    for(uint32 i = 1; i <= sliceCount; ++i)
-	{
-		meshData.Indices32.push_back(0);
-		meshData.Indices32.push_back(i+1);
-		meshData.Indices32.push_back(i);
-	}
-	
-	//
-	// Compute indices for inner stacks (not connected to poles).
-	//
+	vertices[0] = topVertex;
+	vertices[southPoleIndex] = bottomVertex;
 
 	// Offset the indices to the index of the first vertex in the first ring.
 	// This is just skipping the top pole vertex.
     uint32 baseIndex = 1;
-    uint32 ringVertexCount = sliceCount + 1;
-	for(uint32 i = 0; i < stackCount-2; ++i)
+
+	// Stack s writes ring s (the ring below the pole for s = 0 is ring 1, written by
+	// stack 1) and the triangles between ring s and ring s+1.
+	ForEachRow(stackCount, ringVertexCount, [&](uint32 begin, uint32 end)
 	{
-		for(uint32 j = 0; j < sliceCount; ++j)
+		for(uint32 s = begin; s < end; ++s)
 		{
-			meshData.Indices32.push_back(baseIndex + i*ringVertexCount + j);
-			meshData.Indices32.push_back(baseIndex + i*ringVertexCount + j+1);
-			meshData.Indices32.push_back(baseIndex + (i+1)*ringVertexCount + j);
-
-			meshData.Indices32.push_back(baseIndex + (i+1)*ringVertexCount + j);
-			meshData.Indices32.push_back(baseIndex + i*ringVertexCount + j+1);
-			meshData.Indices32.push_back(baseIndex + (i+1)*ringVertexCount + j+1);
+			if(s > 0)
+			{
+				float phi = s*phiStep;
+
+				// Vertices of ring.
+				Vertex* ring = vertices + baseIndex + (s-1)*ringVertexCount;
+				for(uint32 j = 0; j <= sliceCount; ++j)
+				{
+					float theta = j*thetaStep;
+
+					Vertex v;
+
+					// spherical to cartesian
+					v.Position.x = radius*sinf(phi)*cosf(theta);
+					v.Position.y = radius*cosf(phi);
+					v.Position.z = radius*sinf(phi)*sinf(theta);
+
+					// Partial derivative of P with respect to theta
+					v.TangentU.x = -radius*sinf(phi)*sinf(theta);
+					v.TangentU.y = 0.0f;
+					v.TangentU.z = +radius*sinf(phi)*cosf(theta);
+
+					XMVECTOR T = XMLoadFloat3(&v.TangentU);
+					XMStoreFloat3(&v.TangentU, XMVector3Normalize(T));
+
+					XMVECTOR p = XMLoadFloat3(&v.Position);
+					XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
+
+					v.TexC.x = theta / XM_2PI;
+					v.TexC.y = phi / XM_PI;
+
+					ring[j] = v;
+				}
+			}
+
+			if(s == 0)
+			{
+				// Top stack connects the top pole to the first ring.
+				for(uint32 i = 1; i <= sliceCount; ++i)
+				{
+					uint32* tri = indices + 3*(i-1);
+					tri[0] = 0;
+					tri[1] = i+1;
+					tri[2] = i;
+				}
+			}
+			else if(s == stackCount-1)
+			{
+				// Bottom stack connects the last ring to the bottom pole.
+				uint32 lastRing = southPoleIndex - ringVertexCount;
+				for(uint32 i = 0; i < sliceCount; ++i)
+				{
+					uint32* tri = indices + bottomIndexBase + 3*i;
+					tri[0] = southPoleIndex;
+					tri[1] = lastRing+i;
+					tri[2] = lastRing+i+1;
+				}
+			}
+			else
+			{
+				// Inner stack between ring s and ring s+1 (not connected to poles).
+				uint32 i = s-1;
+				uint32* quad = indices + innerIndexBase + i*6*sliceCount;
+				for(uint32 j = 0; j < sliceCount; ++j, quad += 6)
+				{
+					quad[0] = baseIndex + i*ringVertexCount + j;
+					quad[1] = baseIndex + i*ringVertexCount + j+1;
+					quad[2] = baseIndex + (i+1)*ringVertexCount + j;
+
+					quad[3] = baseIndex + (i+1)*ringVertexCount + j;
+					quad[4] = baseIndex + i*ringVertexCount + j+1;
+					quad[5] = baseIndex + (i+1)*ringVertexCount + j+1;
+				}
+			}
 		}
-	}
-
-	//
-	// Compute indices for bottom stack.  The bottom stack was written last to the vertex buffer
-	// and connects the bottom pole to the bottom ring.
-	//
-
-	// South pole vertex was added last.
-	uint32 southPoleIndex = (uint32)meshData.Vertices.size()-1;
-
-	// Offset the indices to the index of the first vertex in the last ring.
-	baseIndex = southPoleIndex - ringVertexCount;
-	
-	for(uint32 i = 0; i < sliceCount; ++i)
-	{
-		meshData.Indices32.push_back(southPoleIndex);
-		meshData.Indices32.push_back(baseIndex+i);
-		meshData.Indices32.push_back(baseIndex+i+1);
-	}
+	});
 
     return meshData;
 }
  
 void GeometryGenerator::Subdivide(MeshData& meshData)
 {
-	// Save a copy of the input geometry.
-	MeshData inputCopy = meshData;
-
-
-	meshData.Vertices.resize(0);
-	meshData.Indices32.resize(0);
+	// The existing vertices are kept as they are; only the indices are rebuilt.
+	std::pmr::vector<uint32> inputIndices(meshData.Indices32.get_allocator());
+	inputIndices.swap(meshData.Indices32);
 
 	//       v1
 	//       *
@@ -230,47 +257,80 @@ void GeometryGenerator::Subdivide(MeshData& meshData)
 	// *-----*-----*
 	// v0    m2     v2
 
-	uint32 numTris = (uint32)inputCopy.Indices32.size()/3;
+	uint32 numTris = (uint32)inputIndices.size()/3;
+
+	// Every edge is split once: triangles sharing an edge look its midpoint up by
+	// the sorted index pair instead of emitting a duplicate.  The lookup is an
+	// open-addressing table sized for at most 3 edges per triangle at half load.
+	size_t tableSize = 64;
+	while(tableSize < (size_t)numTris*6)
+		tableSize *= 2;
+
+	const uint32 emptySlot = 0xffffffff;
+	std::pmr::vector<std::uint64_t> edgeKeys(tableSize, mScratch);
+	std::pmr::vector<uint32> edgeMidPoints(tableSize, emptySlot, mScratch);
+
+	meshData.Vertices.reserve(meshData.Vertices.size() + numTris*3/2 + 1);
+	meshData.Indices32.reserve(numTris*12);
+
+	auto midPointIndex = [&](uint32 a, uint32 b)
+	{
+		std::uint64_t key = a < b ? ((std::uint64_t)a << 32 | b) : ((std::uint64_t)b << 32 | a);
+
+		size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (tableSize - 1);
+		while(edgeMidPoints[slot] != emptySlot)
+		{
+			if(edgeKeys[slot] == key)
+				return edgeMidPoints[slot];
+
+			slot = (slot + 1) & (tableSize - 1);
+		}
+
+		// MidPoint is symmetric, so the first triangle to reach the edge can create it.
+		Vertex m = MidPoint(meshData.Vertices[a], meshData.Vertices[b]);
+
+		uint32 index = (uint32)meshData.Vertices.size();
+		meshData.Vertices.push_back(m);
+
+		edgeKeys[slot] = key;
+		edgeMidPoints[slot] = index;
+
+		return index;
+	};
+
 	for(uint32 i = 0; i < numTris; ++i)
 	{
-		Vertex v0 = inputCopy.Vertices[ inputCopy.Indices32[i*3+0] ];
-		Vertex v1 = inputCopy.Vertices[ inputCopy.Indices32[i*3+1] ];
-		Vertex v2 = inputCopy.Vertices[ inputCopy.Indices32[i*3+2] ];
+		uint32 v0 = inputIndices[i*3+0];
+		uint32 v1 = inputIndices[i*3+1];
+		uint32 v2 = inputIndices[i*3+2];
 
 		//
 		// Generate the midpoints.
 		//
 
-        Vertex m0 = MidPoint(v0, v1);
-        Vertex m1 = MidPoint(v1, v2);
-        Vertex m2 = MidPoint(v0, v2);
+		uint32 m0 = midPointIndex(v0, v1);
+		uint32 m1 = midPointIndex(v1, v2);
+		uint32 m2 = midPointIndex(v0, v2);
 
 		//
 		// Add new geometry.
 		//
 
-		meshData.Vertices.push_back(v0); // 0
-		meshData.Vertices.push_back(v1); // 1
-		meshData.Vertices.push_back(v2); // 2
-		meshData.Vertices.push_back(m0); // 3
-		meshData.Vertices.push_back(m1); // 4
-		meshData.Vertices.push_back(m2); // 5
- 
-		meshData.Indices32.push_back(i*6+0);
-		meshData.Indices32.push_back(i*6+3);
-		meshData.Indices32.push_back(i*6+5);
+		meshData.Indices32.push_back(v0);
+		meshData.Indices32.push_back(m0);
+		meshData.Indices32.push_back(m2);
 
-		meshData.Indices32.push_back(i*6+3);
-		meshData.Indices32.push_back(i*6+4);
-		meshData.Indices32.push_back(i*6+5);
+		meshData.Indices32.push_back(m0);
+		meshData.Indices32.push_back(m1);
+		meshData.Indices32.push_back(m2);
 
-		meshData.Indices32.push_back(i*6+5);
-		meshData.Indices32.push_back(i*6+4);
-		meshData.Indices32.push_back(i*6+2);
+		meshData.Indices32.push_back(m2);
+		meshData.Indices32.push_back(m1);
+		meshData.Indices32.push_back(v2);
 
-		meshData.Indices32.push_back(i*6+3);
-		meshData.Indices32.push_back(i*6+1);
-		meshData.Indices32.push_back(i*6+4);
+		meshData.Indices32.push_back(m0);
+		meshData.Indices32.push_back(v1);
+		meshData.Indices32.push_back(m1);
 	}
 }
 
@@ -306,7 +366,7 @@ GeometryGenerator::Vertex GeometryGenerator::MidPoint(const Vertex& v0, const Ve
 
 GeometryGenerator::MeshData GeometryGenerator::CreateGeosphere(float radius, uint32 numSubdivisions)
 {
-    MeshData meshData;
+    MeshData meshData(mScratch);
 
 	// Put a cap on the number of subdivisions.
     numSubdivisions = std::min<uint32>(numSubdivisions, 6u);
@@ -381,7 +441,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGeosphere(float radius, uin
 
 GeometryGenerator::MeshData GeometryGenerator::CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount)
 {
-    MeshData meshData;
+    MeshData meshData(mScratch);
 
 	//
 	// Build Stacks.
@@ -394,78 +454,95 @@ GeometryGenerator::MeshData GeometryGenerator::CreateCylinder(float bottomRadius
 
 	uint32 ringCount = stackCount+1;
 
-	// Compute vertices for each stack ring starting at the bottom and moving up.
-	for(uint32 i = 0; i < ringCount; ++i)
-	{
-		float y = -0.5f*height + i*stackHeight;
-		float r = bottomRadius + i*radiusStep;
-
-		// vertices of ring
-		float dTheta = 2.0f*XM_PI/sliceCount;
-		for(uint32 j = 0; j <= sliceCount; ++j)
-		{
-			Vertex vertex;
-
-			float c = cosf(j*dTheta);
-			float s = sinf(j*dTheta);
-
-			vertex.Position = XMFLOAT3(r*c, y, r*s);
-
-			vertex.TexC.x = (float)j/sliceCount;
-			vertex.TexC.y = 1.0f - (float)i/stackCount;
-
-			// Cylinder can be parameterized as follows, where we introduce v
-			// parameter that goes in the same direction as the v tex-coord
-			// so that the bitangent goes in the same direction as the v tex-coord.
-			//   Let r0 be the bottom radius and let r1 be the top radius.
-			//   y(v) = h - hv for v in [0,1].
-			//   r(v) = r1 + (r0-r1)v
-			//
-			//   x(t, v) = r(v)*cos(t)
-			//   y(t, v) = h - hv
-			//   z(t, v) = r(v)*sin(t)
-			// 
-			//  dx/dt = -r(v)*sin(t)
-			//  dy/dt = 0
-			//  dz/dt = +r(v)*cos(t)
-			//
-			//  dx/dv = (r0-r1)*cos(t)
-			//  dy/dv = -h
-			//  dz/dv = (r0-r1)*sin(t)
-
-			// This is unit length.
-			vertex.TangentU = XMFLOAT3(-s, 0.0f, c);
-
-			float dr = bottomRadius-topRadius;
-			XMFLOAT3 bitangent(dr*c, -height, dr*s);
-
-			XMVECTOR T = XMLoadFloat3(&vertex.TangentU);
-			XMVECTOR B = XMLoadFloat3(&bitangent);
-			XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
-			XMStoreFloat3(&vertex.Normal, N);
-
-			meshData.Vertices.push_back(vertex);
-		}
-	}
-
 	// Add one because we duplicate the first and last vertex per ring
 	// since the texture coordinates are different.
 	uint32 ringVertexCount = sliceCount+1;
 
-	// Compute indices for each stack.
-	for(uint32 i = 0; i < stackCount; ++i)
+	// Each cap adds a ring plus a center vertex and one triangle per slice; they are
+	// appended after the side, so reserve room for them now.
+	uint32 sideVertexCount = ringCount*ringVertexCount;
+	uint32 sideIndexCount = stackCount*sliceCount*6;
+	meshData.Vertices.reserve(sideVertexCount + 2*(ringVertexCount+1));
+	meshData.Indices32.reserve(sideIndexCount + 2*sliceCount*3);
+	meshData.Vertices.resize(sideVertexCount);
+	meshData.Indices32.resize(sideIndexCount);
+
+	Vertex* vertices = meshData.Vertices.data();
+	uint32* indices = meshData.Indices32.data();
+
+	// Row i writes ring i, starting at the bottom and moving up, and the quads of
+	// stack i between ring i and ring i+1.
+	ForEachRow(ringCount, ringVertexCount, [&](uint32 begin, uint32 end)
 	{
-		for(uint32 j = 0; j < sliceCount; ++j)
+		for(uint32 i = begin; i < end; ++i)
 		{
-			meshData.Indices32.push_back(i*ringVertexCount + j);
-			meshData.Indices32.push_back((i+1)*ringVertexCount + j);
-			meshData.Indices32.push_back((i+1)*ringVertexCount + j+1);
-
-			meshData.Indices32.push_back(i*ringVertexCount + j);
-			meshData.Indices32.push_back((i+1)*ringVertexCount + j+1);
-			meshData.Indices32.push_back(i*ringVertexCount + j+1);
+			float y = -0.5f*height + i*stackHeight;
+			float r = bottomRadius + i*radiusStep;
+
+			// vertices of ring
+			float dTheta = 2.0f*XM_PI/sliceCount;
+			for(uint32 j = 0; j <= sliceCount; ++j)
+			{
+				Vertex vertex;
+
+				float c = cosf(j*dTheta);
+				float s = sinf(j*dTheta);
+
+				vertex.Position = XMFLOAT3(r*c, y, r*s);
+
+				vertex.TexC.x = (float)j/sliceCount;
+				vertex.TexC.y = 1.0f - (float)i/stackCount;
+
+				// Cylinder can be parameterized as follows, where we introduce v
+				// parameter that goes in the same direction as the v tex-coord
+				// so that the bitangent goes in the same direction as the v tex-coord.
+				//   Let r0 be the bottom radius and let r1 be the top radius.
+				//   y(v) = h - hv for v in [0,1].
+				//   r(v) = r1 + (r0-r1)v
+				//
+				//   x(t, v) = r(v)*cos(t)
+				//   y(t, v) = h - hv
+				//   z(t, v) = r(v)*sin(t)
+				// 
+				//  dx/dt = -r(v)*sin(t)
+				//  dy/dt = 0
+				//  dz/dt = +r(v)*cos(t)
+				//
+				//  dx/dv = (r0-r1)*cos(t)
+				//  dy/dv = -h
+				//  dz/dv = (r0-r1)*sin(t)
+
+				// This is unit length.
+				vertex.TangentU = XMFLOAT3(-s, 0.0f, c);
+
+				float dr = bottomRadius-topRadius;
+				XMFLOAT3 bitangent(dr*c, -height, dr*s);
+
+				XMVECTOR T = XMLoadFloat3(&vertex.TangentU);
+				XMVECTOR B = XMLoadFloat3(&bitangent);
+				XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
+				XMStoreFloat3(&vertex.Normal, N);
+
+				vertices[i*ringVertexCount + j] = vertex;
+			}
+
+			// The top ring has no stack above it.
+			if(i == stackCount)
+				continue;
+
+			uint32* quad = indices + i*sliceCount*6;
+			for(uint32 j = 0; j < sliceCount; ++j, quad += 6)
+			{
+				quad[0] = i*ringVertexCount + j;
+				quad[1] = (i+1)*ringVertexCount + j;
+				quad[2] = (i+1)*ringVertexCount + j+1;
+
+				quad[3] = i*ringVertexCount + j;
+				quad[4] = (i+1)*ringVertexCount + j+1;
+				quad[5] = i*ringVertexCount + j+1;
+			}
 		}
-	}
+	});
 
 	BuildCylinderTopCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
 	BuildCylinderBottomCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
@@ -550,7 +627,7 @@ void GeometryGenerator::BuildCylinderBottomCap(float bottomRadius, float topRadi
 
 GeometryGenerator::MeshData GeometryGenerator::CreateGrid(float width, float depth, uint32 m, uint32 n)
 {
-    MeshData meshData;
+    MeshData meshData(mScratch);
 
 	uint32 vertexCount = m*n;
 	uint32 faceCount   = (m-1)*(n-1)*2;
@@ -569,53 +646,129 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGrid(float width, float dep
 	float dv = 1.0f / (m-1);
 
 	meshData.Vertices.resize(vertexCount);
-	for(uint32 i = 0; i < m; ++i)
+	meshData.Indices32.resize(faceCount*3); // 3 indices per face
+
+	Vertex* vertices = meshData.Vertices.data();
+	uint32* indices = meshData.Indices32.data();
+
+	// Row i writes its n vertices at i*n and, except for the last row, the quads
+	// between it and row i+1 at i*(n-1)*6.
+	ForEachRow(m, n, [&](uint32 begin, uint32 end)
 	{
-		float z = halfDepth - i*dz;
-		for(uint32 j = 0; j < n; ++j)
+		for(uint32 i = begin; i < end; ++i)
 		{
-			float x = -halfWidth + j*dx;
+			float z = halfDepth - i*dz;
+			Vertex* row = vertices + i*n;
+			for(uint32 j = 0; j < n; ++j)
+			{
+				float x = -halfWidth + j*dx;
+
+				row[j].Position = XMFLOAT3(x, 0.0f, z);
+				row[j].Normal   = XMFLOAT3(0.0f, 1.0f, 0.0f);
+				row[j].TangentU = XMFLOAT3(1.0f, 0.0f, 0.0f);
+
+				// Stretch texture over grid.
+				row[j].TexC.x = j*du;
+				row[j].TexC.y = i*dv;
+			}
+
+			if(i == m-1)
+				continue;
+
+			// Compute the indices of each quad in this row.
+			uint32* quad = indices + i*(n-1)*6;
+			for(uint32 j = 0; j < n-1; ++j, quad += 6)
+			{
+				quad[0] = i*n+j;
+				quad[1] = i*n+j+1;
+				quad[2] = (i+1)*n+j;
+
+				quad[3] = (i+1)*n+j;
+				quad[4] = i*n+j+1;
+				quad[5] = (i+1)*n+j+1;
+			}
+		}
+	});
 
-			meshData.Vertices[i*n+j].Position = XMFLOAT3(x, 0.0f, z);
-			meshData.Vertices[i*n+j].Normal   = XMFLOAT3(0.0f, 1.0f, 0.0f);
-			meshData.Vertices[i*n+j].TangentU = XMFLOAT3(1.0f, 0.0f, 0.0f);
+    return meshData;
+}
 
-			// Stretch texture over grid.
-			meshData.Vertices[i*n+j].TexC.x = j*du;
-			meshData.Vertices[i*n+j].TexC.y = i*dv;
-		}
-	}
- 
-    //
-	// Create the indices.
-	//
+GeometryGenerator::MeshData GeometryGenerator::CreateGridChunk(float chunkSize, uint32 quadsPerSide, int32 chunkX, int32 chunkZ)
+{
+    MeshData meshData(mScratch);
 
-	meshData.Indices32.resize(faceCount*3); // 3 indices per face
+	// Same layout as CreateGrid with quadsPerSide+1 rows and columns.
+	uint32 n = quadsPerSide + 1;
+	meshData.Vertices.resize(n*n);
+	FillGridChunkVertices(chunkSize, quadsPerSide, chunkX, chunkZ, meshData.Vertices.data());
+
+	meshData.Indices32.resize(quadsPerSide*quadsPerSide*6);
 
-	// Iterate over each quad and compute indices.
-	uint32 k = 0;
-	for(uint32 i = 0; i < m-1; ++i)
+	uint32* indices = meshData.Indices32.data();
+	ForEachRow(quadsPerSide, n, [&](uint32 begin, uint32 end)
 	{
-		for(uint32 j = 0; j < n-1; ++j)
+		for(uint32 i = begin; i < end; ++i)
 		{
-			meshData.Indices32[k]   = i*n+j;
-			meshData.Indices32[k+1] = i*n+j+1;
-			meshData.Indices32[k+2] = (i+1)*n+j;
-
-			meshData.Indices32[k+3] = (i+1)*n+j;
-			meshData.Indices32[k+4] = i*n+j+1;
-			meshData.Indices32[k+5] = (i+1)*n+j+1;
-
-			k += 6; // next quad
+			uint32* quad = indices + i*quadsPerSide*6;
+			for(uint32 j = 0; j < quadsPerSide; ++j, quad += 6)
+			{
+				quad[0] = i*n+j;
+				quad[1] = i*n+j+1;
+				quad[2] = (i+1)*n+j;
+
+				quad[3] = (i+1)*n+j;
+				quad[4] = i*n+j+1;
+				quad[5] = (i+1)*n+j+1;
+			}
 		}
-	}
+	});
 
     return meshData;
 }
 
+void GeometryGenerator::CreateGridChunkVertices(float chunkSize, uint32 quadsPerSide, int32 chunkX, int32 chunkZ,
+	std::pmr::vector<Vertex>& vertices)
+{
+	vertices.resize((quadsPerSide + 1)*(quadsPerSide + 1));
+	FillGridChunkVertices(chunkSize, quadsPerSide, chunkX, chunkZ, vertices.data());
+}
+
+void GeometryGenerator::FillGridChunkVertices(float chunkSize, uint32 quadsPerSide, int32 chunkX, int32 chunkZ, Vertex* out)
+{
+	uint32 n = quadsPerSide + 1;
+	float cellSize = chunkSize / quadsPerSide;
+	float du = 1.0f / quadsPerSide;
+
+	// Global lattice indices of the chunk's first column and row.  Rows run from +z
+	// to -z like CreateGrid so the winding matches.
+	std::int64_t column0 = (std::int64_t)chunkX * quadsPerSide;
+	std::int64_t row0 = ((std::int64_t)chunkZ + 1) * quadsPerSide;
+
+	ForEachRow(n, n, [&](uint32 begin, uint32 end)
+	{
+		for(uint32 i = begin; i < end; ++i)
+		{
+			float z = (float)(row0 - i) * cellSize;
+			Vertex* row = out + i*n;
+			for(uint32 j = 0; j < n; ++j)
+			{
+				float x = (float)(column0 + j) * cellSize;
+
+				row[j].Position = XMFLOAT3(x, 0.0f, z);
+				row[j].Normal   = XMFLOAT3(0.0f, 1.0f, 0.0f);
+				row[j].TangentU = XMFLOAT3(1.0f, 0.0f, 0.0f);
+
+				// Stretch texture over each chunk.
+				row[j].TexC.x = j*du;
+				row[j].TexC.y = i*du;
+			}
+		}
+	});
+}
+
 GeometryGenerator::MeshData GeometryGenerator::CreateQuad(float x, float y, float w, float h, float depth)
 {
-    MeshData meshData;
+    MeshData meshData(mScratch);
 
 	meshData.Vertices.resize(4);
 	meshData.Indices32.resize(6);
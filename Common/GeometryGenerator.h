@@ -10,20 +10,34 @@
 //   1. Change the Direct3D cull mode or manually reverse the winding order.
 //   2. Invert the normal.
 //   3. Update the texture coordinates and tangent vectors.
+//
+// CreateGrid, CreateSphere and CreateCylinder size their output once up front and
+// write each row of vertices and quads at an offset computed from the row number, so
+// rows can be generated in parallel on a JobSystem.  The output is the same with or
+// without one.
+//
+// MeshData holds std::pmr vectors.  Meshes come from the memory resource given to the
+// generator (e.g. a ScratchArena for load-time data), or from the default heap.
 //***************************************************************************************
 
 #pragma once
 
 #include <cstdint>
 #include <DirectXMath.h>
+#include <functional>
+#include <memory_resource>
+#include <stdexcept>
 #include <vector>
 
+class JobSystem;
+
 class GeometryGenerator
 {
 public:
 
     using uint16 = std::uint16_t;
     using uint32 = std::uint32_t;
+    using int32 = std::int32_t;
 
 	struct Vertex
 	{
@@ -55,25 +69,47 @@ public:
 
 	struct MeshData
 	{
-		std::vector<Vertex> Vertices;
-        std::vector<uint32> Indices32;
+		MeshData() = default;
+		explicit MeshData(std::pmr::memory_resource* resource) :
+			Vertices(resource), Indices32(resource), mIndices16(resource) {}
 
-        std::vector<uint16>& GetIndices16()
+		std::pmr::vector<Vertex> Vertices;
+        std::pmr::vector<uint32> Indices32;
+
+        // Throws if an index does not fit in 16 bits instead of truncating it;
+        // pack large meshes with GeometryPacker, which splits them into parts.
+        std::pmr::vector<uint16>& GetIndices16()
         {
 			if(mIndices16.empty())
 			{
 				mIndices16.resize(Indices32.size());
 				for(size_t i = 0; i < Indices32.size(); ++i)
+				{
+					if(Indices32[i] > 0xffff)
+					{
+						mIndices16.clear();
+						throw std::overflow_error("MeshData::GetIndices16: index does not fit in 16 bits.");
+					}
+
 					mIndices16[i] = static_cast<uint16>(Indices32[i]);
+				}
 			}
 
 			return mIndices16;
         }
 
 	private:
-		std::vector<uint16> mIndices16;
+		std::pmr::vector<uint16> mIndices16;
 	};
 
+	///<summary>
+	/// Rows of the grid, sphere and cylinder are split across jobs when given a
+	/// JobSystem; without one everything runs on the calling thread.  Meshes and
+	/// temporary arrays are allocated from scratch if given.
+	///</summary>
+	explicit GeometryGenerator(JobSystem* jobs = nullptr, std::pmr::memory_resource* scratch = nullptr) :
+		mJobs(jobs), mScratch(scratch != nullptr ? scratch : std::pmr::get_default_resource()) {}
+
 	///<summary>
 	/// Creates a box centered at the origin with the given dimensions, where each
     /// face has m rows and n columns of vertices.
@@ -105,15 +141,43 @@ public:
 	///</summary>
     MeshData CreateGrid(float width, float depth, uint32 m, uint32 n);
 
+	///<summary>
+	/// Creates chunk (chunkX, chunkZ) of an unbounded tiled grid in the xz-plane.  The
+	/// chunk covers [chunkX, chunkX+1] x [chunkZ, chunkZ+1] times chunkSize in world
+	/// space and has quadsPerSide quads along each side.  Positions come from global
+	/// lattice coordinates, so neighbouring chunks produce bit-identical edge vertices.
+	/// Every chunk with the same quadsPerSide has the same indices.
+	///</summary>
+    MeshData CreateGridChunk(float chunkSize, uint32 quadsPerSide, int32 chunkX, int32 chunkZ);
+
+	///<summary>
+	/// The vertices of CreateGridChunk only, for callers that share one index list
+	/// across chunks.
+	///</summary>
+    void CreateGridChunkVertices(float chunkSize, uint32 quadsPerSide, int32 chunkX, int32 chunkZ,
+		std::pmr::vector<Vertex>& vertices);
+
 	///<summary>
 	/// Creates a quad aligned with the screen.  This is useful for postprocessing and screen effects.
 	///</summary>
     MeshData CreateQuad(float x, float y, float w, float h, float depth);
 
 private:
+	///<summary>
+	/// Calls fn(begin, end) over [0, rowCount) in chunks of roughly equal work, where
+	/// each row writes about rowWidth vertices.
+	///</summary>
+	void ForEachRow(uint32 rowCount, uint32 rowWidth, const std::function<void(uint32, uint32)>& fn);
+
+	void FillGridChunkVertices(float chunkSize, uint32 quadsPerSide, int32 chunkX, int32 chunkZ, Vertex* vertices);
+
 	void Subdivide(MeshData& meshData);
     Vertex MidPoint(const Vertex& v0, const Vertex& v1);
     void BuildCylinderTopCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData);
     void BuildCylinderBottomCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData);
+
+private:
+	JobSystem* mJobs = nullptr;
+	std::pmr::memory_resource* mScratch = nullptr;
 };
 
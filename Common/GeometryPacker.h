@@ -0,0 +1,416 @@
+//***************************************************************************************
+// GeometryPacker.h
+//
+// Packs several meshes into one shared vertex/index arena.  Each added mesh becomes a
+// SubmeshGeometry entry in PackedGeometry::DrawArgs, so every mesh in the arena can be
+// drawn with the same vertex/index buffer bindings.
+//
+// Indices are stored relative to each submesh's BaseVertexLocation, so 16-bit indices
+// only require each submesh (not the whole arena) to have at most 65536 vertices.
+// Larger meshes can be split into 16-bit addressable parts; part k > 0 of mesh "name"
+// is added to DrawArgs as PartName("name", k).
+//
+// Build can also store the vertices in one of VertexQuantizer's compact encodings; each
+// submesh is then quantized against its own SubmeshGeometry::Bounds, which the shader
+// needs to decode the positions.
+//
+// The vertex/index arrays are allocated from the memory resource given to the
+// constructor, e.g. a ScratchArena during initialization; the packer must be destroyed
+// before that resource is reset.  Generator meshes are converted with VertexWriter, and
+// Build encodes vertices and narrows indices straight into the uploader's staging memory.
+// Vertices are still copied twice, Float layout included: AddMesh copies them into the
+// arena (the bounds, the 16-bit split and Build all read them there, and a source mesh
+// need not outlive AddMesh), and Build writes them from the arena into staging.
+// The packer does not depend on a device; the buffers come from whichever
+// GeometryUploader Build is given.
+//
+// TVertex must have XMFLOAT3 Pos and Normal members, or a VertexLayoutOf specialization
+// describing its position and normal.
+//***************************************************************************************
+
+#pragma once
+
+#include "GeometryGenerator.h"
+#include "GeometryUploader.h"
+#include "SubmeshGeometry.h"
+#include "VertexQuantizer.h"
+#include "VertexWriter.h"
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+// One packed arena: a vertex and an index buffer shared by every submesh in DrawArgs.
+struct PackedGeometry
+{
+	std::string Name;
+
+	StaticBuffer VertexBuffer;
+	StaticBuffer IndexBuffer;
+
+	UINT VertexByteStride = 0;
+	UINT VertexBufferByteSize = 0;
+	DXGI_FORMAT IndexFormat = DXGI_FORMAT_R16_UINT;
+	UINT IndexBufferByteSize = 0;
+
+	std::unordered_map<std::string, SubmeshGeometry> DrawArgs;
+
+	D3D12_VERTEX_BUFFER_VIEW VertexBufferView()const
+	{
+		D3D12_VERTEX_BUFFER_VIEW vbv;
+		vbv.BufferLocation = VertexBuffer.GpuAddress;
+		vbv.StrideInBytes = VertexByteStride;
+		vbv.SizeInBytes = VertexBufferByteSize;
+
+		return vbv;
+	}
+
+	D3D12_INDEX_BUFFER_VIEW IndexBufferView()const
+	{
+		D3D12_INDEX_BUFFER_VIEW ibv;
+		ibv.BufferLocation = IndexBuffer.GpuAddress;
+		ibv.Format = IndexFormat;
+		ibv.SizeInBytes = IndexBufferByteSize;
+
+		return ibv;
+	}
+};
+
+template<typename TVertex>
+class GeometryPacker
+{
+public:
+	static const UINT MaxVerticesPerPart16 = 0x10000;
+
+	explicit GeometryPacker(std::pmr::memory_resource* scratch = std::pmr::get_default_resource()) :
+		mVertices(scratch), mIndices(scratch), mSplitVertices(scratch), mSplitIndices(scratch)
+	{
+	}
+
+	static std::string PartName(const std::string& name, UINT part)
+	{
+		return part == 0 ? name : name + "#" + std::to_string(part);
+	}
+
+	///<summary>
+	/// Appends a generator mesh, keeping only the attributes TVertex needs.
+	///</summary>
+	void AddMesh(const std::string& name, const GeometryGenerator::MeshData& mesh)
+	{
+		SubmeshGeometry submesh = BeginSubmesh((UINT)mesh.Indices32.size());
+
+		mVertices.resize(mVertices.size() + mesh.Vertices.size());
+		VertexWriter<typename VertexLayoutOf<TVertex>::Type>::Write(mesh.Vertices.data(), mesh.Vertices.size(),
+			mVertices.data() + submesh.BaseVertexLocation);
+
+		mIndices.insert(mIndices.end(), mesh.Indices32.begin(), mesh.Indices32.end());
+
+		EndSubmesh(name, submesh);
+	}
+
+	///<summary>
+	/// Appends a mesh that is already in the TVertex layout (e.g. a loaded model).
+	///</summary>
+	void AddMesh(const std::string& name,
+		const TVertex* vertices, UINT vertexCount,
+		const std::uint32_t* indices, UINT indexCount)
+	{
+		SubmeshGeometry submesh = BeginSubmesh(indexCount);
+
+		mVertices.insert(mVertices.end(), vertices, vertices + vertexCount);
+		mIndices.insert(mIndices.end(), indices, indices + indexCount);
+
+		EndSubmesh(name, submesh);
+	}
+
+	UINT VertexCount()const { return (UINT)mVertices.size(); }
+	UINT IndexCount()const { return (UINT)mIndices.size(); }
+
+	///<summary>
+	/// Per-submesh quantization error of the last compact Build, in DrawArgs order.
+	///</summary>
+	const std::vector<std::pair<std::string, QuantizeError>>& QuantizeErrors()const { return mQuantizeErrors; }
+
+	///<summary>
+	/// Staging space Build needs for the given index format (with 16-byte alignment).
+	///</summary>
+	UINT64 StagingByteSize(DXGI_FORMAT indexFormat = DXGI_FORMAT_UNKNOWN)
+	{
+		const UINT64 size32 = (UINT64)mVertices.size() * sizeof(TVertex) + (UINT64)mIndices.size() * sizeof(std::uint32_t);
+		if(indexFormat == DXGI_FORMAT_R32_UINT)
+			return size32 + 2 * 16;
+
+		const Layout& layout16 = Layout16();
+		const UINT64 size16 = (UINT64)layout16.Vertices->size() * sizeof(TVertex) + (UINT64)layout16.Indices->size() * sizeof(std::uint16_t);
+
+		return std::max(size32, size16) + 2 * 16;
+	}
+
+	///<summary>
+	/// Creates one GPU-local vertex buffer and one index buffer holding every added
+	/// mesh; the copies are staged in uploader and recorded by its next Flush.
+	///
+	///   DXGI_FORMAT_R32_UINT: meshes are stored as added.
+	///   DXGI_FORMAT_R16_UINT: meshes with more than 65536 vertices are split into parts,
+	///                         duplicating the vertices on part boundaries.
+	///   DXGI_FORMAT_UNKNOWN:  16-bit unless the duplicated vertices would cost more
+	///                         bytes than the smaller indices save.
+	///
+	/// With a compact vertexEncoding, QuantizeErrors() reports the loss per submesh.
+	///</summary>
+	std::unique_ptr<PackedGeometry> Build(GeometryUploader& uploader, const std::string& name,
+		DXGI_FORMAT indexFormat = DXGI_FORMAT_UNKNOWN, VertexEncoding vertexEncoding = VertexEncoding::Float)
+	{
+		bool use16 = indexFormat != DXGI_FORMAT_R32_UINT;
+		if(indexFormat == DXGI_FORMAT_UNKNOWN)
+		{
+			// The split drops vertices no triangle uses, so it can also come out smaller.
+			const Layout& layout16 = Layout16();
+			const size_t addedVertices = layout16.Vertices->size() > mVertices.size() ? layout16.Vertices->size() - mVertices.size() : 0;
+			const UINT64 addedBytes = (UINT64)addedVertices * sizeof(TVertex);
+			const UINT64 savedBytes = (UINT64)mIndices.size() * (sizeof(std::uint32_t) - sizeof(std::uint16_t));
+			use16 = addedBytes < savedBytes;
+		}
+
+		Layout layout32 = { &mVertices, &mIndices, &mSubmeshes };
+		const Layout& layout = use16 ? Layout16() : layout32;
+
+		auto geo = std::make_unique<PackedGeometry>();
+		geo->Name = name;
+
+		mQuantizeErrors.clear();
+		if(vertexEncoding == VertexEncoding::Float)
+		{
+			const UINT vbByteSize = (UINT)layout.Vertices->size() * sizeof(TVertex);
+			geo->VertexBuffer = uploader.CreateStaticBuffer(layout.Vertices->data(), vbByteSize);
+			geo->VertexByteStride = sizeof(TVertex);
+			geo->VertexBufferByteSize = vbByteSize;
+		}
+		else
+		{
+			const UINT stride = VertexQuantizer::Stride(vertexEncoding);
+			const UINT vbByteSize = (UINT)layout.Vertices->size() * stride;
+
+			// Encoded straight into staging.  Submeshes are laid out back to back, so
+			// each one's vertices run up to the next submesh's base (or the end of the arena).
+			geo->VertexBuffer = uploader.CreateStaticBuffer(vbByteSize, [&](void* dst)
+			{
+				std::uint8_t* encoded = static_cast<std::uint8_t*>(dst);
+				const auto& submeshes = *layout.Submeshes;
+				for(size_t s = 0; s < submeshes.size(); ++s)
+				{
+					const SubmeshGeometry& submesh = submeshes[s].second;
+					const size_t first = (size_t)submesh.BaseVertexLocation;
+					const size_t last = s + 1 < submeshes.size() ? (size_t)submeshes[s + 1].second.BaseVertexLocation : layout.Vertices->size();
+
+					QuantizeError error = VertexQuantizer::Encode(layout.Vertices->data() + first, last - first,
+						submesh.Bounds, vertexEncoding, encoded + first * stride);
+					mQuantizeErrors.push_back(std::make_pair(submeshes[s].first, error));
+				}
+			});
+			geo->VertexByteStride = stride;
+			geo->VertexBufferByteSize = vbByteSize;
+		}
+
+		const std::pmr::vector<std::uint32_t>& indices = *layout.Indices;
+		if(use16)
+		{
+			// The split guarantees every index fits; anything else is a packer bug.
+			for(std::uint32_t index : indices)
+			{
+				if(index > 0xffff)
+					throw std::logic_error("GeometryPacker::Build: 16-bit index out of range.");
+			}
+
+			geo->IndexBufferByteSize = (UINT)indices.size() * sizeof(std::uint16_t);
+			geo->IndexBuffer = uploader.CreateStaticBuffer(geo->IndexBufferByteSize, [&](void* dst)
+			{
+				std::uint16_t* indices16 = static_cast<std::uint16_t*>(dst);
+				for(size_t i = 0; i < indices.size(); ++i)
+					indices16[i] = static_cast<std::uint16_t>(indices[i]);
+			});
+			geo->IndexFormat = DXGI_FORMAT_R16_UINT;
+		}
+		else
+		{
+			geo->IndexBufferByteSize = (UINT)indices.size() * sizeof(std::uint32_t);
+			geo->IndexBuffer = uploader.CreateStaticBuffer(indices.data(), geo->IndexBufferByteSize);
+			geo->IndexFormat = DXGI_FORMAT_R32_UINT;
+		}
+
+		for(auto& submesh : *layout.Submeshes)
+			geo->DrawArgs[submesh.first] = submesh.second;
+
+		return geo;
+	}
+
+private:
+	struct Layout
+	{
+		const std::pmr::vector<TVertex>* Vertices;
+		const std::pmr::vector<std::uint32_t>* Indices;
+		const std::vector<std::pair<std::string, SubmeshGeometry>>* Submeshes;
+	};
+
+	std::pmr::memory_resource* Scratch()const { return mVertices.get_allocator().resource(); }
+
+	SubmeshGeometry BeginSubmesh(UINT indexCount)
+	{
+		mSplitValid = false;
+
+		SubmeshGeometry submesh;
+		submesh.IndexCount = indexCount;
+		submesh.StartIndexLocation = (UINT)mIndices.size();
+		submesh.BaseVertexLocation = (INT)mVertices.size();
+
+		return submesh;
+	}
+
+	void EndSubmesh(const std::string& name, SubmeshGeometry& submesh)
+	{
+		ComputeBounds(submesh, mVertices.data() + submesh.BaseVertexLocation,
+			mVertices.size() - submesh.BaseVertexLocation);
+
+		mSubmeshes.push_back(std::make_pair(name, submesh));
+		mSubmeshVertexCounts.push_back((UINT)(mVertices.size() - submesh.BaseVertexLocation));
+	}
+
+	static void ComputeBounds(SubmeshGeometry& submesh, const TVertex* first, size_t count)
+	{
+		if(count > 0)
+		{
+			DirectX::BoundingBox::CreateFromPoints(submesh.Bounds, count, &first->Pos, sizeof(TVertex));
+			DirectX::BoundingSphere::CreateFromPoints(submesh.Sphere, count, &first->Pos, sizeof(TVertex));
+		}
+	}
+
+	///<summary>
+	/// The arena with every submesh split into 16-bit addressable parts.  Built on
+	/// first use and reused until another mesh is added.
+	///</summary>
+	const Layout& Layout16()
+	{
+		if(!mSplitValid)
+		{
+			BuildSplit16();
+			mSplitValid = true;
+		}
+
+		if(mSplitVertices.empty() && mSplitSubmeshes.empty())
+			mLayout16 = { &mVertices, &mIndices, &mSubmeshes };
+		else
+			mLayout16 = { &mSplitVertices, &mSplitIndices, &mSplitSubmeshes };
+
+		return mLayout16;
+	}
+
+	void BuildSplit16()
+	{
+		mSplitVertices.clear();
+		mSplitIndices.clear();
+		mSplitSubmeshes.clear();
+
+		// Nothing to split: the 16-bit layout is the arena itself.
+		bool needsSplit = false;
+		for(UINT count : mSubmeshVertexCounts)
+			needsSplit |= count > MaxVerticesPerPart16;
+		if(!needsSplit)
+			return;
+
+		for(size_t s = 0; s < mSubmeshes.size(); ++s)
+		{
+			const std::string& name = mSubmeshes[s].first;
+			const SubmeshGeometry& src = mSubmeshes[s].second;
+			const TVertex* srcVertices = mVertices.data() + src.BaseVertexLocation;
+			const std::uint32_t* srcIndices = mIndices.data() + src.StartIndexLocation;
+			const UINT srcVertexCount = mSubmeshVertexCounts[s];
+
+			if(srcVertexCount <= MaxVerticesPerPart16)
+			{
+				SubmeshGeometry submesh = src;
+				submesh.StartIndexLocation = (UINT)mSplitIndices.size();
+				submesh.BaseVertexLocation = (INT)mSplitVertices.size();
+
+				mSplitVertices.insert(mSplitVertices.end(), srcVertices, srcVertices + srcVertexCount);
+				mSplitIndices.insert(mSplitIndices.end(), srcIndices, srcIndices + src.IndexCount);
+				mSplitSubmeshes.push_back(std::make_pair(name, submesh));
+				continue;
+			}
+
+			// Walk the triangles in order and start a new part whenever the next one
+			// would reference more vertices than 16-bit indices can address.  partOf
+			// stamps which part a source vertex was last copied into.
+			std::pmr::vector<UINT> partOf(srcVertexCount, ~0u, Scratch());
+			std::pmr::vector<std::uint32_t> remap(srcVertexCount, Scratch());
+
+			UINT part = 0;
+			UINT partVertexCount = 0;
+			SubmeshGeometry submesh;
+			submesh.StartIndexLocation = (UINT)mSplitIndices.size();
+			submesh.BaseVertexLocation = (INT)mSplitVertices.size();
+
+			auto closePart = [&]()
+			{
+				submesh.IndexCount = (UINT)mSplitIndices.size() - submesh.StartIndexLocation;
+				ComputeBounds(submesh, mSplitVertices.data() + submesh.BaseVertexLocation, partVertexCount);
+				mSplitSubmeshes.push_back(std::make_pair(PartName(name, part), submesh));
+
+				part++;
+				partVertexCount = 0;
+				submesh = SubmeshGeometry();
+				submesh.StartIndexLocation = (UINT)mSplitIndices.size();
+				submesh.BaseVertexLocation = (INT)mSplitVertices.size();
+			};
+
+			for(UINT t = 0; t + 2 < src.IndexCount; t += 3)
+			{
+				const std::uint32_t* tri = srcIndices + t;
+
+				UINT newVertices = 0;
+				for(int k = 0; k < 3; ++k)
+				{
+					bool repeated = (k > 0 && tri[k] == tri[0]) || (k > 1 && tri[k] == tri[1]);
+					if(partOf[tri[k]] != part && !repeated)
+						newVertices++;
+				}
+
+				if(partVertexCount + newVertices > MaxVerticesPerPart16)
+					closePart();
+
+				for(int k = 0; k < 3; ++k)
+				{
+					std::uint32_t v = tri[k];
+					if(partOf[v] != part)
+					{
+						partOf[v] = part;
+						remap[v] = partVertexCount++;
+						mSplitVertices.push_back(srcVertices[v]);
+					}
+
+					mSplitIndices.push_back(remap[v]);
+				}
+			}
+
+			closePart();
+		}
+	}
+
+private:
+	std::pmr::vector<TVertex> mVertices;
+	std::pmr::vector<std::uint32_t> mIndices;
+
+	// Kept in insertion order; DrawArgs is filled from this on Build.
+	std::vector<std::pair<std::string, SubmeshGeometry>> mSubmeshes;
+	std::vector<UINT> mSubmeshVertexCounts;
+
+	// 16-bit addressable copy of the arena, only filled when some mesh needs splitting.
+	bool mSplitValid = false;
+	std::pmr::vector<TVertex> mSplitVertices;
+	std::pmr::vector<std::uint32_t> mSplitIndices;
+	std::vector<std::pair<std::string, SubmeshGeometry>> mSplitSubmeshes;
+	Layout mLayout16 = {};
+
+	std::vector<std::pair<std::string, QuantizeError>> mQuantizeErrors;
+};
@@ -0,0 +1,86 @@
+//***************************************************************************************
+// GeometryUploader.cpp
+//***************************************************************************************
+
+#include "GeometryUploader.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	// Buffer copies have no alignment requirement; 16 keeps each staged block SIMD friendly.
+	const UINT64 StagingAlignment = 16;
+}
+
+GeometryUploader::GeometryUploader(UINT64 stagingByteSize, bool keepStaging) :
+	mRing(stagingByteSize),
+	mKeepStaging(keepStaging)
+{
+}
+
+StaticBuffer GeometryUploader::CreateStaticBuffer(const void* initData, UINT64 byteSize)
+{
+	StaticBuffer buffer;
+	std::memcpy(Stage(byteSize, buffer), initData, (size_t)byteSize);
+
+	return buffer;
+}
+
+std::uint8_t* GeometryUploader::Stage(UINT64 byteSize, StaticBuffer& buffer)
+{
+	if(mStaging == nullptr)
+		mMappedData = CreateStaging(mRing.Capacity(), mStaging);
+
+	UINT64 offset = mRing.Allocate(byteSize, StagingAlignment);
+	if(offset == UploadRing::InvalidOffset)
+		throw std::length_error("GeometryUploader::CreateStaticBuffer: staging ring is full.");
+
+	// Buffers are created directly in COPY_DEST, which saves one transition per buffer.
+	buffer = CreateBuffer(byteSize);
+
+	PendingCopy copy;
+	copy.Dest = buffer.Resource;
+	copy.SrcOffset = offset;
+	copy.ByteSize = byteSize;
+	mPendingCopies.push_back(copy);
+
+	return mMappedData + offset;
+}
+
+void GeometryUploader::Flush(CommandRecorder& recorder)
+{
+	if(mPendingCopies.empty())
+		return;
+
+	mBarriers.clear();
+	for(const PendingCopy& copy : mPendingCopies)
+	{
+		recorder.CopyBufferRegion(copy.Dest, 0, mStaging, copy.SrcOffset, copy.ByteSize);
+
+		mBarriers.push_back(TransitionBarrier(copy.Dest,
+			D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
+	}
+
+	recorder.ResourceBarrier((UINT)mBarriers.size(), mBarriers.data());
+
+	mPendingCopies.clear();
+}
+
+void GeometryUploader::Submit(UINT64 fenceValue)
+{
+	mRing.Submit(fenceValue);
+}
+
+void GeometryUploader::Retire(UINT64 completedFenceValue)
+{
+	mRing.Retire(completedFenceValue);
+
+	// Nothing left to copy from: give the staging memory back until the next batch.
+	if(!mKeepStaging && mRing.Empty() && mPendingCopies.empty() && mStaging != nullptr)
+	{
+		ReleaseStaging();
+		mStaging = nullptr;
+		mMappedData = nullptr;
+	}
+}
@@ -0,0 +1,113 @@
+//***************************************************************************************
+// GeometryUploader.h
+//
+// Uploads static vertex/index data into GPU-local buffers through one shared staging
+// buffer.  Data is staged into the ring as buffers are created; Flush records every
+// pending copy into a command recorder as one batch (one barrier call after the
+// copies).  Staging space is returned once the fence value the batch was submitted
+// with has completed.  The staging buffer itself is released when nothing is left in
+// flight, unless the uploader keeps it: uploads that recur every few frames, such as
+// streamed terrain, would otherwise create and destroy it over and over.
+//
+// The ring and the copy batches are shared; implementations create the buffers and
+// the staging memory.  StaticGeometryUploader uses DEFAULT- and UPLOAD-heap resources,
+// MemoryGeometryUploader plain memory, so geometry can be built and streamed without
+// a device.  The uploader owns every buffer it creates until ReleaseBuffer.
+//***************************************************************************************
+
+#pragma once
+
+#include "CommandRecorder.h"
+#include "UploadRing.h"
+#include <vector>
+
+struct StaticBuffer
+{
+	ID3D12Resource* Resource = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS GpuAddress = 0;
+};
+
+class GeometryUploader
+{
+public:
+	GeometryUploader(UINT64 stagingByteSize, bool keepStaging);
+	GeometryUploader(const GeometryUploader& rhs) = delete;
+	GeometryUploader& operator=(const GeometryUploader& rhs) = delete;
+	virtual ~GeometryUploader() = default;
+
+	///<summary>
+	/// Creates a buffer and stages initData for it.  The copy is recorded by the next
+	/// Flush; the buffer is in GENERIC_READ state after that.
+	///</summary>
+	StaticBuffer CreateStaticBuffer(const void* initData, UINT64 byteSize);
+
+	///<summary>
+	/// Same, but write(void* dst) fills the byteSize bytes of staging memory in place,
+	/// e.g. with VertexWriter, instead of copying them from an existing array.  The
+	/// staging memory may be write-combined: write it sequentially and never read it.
+	///</summary>
+	template<typename TWrite>
+	StaticBuffer CreateStaticBuffer(UINT64 byteSize, TWrite&& write)
+	{
+		StaticBuffer buffer;
+		write(static_cast<void*>(Stage(byteSize, buffer)));
+		return buffer;
+	}
+
+	///<summary>
+	/// Destroys a buffer.  The GPU must be done with it.
+	///</summary>
+	virtual void ReleaseBuffer(const StaticBuffer& buffer) = 0;
+
+	///<summary>
+	/// Records all pending copies.
+	///</summary>
+	void Flush(CommandRecorder& recorder);
+
+	///<summary>
+	/// Call after the flushed command list has been executed and fenceValue signalled.
+	///</summary>
+	void Submit(UINT64 fenceValue);
+
+	///<summary>
+	/// Frees staging space for every batch whose fence has completed, and the staging
+	/// buffer once it is empty if it is not kept.
+	///</summary>
+	void Retire(UINT64 completedFenceValue);
+
+	UINT64 StagingBytesInUse()const { return mRing.UsedBytes(); }
+
+protected:
+	///<summary>
+	/// Creates a GPU-local buffer in COPY_DEST state.
+	///</summary>
+	virtual StaticBuffer CreateBuffer(UINT64 byteSize) = 0;
+
+	///<summary>
+	/// Creates the mapped staging buffer of byteSize bytes, or releases it.
+	///</summary>
+	virtual std::uint8_t* CreateStaging(UINT64 byteSize, ID3D12Resource*& resource) = 0;
+	virtual void ReleaseStaging() = 0;
+
+private:
+	///<summary>
+	/// Allocates staging space and creates the buffer it is copied into on Flush.
+	///</summary>
+	std::uint8_t* Stage(UINT64 byteSize, StaticBuffer& buffer);
+
+private:
+	struct PendingCopy
+	{
+		ID3D12Resource* Dest = nullptr;
+		UINT64 SrcOffset = 0;
+		UINT64 ByteSize = 0;
+	};
+
+	UploadRing mRing;
+	ID3D12Resource* mStaging = nullptr;
+	std::uint8_t* mMappedData = nullptr;
+	bool mKeepStaging = false;
+
+	std::vector<PendingCopy> mPendingCopies;
+	std::vector<D3D12_RESOURCE_BARRIER> mBarriers;
+};
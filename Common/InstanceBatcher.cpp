@@ -0,0 +1,126 @@
+//***************************************************************************************
+// InstanceBatcher.cpp
+//***************************************************************************************
+
+#include "InstanceBatcher.h"
+
+#include <xmmintrin.h>
+
+using namespace DirectX;
+
+void InstanceBatcher::Build(const std::uint32_t* geometryIds, const std::uint32_t* materialIds,
+	const std::uint8_t* visible, std::uint32_t count)
+{
+	mGroups.clear();
+	mGroupOfInstance.clear();
+	RehashGroups(mTableGroups.empty() ? 64 : mTableGroups.size());
+
+	// Pass 1: find each object's group and count group sizes.  Neighbouring objects
+	// usually share a key, so the last lookup is cached.
+	std::uint64_t lastKey = ~0ull;
+	std::uint32_t lastGroup = 0;
+
+	for(std::uint32_t i = 0; i < count; ++i)
+	{
+		if(visible != nullptr && !visible[i])
+			continue;
+
+		std::uint64_t key = (std::uint64_t)geometryIds[i] << 32 | materialIds[i];
+		if(key != lastKey)
+		{
+			lastKey = key;
+			lastGroup = FindOrAddGroup(geometryIds[i], materialIds[i]);
+		}
+
+		mGroups[lastGroup].InstanceCount++;
+		mGroupOfInstance.push_back(lastGroup);
+	}
+
+	// Prefix sum gives each group its range in the instance buffer.
+	mCursor.resize(mGroups.size());
+
+	std::uint32_t first = 0;
+	for(size_t g = 0; g < mGroups.size(); ++g)
+	{
+		mGroups[g].FirstInstance = first;
+		mCursor[g] = first;
+		first += mGroups[g].InstanceCount;
+	}
+
+	// Pass 2: scatter object indices into their group ranges.
+	mOrder.resize(first);
+
+	std::uint32_t instance = 0;
+	for(std::uint32_t i = 0; i < count; ++i)
+	{
+		if(visible != nullptr && !visible[i])
+			continue;
+
+		mOrder[mCursor[mGroupOfInstance[instance++]]++] = i;
+	}
+}
+
+std::uint32_t InstanceBatcher::FindOrAddGroup(std::uint32_t geometryId, std::uint32_t materialId)
+{
+	std::uint64_t key = (std::uint64_t)geometryId << 32 | materialId;
+	size_t mask = mTableGroups.size() - 1;
+	size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+	for(;;)
+	{
+		if(mTableGroups[slot] == ~0u)
+			break;
+		if(mTableKeys[slot] == key)
+			return mTableGroups[slot];
+
+		slot = (slot + 1) & mask;
+	}
+
+	std::uint32_t groupIndex = (std::uint32_t)mGroups.size();
+
+	InstanceGroup group;
+	group.GeometryId = geometryId;
+	group.MaterialId = materialId;
+	mGroups.push_back(group);
+
+	mTableKeys[slot] = key;
+	mTableGroups[slot] = groupIndex;
+
+	// Keep the table at most half full.
+	if(mGroups.size() * 2 > mTableGroups.size())
+		RehashGroups(mTableGroups.size() * 2);
+
+	return groupIndex;
+}
+
+void InstanceBatcher::RehashGroups(size_t tableSize)
+{
+	mTableKeys.assign(tableSize, 0);
+	mTableGroups.assign(tableSize, ~0u);
+
+	size_t mask = tableSize - 1;
+	for(std::uint32_t g = 0; g < (std::uint32_t)mGroups.size(); ++g)
+	{
+		std::uint64_t key = (std::uint64_t)mGroups[g].GeometryId << 32 | mGroups[g].MaterialId;
+		size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+		while(mTableGroups[slot] != ~0u)
+			slot = (slot + 1) & mask;
+
+		mTableKeys[slot] = key;
+		mTableGroups[slot] = g;
+	}
+}
+
+void InstanceBatcher::TransposeWorld(const XMFLOAT4X4& src, XMFLOAT4X4& dst)
+{
+	__m128 r0 = _mm_loadu_ps(&src.m[0][0]);
+	__m128 r1 = _mm_loadu_ps(&src.m[1][0]);
+	__m128 r2 = _mm_loadu_ps(&src.m[2][0]);
+	__m128 r3 = _mm_loadu_ps(&src.m[3][0]);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	_mm_storeu_ps(&dst.m[0][0], r0);
+	_mm_storeu_ps(&dst.m[1][0], r1);
+	_mm_storeu_ps(&dst.m[2][0], r2);
+	_mm_storeu_ps(&dst.m[3][0], r3);
+}
@@ -0,0 +1,71 @@
+//***************************************************************************************
+// InstanceBatcher.h
+//
+// Groups visible objects that share a geometry and a material so each group can be
+// drawn with a single instanced draw.  Groups are ordered by their first visible
+// object and objects keep their dense order inside a group, so the output only
+// depends on the input arrays.
+//
+// CPU only; the packed instance data is written straight into mapped upload memory.
+//***************************************************************************************
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+struct InstanceGroup
+{
+	std::uint32_t GeometryId = 0;
+	std::uint32_t MaterialId = 0;
+	std::uint32_t FirstInstance = 0;
+	std::uint32_t InstanceCount = 0;
+};
+
+class InstanceBatcher
+{
+public:
+	///<summary>
+	/// Builds the groups from the dense per-object arrays.  visible may be null to
+	/// take every object.
+	///</summary>
+	void Build(const std::uint32_t* geometryIds, const std::uint32_t* materialIds,
+		const std::uint8_t* visible, std::uint32_t count);
+
+	const std::vector<InstanceGroup>& Groups()const { return mGroups; }
+
+	///<summary>
+	/// Dense object index of every instance, in instance-buffer order.
+	///</summary>
+	const std::vector<std::uint32_t>& Order()const { return mOrder; }
+
+	std::uint32_t InstanceCount()const { return (std::uint32_t)mOrder.size(); }
+
+	///<summary>
+	/// Writes the transposed world matrix of every instance to dst[k].World.
+	///</summary>
+	template<typename TInstance>
+	void PackWorlds(const DirectX::XMFLOAT4X4* worlds, TInstance* dst)const
+	{
+		for(std::uint32_t k = 0; k < InstanceCount(); ++k)
+			TransposeWorld(worlds[mOrder[k]], dst[k].World);
+	}
+
+private:
+	std::uint32_t FindOrAddGroup(std::uint32_t geometryId, std::uint32_t materialId);
+	void RehashGroups(size_t tableSize);
+
+	static void TransposeWorld(const DirectX::XMFLOAT4X4& src, DirectX::XMFLOAT4X4& dst);
+
+private:
+	std::vector<InstanceGroup> mGroups;
+	std::vector<std::uint32_t> mOrder;
+
+	// Open-addressing table from (geometry, material) key to group index; ~0u is
+	// an empty slot.  Kept between frames along with the other scratch arrays.
+	std::vector<std::uint64_t> mTableKeys;
+	std::vector<std::uint32_t> mTableGroups;
+	std::vector<std::uint32_t> mGroupOfInstance;
+	std::vector<std::uint32_t> mCursor;
+};
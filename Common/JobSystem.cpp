@@ -0,0 +1,109 @@
+//***************************************************************************************
+// JobSystem.cpp
+//***************************************************************************************
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+JobSystem::JobSystem(int workerCount)
+{
+	if(workerCount < 0)
+		workerCount = std::max(1, (int)std::thread::hardware_concurrency()) - 1;
+
+	for(int i = 0; i < workerCount; ++i)
+		mWorkers.emplace_back(&JobSystem::WorkerMain, this);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mQuit = true;
+	}
+	mWakeCv.notify_all();
+
+	for(auto& worker : mWorkers)
+		worker.join();
+}
+
+void JobSystem::ParallelFor(std::uint32_t count, std::uint32_t chunkSize,
+	const std::function<void(std::uint32_t, std::uint32_t, std::uint32_t)>& fn)
+{
+	if(count == 0)
+		return;
+
+	chunkSize = std::max(1u, chunkSize);
+	std::uint32_t chunkCount = ChunkCount(count, chunkSize);
+
+	// Not worth waking anyone for a single chunk.
+	if(mWorkers.empty() || chunkCount == 1)
+	{
+		for(std::uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+			fn(chunk, chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFn = &fn;
+		mCount = count;
+		mChunkSize = chunkSize;
+		mChunkCount = chunkCount;
+		mNextChunk = 0;
+		mGeneration++;
+	}
+	mWakeCv.notify_all();
+
+	RunChunks();
+
+	// Every chunk has been claimed; wait for workers still running one.
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDoneCv.wait(lock, [this] { return mBusyWorkers == 0; });
+	mFn = nullptr;
+}
+
+void JobSystem::WorkerMain()
+{
+	std::uint64_t seenGeneration = 0;
+
+	for(;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWakeCv.wait(lock, [&] { return mQuit || mGeneration != seenGeneration; });
+			if(mQuit)
+				return;
+
+			// A worker that wakes after the loop already finished must not touch it;
+			// the owner may be about to start the next one.
+			seenGeneration = mGeneration;
+			if(mFn == nullptr)
+				continue;
+
+			mBusyWorkers++;
+		}
+
+		RunChunks();
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mBusyWorkers--;
+		}
+		mDoneCv.notify_one();
+	}
+}
+
+void JobSystem::RunChunks()
+{
+	for(;;)
+	{
+		std::uint32_t chunk = mNextChunk.fetch_add(1);
+		if(chunk >= mChunkCount)
+			return;
+
+		std::uint32_t begin = chunk * mChunkSize;
+		std::uint32_t end = std::min(mCount, begin + mChunkSize);
+		(*mFn)(chunk, begin, end);
+	}
+}
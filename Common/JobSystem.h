@@ -0,0 +1,73 @@
+//***************************************************************************************
+// JobSystem.h
+//
+// Small fixed worker pool for data-parallel loops.  ParallelFor splits [0, count) into
+// fixed-size chunks that the workers and the calling thread pull from a shared
+// counter.  Chunk boundaries depend only on count and chunkSize, never on the number of
+// threads, so callers that keep per-chunk results get the same output for any pool
+// size.
+//
+// Only one ParallelFor may run at a time, and it must be called from the thread that
+// owns the pool.
+//***************************************************************************************
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+	///<summary>
+	/// Starts workerCount background threads.  -1 picks one less than the number of
+	/// hardware threads, leaving a core for the calling thread.
+	///</summary>
+	explicit JobSystem(int workerCount = -1);
+	JobSystem(const JobSystem& rhs) = delete;
+	JobSystem& operator=(const JobSystem& rhs) = delete;
+	~JobSystem();
+
+	///<summary>
+	/// Threads that take part in ParallelFor, including the caller.
+	///</summary>
+	std::uint32_t ThreadCount()const { return (std::uint32_t)mWorkers.size() + 1; }
+
+	static std::uint32_t ChunkCount(std::uint32_t count, std::uint32_t chunkSize)
+	{
+		return (count + chunkSize - 1) / chunkSize;
+	}
+
+	///<summary>
+	/// Calls fn(chunkIndex, begin, end) once per chunk and returns when all chunks
+	/// have finished.
+	///</summary>
+	void ParallelFor(std::uint32_t count, std::uint32_t chunkSize,
+		const std::function<void(std::uint32_t, std::uint32_t, std::uint32_t)>& fn);
+
+private:
+	void WorkerMain();
+	void RunChunks();
+
+private:
+	std::vector<std::thread> mWorkers;
+
+	std::mutex mMutex;
+	std::condition_variable mWakeCv;
+	std::condition_variable mDoneCv;
+	std::uint64_t mGeneration = 0;
+	std::uint32_t mBusyWorkers = 0;
+	bool mQuit = false;
+
+	// Current loop; written by the owner under mMutex before mGeneration is bumped.
+	const std::function<void(std::uint32_t, std::uint32_t, std::uint32_t)>* mFn = nullptr;
+	std::uint32_t mCount = 0;
+	std::uint32_t mChunkSize = 1;
+	std::uint32_t mChunkCount = 0;
+	std::atomic<std::uint32_t> mNextChunk = 0;
+};
@@ -0,0 +1,177 @@
+//***************************************************************************************
+// LinearPageAllocator.h
+//
+// Offset bookkeeping for a linear allocator over a growing list of fixed-size pages.
+// Like UploadRing it owns no GPU memory; pages are numbered and the owner creates the
+// memory for a page the first time its index is handed out.
+//
+// Allocate bumps an offset in the current page.  When a request does not fit, the
+// allocator moves on to a free page, or a new one, so the total size is never fixed.
+// A request larger than a page gets a page of its own and leaves the current page as
+// it is.  Like every page, a large page is never released: once retired it goes to a
+// free list of its own and is reused by the next large request it can hold, so the
+// memory kept is the largest set of large pages in flight at once.  Submit tags every page opened since the previous Submit with a fence value;
+// Retire returns them to the free list once that fence has completed.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+struct LinearAllocation
+{
+	std::uint32_t Page = 0;
+	std::uint64_t Offset = 0;
+};
+
+class LinearPageAllocator
+{
+public:
+	explicit LinearPageAllocator(std::uint64_t pageSize) :
+		mPageSize(pageSize)
+	{
+	}
+
+	///<summary>
+	/// Returns the page and offset of byteSize bytes aligned to alignment (a power of
+	/// two, at most the page size).  A page index >= the PageCount() before the call is
+	/// a new page of PageSize(page) bytes.
+	///</summary>
+	LinearAllocation Allocate(std::uint64_t byteSize, std::uint64_t alignment)
+	{
+		mAllocatedBytes += byteSize;
+
+		if(byteSize > mPageSize)
+			return { OpenLargePage(byteSize), 0 };
+
+		std::uint64_t offset = AlignUp(mOffset, alignment);
+		if(mCurrent == NoPage || offset + byteSize > mPageSize)
+		{
+			mCurrent = OpenPage();
+			offset = 0;
+		}
+
+		mOffset = offset + byteSize;
+		return { mCurrent, offset };
+	}
+
+	///<summary>
+	/// Tags every page opened since the previous Submit with fenceValue.  The next
+	/// Allocate starts a new page.
+	///</summary>
+	void Submit(std::uint64_t fenceValue)
+	{
+		for(std::uint32_t page : mOpenPages)
+			mInFlight.push_back({ fenceValue, page });
+
+		mOpenPages.clear();
+		mCurrent = NoPage;
+		mOffset = 0;
+		mAllocatedBytes = 0;
+	}
+
+	///<summary>
+	/// Frees every page whose fence value is <= completedFenceValue.
+	///</summary>
+	void Retire(std::uint64_t completedFenceValue)
+	{
+		while(!mInFlight.empty() && mInFlight.front().FenceValue <= completedFenceValue)
+		{
+			std::uint32_t page = mInFlight.front().Page;
+			if(mPageSizes[page] > mPageSize)
+				mFreeLargePages.push_back(page);
+			else
+				mFreePages.push_back(page);
+
+			mInFlight.pop_front();
+		}
+	}
+
+	std::uint32_t PageCount()const { return (std::uint32_t)mPageSizes.size(); }
+	std::uint64_t PageSize(std::uint32_t page)const { return mPageSizes[page]; }
+
+	// Pages written since the last Submit, and the bytes requested from them.
+	std::uint32_t OpenPageCount()const { return (std::uint32_t)mOpenPages.size(); }
+	std::uint64_t AllocatedBytes()const { return mAllocatedBytes; }
+
+	std::uint64_t ReservedBytes()const
+	{
+		std::uint64_t total = 0;
+		for(std::uint64_t size : mPageSizes)
+			total += size;
+		return total;
+	}
+
+private:
+	static const std::uint32_t NoPage = ~0u;
+
+	static std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	std::uint32_t OpenPage()
+	{
+		std::uint32_t page;
+		if(!mFreePages.empty())
+		{
+			page = mFreePages.back();
+			mFreePages.pop_back();
+		}
+		else
+		{
+			page = PageCount();
+			mPageSizes.push_back(mPageSize);
+		}
+
+		mOpenPages.push_back(page);
+		return page;
+	}
+
+	std::uint32_t OpenLargePage(std::uint64_t byteSize)
+	{
+		// Large requests are rare, so a linear search of their free list is enough.
+		std::uint32_t page = NoPage;
+		for(std::uint32_t i = 0; i < (std::uint32_t)mFreeLargePages.size(); ++i)
+		{
+			if(mPageSizes[mFreeLargePages[i]] >= byteSize)
+			{
+				page = mFreeLargePages[i];
+				mFreeLargePages[i] = mFreeLargePages.back();
+				mFreeLargePages.pop_back();
+				break;
+			}
+		}
+
+		if(page == NoPage)
+		{
+			page = PageCount();
+			mPageSizes.push_back(AlignUp(byteSize, mPageSize));
+		}
+
+		mOpenPages.push_back(page);
+		return page;
+	}
+
+private:
+	struct InFlightPage
+	{
+		std::uint64_t FenceValue;
+		std::uint32_t Page;
+	};
+
+	std::uint64_t mPageSize = 0;
+	std::vector<std::uint64_t> mPageSizes;
+
+	std::uint32_t mCurrent = NoPage;
+	std::uint64_t mOffset = 0;
+	std::uint64_t mAllocatedBytes = 0;
+
+	std::vector<std::uint32_t> mOpenPages;
+	std::vector<std::uint32_t> mFreePages;
+	// Retired pages larger than mPageSize, kept until a large request fits one.
+	std::vector<std::uint32_t> mFreeLargePages;
+	std::deque<InFlightPage> mInFlight;
+};
@@ -0,0 +1,293 @@
+//***************************************************************************************
+// MemoryCommandRecorder.cpp
+//***************************************************************************************
+
+#include "MemoryCommandRecorder.h"
+
+#include <cstring>
+
+namespace
+{
+	struct RootDescriptorArgs
+	{
+		UINT RootParameter;
+		D3D12_GPU_VIRTUAL_ADDRESS Address;
+	};
+
+	struct RootConstantsArgs
+	{
+		UINT RootParameter;
+		UINT Count;
+		UINT DestOffset;
+	};
+
+	struct RenderTargetArgs
+	{
+		D3D12_CPU_DESCRIPTOR_HANDLE RenderTarget;
+		D3D12_CPU_DESCRIPTOR_HANDLE DepthStencil;
+	};
+
+	struct ClearRenderTargetArgs
+	{
+		D3D12_CPU_DESCRIPTOR_HANDLE RenderTarget;
+		FLOAT Color[4];
+	};
+
+	struct ClearDepthStencilArgs
+	{
+		D3D12_CPU_DESCRIPTOR_HANDLE DepthStencil;
+		D3D12_CLEAR_FLAGS Flags;
+		FLOAT Depth;
+		UINT8 Stencil;
+	};
+
+	struct CopyBufferArgs
+	{
+		ID3D12Resource* Dest;
+		UINT64 DestOffset;
+		ID3D12Resource* Src;
+		UINT64 SrcOffset;
+		UINT64 ByteSize;
+	};
+
+	struct DrawArgs
+	{
+		UINT IndexCount;
+		UINT InstanceCount;
+		UINT StartIndex;
+		INT BaseVertex;
+		UINT StartInstance;
+	};
+
+	template<typename T>
+	T Read(const std::uint8_t* p)
+	{
+		T value;
+		std::memcpy(&value, p, sizeof(T));
+		return value;
+	}
+}
+
+void MemoryCommandRecorder::Clear()
+{
+	mStream.clear();
+	mCommandCount = 0;
+	mStats = CommandStreamStats();
+}
+
+template<typename TArgs>
+void MemoryCommandRecorder::Append(CommandType type, const TArgs& args, const void* extra, size_t extraSize)
+{
+	CommandHeader header = { type, (std::uint16_t)(sizeof(CommandHeader) + sizeof(TArgs) + extraSize) };
+
+	size_t offset = mStream.size();
+	mStream.resize(offset + header.ByteSize);
+	std::memcpy(mStream.data() + offset, &header, sizeof(header));
+	std::memcpy(mStream.data() + offset + sizeof(header), &args, sizeof(TArgs));
+	if(extraSize > 0)
+		std::memcpy(mStream.data() + offset + sizeof(header) + sizeof(TArgs), extra, extraSize);
+
+	mCommandCount++;
+}
+
+void MemoryCommandRecorder::SetPipelineState(ID3D12PipelineState* pso)
+{
+	mStats.StateChanges++;
+	Append(CommandType::SetPipelineState, pso);
+}
+
+void MemoryCommandRecorder::SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)
+{
+	mStats.StateChanges++;
+	Append(CommandType::SetGraphicsRootSignature, rootSignature);
+}
+
+void MemoryCommandRecorder::SetGraphicsRootConstantBufferView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	mStats.StateChanges++;
+	Append(CommandType::SetGraphicsRootConstantBufferView, RootDescriptorArgs{ rootParameter, address });
+}
+
+void MemoryCommandRecorder::SetGraphicsRootShaderResourceView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	mStats.StateChanges++;
+	Append(CommandType::SetGraphicsRootShaderResourceView, RootDescriptorArgs{ rootParameter, address });
+}
+
+void MemoryCommandRecorder::SetGraphicsRoot32BitConstants(UINT rootParameter, UINT count, const void* data, UINT destOffset)
+{
+	mStats.StateChanges++;
+	Append(CommandType::SetGraphicsRoot32BitConstants, RootConstantsArgs{ rootParameter, count, destOffset },
+		data, count * sizeof(UINT));
+}
+
+void MemoryCommandRecorder::IASetVertexBuffer(const D3D12_VERTEX_BUFFER_VIEW& view)
+{
+	mStats.StateChanges++;
+	Append(CommandType::IASetVertexBuffer, view);
+}
+
+void MemoryCommandRecorder::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view)
+{
+	mStats.StateChanges++;
+	Append(CommandType::IASetIndexBuffer, view);
+}
+
+void MemoryCommandRecorder::IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+{
+	mStats.StateChanges++;
+	Append(CommandType::IASetPrimitiveTopology, topology);
+}
+
+void MemoryCommandRecorder::RSSetViewport(const D3D12_VIEWPORT& viewport)
+{
+	mStats.StateChanges++;
+	Append(CommandType::RSSetViewport, viewport);
+}
+
+void MemoryCommandRecorder::RSSetScissorRect(const D3D12_RECT& rect)
+{
+	mStats.StateChanges++;
+	Append(CommandType::RSSetScissorRect, rect);
+}
+
+void MemoryCommandRecorder::OMSetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, D3D12_CPU_DESCRIPTOR_HANDLE depthStencil)
+{
+	mStats.StateChanges++;
+	Append(CommandType::OMSetRenderTarget, RenderTargetArgs{ renderTarget, depthStencil });
+}
+
+void MemoryCommandRecorder::DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+{
+	mStats.Draws++;
+	Append(CommandType::DrawIndexedInstanced, DrawArgs{ indexCount, instanceCount, startIndex, baseVertex, startInstance });
+}
+
+void MemoryCommandRecorder::ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers)
+{
+	mStats.Barriers += count;
+	for(UINT first = 0; first < count; first += MaxBarriersPerCommand)
+	{
+		UINT chunk = count - first < MaxBarriersPerCommand ? count - first : MaxBarriersPerCommand;
+		Append(CommandType::ResourceBarrier, chunk, barriers + first, chunk * sizeof(D3D12_RESOURCE_BARRIER));
+	}
+}
+
+void MemoryCommandRecorder::ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, const FLOAT color[4])
+{
+	mStats.Clears++;
+	ClearRenderTargetArgs args = { renderTarget, { color[0], color[1], color[2], color[3] } };
+	Append(CommandType::ClearRenderTargetView, args);
+}
+
+void MemoryCommandRecorder::ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE depthStencil, D3D12_CLEAR_FLAGS flags, FLOAT depth, UINT8 stencil)
+{
+	mStats.Clears++;
+	Append(CommandType::ClearDepthStencilView, ClearDepthStencilArgs{ depthStencil, flags, depth, stencil });
+}
+
+void MemoryCommandRecorder::CopyBufferRegion(ID3D12Resource* dest, UINT64 destOffset, ID3D12Resource* src, UINT64 srcOffset, UINT64 byteSize)
+{
+	mStats.Copies++;
+	Append(CommandType::CopyBufferRegion, CopyBufferArgs{ dest, destOffset, src, srcOffset, byteSize });
+}
+
+void MemoryCommandRecorder::Replay(CommandRecorder& target)const
+{
+	const std::uint8_t* p = mStream.data();
+	const std::uint8_t* end = p + mStream.size();
+
+	while(p < end)
+	{
+		CommandHeader header = Read<CommandHeader>(p);
+		const std::uint8_t* args = p + sizeof(CommandHeader);
+
+		switch(header.Type)
+		{
+		case CommandType::SetPipelineState:
+			target.SetPipelineState(Read<ID3D12PipelineState*>(args));
+			break;
+		case CommandType::SetGraphicsRootSignature:
+			target.SetGraphicsRootSignature(Read<ID3D12RootSignature*>(args));
+			break;
+		case CommandType::SetGraphicsRootConstantBufferView:
+		{
+			RootDescriptorArgs a = Read<RootDescriptorArgs>(args);
+			target.SetGraphicsRootConstantBufferView(a.RootParameter, a.Address);
+			break;
+		}
+		case CommandType::SetGraphicsRootShaderResourceView:
+		{
+			RootDescriptorArgs a = Read<RootDescriptorArgs>(args);
+			target.SetGraphicsRootShaderResourceView(a.RootParameter, a.Address);
+			break;
+		}
+		case CommandType::SetGraphicsRoot32BitConstants:
+		{
+			// Copied out so the values are aligned; a root signature holds at most 64.
+			RootConstantsArgs a = Read<RootConstantsArgs>(args);
+			UINT values[64];
+			UINT count = a.Count < 64 ? a.Count : 64;
+			std::memcpy(values, args + sizeof(RootConstantsArgs), count * sizeof(UINT));
+			target.SetGraphicsRoot32BitConstants(a.RootParameter, count, values, a.DestOffset);
+			break;
+		}
+		case CommandType::IASetVertexBuffer:
+			target.IASetVertexBuffer(Read<D3D12_VERTEX_BUFFER_VIEW>(args));
+			break;
+		case CommandType::IASetIndexBuffer:
+			target.IASetIndexBuffer(Read<D3D12_INDEX_BUFFER_VIEW>(args));
+			break;
+		case CommandType::IASetPrimitiveTopology:
+			target.IASetPrimitiveTopology(Read<D3D12_PRIMITIVE_TOPOLOGY>(args));
+			break;
+		case CommandType::RSSetViewport:
+			target.RSSetViewport(Read<D3D12_VIEWPORT>(args));
+			break;
+		case CommandType::RSSetScissorRect:
+			target.RSSetScissorRect(Read<D3D12_RECT>(args));
+			break;
+		case CommandType::OMSetRenderTarget:
+		{
+			RenderTargetArgs a = Read<RenderTargetArgs>(args);
+			target.OMSetRenderTarget(a.RenderTarget, a.DepthStencil);
+			break;
+		}
+		case CommandType::DrawIndexedInstanced:
+		{
+			DrawArgs a = Read<DrawArgs>(args);
+			target.DrawIndexedInstanced(a.IndexCount, a.InstanceCount, a.StartIndex, a.BaseVertex, a.StartInstance);
+			break;
+		}
+		case CommandType::ResourceBarrier:
+		{
+			// Copied out for alignment, like root constants.
+			UINT count = Read<UINT>(args);
+			D3D12_RESOURCE_BARRIER barriers[MaxBarriersPerCommand];
+			std::memcpy(barriers, args + sizeof(UINT), count * sizeof(D3D12_RESOURCE_BARRIER));
+			target.ResourceBarrier(count, barriers);
+			break;
+		}
+		case CommandType::ClearRenderTargetView:
+		{
+			ClearRenderTargetArgs a = Read<ClearRenderTargetArgs>(args);
+			target.ClearRenderTargetView(a.RenderTarget, a.Color);
+			break;
+		}
+		case CommandType::ClearDepthStencilView:
+		{
+			ClearDepthStencilArgs a = Read<ClearDepthStencilArgs>(args);
+			target.ClearDepthStencilView(a.DepthStencil, a.Flags, a.Depth, a.Stencil);
+			break;
+		}
+		case CommandType::CopyBufferRegion:
+		{
+			CopyBufferArgs a = Read<CopyBufferArgs>(args);
+			target.CopyBufferRegion(a.Dest, a.DestOffset, a.Src, a.SrcOffset, a.ByteSize);
+			break;
+		}
+		}
+
+		p += header.ByteSize;
+	}
+}
@@ -0,0 +1,108 @@
+//***************************************************************************************
+// MemoryCommandRecorder.h
+//
+// CommandRecorder that appends each command to a byte stream instead of a command
+// list: a small header (command type and size) followed by the arguments.  Replay
+// issues the stored commands to another recorder in order, so a stream recorded off
+// the render thread, or in several parts, can be checked or submitted later.  Stats
+// counts the commands by kind, so a frame's CPU side can be measured without a device.
+//
+// Pointers (pipeline state, root signature, resources) are stored as they are and
+// must stay valid until Replay.
+//***************************************************************************************
+
+#pragma once
+
+#include "CommandRecorder.h"
+#include <cstdint>
+#include <vector>
+
+struct CommandStreamStats
+{
+	UINT Draws = 0;
+
+	// Pipeline, root signature, root argument, input assembler, viewport and render
+	// target commands.
+	UINT StateChanges = 0;
+
+	// Barriers (not ResourceBarrier calls), clears and buffer copies.
+	UINT Barriers = 0;
+	UINT Clears = 0;
+	UINT Copies = 0;
+};
+
+class MemoryCommandRecorder : public CommandRecorder
+{
+public:
+	void Clear();
+
+	void SetPipelineState(ID3D12PipelineState* pso)override;
+	void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)override;
+	void SetGraphicsRootConstantBufferView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)override;
+	void SetGraphicsRootShaderResourceView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)override;
+	void SetGraphicsRoot32BitConstants(UINT rootParameter, UINT count, const void* data, UINT destOffset)override;
+
+	void IASetVertexBuffer(const D3D12_VERTEX_BUFFER_VIEW& view)override;
+	void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view)override;
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)override;
+
+	void RSSetViewport(const D3D12_VIEWPORT& viewport)override;
+	void RSSetScissorRect(const D3D12_RECT& rect)override;
+	void OMSetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, D3D12_CPU_DESCRIPTOR_HANDLE depthStencil)override;
+
+	void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)override;
+
+	void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers)override;
+	void ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, const FLOAT color[4])override;
+	void ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE depthStencil, D3D12_CLEAR_FLAGS flags, FLOAT depth, UINT8 stencil)override;
+	void CopyBufferRegion(ID3D12Resource* dest, UINT64 destOffset, ID3D12Resource* src, UINT64 srcOffset, UINT64 byteSize)override;
+
+	///<summary>
+	/// Issues every stored command to target, in recording order.
+	///</summary>
+	void Replay(CommandRecorder& target)const;
+
+	UINT CommandCount()const { return mCommandCount; }
+	const CommandStreamStats& Stats()const { return mStats; }
+	size_t ByteSize()const { return mStream.size(); }
+	const std::vector<std::uint8_t>& Stream()const { return mStream; }
+
+private:
+	enum class CommandType : std::uint16_t
+	{
+		SetPipelineState,
+		SetGraphicsRootSignature,
+		SetGraphicsRootConstantBufferView,
+		SetGraphicsRootShaderResourceView,
+		SetGraphicsRoot32BitConstants,
+		IASetVertexBuffer,
+		IASetIndexBuffer,
+		IASetPrimitiveTopology,
+		RSSetViewport,
+		RSSetScissorRect,
+		OMSetRenderTarget,
+		DrawIndexedInstanced,
+		ResourceBarrier,
+		ClearRenderTargetView,
+		ClearDepthStencilView,
+		CopyBufferRegion,
+	};
+
+	// Barriers stored per ResourceBarrier command; longer calls are split so a command
+	// stays within its 16-bit size and Replay can copy it to the stack.
+	static const UINT MaxBarriersPerCommand = 64;
+
+	struct CommandHeader
+	{
+		CommandType Type;
+		std::uint16_t ByteSize;
+	};
+
+	template<typename TArgs>
+	void Append(CommandType type, const TArgs& args, const void* extra = nullptr, size_t extraSize = 0);
+
+private:
+	std::vector<std::uint8_t> mStream;
+	UINT mCommandCount = 0;
+	CommandStreamStats mStats;
+};
@@ -0,0 +1,77 @@
+//***************************************************************************************
+// MemoryGeometryUploader.h
+//
+// GeometryUploader whose buffers and staging are plain memory, for building and
+// streaming geometry without a device.  Resource pointers and GPU addresses are the
+// addresses of that memory: unique and stable, but only to be stored and compared.
+// Flush records the same copies and barriers as on a device; nothing executes them,
+// so a buffer's own memory is never filled.
+//***************************************************************************************
+
+#pragma once
+
+#include "GeometryUploader.h"
+#include <memory>
+#include <unordered_map>
+
+class MemoryGeometryUploader : public GeometryUploader
+{
+public:
+	MemoryGeometryUploader(UINT64 stagingByteSize, bool keepStaging = false) :
+		GeometryUploader(stagingByteSize, keepStaging)
+	{
+	}
+
+	void ReleaseBuffer(const StaticBuffer& buffer)override
+	{
+		mBuffers.erase(buffer.Resource);
+	}
+
+	// Bytes held by buffers that have not been released.
+	UINT64 BufferBytes()const
+	{
+		UINT64 total = 0;
+		for(const auto& entry : mBuffers)
+			total += entry.second.ByteSize;
+		return total;
+	}
+
+	UINT BufferCount()const { return (UINT)mBuffers.size(); }
+
+protected:
+	StaticBuffer CreateBuffer(UINT64 byteSize)override
+	{
+		Memory memory;
+		memory.Data = std::make_unique<std::uint8_t[]>((size_t)byteSize);
+		memory.ByteSize = byteSize;
+
+		StaticBuffer buffer;
+		buffer.Resource = reinterpret_cast<ID3D12Resource*>(memory.Data.get());
+		buffer.GpuAddress = reinterpret_cast<std::uintptr_t>(memory.Data.get());
+
+		mBuffers[buffer.Resource] = std::move(memory);
+		return buffer;
+	}
+
+	std::uint8_t* CreateStaging(UINT64 byteSize, ID3D12Resource*& resource)override
+	{
+		mStaging = std::make_unique<std::uint8_t[]>((size_t)byteSize);
+		resource = reinterpret_cast<ID3D12Resource*>(mStaging.get());
+		return mStaging.get();
+	}
+
+	void ReleaseStaging()override
+	{
+		mStaging.reset();
+	}
+
+private:
+	struct Memory
+	{
+		std::unique_ptr<std::uint8_t[]> Data;
+		UINT64 ByteSize = 0;
+	};
+
+	std::unique_ptr<std::uint8_t[]> mStaging;
+	std::unordered_map<ID3D12Resource*, Memory> mBuffers;
+};
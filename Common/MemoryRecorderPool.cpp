@@ -0,0 +1,40 @@
+//***************************************************************************************
+// MemoryRecorderPool.cpp
+//***************************************************************************************
+
+#include "MemoryRecorderPool.h"
+
+void MemoryRecorderPool::BeginFrame(UINT)
+{
+	mUsed = 0;
+}
+
+CommandRecorder& MemoryRecorderPool::Acquire()
+{
+	if(mUsed == mRecorders.size())
+		mRecorders.emplace_back();
+
+	MemoryCommandRecorder& recorder = mRecorders[mUsed++];
+	recorder.Clear();
+	return recorder;
+}
+
+void MemoryRecorderPool::Submit()
+{
+	mSubmitted = SubmittedFrameStats();
+	mSubmitted.Lists = mUsed;
+
+	for(UINT i = 0; i < mUsed; ++i)
+	{
+		const MemoryCommandRecorder& list = mRecorders[i];
+		const CommandStreamStats& stats = list.Stats();
+
+		mSubmitted.Commands += list.CommandCount();
+		mSubmitted.Bytes += list.ByteSize();
+		mSubmitted.Stream.Draws += stats.Draws;
+		mSubmitted.Stream.StateChanges += stats.StateChanges;
+		mSubmitted.Stream.Barriers += stats.Barriers;
+		mSubmitted.Stream.Clears += stats.Clears;
+		mSubmitted.Stream.Copies += stats.Copies;
+	}
+}
@@ -0,0 +1,44 @@
+//***************************************************************************************
+// MemoryRecorderPool.h
+//
+// CommandRecorderPool that records every list into a MemoryCommandRecorder.  Submit
+// totals the lists of the frame; the streams stay readable until the next BeginFrame,
+// e.g. to replay them into another recorder.
+//***************************************************************************************
+
+#pragma once
+
+#include "CommandRecorderPool.h"
+#include "MemoryCommandRecorder.h"
+#include <deque>
+
+struct SubmittedFrameStats
+{
+	UINT Lists = 0;
+	UINT Commands = 0;
+	UINT64 Bytes = 0;
+	CommandStreamStats Stream;
+};
+
+class MemoryRecorderPool : public CommandRecorderPool
+{
+public:
+	void BeginFrame(UINT frameIndex)override;
+	CommandRecorder& Acquire()override;
+	void Submit()override;
+
+	///<summary>
+	/// Totals of the last Submit.
+	///</summary>
+	const SubmittedFrameStats& Submitted()const { return mSubmitted; }
+
+	UINT ListCount()const { return mUsed; }
+	const MemoryCommandRecorder& List(UINT i)const { return mRecorders[i]; }
+
+private:
+	// Recorders keep their addresses, and their stream capacity, across frames.
+	std::deque<MemoryCommandRecorder> mRecorders;
+	UINT mUsed = 0;
+
+	SubmittedFrameStats mSubmitted;
+};
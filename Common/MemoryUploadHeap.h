@@ -0,0 +1,40 @@
+//***************************************************************************************
+// MemoryUploadHeap.h
+//
+// UploadHeap whose pages are plain memory, for running the frame without a device.
+// GPU addresses are the pages' CPU addresses, so they are unique, keep their offsets
+// and can be told apart in a recorded command stream, but must never reach a device.
+//***************************************************************************************
+
+#pragma once
+
+#include "UploadHeap.h"
+#include <memory>
+
+class MemoryUploadHeap : public UploadHeap
+{
+public:
+	explicit MemoryUploadHeap(UINT64 pageSize) :
+		UploadHeap(pageSize)
+	{
+	}
+
+protected:
+	UploadAllocation CreatePage(UINT64 byteSize)override
+	{
+		// Same placement alignment as a buffer resource, so slice alignment carries over.
+		const std::size_t alignment = 64 * 1024;
+		mPages.push_back(std::make_unique<std::uint8_t[]>((std::size_t)byteSize + alignment));
+
+		std::uintptr_t address = reinterpret_cast<std::uintptr_t>(mPages.back().get());
+		address = (address + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+
+		UploadAllocation page;
+		page.CpuAddress = reinterpret_cast<std::uint8_t*>(address);
+		page.GpuAddress = (D3D12_GPU_VIRTUAL_ADDRESS)address;
+		return page;
+	}
+
+private:
+	std::vector<std::unique_ptr<std::uint8_t[]>> mPages;
+};
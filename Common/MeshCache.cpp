@@ -0,0 +1,203 @@
+//***************************************************************************************
+// MeshCache.cpp
+//***************************************************************************************
+
+#include "MeshCache.h"
+
+using namespace DirectX;
+
+namespace
+{
+	const char MeshCacheMagic[4] = { 'M', 'S', 'H', 'C' };
+
+	std::uint64_t AlignUp16(std::uint64_t value)
+	{
+		return (value + 15) & ~std::uint64_t(15);
+	}
+}
+
+MeshCache::~MeshCache()
+{
+	Close();
+}
+
+bool MeshCache::Open(const std::wstring& filename, const std::wstring& sourceFilename)
+{
+	Close();
+
+	mFile = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(mFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(MeshCacheHeader))
+	{
+		Close();
+		return false;
+	}
+
+	mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(mMapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	mView = reinterpret_cast<const BYTE*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+	if(mView == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	mHeader = reinterpret_cast<const MeshCacheHeader*>(mView);
+
+	// Reject files from other versions or that were truncated while being written.
+	const std::uint64_t size = (std::uint64_t)fileSize.QuadPart;
+	bool valid =
+		memcmp(mHeader->Magic, MeshCacheMagic, sizeof(MeshCacheMagic)) == 0 &&
+		mHeader->Version == Version &&
+		(mHeader->IndexStride == 2 || mHeader->IndexStride == 4) &&
+		mHeader->VertexOffset + (std::uint64_t)mHeader->VertexStride * mHeader->VertexCount <= size &&
+		mHeader->IndexOffset + (std::uint64_t)mHeader->IndexStride * mHeader->IndexCount <= size &&
+		mHeader->MeshletStride == sizeof(Meshlet) &&
+		mHeader->MeshletOffset + (std::uint64_t)sizeof(Meshlet) * mHeader->MeshletCount <= size &&
+		mHeader->LodOffset + (std::uint64_t)sizeof(MeshCacheLod) * mHeader->LodCount <= size;
+
+	for(UINT level = 0; valid && level < mHeader->LodCount; ++level)
+	{
+		const MeshCacheLod& lod = Lod(level);
+		valid =
+			lod.VertexOffset + (std::uint64_t)mHeader->VertexStride * lod.VertexCount <= size &&
+			lod.IndexOffset + (std::uint64_t)mHeader->IndexStride * lod.IndexCount <= size;
+	}
+
+	if(valid && !sourceFilename.empty())
+	{
+		std::uint64_t sourceSize = 0;
+		std::uint64_t sourceTime = 0;
+		if(GetSourceStamp(sourceFilename, sourceSize, sourceTime))
+			valid = sourceSize == mHeader->SourceByteSize && sourceTime == mHeader->SourceWriteTime;
+	}
+
+	if(!valid)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void MeshCache::Close()
+{
+	if(mView != nullptr)
+		UnmapViewOfFile(mView);
+
+	if(mMapping != nullptr)
+		CloseHandle(mMapping);
+
+	if(mFile != INVALID_HANDLE_VALUE)
+		CloseHandle(mFile);
+
+	mView = nullptr;
+	mHeader = nullptr;
+	mMapping = nullptr;
+	mFile = INVALID_HANDLE_VALUE;
+}
+
+BoundingBox MeshCache::Bounds()const
+{
+	BoundingBox bounds;
+	XMVECTOR vMin = XMLoadFloat3(&mHeader->BoundsMin);
+	XMVECTOR vMax = XMLoadFloat3(&mHeader->BoundsMax);
+	BoundingBox::CreateFromPoints(bounds, vMin, vMax);
+
+	return bounds;
+}
+
+bool MeshCache::Write(
+	const std::wstring& filename,
+	const std::wstring& sourceFilename,
+	const void* vertices, UINT vertexStride, UINT vertexCount,
+	const void* indices, UINT indexStride, UINT indexCount,
+	const BoundingBox& bounds,
+	const Meshlet* meshlets, UINT meshletCount,
+	const MeshCacheLodSource* lods, UINT lodCount)
+{
+	MeshCacheHeader header = {};
+	memcpy(header.Magic, MeshCacheMagic, sizeof(MeshCacheMagic));
+	header.Version = Version;
+	header.VertexStride = vertexStride;
+	header.VertexCount = vertexCount;
+	header.IndexStride = indexStride;
+	header.IndexCount = indexCount;
+	header.VertexOffset = AlignUp16(sizeof(MeshCacheHeader));
+	header.IndexOffset = AlignUp16(header.VertexOffset + (std::uint64_t)vertexStride * vertexCount);
+	header.MeshletStride = sizeof(Meshlet);
+	header.MeshletCount = meshletCount;
+	header.MeshletOffset = AlignUp16(header.IndexOffset + (std::uint64_t)indexStride * indexCount);
+	header.LodCount = lodCount;
+	header.LodOffset = AlignUp16(header.MeshletOffset + (std::uint64_t)sizeof(Meshlet) * meshletCount);
+
+	// Level streams follow the table in order.
+	std::vector<MeshCacheLod> lodTable(lodCount);
+	std::uint64_t end = header.LodOffset + (std::uint64_t)sizeof(MeshCacheLod) * lodCount;
+	for(UINT level = 0; level < lodCount; ++level)
+	{
+		MeshCacheLod& lod = lodTable[level];
+		lod.VertexCount = lods[level].VertexCount;
+		lod.IndexCount = lods[level].IndexCount;
+		lod.VertexOffset = AlignUp16(end);
+		lod.IndexOffset = AlignUp16(lod.VertexOffset + (std::uint64_t)vertexStride * lod.VertexCount);
+		lod.Error = lods[level].Error;
+		end = lod.IndexOffset + (std::uint64_t)indexStride * lod.IndexCount;
+	}
+
+	XMVECTOR center = XMLoadFloat3(&bounds.Center);
+	XMVECTOR extents = XMLoadFloat3(&bounds.Extents);
+	XMStoreFloat3(&header.BoundsMin, center - extents);
+	XMStoreFloat3(&header.BoundsMax, center + extents);
+
+	GetSourceStamp(sourceFilename, header.SourceByteSize, header.SourceWriteTime);
+
+	std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+	if(!fout)
+		return false;
+
+	// Pads up to offset, then writes the stream there.
+	const char padding[16] = {};
+	std::uint64_t written = 0;
+	auto writeAt = [&](std::uint64_t offset, const void* data, std::uint64_t byteSize)
+	{
+		fout.write(padding, (std::streamsize)(offset - written));
+		fout.write(reinterpret_cast<const char*>(data), (std::streamsize)byteSize);
+		written = offset + byteSize;
+	};
+
+	writeAt(0, &header, sizeof(header));
+	writeAt(header.VertexOffset, vertices, (std::uint64_t)vertexStride * vertexCount);
+	writeAt(header.IndexOffset, indices, (std::uint64_t)indexStride * indexCount);
+	writeAt(header.MeshletOffset, meshlets, (std::uint64_t)sizeof(Meshlet) * meshletCount);
+	writeAt(header.LodOffset, lodTable.data(), (std::uint64_t)sizeof(MeshCacheLod) * lodCount);
+	for(UINT level = 0; level < lodCount; ++level)
+	{
+		writeAt(lodTable[level].VertexOffset, lods[level].Vertices, (std::uint64_t)vertexStride * lodTable[level].VertexCount);
+		writeAt(lodTable[level].IndexOffset, lods[level].Indices, (std::uint64_t)indexStride * lodTable[level].IndexCount);
+	}
+
+	return fout.good();
+}
+
+bool MeshCache::GetSourceStamp(const std::wstring& filename, std::uint64_t& byteSize, std::uint64_t& writeTime)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if(!GetFileAttributesExW(filename.c_str(), GetFileExInfoStandard, &data))
+		return false;
+
+	byteSize = ((std::uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+	writeTime = ((std::uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+
+	return true;
+}
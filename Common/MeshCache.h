@@ -0,0 +1,132 @@
+//***************************************************************************************
+// MeshCache.h
+//
+// Versioned binary container for static meshes.  A cache file is laid out as
+//
+//   [MeshCacheHeader][vertex stream][index stream][meshlets][LOD table]
+//   [LOD 1 vertex stream][LOD 1 index stream]...
+//
+// with every stream 16-byte aligned.  Along with the mesh itself it keeps what is
+// derived from it at load time (meshlets for the index order stored, and the
+// simplified, optimized LOD levels), so a cache hit skips all of that work.  The header records the size and write time of
+// the text model it was converted from so a cache is rebuilt when the source changes.
+// Reading memory-maps the file so vertex/index data can be copied straight into GPU
+// upload memory without any parsing.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include "MeshletBuilder.h"
+
+struct MeshCacheHeader
+{
+	char Magic[4];
+	std::uint32_t Version;
+
+	std::uint32_t VertexStride;
+	std::uint32_t VertexCount;
+	std::uint32_t IndexStride;
+	std::uint32_t IndexCount;
+
+	std::uint64_t VertexOffset;
+	std::uint64_t IndexOffset;
+
+	std::uint32_t MeshletStride;
+	std::uint32_t MeshletCount;
+	std::uint64_t MeshletOffset;
+
+	// MeshCacheLod entries, one per simplified level.
+	std::uint32_t LodCount;
+	std::uint32_t Reserved;
+	std::uint64_t LodOffset;
+
+	DirectX::XMFLOAT3 BoundsMin;
+	DirectX::XMFLOAT3 BoundsMax;
+
+	// Identifies the source file this cache was converted from.
+	std::uint64_t SourceByteSize;
+	std::uint64_t SourceWriteTime;
+};
+
+// A simplified level; its streams use the header's vertex and index strides.
+struct MeshCacheLod
+{
+	std::uint32_t VertexCount;
+	std::uint32_t IndexCount;
+	std::uint64_t VertexOffset;
+	std::uint64_t IndexOffset;
+	float Error;
+	std::uint32_t Reserved;
+};
+
+// Source data for one level when writing a cache.
+struct MeshCacheLodSource
+{
+	const void* Vertices = nullptr;
+	UINT VertexCount = 0;
+	const void* Indices = nullptr;
+	UINT IndexCount = 0;
+	float Error = 0.0f;
+};
+
+class MeshCache
+{
+public:
+	// 2: streams are stored after vertex cache/fetch optimization.
+	// 3: indices are in meshlet order; meshlets and LOD levels are stored too.
+	static const std::uint32_t Version = 3;
+
+	MeshCache() = default;
+	MeshCache(const MeshCache& rhs) = delete;
+	MeshCache& operator=(const MeshCache& rhs) = delete;
+	~MeshCache();
+
+	///<summary>
+	/// Maps the cache file and validates its header.  If sourceFilename is given the
+	/// cache is rejected when that file no longer matches the recorded size/write time.
+	///</summary>
+	bool Open(const std::wstring& filename, const std::wstring& sourceFilename = L"");
+	void Close();
+
+	const MeshCacheHeader& Header()const { return *mHeader; }
+
+	const void* Vertices()const { return mView + mHeader->VertexOffset; }
+	const void* Indices()const { return mView + mHeader->IndexOffset; }
+
+	UINT VertexByteSize()const { return mHeader->VertexStride * mHeader->VertexCount; }
+	UINT IndexByteSize()const { return mHeader->IndexStride * mHeader->IndexCount; }
+
+	const Meshlet* Meshlets()const { return reinterpret_cast<const Meshlet*>(mView + mHeader->MeshletOffset); }
+	UINT MeshletCount()const { return mHeader->MeshletCount; }
+
+	UINT LodCount()const { return mHeader->LodCount; }
+	const MeshCacheLod& Lod(UINT level)const { return reinterpret_cast<const MeshCacheLod*>(mView + mHeader->LodOffset)[level]; }
+	const void* LodVertices(UINT level)const { return mView + Lod(level).VertexOffset; }
+	const void* LodIndices(UINT level)const { return mView + Lod(level).IndexOffset; }
+
+	DirectX::BoundingBox Bounds()const;
+
+	///<summary>
+	/// Writes a cache file.  indices should already be in meshlet order; the LOD
+	/// levels use the same strides as the mesh.  Returns false if the file could not
+	/// be written.
+	///</summary>
+	static bool Write(
+		const std::wstring& filename,
+		const std::wstring& sourceFilename,
+		const void* vertices, UINT vertexStride, UINT vertexCount,
+		const void* indices, UINT indexStride, UINT indexCount,
+		const DirectX::BoundingBox& bounds,
+		const Meshlet* meshlets, UINT meshletCount,
+		const MeshCacheLodSource* lods, UINT lodCount);
+
+private:
+	static bool GetSourceStamp(const std::wstring& filename, std::uint64_t& byteSize, std::uint64_t& writeTime);
+
+private:
+	HANDLE mFile = INVALID_HANDLE_VALUE;
+	HANDLE mMapping = nullptr;
+	const BYTE* mView = nullptr;
+	const MeshCacheHeader* mHeader = nullptr;
+};
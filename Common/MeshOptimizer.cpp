@@ -0,0 +1,225 @@
+//***************************************************************************************
+// MeshOptimizer.cpp
+//***************************************************************************************
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Forsyth's tuning values.  The scoring cache is larger than real hardware
+	// FIFOs on purpose; it only ranks candidates.
+	const int ScoreCacheSize = 32;
+	const float CacheDecayPower = 1.5f;
+	const float LastTriScore = 0.75f;
+	const float ValenceBoostScale = 2.0f;
+	const float ValenceBoostPower = 0.5f;
+
+	float VertexScore(int cachePosition, std::uint32_t remainingTriangles)
+	{
+		// No triangles left to use this vertex.
+		if(remainingTriangles == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if(cachePosition >= 0)
+		{
+			// The three vertices of the last triangle get a fixed score so the next
+			// triangle does not simply reuse the same edge forever.
+			if(cachePosition < 3)
+				score = LastTriScore;
+			else
+			{
+				const float scaler = 1.0f / (ScoreCacheSize - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+			}
+		}
+
+		// Favor vertices with few triangles left so they are finished off early.
+		score += ValenceBoostScale * std::pow((float)remainingTriangles, -ValenceBoostPower);
+		return score;
+	}
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const uint32* indices, size_t indexCount,
+	uint32 vertexCount, uint32 cacheSize)
+{
+	VertexCacheStats stats;
+	if(indexCount == 0)
+		return stats;
+
+	// FIFO cache: a hit does not refresh the entry.  timestamps[v] is the miss
+	// counter value when v was last inserted.
+	std::vector<std::uint64_t> timestamps(vertexCount, 0);
+	std::vector<std::uint8_t> referenced(vertexCount, 0);
+
+	std::uint64_t misses = 0;
+	uint32 uniqueVertices = 0;
+
+	for(size_t i = 0; i < indexCount; ++i)
+	{
+		uint32 v = indices[i];
+		if(!referenced[v])
+		{
+			referenced[v] = 1;
+			uniqueVertices++;
+		}
+
+		if(timestamps[v] == 0 || misses + 1 - timestamps[v] > cacheSize)
+		{
+			misses++;
+			timestamps[v] = misses;
+		}
+	}
+
+	stats.Acmr = (float)misses / (float)(indexCount / 3);
+	stats.Atvr = (float)misses / (float)uniqueVertices;
+	return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32* indices, size_t indexCount, uint32 vertexCount)
+{
+	const uint32 triCount = (uint32)(indexCount / 3);
+	if(triCount == 0)
+		return;
+
+	// Per-vertex triangle lists in one array.  The first remaining[v] entries of a
+	// vertex's list are the triangles not emitted yet.
+	std::vector<uint32> remaining(vertexCount, 0);
+	for(size_t i = 0; i < indexCount; ++i)
+		remaining[indices[i]]++;
+
+	std::vector<uint32> offsets(vertexCount + 1, 0);
+	for(uint32 v = 0; v < vertexCount; ++v)
+		offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<uint32> adjacency(indexCount);
+	{
+		std::vector<uint32> cursor(offsets.begin(), offsets.end() - 1);
+		for(size_t i = 0; i < indexCount; ++i)
+			adjacency[cursor[indices[i]]++] = (uint32)(i / 3);
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for(uint32 v = 0; v < vertexCount; ++v)
+		vertexScore[v] = VertexScore(-1, remaining[v]);
+
+	std::vector<float> triScore(triCount);
+	std::vector<std::uint8_t> emitted(triCount, 0);
+
+	uint32 bestTri = 0;
+	for(uint32 t = 0; t < triCount; ++t)
+	{
+		triScore[t] = vertexScore[indices[t*3+0]] + vertexScore[indices[t*3+1]] + vertexScore[indices[t*3+2]];
+		if(triScore[t] > triScore[bestTri])
+			bestTri = t;
+	}
+
+	std::vector<uint32> output;
+	output.reserve(indexCount);
+
+	uint32 cache[ScoreCacheSize + 3];
+	int cacheCount = 0;
+	uint32 scanCursor = 0;
+
+	for(uint32 n = 0; n < triCount; ++n)
+	{
+		// Nothing in the cache has triangles left; continue with the next unused one.
+		if(bestTri == ~0u)
+		{
+			while(emitted[scanCursor])
+				scanCursor++;
+			bestTri = scanCursor;
+		}
+
+		const uint32* tri = &indices[bestTri * 3];
+		output.insert(output.end(), tri, tri + 3);
+		emitted[bestTri] = 1;
+
+		// Take the triangle off its vertices' remaining lists.
+		for(int k = 0; k < 3; ++k)
+		{
+			uint32 v = tri[k];
+			uint32* list = &adjacency[offsets[v]];
+			for(uint32 j = 0; j < remaining[v]; ++j)
+			{
+				if(list[j] == bestTri)
+				{
+					std::swap(list[j], list[remaining[v] - 1]);
+					remaining[v]--;
+					break;
+				}
+			}
+		}
+
+		// The triangle's vertices move to the front of the LRU cache.
+		uint32 newCache[ScoreCacheSize + 3];
+		int newCount = 0;
+		for(int k = 0; k < 3; ++k)
+		{
+			if(std::find(newCache, newCache + newCount, tri[k]) == newCache + newCount)
+				newCache[newCount++] = tri[k];
+		}
+		for(int i = 0; i < cacheCount; ++i)
+		{
+			if(cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2])
+				newCache[newCount++] = cache[i];
+		}
+
+		// Rescore every vertex that moved, including the ones pushed out.
+		for(int i = 0; i < newCount; ++i)
+		{
+			uint32 v = newCache[i];
+			cachePosition[v] = i < ScoreCacheSize ? i : -1;
+			vertexScore[v] = VertexScore(cachePosition[v], remaining[v]);
+		}
+
+		// Clamped as size_t so the copy's bound is visible to the compiler.
+		const size_t keep = std::min<size_t>((size_t)newCount, ScoreCacheSize);
+		std::copy(newCache, newCache + keep, cache);
+		cacheCount = (int)keep;
+
+		// Rescore the triangles touching the cache and pick the best one.
+		bestTri = ~0u;
+		float bestScore = -1.0f;
+		for(int i = 0; i < newCount; ++i)
+		{
+			uint32 v = newCache[i];
+			const uint32* list = &adjacency[offsets[v]];
+			for(uint32 j = 0; j < remaining[v]; ++j)
+			{
+				uint32 t = list[j];
+				triScore[t] = vertexScore[indices[t*3+0]] + vertexScore[indices[t*3+1]] + vertexScore[indices[t*3+2]];
+
+				if(i < cacheCount && triScore[t] > bestScore)
+				{
+					bestScore = triScore[t];
+					bestTri = t;
+				}
+			}
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+MeshOptimizer::uint32 MeshOptimizer::BuildVertexFetchRemap(uint32* indices, size_t indexCount,
+	uint32 vertexCount, std::vector<uint32>& remap)
+{
+	remap.assign(vertexCount, ~0u);
+
+	uint32 next = 0;
+	for(size_t i = 0; i < indexCount; ++i)
+	{
+		uint32& r = remap[indices[i]];
+		if(r == ~0u)
+			r = next++;
+
+		indices[i] = r;
+	}
+
+	return next;
+}
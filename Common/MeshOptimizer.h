@@ -0,0 +1,92 @@
+//***************************************************************************************
+// MeshOptimizer.h
+//
+// Reorders indexed triangle lists for the GPU:
+//
+//   1. OptimizeVertexCache reorders triangles with Forsyth's linear-speed vertex
+//      cache algorithm so consecutive triangles reuse recently transformed vertices.
+//   2. OptimizeVertexFetch renumbers vertices in first-use order so vertex fetches
+//      walk memory mostly forward.  Unreferenced vertices are dropped.
+//
+// AnalyzeVertexCache simulates a FIFO post-transform cache and reports ACMR (cache
+// misses per triangle) and ATVR (misses per referenced vertex; 1.0 is optimal).
+//
+// CPU only; works on any vertex type and vector allocator, e.g.
+// GeometryGenerator::MeshData's std::pmr vectors or loaded model data.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct VertexCacheStats
+{
+	float Acmr = 0.0f;
+	float Atvr = 0.0f;
+};
+
+struct MeshOptimizeReport
+{
+	VertexCacheStats Before;
+	VertexCacheStats After;
+};
+
+class MeshOptimizer
+{
+public:
+	using uint32 = std::uint32_t;
+
+	static VertexCacheStats AnalyzeVertexCache(const uint32* indices, size_t indexCount,
+		uint32 vertexCount, uint32 cacheSize = 16);
+
+	static void OptimizeVertexCache(uint32* indices, size_t indexCount, uint32 vertexCount);
+
+	///<summary>
+	/// Rewrites indices to first-use order and fills remap[old] = new (or ~0u for
+	/// unreferenced vertices).  Returns the number of referenced vertices.
+	///</summary>
+	static uint32 BuildVertexFetchRemap(uint32* indices, size_t indexCount,
+		uint32 vertexCount, std::vector<uint32>& remap);
+
+	template<typename TVertex, typename TVertexAlloc, typename TIndexAlloc>
+	static void OptimizeVertexFetch(std::vector<TVertex, TVertexAlloc>& vertices, std::vector<uint32, TIndexAlloc>& indices)
+	{
+		std::vector<uint32> remap;
+		uint32 used = BuildVertexFetchRemap(indices.data(), indices.size(), (uint32)vertices.size(), remap);
+
+		// Same allocator as the input, so the swap below is valid for std::pmr vectors too.
+		std::vector<TVertex, TVertexAlloc> reordered(used, vertices.get_allocator());
+		for(uint32 v = 0; v < (uint32)vertices.size(); ++v)
+		{
+			if(remap[v] != ~0u)
+				reordered[remap[v]] = vertices[v];
+		}
+
+		vertices.swap(reordered);
+	}
+
+	///<summary>
+	/// Runs both passes and reports the cache behavior before and after.  Input that
+	/// is already well ordered (some exporters optimize on write) keeps its triangle
+	/// order if the reordering would not lower its ACMR.
+	///</summary>
+	template<typename TVertex, typename TVertexAlloc, typename TIndexAlloc>
+	static MeshOptimizeReport Optimize(std::vector<TVertex, TVertexAlloc>& vertices, std::vector<uint32, TIndexAlloc>& indices)
+	{
+		MeshOptimizeReport report;
+		report.Before = AnalyzeVertexCache(indices.data(), indices.size(), (uint32)vertices.size());
+
+		std::vector<uint32, TIndexAlloc> original(indices.begin(), indices.end(), indices.get_allocator());
+		OptimizeVertexCache(indices.data(), indices.size(), (uint32)vertices.size());
+
+		if(AnalyzeVertexCache(indices.data(), indices.size(), (uint32)vertices.size()).Acmr >= report.Before.Acmr)
+			indices.swap(original);
+
+		OptimizeVertexFetch(vertices, indices);
+
+		report.After = AnalyzeVertexCache(indices.data(), indices.size(), (uint32)vertices.size());
+		return report;
+	}
+};
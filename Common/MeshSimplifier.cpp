@@ -0,0 +1,575 @@
+//***************************************************************************************
+// MeshSimplifier.cpp
+//***************************************************************************************
+
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+using namespace DirectX;
+
+namespace
+{
+	using uint32 = std::uint32_t;
+
+	// Symmetric 4x4 quadric, with the accumulated plane area as weight.
+	struct Quadric
+	{
+		double A00 = 0, A01 = 0, A02 = 0, A11 = 0, A12 = 0, A22 = 0;
+		double B0 = 0, B1 = 0, B2 = 0;
+		double C = 0;
+		double Weight = 0;
+
+		void AddPlane(double a, double b, double c, double d, double w)
+		{
+			A00 += w * a * a; A01 += w * a * b; A02 += w * a * c;
+			A11 += w * b * b; A12 += w * b * c; A22 += w * c * c;
+			B0 += w * a * d; B1 += w * b * d; B2 += w * c * d;
+			C += w * d * d;
+			Weight += w;
+		}
+
+		void Add(const Quadric& q)
+		{
+			A00 += q.A00; A01 += q.A01; A02 += q.A02;
+			A11 += q.A11; A12 += q.A12; A22 += q.A22;
+			B0 += q.B0; B1 += q.B1; B2 += q.B2;
+			C += q.C;
+			Weight += q.Weight;
+		}
+
+		// Weighted sum of squared plane distances at p.
+		double Evaluate(const XMFLOAT3& p)const
+		{
+			double x = p.x, y = p.y, z = p.z;
+			double r = x * (A00 * x + A01 * y + A02 * z) +
+				y * (A01 * x + A11 * y + A12 * z) +
+				z * (A02 * x + A12 * y + A22 * z) +
+				2.0 * (B0 * x + B1 * y + B2 * z) + C;
+			return std::max(r, 0.0);
+		}
+	};
+
+	struct Collapse
+	{
+		uint32 From;
+		uint32 To;
+		float Error;	// squared, normalized by weight
+	};
+
+	const XMFLOAT3& PositionAt(const XMFLOAT3* positions, uint32 stride, uint32 i)
+	{
+		return *reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const std::uint8_t*>(positions) + (size_t)i * stride);
+	}
+
+	XMFLOAT3 TriangleNormal(const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2)
+	{
+		float ax = p1.x - p0.x, ay = p1.y - p0.y, az = p1.z - p0.z;
+		float bx = p2.x - p0.x, by = p2.y - p0.y, bz = p2.z - p0.z;
+		return XMFLOAT3(ay * bz - az * by, az * bx - ax * bz, ax * by - ay * bx);
+	}
+
+	float Dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	XMFLOAT3 Sub(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+
+	// Closest point on a triangle (Ericson, Real-Time Collision Detection 5.1.5).
+	float PointTriangleDistance(const XMFLOAT3& p, const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c)
+	{
+		XMFLOAT3 ab = Sub(b, a), ac = Sub(c, a), ap = Sub(p, a);
+		XMFLOAT3 q;
+
+		float d1 = Dot(ab, ap), d2 = Dot(ac, ap);
+		XMFLOAT3 bp = Sub(p, b);
+		float d3 = Dot(ab, bp), d4 = Dot(ac, bp);
+		XMFLOAT3 cp = Sub(p, c);
+		float d5 = Dot(ab, cp), d6 = Dot(ac, cp);
+		float vc = d1 * d4 - d3 * d2;
+		float vb = d5 * d2 - d1 * d6;
+		float va = d3 * d6 - d5 * d4;
+
+		if(d1 <= 0.0f && d2 <= 0.0f)
+			q = a;
+		else if(d3 >= 0.0f && d4 <= d3)
+			q = b;
+		else if(d6 >= 0.0f && d5 <= d6)
+			q = c;
+		else if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+		{
+			float t = d1 / (d1 - d3);
+			q = XMFLOAT3(a.x + ab.x * t, a.y + ab.y * t, a.z + ab.z * t);
+		}
+		else if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+		{
+			float t = d2 / (d2 - d6);
+			q = XMFLOAT3(a.x + ac.x * t, a.y + ac.y * t, a.z + ac.z * t);
+		}
+		else if(va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+		{
+			float t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			q = XMFLOAT3(b.x + (c.x - b.x) * t, b.y + (c.y - b.y) * t, b.z + (c.z - b.z) * t);
+		}
+		else
+		{
+			float denom = va + vb + vc;
+			if(denom == 0.0f)
+				q = a;
+			else
+			{
+				float v = vb / denom, w = vc / denom;
+				q = XMFLOAT3(a.x + ab.x * v + ac.x * w, a.y + ab.y * v + ac.y * w, a.z + ab.z * v + ac.z * w);
+			}
+		}
+
+		XMFLOAT3 d = Sub(p, q);
+		return std::sqrt(Dot(d, d));
+	}
+
+	// Vertices sharing a position get the same canonical id, so seams do not look
+	// like borders.
+	std::vector<uint32> WeldPositions(const XMFLOAT3* positions, uint32 stride, uint32 vertexCount)
+	{
+		std::vector<uint32> order(vertexCount);
+		std::iota(order.begin(), order.end(), 0u);
+
+		auto less = [&](uint32 a, uint32 b)
+		{
+			const XMFLOAT3& pa = PositionAt(positions, stride, a);
+			const XMFLOAT3& pb = PositionAt(positions, stride, b);
+			if(pa.x != pb.x) return pa.x < pb.x;
+			if(pa.y != pb.y) return pa.y < pb.y;
+			if(pa.z != pb.z) return pa.z < pb.z;
+			return a < b;
+		};
+		std::sort(order.begin(), order.end(), less);
+
+		std::vector<uint32> canonical(vertexCount);
+		for(uint32 i = 0; i < vertexCount; ++i)
+		{
+			uint32 v = order[i];
+			if(i > 0)
+			{
+				const XMFLOAT3& p = PositionAt(positions, stride, v);
+				const XMFLOAT3& q = PositionAt(positions, stride, order[i - 1]);
+				if(p.x == q.x && p.y == q.y && p.z == q.z)
+				{
+					canonical[v] = canonical[order[i - 1]];
+					continue;
+				}
+			}
+			canonical[v] = v;
+		}
+
+		return canonical;
+	}
+
+	// Marks vertices that may move: not on a seam and not on an open border.
+	std::vector<std::uint8_t> FindMovableVertices(const std::vector<uint32>& canonical,
+		const uint32* indices, size_t indexCount, uint32 vertexCount)
+	{
+		std::vector<std::uint8_t> movable(vertexCount, 1);
+
+		// Seams: more than one vertex per position.
+		std::vector<uint32> wedges(vertexCount, 0);
+		for(uint32 v = 0; v < vertexCount; ++v)
+			wedges[canonical[v]]++;
+		for(uint32 v = 0; v < vertexCount; ++v)
+		{
+			if(wedges[canonical[v]] > 1)
+				movable[v] = 0;
+		}
+
+		// Borders: welded edges used by a single triangle.  Each undirected edge is
+		// sorted and counted after sorting the list.
+		std::vector<std::uint64_t> edges;
+		edges.reserve(indexCount);
+		for(size_t t = 0; t + 2 < indexCount; t += 3)
+		{
+			for(int k = 0; k < 3; ++k)
+			{
+				uint32 a = canonical[indices[t + k]];
+				uint32 b = canonical[indices[t + (k + 1) % 3]];
+				if(a > b)
+					std::swap(a, b);
+				edges.push_back(((std::uint64_t)a << 32) | b);
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+
+		std::vector<std::uint8_t> onBorder(vertexCount, 0);
+		for(size_t i = 0; i < edges.size(); )
+		{
+			size_t j = i + 1;
+			while(j < edges.size() && edges[j] == edges[i])
+				j++;
+
+			if(j - i == 1)
+			{
+				onBorder[(uint32)(edges[i] >> 32)] = 1;
+				onBorder[(uint32)edges[i]] = 1;
+			}
+			i = j;
+		}
+
+		for(uint32 v = 0; v < vertexCount; ++v)
+		{
+			if(onBorder[canonical[v]])
+				movable[v] = 0;
+		}
+
+		return movable;
+	}
+}
+
+namespace
+{
+	// Simplification state kept between targets, so a LOD chain is one progressive
+	// run instead of one run per level.
+	class Simplification
+	{
+	public:
+		Simplification(const XMFLOAT3* positions, uint32 positionStride, uint32 vertexCount,
+			const uint32* indices, size_t indexCount);
+
+		void Run(size_t targetIndexCount, float maxError);
+
+		const std::vector<uint32>& Indices()const { return mIndices; }
+		float QuadricError()const { return (float)std::sqrt(mQuadricErrorSq); }
+		float MeasureError();
+
+	private:
+		bool CollapsePass(size_t targetIndexCount, double maxErrorSq);
+		const XMFLOAT3& Position(uint32 i)const { return PositionAt(mPositions, mStride, i); }
+
+	private:
+		const XMFLOAT3* mPositions;
+		uint32 mStride;
+		uint32 mVertexCount;
+
+		std::vector<uint32> mIndices;
+		std::vector<std::uint8_t> mMovable;
+		std::vector<Quadric> mQuadrics;
+
+		double mQuadricErrorSq = 0.0;
+
+		// Vertex each original vertex has been collapsed into.
+		std::vector<uint32> mRepresentative;
+
+		// Per-pass scratch.
+		std::vector<uint32> mAdjacencyOffsets;
+		std::vector<uint32> mAdjacency;
+		std::vector<uint32> mCursor;
+		std::vector<Collapse> mCollapses;
+		std::vector<uint32> mRemap;
+		std::vector<std::uint8_t> mLocked;
+	};
+
+	Simplification::Simplification(const XMFLOAT3* positions, uint32 positionStride, uint32 vertexCount,
+		const uint32* indices, size_t indexCount) :
+		mPositions(positions),
+		mStride(positionStride),
+		mVertexCount(vertexCount),
+		mIndices(indices, indices + indexCount - indexCount % 3),
+		mQuadrics(vertexCount),
+		mRepresentative(vertexCount),
+		mRemap(vertexCount),
+		mLocked(vertexCount)
+	{
+		std::iota(mRepresentative.begin(), mRepresentative.end(), 0u);
+
+		std::vector<uint32> canonical = WeldPositions(positions, positionStride, vertexCount);
+		mMovable = FindMovableVertices(canonical, mIndices.data(), mIndices.size(), vertexCount);
+
+		// Each vertex starts with the planes of its triangles, weighted by area.
+		for(size_t t = 0; t < mIndices.size(); t += 3)
+		{
+			const XMFLOAT3& p0 = Position(mIndices[t + 0]);
+			const XMFLOAT3& p1 = Position(mIndices[t + 1]);
+			const XMFLOAT3& p2 = Position(mIndices[t + 2]);
+
+			XMFLOAT3 n = TriangleNormal(p0, p1, p2);
+			double length = std::sqrt((double)n.x * n.x + (double)n.y * n.y + (double)n.z * n.z);
+			if(length <= 0.0)
+				continue;
+
+			double a = n.x / length, b = n.y / length, c = n.z / length;
+			double d = -(a * p0.x + b * p0.y + c * p0.z);
+			double area = 0.5 * length;
+
+			for(int k = 0; k < 3; ++k)
+				mQuadrics[mIndices[t + k]].AddPlane(a, b, c, d, area);
+		}
+	}
+
+	void Simplification::Run(size_t targetIndexCount, float maxError)
+	{
+		const double maxErrorSq = (double)maxError * maxError;
+		while(mIndices.size() > targetIndexCount && CollapsePass(targetIndexCount, maxErrorSq))
+		{
+		}
+	}
+
+	bool Simplification::CollapsePass(size_t targetIndexCount, double maxErrorSq)
+	{
+		// Triangles around each vertex.
+		mAdjacencyOffsets.assign(mVertexCount + 1, 0);
+		for(uint32 i : mIndices)
+			mAdjacencyOffsets[i + 1]++;
+		for(uint32 v = 0; v < mVertexCount; ++v)
+			mAdjacencyOffsets[v + 1] += mAdjacencyOffsets[v];
+
+		mAdjacency.resize(mIndices.size());
+		mCursor.assign(mAdjacencyOffsets.begin(), mAdjacencyOffsets.end() - 1);
+		for(size_t i = 0; i < mIndices.size(); ++i)
+			mAdjacency[mCursor[mIndices[i]]++] = (uint32)(i / 3);
+
+		// Candidate collapses, one per directed triangle edge.  Movable vertices are
+		// interior, so the opposite direction comes from the neighbouring triangle.
+		mCollapses.clear();
+		for(size_t t = 0; t < mIndices.size(); t += 3)
+		{
+			for(int k = 0; k < 3; ++k)
+			{
+				uint32 a = mIndices[t + k];
+				uint32 b = mIndices[t + (k + 1) % 3];
+				if(!mMovable[a])
+					continue;
+
+				Quadric q = mQuadrics[a];
+				q.Add(mQuadrics[b]);
+				double error = q.Weight > 0.0 ? q.Evaluate(Position(b)) / q.Weight : 0.0;
+				mCollapses.push_back({ a, b, (float)error });
+			}
+		}
+
+		std::sort(mCollapses.begin(), mCollapses.end(),
+			[](const Collapse& x, const Collapse& y) { return x.Error < y.Error; });
+
+		std::iota(mRemap.begin(), mRemap.end(), 0u);
+		std::fill(mLocked.begin(), mLocked.end(), (std::uint8_t)0);
+
+		size_t triangleCount = mIndices.size() / 3;
+		const size_t targetTriangles = targetIndexCount / 3;
+
+		// Only take the cheaper half of the remaining work per pass so later passes
+		// see the merged quadrics.
+		const size_t passLimit = (triangleCount - targetTriangles) / 2 + 1;
+		size_t removed = 0;
+		bool anyCollapsed = false;
+
+		for(const Collapse& collapse : mCollapses)
+		{
+			if(triangleCount <= targetTriangles || removed >= passLimit)
+				break;
+			if(collapse.Error > maxErrorSq)
+				break;
+
+			uint32 from = collapse.From;
+			uint32 to = collapse.To;
+			if(mLocked[from] || mLocked[to])
+				continue;
+
+			// Reject collapses that would flip a surviving triangle around from.
+			const XMFLOAT3& target = Position(to);
+			bool flips = false;
+			size_t collapsedTriangles = 0;
+			for(uint32 a = mAdjacencyOffsets[from]; a < mAdjacencyOffsets[from + 1] && !flips; ++a)
+			{
+				const uint32* tri = &mIndices[mAdjacency[a] * 3];
+				uint32 v[3] = { mRemap[tri[0]], mRemap[tri[1]], mRemap[tri[2]] };
+
+				if(v[0] == to || v[1] == to || v[2] == to)
+				{
+					collapsedTriangles++;
+					continue;
+				}
+
+				XMFLOAT3 p[3] = { Position(v[0]), Position(v[1]), Position(v[2]) };
+				XMFLOAT3 before = TriangleNormal(p[0], p[1], p[2]);
+
+				for(int k = 0; k < 3; ++k)
+				{
+					if(v[k] == from)
+						p[k] = target;
+				}
+				XMFLOAT3 after = TriangleNormal(p[0], p[1], p[2]);
+
+				flips = before.x * after.x + before.y * after.y + before.z * after.z <= 0.0f;
+			}
+
+			if(flips)
+				continue;
+
+			mRemap[from] = to;
+			mQuadrics[to].Add(mQuadrics[from]);
+			mLocked[from] = 1;
+			mLocked[to] = 1;
+
+			mQuadricErrorSq = std::max(mQuadricErrorSq, (double)collapse.Error);
+			triangleCount -= collapsedTriangles;
+			removed += collapsedTriangles;
+			anyCollapsed = true;
+		}
+
+		if(!anyCollapsed)
+			return false;
+
+		for(uint32& r : mRepresentative)
+			r = mRemap[r];
+
+		// Apply the collapses and drop the triangles that became degenerate.
+		size_t write = 0;
+		for(size_t t = 0; t < mIndices.size(); t += 3)
+		{
+			uint32 a = mRemap[mIndices[t + 0]];
+			uint32 b = mRemap[mIndices[t + 1]];
+			uint32 c = mRemap[mIndices[t + 2]];
+			if(a == b || b == c || c == a)
+				continue;
+
+			mIndices[write++] = a;
+			mIndices[write++] = b;
+			mIndices[write++] = c;
+		}
+		mIndices.resize(write);
+
+		return true;
+	}
+
+	float Simplification::MeasureError()
+	{
+		// Distance from every original vertex to the simplified surface.  The
+		// triangles around the vertex it was collapsed into give an upper bound, which
+		// is then used as the search radius in a uniform grid of the triangles.
+		mAdjacencyOffsets.assign(mVertexCount + 1, 0);
+		for(uint32 i : mIndices)
+			mAdjacencyOffsets[i + 1]++;
+		for(uint32 v = 0; v < mVertexCount; ++v)
+			mAdjacencyOffsets[v + 1] += mAdjacencyOffsets[v];
+
+		mAdjacency.resize(mIndices.size());
+		mCursor.assign(mAdjacencyOffsets.begin(), mAdjacencyOffsets.end() - 1);
+		for(size_t i = 0; i < mIndices.size(); ++i)
+			mAdjacency[mCursor[mIndices[i]]++] = (uint32)(i / 3);
+
+		const size_t triangleCount = mIndices.size() / 3;
+		if(triangleCount == 0)
+			return 0.0f;
+
+		// Cell size from the average edge length keeps a few triangles per cell.
+		double edgeSum = 0.0;
+		for(size_t t = 0; t < triangleCount; ++t)
+		{
+			XMFLOAT3 e = Sub(Position(mIndices[t * 3 + 1]), Position(mIndices[t * 3]));
+			edgeSum += std::sqrt(Dot(e, e));
+		}
+		const float cellSize = std::max((float)(edgeSum / triangleCount), 1e-6f);
+
+		auto cellOf = [cellSize](float x) { return (std::int32_t)std::floor(x / cellSize); };
+		auto cellKey = [](std::int32_t x, std::int32_t y, std::int32_t z)
+		{
+			return ((std::uint64_t)(x & 0x1fffff) << 42) | ((std::uint64_t)(y & 0x1fffff) << 21) | (std::uint64_t)(z & 0x1fffff);
+		};
+
+		std::vector<std::pair<std::uint64_t, uint32>> cells;
+		for(size_t t = 0; t < triangleCount; ++t)
+		{
+			const XMFLOAT3& p0 = Position(mIndices[t * 3 + 0]);
+			const XMFLOAT3& p1 = Position(mIndices[t * 3 + 1]);
+			const XMFLOAT3& p2 = Position(mIndices[t * 3 + 2]);
+
+			std::int32_t x0 = cellOf(std::min(p0.x, std::min(p1.x, p2.x))), x1 = cellOf(std::max(p0.x, std::max(p1.x, p2.x)));
+			std::int32_t y0 = cellOf(std::min(p0.y, std::min(p1.y, p2.y))), y1 = cellOf(std::max(p0.y, std::max(p1.y, p2.y)));
+			std::int32_t z0 = cellOf(std::min(p0.z, std::min(p1.z, p2.z))), z1 = cellOf(std::max(p0.z, std::max(p1.z, p2.z)));
+
+			for(std::int32_t x = x0; x <= x1; ++x)
+				for(std::int32_t y = y0; y <= y1; ++y)
+					for(std::int32_t z = z0; z <= z1; ++z)
+						cells.push_back(std::make_pair(cellKey(x, y, z), (uint32)t));
+		}
+		std::sort(cells.begin(), cells.end());
+
+		float error = 0.0f;
+		for(uint32 v = 0; v < mVertexCount; ++v)
+		{
+			uint32 r = mRepresentative[v];
+			if(r == v || mAdjacencyOffsets[r] == mAdjacencyOffsets[r + 1])
+				continue;
+
+			const XMFLOAT3& p = Position(v);
+
+			float nearest = FLT_MAX;
+			for(uint32 a = mAdjacencyOffsets[r]; a < mAdjacencyOffsets[r + 1]; ++a)
+			{
+				const uint32* tri = &mIndices[mAdjacency[a] * 3];
+				nearest = std::min(nearest, PointTriangleDistance(p, Position(tri[0]), Position(tri[1]), Position(tri[2])));
+			}
+
+			// Anything closer lies in the cells within the current bound.
+			if(nearest > error)
+			{
+				std::int32_t x0 = cellOf(p.x - nearest), x1 = cellOf(p.x + nearest);
+				std::int32_t y0 = cellOf(p.y - nearest), y1 = cellOf(p.y + nearest);
+				std::int32_t z0 = cellOf(p.z - nearest), z1 = cellOf(p.z + nearest);
+
+				for(std::int32_t x = x0; x <= x1 && nearest > error; ++x)
+					for(std::int32_t y = y0; y <= y1 && nearest > error; ++y)
+						for(std::int32_t z = z0; z <= z1 && nearest > error; ++z)
+						{
+							auto it = std::lower_bound(cells.begin(), cells.end(), std::make_pair(cellKey(x, y, z), 0u));
+							for(; it != cells.end() && it->first == cellKey(x, y, z); ++it)
+							{
+								const uint32* tri = &mIndices[it->second * 3];
+								nearest = std::min(nearest, PointTriangleDistance(p, Position(tri[0]), Position(tri[1]), Position(tri[2])));
+							}
+						}
+			}
+
+			error = std::max(error, nearest);
+		}
+
+		return error;
+	}
+}
+
+float MeshSimplifier::Simplify(const XMFLOAT3* positions, uint32 positionStride,
+	uint32 vertexCount, const uint32* indices, size_t indexCount,
+	size_t targetIndexCount, float maxError, std::vector<uint32>& result)
+{
+	Simplification simplification(positions, positionStride, vertexCount, indices, indexCount);
+	simplification.Run(targetIndexCount, maxError);
+
+	result = simplification.Indices();
+	return simplification.MeasureError();
+}
+
+std::vector<MeshLod> MeshSimplifier::BuildLodChain(const XMFLOAT3* positions, uint32 positionStride,
+	uint32 vertexCount, const uint32* indices, size_t indexCount,
+	uint32 maxLevels, float reduction)
+{
+	std::vector<MeshLod> lods;
+
+	// One progressive run; each level is a snapshot measured against the full mesh.
+	Simplification simplification(positions, positionStride, vertexCount, indices, indexCount);
+
+	size_t previousCount = indexCount;
+	for(uint32 level = 0; level < maxLevels; ++level)
+	{
+		simplification.Run((size_t)(previousCount * reduction) / 3 * 3, FLT_MAX);
+
+		const std::vector<uint32>& current = simplification.Indices();
+		if(current.size() > previousCount * 8 / 10)
+			break;
+
+		MeshLod lod;
+		lod.Indices = current;
+		lod.Error = simplification.MeasureError();
+		lods.push_back(std::move(lod));
+
+		previousCount = current.size();
+	}
+
+	return lods;
+}
@@ -0,0 +1,54 @@
+//***************************************************************************************
+// MeshSimplifier.h
+//
+// Quadric error metric mesh simplification (Garland & Heckbert) and LOD chains.
+//
+// Simplification only rewrites the index list: every collapse moves a vertex onto one
+// of its neighbours, so the result still indexes the original vertex array.  Run
+// MeshOptimizer::Optimize on the result to reorder it and drop unused vertices.
+//
+// Vertices on open borders and on attribute seams (several vertices sharing one
+// position, e.g. the hard edges of a box) are never moved, so the silhouette of open
+// meshes and the normals across seams are kept.
+//
+// Collapses are ordered by quadric error (area-weighted RMS distance to the merged
+// planes).  The reported error is measured on the result instead: the largest
+// distance, in mesh units, from an original vertex to the simplified surface.
+//***************************************************************************************
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct MeshLod
+{
+	std::vector<std::uint32_t> Indices;
+	float Error = 0.0f;
+};
+
+class MeshSimplifier
+{
+public:
+	///<summary>
+	/// Collapses edges in order of increasing error until at most targetIndexCount
+	/// indices remain or the next collapse's quadric error would exceed maxError.  positions points at
+	/// the first vertex's position; consecutive positions are positionStride bytes
+	/// apart.  Returns the error of the result.
+	///</summary>
+	static float Simplify(const DirectX::XMFLOAT3* positions, std::uint32_t positionStride,
+		std::uint32_t vertexCount, const std::uint32_t* indices, size_t indexCount,
+		size_t targetIndexCount, float maxError, std::vector<std::uint32_t>& result);
+
+	///<summary>
+	/// Builds up to maxLevels simplified levels, each targeting reduction times the
+	/// previous level's triangle count.  The chain stops early once a level can no
+	/// longer get below 80% of the previous one (everything left is locked).  The
+	/// full-detail mesh itself is not included.
+	///</summary>
+	static std::vector<MeshLod> BuildLodChain(const DirectX::XMFLOAT3* positions, std::uint32_t positionStride,
+		std::uint32_t vertexCount, const std::uint32_t* indices, size_t indexCount,
+		std::uint32_t maxLevels = 3, float reduction = 0.5f);
+};
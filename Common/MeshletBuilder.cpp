@@ -0,0 +1,306 @@
+//***************************************************************************************
+// MeshletBuilder.cpp
+//***************************************************************************************
+
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+
+#include <DirectXCollision.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	const XMFLOAT3& PositionAt(const XMFLOAT3* positions, std::uint32_t stride, std::uint32_t i)
+	{
+		return *reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const std::uint8_t*>(positions) + (size_t)i * stride);
+	}
+
+	XMFLOAT3 Sub(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+	float Dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+	XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+
+	bool Normalize(XMFLOAT3& v)
+	{
+		float length = std::sqrt(Dot(v, v));
+		if(length <= 1e-12f)
+			return false;
+
+		v = XMFLOAT3(v.x / length, v.y / length, v.z / length);
+		return true;
+	}
+}
+
+std::vector<Meshlet> MeshletBuilder::Build(const XMFLOAT3* positions, std::uint32_t positionStride,
+	std::uint32_t vertexCount, std::uint32_t* indices, std::size_t indexCount,
+	std::uint32_t maxVertices, std::uint32_t maxTriangles)
+{
+	const std::uint32_t triangleCount = (std::uint32_t)(indexCount / 3);
+
+	// Triangles around each vertex, in compressed rows.
+	std::vector<std::uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for(std::uint32_t i = 0; i < triangleCount * 3; ++i)
+		adjacencyOffsets[indices[i] + 1]++;
+	for(std::uint32_t v = 0; v < vertexCount; ++v)
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+	std::vector<std::uint32_t> adjacency(triangleCount * 3);
+	std::vector<std::uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for(std::uint32_t i = 0; i < triangleCount * 3; ++i)
+		adjacency[cursor[indices[i]]++] = i / 3;
+
+	std::vector<XMFLOAT3> triangleNormals(triangleCount);
+	for(std::uint32_t t = 0; t < triangleCount; ++t)
+	{
+		const XMFLOAT3& p0 = PositionAt(positions, positionStride, indices[t * 3 + 0]);
+		const XMFLOAT3& p1 = PositionAt(positions, positionStride, indices[t * 3 + 1]);
+		const XMFLOAT3& p2 = PositionAt(positions, positionStride, indices[t * 3 + 2]);
+
+		XMFLOAT3 n = Cross(Sub(p1, p0), Sub(p2, p0));
+		if(!Normalize(n))
+			n = XMFLOAT3(0.0f, 0.0f, 0.0f);
+		triangleNormals[t] = n;
+	}
+
+	std::vector<Meshlet> meshlets;
+	std::vector<std::uint32_t> ordered;
+	ordered.reserve(indexCount);
+
+	std::vector<std::uint8_t> emitted(triangleCount, 0);
+
+	// Unemitted triangles left around each vertex.
+	std::vector<std::uint32_t> live(vertexCount);
+	for(std::uint32_t v = 0; v < vertexCount; ++v)
+		live[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+
+	// meshletOf stamps which meshlet a vertex was last added to.
+	std::vector<std::uint32_t> meshletOf(vertexCount, ~0u);
+	std::vector<std::uint32_t> meshletVertices;
+	std::vector<XMFLOAT3> scratch;
+
+	auto newVertexCount = [&](std::uint32_t t, std::uint32_t id)
+	{
+		const std::uint32_t* tri = &indices[t * 3];
+
+		std::uint32_t count = 0;
+		for(int k = 0; k < 3; ++k)
+		{
+			bool repeated = (k > 0 && tri[k] == tri[0]) || (k > 1 && tri[k] == tri[1]);
+			if(meshletOf[tri[k]] != id && !repeated)
+				count++;
+		}
+		return count;
+	};
+
+	std::uint32_t seed = 0;
+	while(true)
+	{
+		// Continue next to the previous meshlet where the fewest triangles are left,
+		// so the mesh is eaten from its borders instead of leaving isolated islands.
+		std::uint32_t start = ~0u;
+		std::uint32_t bestLive = ~0u;
+		for(std::uint32_t v : meshletVertices)
+		{
+			for(std::uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+			{
+				std::uint32_t t = adjacency[a];
+				if(emitted[t])
+					continue;
+
+				const std::uint32_t* tri = &indices[t * 3];
+				std::uint32_t l = live[tri[0]] + live[tri[1]] + live[tri[2]];
+				if(l < bestLive)
+				{
+					start = t;
+					bestLive = l;
+				}
+			}
+		}
+
+		if(start == ~0u)
+		{
+			while(seed < triangleCount && emitted[seed])
+				seed++;
+			if(seed == triangleCount)
+				break;
+			start = seed;
+		}
+
+		const std::uint32_t id = (std::uint32_t)meshlets.size();
+
+		Meshlet meshlet;
+		meshlet.StartIndex = (std::uint32_t)ordered.size();
+		meshletVertices.clear();
+
+		XMFLOAT3 normalSum(0.0f, 0.0f, 0.0f);
+		std::uint32_t next = start;
+
+		while(next != ~0u)
+		{
+			const std::uint32_t* tri = &indices[next * 3];
+			for(int k = 0; k < 3; ++k)
+			{
+				if(meshletOf[tri[k]] != id)
+				{
+					meshletOf[tri[k]] = id;
+					meshletVertices.push_back(tri[k]);
+				}
+				ordered.push_back(tri[k]);
+			}
+
+			emitted[next] = 1;
+			for(int k = 0; k < 3; ++k)
+				live[tri[k]]--;
+			meshlet.TriangleCount++;
+
+			const XMFLOAT3& n = triangleNormals[next];
+			normalSum = XMFLOAT3(normalSum.x + n.x, normalSum.y + n.y, normalSum.z + n.z);
+
+			if(meshlet.TriangleCount == maxTriangles)
+				break;
+
+			// Pick the neighbouring triangle that fits and adds the fewest vertices,
+			// then the one whose normal is closest to the meshlet's average.
+			XMFLOAT3 axis = normalSum;
+			Normalize(axis);
+
+			next = ~0u;
+			std::uint32_t bestNew = 4;
+			float bestDot = -2.0f;
+			for(std::uint32_t v : meshletVertices)
+			{
+				for(std::uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+				{
+					std::uint32_t t = adjacency[a];
+					if(emitted[t])
+						continue;
+
+					std::uint32_t added = newVertexCount(t, id);
+					if(meshletVertices.size() + added > maxVertices)
+						continue;
+
+					float d = Dot(triangleNormals[t], axis);
+					if(added < bestNew || (added == bestNew && d > bestDot))
+					{
+						next = t;
+						bestNew = added;
+						bestDot = d;
+					}
+				}
+			}
+
+			// No neighbour left (a small disconnected piece): keep filling with the
+			// next unused triangle in index order, which is usually nearby, as long
+			// as it roughly faces the same way.
+			if(next == ~0u)
+			{
+				while(seed < triangleCount && emitted[seed])
+					seed++;
+				if(seed < triangleCount && meshletVertices.size() + newVertexCount(seed, id) <= maxVertices &&
+					Dot(triangleNormals[seed], axis) > 0.5f)
+					next = seed;
+			}
+		}
+
+		meshlet.VertexCount = (std::uint32_t)meshletVertices.size();
+		OptimizeMeshletOrder(ordered.data() + meshlet.StartIndex, meshlet.TriangleCount * 3, meshletVertices);
+		ComputeBounds(meshlet, positions, positionStride, ordered.data() + meshlet.StartIndex, scratch);
+		meshlets.push_back(meshlet);
+	}
+
+	std::copy(ordered.begin(), ordered.end(), indices);
+	return meshlets;
+}
+
+void MeshletBuilder::OptimizeMeshletOrder(std::uint32_t* indices, std::uint32_t indexCount,
+	const std::vector<std::uint32_t>& meshletVertices)
+{
+	// Growth order follows the surface but not the post-transform cache; reorder the
+	// meshlet's triangles on indices local to the meshlet so the pass stays cheap.
+	std::uint32_t local[3 * MaxTriangles];
+	if(indexCount > 3 * MaxTriangles)
+		return;
+
+	for(std::uint32_t i = 0; i < indexCount; ++i)
+	{
+		auto it = std::find(meshletVertices.begin(), meshletVertices.end(), indices[i]);
+		local[i] = (std::uint32_t)(it - meshletVertices.begin());
+	}
+
+	MeshOptimizer::OptimizeVertexCache(local, indexCount, (std::uint32_t)meshletVertices.size());
+
+	for(std::uint32_t i = 0; i < indexCount; ++i)
+		indices[i] = meshletVertices[local[i]];
+}
+
+void MeshletBuilder::ComputeBounds(Meshlet& meshlet, const XMFLOAT3* positions, std::uint32_t positionStride,
+	const std::uint32_t* indices, std::vector<XMFLOAT3>& scratch)
+{
+	const std::uint32_t indexCount = meshlet.TriangleCount * 3;
+
+	scratch.clear();
+	for(std::uint32_t i = 0; i < indexCount; ++i)
+		scratch.push_back(PositionAt(positions, positionStride, indices[i]));
+
+	BoundingSphere sphere;
+	BoundingSphere::CreateFromPoints(sphere, scratch.size(), scratch.data(), sizeof(XMFLOAT3));
+	meshlet.Center = sphere.Center;
+	meshlet.Radius = sphere.Radius;
+
+	// Cone axis: the average of the unit triangle normals.  Degenerate triangles
+	// face nowhere and are skipped.
+	struct TrianglePlane
+	{
+		XMFLOAT3 Normal;
+		XMFLOAT3 Point;
+	};
+
+	std::vector<TrianglePlane> planes;
+	planes.reserve(meshlet.TriangleCount);
+
+	XMFLOAT3 axis(0.0f, 0.0f, 0.0f);
+	for(std::uint32_t i = 0; i < indexCount; i += 3)
+	{
+		XMFLOAT3 n = Cross(Sub(scratch[i + 1], scratch[i]), Sub(scratch[i + 2], scratch[i]));
+		if(!Normalize(n))
+			continue;
+
+		planes.push_back({ n, scratch[i] });
+		axis = XMFLOAT3(axis.x + n.x, axis.y + n.y, axis.z + n.z);
+	}
+
+	if(planes.empty() || !Normalize(axis))
+		return;
+
+	float minDot = 1.0f;
+	for(const TrianglePlane& plane : planes)
+		minDot = std::min(minDot, Dot(plane.Normal, axis));
+
+	// A cone wider than ~84 degrees almost never rejects anything; leave it disabled
+	// rather than placing the apex far away.
+	if(minDot <= 0.1f)
+		return;
+
+	// Move the apex back along the axis until it is behind every triangle's plane,
+	// so the test holds for an eye anywhere, not just far away.
+	float maxT = 0.0f;
+	for(const TrianglePlane& plane : planes)
+	{
+		float dc = Dot(Sub(meshlet.Center, plane.Point), plane.Normal);
+		float dn = Dot(axis, plane.Normal);
+		maxT = std::max(maxT, dc / dn);
+	}
+
+	meshlet.ConeAxis = axis;
+	meshlet.ConeApex = XMFLOAT3(
+		meshlet.Center.x - axis.x * maxT,
+		meshlet.Center.y - axis.y * maxT,
+		meshlet.Center.z - axis.z * maxT);
+	meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+}
@@ -0,0 +1,60 @@
+//***************************************************************************************
+// MeshletBuilder.h
+//
+// Splits an indexed triangle list into meshlets (clusters) of at most 64 vertices and
+// 124 triangles, and computes the data ClusterCuller needs to reject whole meshlets:
+// a bounding sphere and a normal cone.
+//
+// Each meshlet is grown greedily from a seed triangle: the next triangle is the
+// neighbour that adds the fewest new vertices, ties broken by how closely its normal
+// follows the meshlet's, which keeps the normal cones tight.  Seeds are taken in index
+// order, so a vertex cache optimized input (MeshOptimizer) stays mostly in order.  The
+// indices are rewritten so every meshlet is a contiguous range and can be drawn on
+// its own.
+//***************************************************************************************
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+struct Meshlet
+{
+	// Index range relative to the mesh's first index.
+	std::uint32_t StartIndex = 0;
+	std::uint32_t TriangleCount = 0;
+	std::uint32_t VertexCount = 0;
+
+	// Object-space bounding sphere.
+	DirectX::XMFLOAT3 Center = { 0.0f, 0.0f, 0.0f };
+	float Radius = 0.0f;
+
+	// Normal cone: every triangle faces away from an eye at e when
+	// dot(normalize(ConeApex - e), ConeAxis) >= ConeCutoff.  A cutoff above 1 means
+	// the normals spread too far for the cone to ever reject the meshlet.
+	DirectX::XMFLOAT3 ConeApex = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 ConeAxis = { 0.0f, 0.0f, 1.0f };
+	float ConeCutoff = 2.0f;
+};
+
+class MeshletBuilder
+{
+public:
+	static const std::uint32_t MaxVertices = 64;
+	static const std::uint32_t MaxTriangles = 124;
+
+	///<summary>
+	/// positions points at the first vertex's position; consecutive positions are
+	/// positionStride bytes apart.  indices is reordered in place to meshlet order.
+	///</summary>
+	static std::vector<Meshlet> Build(const DirectX::XMFLOAT3* positions, std::uint32_t positionStride,
+		std::uint32_t vertexCount, std::uint32_t* indices, std::size_t indexCount,
+		std::uint32_t maxVertices = MaxVertices, std::uint32_t maxTriangles = MaxTriangles);
+
+private:
+	static void OptimizeMeshletOrder(std::uint32_t* indices, std::uint32_t indexCount,
+		const std::vector<std::uint32_t>& meshletVertices);
+	static void ComputeBounds(Meshlet& meshlet, const DirectX::XMFLOAT3* positions, std::uint32_t positionStride,
+		const std::uint32_t* indices, std::vector<DirectX::XMFLOAT3>& scratch);
+};
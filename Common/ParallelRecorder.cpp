@@ -0,0 +1,74 @@
+//***************************************************************************************
+// ParallelRecorder.cpp
+//***************************************************************************************
+
+#include "ParallelRecorder.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+
+ParallelRecorder::ParallelRecorder(JobSystem* jobs) :
+	mJobs(jobs)
+{
+}
+
+void ParallelRecorder::Partition(const std::uint32_t* costs, std::uint32_t count, std::uint32_t maxRanges,
+	std::uint32_t minCostPerRange, std::vector<RecordRange>& ranges)
+{
+	ranges.clear();
+	if(count == 0)
+		return;
+
+	std::uint64_t total = 0;
+	for(std::uint32_t i = 0; i < count; ++i)
+		total += costs[i];
+
+	// As many ranges as the work supports, up to maxRanges.
+	std::uint64_t rangeCount = std::max(1u, maxRanges);
+	if(minCostPerRange > 0)
+		rangeCount = std::min(rangeCount, std::max<std::uint64_t>(1, total / minCostPerRange));
+	rangeCount = std::min<std::uint64_t>(rangeCount, count);
+
+	RecordRange range;
+	std::uint64_t running = 0;
+	for(std::uint32_t i = 0; i < count; ++i)
+	{
+		running += costs[i];
+
+		// Close the range once the running cost reaches its share of the total.
+		std::uint64_t closed = ranges.size() + 1;
+		if(closed < rangeCount && running * rangeCount >= total * closed)
+		{
+			range.End = i + 1;
+			ranges.push_back(range);
+			range.Begin = i + 1;
+		}
+	}
+
+	range.End = count;
+	if(range.End > range.Begin)
+		ranges.push_back(range);
+}
+
+void ParallelRecorder::Record(const std::vector<RecordRange>& ranges, CommandRecorder* const* recorders,
+	const std::function<void(std::uint32_t, const RecordRange&, CommandRecorder&)>& record)
+{
+	if(mJobs == nullptr || ranges.size() < 2)
+	{
+		for(std::uint32_t r = 0; r < (std::uint32_t)ranges.size(); ++r)
+			record(r, ranges[r], *recorders[r]);
+		return;
+	}
+
+	// One chunk per range; which thread takes a range does not change the output.
+	mJobs->ParallelFor((std::uint32_t)ranges.size(), 1, [&](std::uint32_t, std::uint32_t begin, std::uint32_t end)
+	{
+		for(std::uint32_t r = begin; r < end; ++r)
+			record(r, ranges[r], *recorders[r]);
+	});
+}
+
+std::uint32_t ParallelRecorder::ThreadCount()const
+{
+	return mJobs != nullptr ? mJobs->ThreadCount() : 1;
+}
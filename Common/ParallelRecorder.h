@@ -0,0 +1,62 @@
+//***************************************************************************************
+// ParallelRecorder.h
+//
+// Records one ordered draw stream on several threads.  Partition splits the stream
+// into contiguous ranges of about equal cost; Record then records every range into its
+// own CommandRecorder on the JobSystem.  Submitting the recorders in range order gives
+// the same sequence of draws as recording the stream on one thread, whichever thread
+// recorded which range.
+//
+// Each range starts a new command list, so the record callback has to bind all the
+// state its draws need; bound state does not carry over between ranges.  Ranges are
+// only split off when they have at least minCostPerRange of work, so a short stream
+// is not spread over lists that each cost more to set up than to fill.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class CommandRecorder;
+class JobSystem;
+
+struct RecordRange
+{
+	std::uint32_t Begin = 0;
+	std::uint32_t End = 0;
+};
+
+class ParallelRecorder
+{
+public:
+	///<summary>
+	/// Without a JobSystem every range is recorded on the calling thread.
+	///</summary>
+	explicit ParallelRecorder(JobSystem* jobs = nullptr);
+
+	///<summary>
+	/// Splits items [0, count) with the given per-item costs into at most maxRanges
+	/// contiguous ranges.  The range count is lowered until each range's equal share
+	/// of the total is at least minCostPerRange, and cuts fall where the running cost
+	/// crosses each share.
+	///</summary>
+	static void Partition(const std::uint32_t* costs, std::uint32_t count, std::uint32_t maxRanges,
+		std::uint32_t minCostPerRange, std::vector<RecordRange>& ranges);
+
+	///<summary>
+	/// Calls record(rangeIndex, range, *recorders[rangeIndex]) for every range, in
+	/// parallel, and returns when all have finished.
+	///</summary>
+	void Record(const std::vector<RecordRange>& ranges, CommandRecorder* const* recorders,
+		const std::function<void(std::uint32_t, const RecordRange&, CommandRecorder&)>& record);
+
+	///<summary>
+	/// Threads that can record at once, including the caller.
+	///</summary>
+	std::uint32_t ThreadCount()const;
+
+private:
+	JobSystem* mJobs = nullptr;
+};
@@ -0,0 +1,96 @@
+//***************************************************************************************
+// RenderQueue.cpp
+//***************************************************************************************
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+namespace
+{
+	std::uint64_t Field(std::uint32_t value, std::uint32_t bits)
+	{
+		return (std::uint64_t)value & ((1ull << bits) - 1);
+	}
+}
+
+std::uint64_t RenderSortKey::Make(std::uint32_t pipeline, std::uint32_t buffer, std::uint32_t geometry,
+	std::uint32_t material, std::uint32_t depthBucket)
+{
+	std::uint64_t key = Field(pipeline, PipelineBits);
+	key = key << BufferBits | Field(buffer, BufferBits);
+	key = key << GeometryBits | Field(geometry, GeometryBits);
+	key = key << MaterialBits | Field(material, MaterialBits);
+	key = key << DepthBits | Field(depthBucket, DepthBits);
+	return key;
+}
+
+std::uint32_t RenderSortKey::DepthBucket(float distance, float farDistance)
+{
+	const float maxBucket = (float)((1u << DepthBits) - 1);
+	if(!(farDistance > 0.0f) || !(distance > 0.0f))
+		return 0;
+
+	return (std::uint32_t)std::min(distance / farDistance * maxBucket, maxBucket);
+}
+
+void RenderQueue::Clear()
+{
+	mKeys.clear();
+	mItems.clear();
+	mStats = RenderQueueStats();
+}
+
+void RenderQueue::Push(std::uint64_t key, std::uint32_t item)
+{
+	mKeys.push_back(key);
+	mItems.push_back(item);
+}
+
+void RenderQueue::Sort()
+{
+	const size_t count = mKeys.size();
+	mStats.Items = (std::uint32_t)count;
+	mStats.SortPasses = 0;
+	if(count < 2)
+		return;
+
+	// All eight byte histograms in one pass over the keys.
+	std::uint32_t histograms[8][256] = {};
+	for(std::uint64_t key : mKeys)
+	{
+		for(int b = 0; b < 8; ++b)
+			histograms[b][(key >> (8 * b)) & 0xff]++;
+	}
+
+	mSortKeys.resize(count);
+	mSortItems.resize(count);
+
+	for(int b = 0; b < 8; ++b)
+	{
+		std::uint32_t* histogram = histograms[b];
+
+		// Every key has the same byte here; the pass would not move anything.
+		if(histogram[(mKeys[0] >> (8 * b)) & 0xff] == count)
+			continue;
+
+		std::uint32_t offset = 0;
+		for(int v = 0; v < 256; ++v)
+		{
+			std::uint32_t n = histogram[v];
+			histogram[v] = offset;
+			offset += n;
+		}
+
+		for(size_t i = 0; i < count; ++i)
+		{
+			std::uint32_t dst = histogram[(mKeys[i] >> (8 * b)) & 0xff]++;
+			mSortKeys[dst] = mKeys[i];
+			mSortItems[dst] = mItems[i];
+		}
+
+		mKeys.swap(mSortKeys);
+		mItems.swap(mSortItems);
+		mStats.SortPasses++;
+	}
+}
@@ -0,0 +1,80 @@
+//***************************************************************************************
+// RenderQueue.h
+//
+// Orders draw items by a 64-bit sort key so that items sharing state are submitted
+// back to back.  RenderSortKey packs, from the most significant bits down:
+//
+//   pipeline state (4) | vertex/index buffers (16) | geometry (16) | material (12) | depth (16)
+//
+// Only the pipeline state and the buffers bind anything: switching buffers costs two
+// views.  Geometry selects a range of the buffers and its topology, and material is an
+// index passed with the per-draw root constants, which are written for every group
+// anyway.  Material is therefore the least significant state; it only keeps groups
+// that read the same material data together.  The depth bucket is the item's view
+// distance quantized to 16 bits, so items that share all state are drawn front to
+// back.  Fields wider than their bits are masked.
+//
+// Sort is an LSD radix sort over the key bytes.  One pass builds all eight byte
+// histograms, and bytes that are the same for every key are skipped, so keys that
+// only use a few fields cost a few passes.  The sort is stable: items with equal keys
+// keep their push order.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct RenderSortKey
+{
+	static const std::uint32_t PipelineBits = 4;
+	static const std::uint32_t BufferBits = 16;
+	static const std::uint32_t GeometryBits = 16;
+	static const std::uint32_t MaterialBits = 12;
+	static const std::uint32_t DepthBits = 16;
+
+	static std::uint64_t Make(std::uint32_t pipeline, std::uint32_t buffer, std::uint32_t geometry,
+		std::uint32_t material, std::uint32_t depthBucket);
+
+	///<summary>
+	/// Quantizes a view distance in [0, farDistance] to a depth bucket; nearer is smaller.
+	///</summary>
+	static std::uint32_t DepthBucket(float distance, float farDistance);
+};
+
+struct RenderQueueStats
+{
+	std::uint32_t Items = 0;
+
+	// Radix passes that moved data; at most 8.
+	std::uint32_t SortPasses = 0;
+};
+
+class RenderQueue
+{
+public:
+	void Clear();
+	void Push(std::uint64_t key, std::uint32_t item);
+
+	void Sort();
+
+	std::uint32_t Size()const { return (std::uint32_t)mItems.size(); }
+
+	///<summary>
+	/// Items in key order after Sort, in push order before.
+	///</summary>
+	const std::vector<std::uint32_t>& Items()const { return mItems; }
+	const std::vector<std::uint64_t>& Keys()const { return mKeys; }
+
+	const RenderQueueStats& Stats()const { return mStats; }
+
+private:
+	std::vector<std::uint64_t> mKeys;
+	std::vector<std::uint32_t> mItems;
+
+	// Radix sort ping-pong buffers, kept between frames.
+	std::vector<std::uint64_t> mSortKeys;
+	std::vector<std::uint32_t> mSortItems;
+
+	RenderQueueStats mStats;
+};
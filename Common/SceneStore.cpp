@@ -0,0 +1,104 @@
+//***************************************************************************************
+// SceneStore.cpp
+//***************************************************************************************
+
+#include "SceneStore.h"
+
+using namespace DirectX;
+
+SceneStore::Handle SceneStore::Add(const XMFLOAT4X4& world,
+	const BoundingBox& localBounds, const BoundingSphere& localSphere,
+	std::uint32_t geometryId, std::uint32_t materialId)
+{
+	std::uint32_t slot;
+	if(!mFreeSlots.empty())
+	{
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else
+	{
+		slot = (std::uint32_t)mSlots.size();
+		mSlots.push_back(SlotEntry());
+	}
+
+	std::uint32_t index = Size();
+	mSlots[slot].Dense = index;
+
+	mWorld.push_back(world);
+	mLocalBounds.push_back(localBounds);
+	mWorldBounds.push_back(localBounds);
+	mLocalSpheres.push_back(localSphere);
+	mWorldSpheres.push_back(localSphere);
+	mGeometryIds.push_back(geometryId);
+	mMaterialIds.push_back(materialId);
+	mDenseToSlot.push_back(slot);
+
+	UpdateWorldBounds(index);
+
+	return { slot, mSlots[slot].Generation };
+}
+
+void SceneStore::Remove(Handle handle)
+{
+	if(!IsValid(handle))
+		return;
+
+	std::uint32_t index = mSlots[handle.Slot].Dense;
+	std::uint32_t last = Size() - 1;
+
+	if(index != last)
+	{
+		mWorld[index] = mWorld[last];
+		mLocalBounds[index] = mLocalBounds[last];
+		mWorldBounds[index] = mWorldBounds[last];
+		mLocalSpheres[index] = mLocalSpheres[last];
+		mWorldSpheres[index] = mWorldSpheres[last];
+		mGeometryIds[index] = mGeometryIds[last];
+		mMaterialIds[index] = mMaterialIds[last];
+		mDenseToSlot[index] = mDenseToSlot[last];
+
+		mSlots[mDenseToSlot[index]].Dense = index;
+	}
+
+	mWorld.pop_back();
+	mLocalBounds.pop_back();
+	mWorldBounds.pop_back();
+	mLocalSpheres.pop_back();
+	mWorldSpheres.pop_back();
+	mGeometryIds.pop_back();
+	mMaterialIds.pop_back();
+	mDenseToSlot.pop_back();
+
+	// Invalidate outstanding handles to this slot before reusing it.
+	mSlots[handle.Slot].Generation++;
+	mFreeSlots.push_back(handle.Slot);
+}
+
+bool SceneStore::IsValid(Handle handle)const
+{
+	return handle.Slot < mSlots.size() &&
+		mSlots[handle.Slot].Generation == handle.Generation &&
+		mSlots[handle.Slot].Dense < Size() &&
+		mDenseToSlot[mSlots[handle.Slot].Dense] == handle.Slot;
+}
+
+void SceneStore::SetWorld(Handle handle, const XMFLOAT4X4& world)
+{
+	std::uint32_t index = IndexOf(handle);
+	mWorld[index] = world;
+
+	UpdateWorldBounds(index);
+}
+
+void SceneStore::SetMaterial(Handle handle, std::uint32_t materialId)
+{
+	mMaterialIds[IndexOf(handle)] = materialId;
+}
+
+void SceneStore::UpdateWorldBounds(std::uint32_t index)
+{
+	XMMATRIX world = XMLoadFloat4x4(&mWorld[index]);
+	mLocalBounds[index].Transform(mWorldBounds[index], world);
+	mLocalSpheres[index].Transform(mWorldSpheres[index], world);
+}
@@ -0,0 +1,74 @@
+//***************************************************************************************
+// SceneStore.h
+//
+// Structure-of-arrays storage for per-object scene data.  World matrices, bounds,
+// geometry IDs and material IDs live in separate contiguous arrays so per-frame
+// passes (instance packing, culling) are linear sweeps instead of pointer chases.
+//
+// Objects are referenced through stable handles.  Removal swaps the last object into
+// the hole, so dense indices change but handles stay valid.
+//***************************************************************************************
+
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <cstdint>
+#include <vector>
+
+class SceneStore
+{
+public:
+	struct Handle
+	{
+		std::uint32_t Slot = ~0u;
+		std::uint32_t Generation = 0;
+	};
+
+	Handle Add(const DirectX::XMFLOAT4X4& world,
+		const DirectX::BoundingBox& localBounds, const DirectX::BoundingSphere& localSphere,
+		std::uint32_t geometryId, std::uint32_t materialId);
+	void Remove(Handle handle);
+
+	bool IsValid(Handle handle)const;
+
+	///<summary>
+	/// Current position of the object in the dense arrays.
+	///</summary>
+	std::uint32_t IndexOf(Handle handle)const { return mSlots[handle.Slot].Dense; }
+
+	void SetWorld(Handle handle, const DirectX::XMFLOAT4X4& world);
+	void SetMaterial(Handle handle, std::uint32_t materialId);
+
+	std::uint32_t Size()const { return (std::uint32_t)mWorld.size(); }
+
+	// Dense arrays, all Size() long.
+	const DirectX::XMFLOAT4X4* World()const { return mWorld.data(); }
+	const DirectX::BoundingBox* WorldBounds()const { return mWorldBounds.data(); }
+	const DirectX::BoundingSphere* WorldSpheres()const { return mWorldSpheres.data(); }
+	const std::uint32_t* GeometryIds()const { return mGeometryIds.data(); }
+	const std::uint32_t* MaterialIds()const { return mMaterialIds.data(); }
+	Handle HandleAt(std::uint32_t index)const { return { mDenseToSlot[index], mSlots[mDenseToSlot[index]].Generation }; }
+
+private:
+	void UpdateWorldBounds(std::uint32_t index);
+
+private:
+	std::vector<DirectX::XMFLOAT4X4> mWorld;
+	std::vector<DirectX::BoundingBox> mLocalBounds;
+	std::vector<DirectX::BoundingBox> mWorldBounds;
+	std::vector<DirectX::BoundingSphere> mLocalSpheres;
+	std::vector<DirectX::BoundingSphere> mWorldSpheres;
+	std::vector<std::uint32_t> mGeometryIds;
+	std::vector<std::uint32_t> mMaterialIds;
+	std::vector<std::uint32_t> mDenseToSlot;
+
+	struct SlotEntry
+	{
+		std::uint32_t Dense = 0;
+		std::uint32_t Generation = 0;
+	};
+
+	std::vector<SlotEntry> mSlots;
+	std::vector<std::uint32_t> mFreeSlots;
+};
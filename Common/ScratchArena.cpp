@@ -0,0 +1,101 @@
+//***************************************************************************************
+// ScratchArena.cpp
+//***************************************************************************************
+
+#include "ScratchArena.h"
+
+#include <algorithm>
+
+namespace
+{
+	char* AlignUp(char* p, std::size_t alignment)
+	{
+		std::uintptr_t value = reinterpret_cast<std::uintptr_t>(p);
+		return p + ((alignment - (value & (alignment - 1))) & (alignment - 1));
+	}
+}
+
+ScratchArena::ScratchArena(std::size_t blockSize, std::pmr::memory_resource* upstream) :
+	mBlockSize(std::max(blockSize, (std::size_t)4096)),
+	mUpstream(upstream)
+{
+}
+
+ScratchArena::~ScratchArena()
+{
+	Reset();
+}
+
+void ScratchArena::Reset()
+{
+	while(mBlocks != nullptr)
+	{
+		Block* next = mBlocks->Next;
+		mUpstream->deallocate(mBlocks, mBlocks->ByteSize, alignof(std::max_align_t));
+		mBlocks = next;
+	}
+
+	mCursor = nullptr;
+	mEnd = nullptr;
+	mLast = nullptr;
+	mLastBegin = nullptr;
+
+	mStats.BytesInUse = 0;
+	mStats.ReservedBytes = 0;
+	mStats.Blocks = 0;
+	mStats.Resets++;
+}
+
+void* ScratchArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+	char* p = mCursor != nullptr ? AlignUp(mCursor, alignment) : nullptr;
+	if(p == nullptr || bytes > (std::size_t)(mEnd - p))
+	{
+		// The rest of the current block is abandoned; large requests get their own block.
+		AddBlock(bytes + alignment);
+		p = AlignUp(mCursor, alignment);
+	}
+
+	mStats.BytesInUse += (std::uint64_t)(p + bytes - mCursor);
+	mStats.PeakBytes = std::max(mStats.PeakBytes, mStats.BytesInUse);
+	mStats.Allocations++;
+
+	mLastBegin = mCursor;
+	mLast = p;
+	mCursor = p + bytes;
+	return p;
+}
+
+void ScratchArena::do_deallocate(void* p, std::size_t bytes, std::size_t /*alignment*/)
+{
+	mStats.Deallocations++;
+
+	// Only the newest allocation can be given back before Reset.  The cursor goes back
+	// to where it was before the allocation's padding, and the same bytes come off
+	// BytesInUse that do_allocate added.
+	if(p == mLast && (char*)p + bytes == mCursor)
+	{
+		mStats.BytesInUse -= (std::uint64_t)(mCursor - mLastBegin);
+		mCursor = mLastBegin;
+		mLast = nullptr;
+		mLastBegin = nullptr;
+	}
+}
+
+void ScratchArena::AddBlock(std::size_t minBytes)
+{
+	std::size_t byteSize = std::max(mBlockSize, minBytes + sizeof(Block));
+	Block* block = static_cast<Block*>(mUpstream->allocate(byteSize, alignof(std::max_align_t)));
+	block->Next = mBlocks;
+	block->ByteSize = byteSize;
+	mBlocks = block;
+
+	mCursor = reinterpret_cast<char*>(block + 1);
+	mEnd = reinterpret_cast<char*>(block) + byteSize;
+	mLast = nullptr;
+	mLastBegin = nullptr;
+
+	mStats.ReservedBytes += byteSize;
+	mStats.PeakReservedBytes = std::max(mStats.PeakReservedBytes, mStats.ReservedBytes);
+	mStats.Blocks++;
+}
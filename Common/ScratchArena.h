@@ -0,0 +1,85 @@
+//***************************************************************************************
+// ScratchArena.h
+//
+// Linear allocator for load-time scratch data (generated meshes, converted vertex and
+// index arrays, file buffers).  Allocations bump a cursor through large blocks taken
+// from an upstream resource; deallocation only rewinds the cursor when it frees the
+// most recent allocation, and Reset() returns every block at once.
+//
+// It is a std::pmr::memory_resource, so std::pmr containers such as
+// GeometryGenerator::MeshData and GeometryPacker's arrays can draw from it.  Anything
+// allocated from the arena must be destroyed before Reset().  Not thread-safe.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+struct ScratchArenaStats
+{
+	// Bytes handed out since the last Reset (including alignment padding), and the
+	// most that was ever in use at once.
+	std::uint64_t BytesInUse = 0;
+	std::uint64_t PeakBytes = 0;
+
+	// Bytes held in blocks from the upstream resource.
+	std::uint64_t ReservedBytes = 0;
+	std::uint64_t PeakReservedBytes = 0;
+
+	// Counted since construction.
+	std::uint64_t Allocations = 0;
+	std::uint64_t Deallocations = 0;
+	std::uint32_t Blocks = 0;
+	std::uint32_t Resets = 0;
+};
+
+class ScratchArena : public std::pmr::memory_resource
+{
+public:
+	///<summary>
+	/// Blocks are blockSize bytes; larger requests get a block of their own.
+	///</summary>
+	explicit ScratchArena(std::size_t blockSize = 1 << 20,
+		std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+	ScratchArena(const ScratchArena& rhs) = delete;
+	ScratchArena& operator=(const ScratchArena& rhs) = delete;
+	~ScratchArena();
+
+	///<summary>
+	/// Returns every block to the upstream resource.
+	///</summary>
+	void Reset();
+
+	const ScratchArenaStats& Stats()const { return mStats; }
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment)override;
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)override;
+	bool do_is_equal(const std::pmr::memory_resource& other)const noexcept override { return this == &other; }
+
+	void AddBlock(std::size_t minBytes);
+
+private:
+	// Blocks form a list through a header at the start of each block.
+	struct Block
+	{
+		Block* Next;
+		std::size_t ByteSize;
+	};
+
+	std::size_t mBlockSize = 0;
+	std::pmr::memory_resource* mUpstream = nullptr;
+
+	Block* mBlocks = nullptr;
+	char* mCursor = nullptr;
+	char* mEnd = nullptr;
+
+	// Start of the most recent allocation, and the cursor before it was aligned, so
+	// freeing it can rewind the cursor and its padding.
+	char* mLast = nullptr;
+	char* mLastBegin = nullptr;
+
+	ScratchArenaStats mStats;
+};
@@ -0,0 +1,73 @@
+//***************************************************************************************
+// StaticGeometryUploader.cpp
+//***************************************************************************************
+
+#include "StaticGeometryUploader.h"
+
+using Microsoft::WRL::ComPtr;
+
+StaticGeometryUploader::StaticGeometryUploader(ID3D12Device* device, UINT64 stagingByteSize, bool keepStaging) :
+	GeometryUploader(stagingByteSize, keepStaging),
+	md3dDevice(device)
+{
+}
+
+StaticGeometryUploader::~StaticGeometryUploader()
+{
+	if(mStaging != nullptr)
+		mStaging->Unmap(0, nullptr);
+}
+
+StaticBuffer StaticGeometryUploader::CreateBuffer(UINT64 byteSize)
+{
+	D3D12_HEAP_PROPERTIES heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(byteSize);
+
+	ComPtr<ID3D12Resource> resource;
+	ThrowIfFailed(md3dDevice->CreateCommittedResource(
+		&heapProperty,
+		D3D12_HEAP_FLAG_NONE,
+		&desc,
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(&resource)));
+
+	StaticBuffer buffer;
+	buffer.Resource = resource.Get();
+	buffer.GpuAddress = resource->GetGPUVirtualAddress();
+
+	mBuffers[resource.Get()] = resource;
+	return buffer;
+}
+
+void StaticGeometryUploader::ReleaseBuffer(const StaticBuffer& buffer)
+{
+	mBuffers.erase(buffer.Resource);
+}
+
+std::uint8_t* StaticGeometryUploader::CreateStaging(UINT64 byteSize, ID3D12Resource*& resource)
+{
+	D3D12_HEAP_PROPERTIES heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(byteSize);
+
+	ThrowIfFailed(md3dDevice->CreateCommittedResource(
+		&heapProperty,
+		D3D12_HEAP_FLAG_NONE,
+		&desc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&mStaging)));
+
+	std::uint8_t* mappedData = nullptr;
+	CD3DX12_RANGE readRange(0, 0);
+	ThrowIfFailed(mStaging->Map(0, &readRange, reinterpret_cast<void**>(&mappedData)));
+
+	resource = mStaging.Get();
+	return mappedData;
+}
+
+void StaticGeometryUploader::ReleaseStaging()
+{
+	mStaging->Unmap(0, nullptr);
+	mStaging = nullptr;
+}
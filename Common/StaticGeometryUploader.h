@@ -0,0 +1,31 @@
+//***************************************************************************************
+// StaticGeometryUploader.h
+//
+// GeometryUploader whose buffers are DEFAULT-heap resources, staged through one
+// persistently mapped UPLOAD-heap buffer.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include "GeometryUploader.h"
+
+class StaticGeometryUploader : public GeometryUploader
+{
+public:
+	StaticGeometryUploader(ID3D12Device* device, UINT64 stagingByteSize, bool keepStaging = false);
+	~StaticGeometryUploader();
+
+	void ReleaseBuffer(const StaticBuffer& buffer)override;
+
+protected:
+	StaticBuffer CreateBuffer(UINT64 byteSize)override;
+	std::uint8_t* CreateStaging(UINT64 byteSize, ID3D12Resource*& resource)override;
+	void ReleaseStaging()override;
+
+private:
+	ID3D12Device* md3dDevice = nullptr;
+
+	Microsoft::WRL::ComPtr<ID3D12Resource> mStaging;
+	std::unordered_map<ID3D12Resource*, Microsoft::WRL::ComPtr<ID3D12Resource>> mBuffers;
+};
@@ -0,0 +1,29 @@
+//***************************************************************************************
+// SubmeshGeometry.h
+//
+// Draw range of one mesh inside a shared vertex/index buffer.  Kept apart from
+// d3dUtil.h so device-free code (GeometryPacker, the scene) can use it.
+//***************************************************************************************
+
+#pragma once
+
+#include <d3d12.h>
+#include <DirectXCollision.h>
+
+// Defines a subrange of geometry in a MeshGeometry.  This is for when multiple
+// geometries are stored in one vertex and index buffer.  It provides the offsets
+// and data needed to draw a subset of geometry stores in the vertex and index 
+// buffers so that we can implement the technique described by Figure 6.3.
+struct SubmeshGeometry
+{
+	UINT IndexCount = 0;
+	UINT StartIndexLocation = 0;
+	INT BaseVertexLocation = 0;
+
+    // Bounding box of the geometry defined by this submesh. 
+    // This is used in later chapters of the book.
+	DirectX::BoundingBox Bounds;
+
+	// Bounding sphere of the same geometry; cheaper to test against a frustum.
+	DirectX::BoundingSphere Sphere;
+};
@@ -0,0 +1,117 @@
+//***************************************************************************************
+// TerrainStreamer.cpp
+//***************************************************************************************
+
+#include "TerrainStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+TerrainStreamer::TerrainStreamer(float chunkSize, std::uint32_t quadsPerSide, float loadRadius, float evictRadius,
+	std::uint32_t maxLoadsPerUpdate, JobSystem* jobs) :
+	mGenerator(jobs),
+	mChunkSize(chunkSize),
+	mQuadsPerSide(std::max(1u, quadsPerSide)),
+	mLoadRadius(loadRadius),
+	mEvictRadius(std::max(loadRadius, evictRadius)),
+	mMaxLoadsPerUpdate(std::max(1u, maxLoadsPerUpdate))
+{
+	GeometryGenerator::MeshData chunk = mGenerator.CreateGridChunk(mChunkSize, mQuadsPerSide, 0, 0);
+	mIndices.assign(chunk.Indices32.begin(), chunk.Indices32.end());
+}
+
+void TerrainStreamer::Update(const XMFLOAT3& viewerPos)
+{
+	mLoaded.clear();
+	mEvicted.clear();
+
+	for(auto it = mChunks.begin(); it != mChunks.end();)
+	{
+		if(Distance(it->second->Coord, viewerPos) > mEvictRadius)
+		{
+			mEvicted.push_back(it->second->Coord);
+			it = mChunks.erase(it);
+		}
+		else
+			++it;
+	}
+
+	// Every chunk whose square reaches into the load radius.  A chunk whose far edge is
+	// exactly at x - r is at distance r, but ChunkOf puts x - r in the next chunk up, so
+	// the scan starts one chunk lower and lets the distance test decide.
+	mCandidates.clear();
+	const std::int32_t x0 = ChunkOf(viewerPos.x - mLoadRadius) - 1, x1 = ChunkOf(viewerPos.x + mLoadRadius);
+	const std::int32_t z0 = ChunkOf(viewerPos.z - mLoadRadius) - 1, z1 = ChunkOf(viewerPos.z + mLoadRadius);
+	for(std::int32_t z = z0; z <= z1; ++z)
+	{
+		for(std::int32_t x = x0; x <= x1; ++x)
+		{
+			TerrainChunkCoord coord = { x, z };
+			float distance = Distance(coord, viewerPos);
+			if(distance <= mLoadRadius && mChunks.find(Key(coord)) == mChunks.end())
+				mCandidates.push_back(std::make_pair(distance, coord));
+		}
+	}
+
+	// Nearest first; ties broken by coordinate so the order does not depend on the scan.
+	auto nearer = [](const std::pair<float, TerrainChunkCoord>& a, const std::pair<float, TerrainChunkCoord>& b)
+	{
+		if(a.first != b.first)
+			return a.first < b.first;
+		return a.second.Z != b.second.Z ? a.second.Z < b.second.Z : a.second.X < b.second.X;
+	};
+
+	const size_t loadCount = std::min(mCandidates.size(), (size_t)mMaxLoadsPerUpdate);
+	std::partial_sort(mCandidates.begin(), mCandidates.begin() + loadCount, mCandidates.end(), nearer);
+
+	for(size_t i = 0; i < loadCount; ++i)
+	{
+		auto chunk = std::make_unique<TerrainChunk>();
+		chunk->Coord = mCandidates[i].second;
+		mGenerator.CreateGridChunkVertices(mChunkSize, mQuadsPerSide, chunk->Coord.X, chunk->Coord.Z, chunk->Vertices);
+
+		// Over every vertex, so the box stays right if chunks get heights.
+		BoundingBox::CreateFromPoints(chunk->Bounds, chunk->Vertices.size(), &chunk->Vertices[0].Position,
+			sizeof(GeometryGenerator::Vertex));
+
+		mLoaded.push_back(chunk.get());
+		mChunks.emplace(Key(chunk->Coord), std::move(chunk));
+	}
+
+	mStats.Resident = (std::uint32_t)mChunks.size();
+	mStats.PeakResident = std::max(mStats.PeakResident, mStats.Resident);
+	mStats.Loaded = (std::uint32_t)mLoaded.size();
+	mStats.Evicted = (std::uint32_t)mEvicted.size();
+	mStats.TotalLoaded += mStats.Loaded;
+	mStats.TotalEvicted += mStats.Evicted;
+	mStats.ResidentBytes = (std::uint64_t)mStats.Resident * VerticesPerChunk() * sizeof(GeometryGenerator::Vertex);
+}
+
+const TerrainChunk* TerrainStreamer::Find(TerrainChunkCoord coord)const
+{
+	auto it = mChunks.find(Key(coord));
+	return it != mChunks.end() ? it->second.get() : nullptr;
+}
+
+std::uint32_t TerrainStreamer::MaxResidentChunks()const
+{
+	// Everything left after eviction lies within the evict radius, which spans at
+	// most floor(2r/size)+2 chunks along each axis (counting chunks it only touches).
+	std::uint32_t perSide = (std::uint32_t)std::floor(2.0f * mEvictRadius / mChunkSize) + 2;
+	return perSide * perSide;
+}
+
+float TerrainStreamer::Distance(TerrainChunkCoord coord, const XMFLOAT3& viewerPos)const
+{
+	float minX = coord.X * mChunkSize, minZ = coord.Z * mChunkSize;
+	float dx = std::max(std::max(minX - viewerPos.x, viewerPos.x - (minX + mChunkSize)), 0.0f);
+	float dz = std::max(std::max(minZ - viewerPos.z, viewerPos.z - (minZ + mChunkSize)), 0.0f);
+	return std::sqrt(dx * dx + dz * dz);
+}
+
+std::int32_t TerrainStreamer::ChunkOf(float x)const
+{
+	return (std::int32_t)std::floor(x / mChunkSize);
+}
@@ -0,0 +1,128 @@
+//***************************************************************************************
+// TerrainStreamer.h
+//
+// Keeps the chunks of an unbounded tiled terrain grid resident around a viewer.  Each
+// Update loads the missing chunks within the load radius, nearest first and at most a
+// fixed number per call, and evicts the chunks beyond the evict radius.  Memory is
+// bounded by the radii, not by the size of the world.  The evict radius is larger than
+// the load radius so a chunk on the boundary is not loaded and evicted again every
+// time the viewer moves back and forth.
+//
+// Chunks come from GeometryGenerator::CreateGridChunkVertices, so neighbouring chunks
+// share bit-identical edge vertices and the terrain has no cracks.  All chunks have
+// the same topology and share one index list.
+//
+// Distances are measured in the xz-plane from the viewer to the nearest point of a
+// chunk's square.
+//***************************************************************************************
+
+#pragma once
+
+#include "GeometryGenerator.h"
+#include <DirectXCollision.h>
+#include <memory>
+#include <unordered_map>
+
+struct TerrainChunkCoord
+{
+	std::int32_t X = 0;
+	std::int32_t Z = 0;
+};
+
+struct TerrainChunk
+{
+	TerrainChunkCoord Coord;
+	std::pmr::vector<GeometryGenerator::Vertex> Vertices;
+	DirectX::BoundingBox Bounds;
+};
+
+struct TerrainStreamStats
+{
+	std::uint32_t Resident = 0;
+	std::uint32_t PeakResident = 0;
+
+	// Chunks loaded and evicted by the last Update, and since construction.
+	std::uint32_t Loaded = 0;
+	std::uint32_t Evicted = 0;
+	std::uint64_t TotalLoaded = 0;
+	std::uint64_t TotalEvicted = 0;
+
+	// CPU vertex memory of the resident chunks.
+	std::uint64_t ResidentBytes = 0;
+};
+
+class TerrainStreamer
+{
+public:
+	///<summary>
+	/// Chunks are chunkSize wide with quadsPerSide quads along each side.  evictRadius
+	/// is raised to loadRadius if smaller.  jobs, if given, generates the rows of each
+	/// chunk in parallel.
+	///</summary>
+	TerrainStreamer(float chunkSize, std::uint32_t quadsPerSide, float loadRadius, float evictRadius,
+		std::uint32_t maxLoadsPerUpdate = 4, JobSystem* jobs = nullptr);
+	TerrainStreamer(const TerrainStreamer& rhs) = delete;
+	TerrainStreamer& operator=(const TerrainStreamer& rhs) = delete;
+
+	///<summary>
+	/// Evicts the chunks beyond the evict radius of viewerPos, then loads up to
+	/// maxLoadsPerUpdate of the missing chunks within the load radius.
+	///</summary>
+	void Update(const DirectX::XMFLOAT3& viewerPos);
+
+	///<summary>
+	/// Chunks loaded and evicted by the last Update.  Loaded pointers stay valid until
+	/// the chunk is evicted.
+	///</summary>
+	const std::vector<const TerrainChunk*>& Loaded()const { return mLoaded; }
+	const std::vector<TerrainChunkCoord>& Evicted()const { return mEvicted; }
+
+	const TerrainChunk* Find(TerrainChunkCoord coord)const;
+
+	///<summary>
+	/// Index list shared by every chunk.
+	///</summary>
+	const std::vector<std::uint32_t>& Indices()const { return mIndices; }
+
+	std::uint32_t VerticesPerChunk()const { return (mQuadsPerSide + 1) * (mQuadsPerSide + 1); }
+
+	///<summary>
+	/// Upper bound on the number of chunks resident at once.
+	///</summary>
+	std::uint32_t MaxResidentChunks()const;
+
+	std::uint32_t MaxLoadsPerUpdate()const { return mMaxLoadsPerUpdate; }
+
+	const TerrainStreamStats& Stats()const { return mStats; }
+
+	static std::uint64_t Key(TerrainChunkCoord coord)
+	{
+		return (std::uint64_t)(std::uint32_t)coord.X << 32 | (std::uint32_t)coord.Z;
+	}
+
+private:
+	float Distance(TerrainChunkCoord coord, const DirectX::XMFLOAT3& viewerPos)const;
+	std::int32_t ChunkOf(float x)const;
+
+private:
+	GeometryGenerator mGenerator;
+
+	float mChunkSize = 1.0f;
+	std::uint32_t mQuadsPerSide = 1;
+	float mLoadRadius = 0.0f;
+	float mEvictRadius = 0.0f;
+	std::uint32_t mMaxLoadsPerUpdate = 4;
+
+	std::vector<std::uint32_t> mIndices;
+
+	// Owned through pointers so chunks do not move when the map rehashes.
+	std::unordered_map<std::uint64_t, std::unique_ptr<TerrainChunk>> mChunks;
+
+	std::vector<const TerrainChunk*> mLoaded;
+	std::vector<TerrainChunkCoord> mEvicted;
+
+	// Scratch: missing chunks in range with their distance.
+	std::vector<std::pair<float, TerrainChunkCoord>> mCandidates;
+
+	TerrainStreamStats mStats;
+};
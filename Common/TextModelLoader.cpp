@@ -0,0 +1,193 @@
+//***************************************************************************************
+// TextModelLoader.cpp
+//***************************************************************************************
+
+#include "TextModelLoader.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define TEXTMODEL_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	const std::size_t Padding = 16;
+
+	inline bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+	}
+
+	inline unsigned FirstSetBit(unsigned mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return (unsigned)__builtin_ctz(mask);
+#endif
+	}
+
+#if defined(TEXTMODEL_SSE2)
+	// Returns a 16-bit mask with a bit set for every whitespace byte at p[0..15].
+	inline unsigned WhitespaceMask(const char* p)
+	{
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i ws = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'))),
+			_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'))));
+
+		return (unsigned)_mm_movemask_epi8(ws);
+	}
+#endif
+}
+
+bool TextModelLoader::OpenStream(const std::wstring& filename, std::ifstream& fin)
+{
+#if defined(_MSC_VER)
+	fin.open(filename);
+#else
+	fin.open(std::string(filename.begin(), filename.end()));
+#endif
+	return fin.is_open();
+}
+
+bool TextModelLoader::Open(const std::wstring& filename)
+{
+#if defined(_MSC_VER)
+	std::ifstream fin(filename, std::ios::binary);
+#else
+	std::ifstream fin(std::string(filename.begin(), filename.end()), std::ios::binary);
+#endif
+	if(!fin)
+		return false;
+
+	fin.seekg(0, std::ios_base::end);
+	std::size_t size = (std::size_t)fin.tellg();
+	fin.seekg(0, std::ios_base::beg);
+
+	mBuffer.assign(size + Padding, '\0');
+	fin.read(mBuffer.data(), size);
+	if(!fin)
+		return false;
+
+	mCursor = mBuffer.data();
+	mEnd = mBuffer.data() + size;
+
+	return NextLabeledUInt(mVertexCount) && NextLabeledUInt(mTriangleCount);
+}
+
+bool TextModelLoader::ReadIndices(std::uint32_t* indices, std::size_t indexCount)
+{
+	if(!SkipPast('{'))
+		return false;
+
+	// An index past the vertex list would read outside the vertex buffer on the GPU.
+	for(std::size_t i = 0; i < indexCount; ++i)
+	{
+		if(!NextUInt(indices[i]) || indices[i] >= mVertexCount)
+			return false;
+	}
+
+	return SkipPast('}');
+}
+
+void TextModelLoader::SkipWhitespace()
+{
+	// Tokens are usually separated by a single space, so test one byte before going wide.
+	if(mCursor < mEnd && !IsSpace(*mCursor))
+		return;
+
+#if defined(TEXTMODEL_SSE2)
+	while(mCursor < mEnd)
+	{
+		unsigned notSpace = ~WhitespaceMask(mCursor) & 0xFFFF;
+		if(notSpace != 0)
+		{
+			mCursor += FirstSetBit(notSpace);
+			break;
+		}
+		mCursor += 16;
+	}
+#else
+	while(mCursor < mEnd && IsSpace(*mCursor))
+		++mCursor;
+#endif
+
+	if(mCursor > mEnd)
+		mCursor = mEnd;
+}
+
+const char* TextModelLoader::TokenEnd(const char* p)const
+{
+#if defined(TEXTMODEL_SSE2)
+	// The zero padding after mEnd terminates the scan for a token at the end of the file.
+	while(p < mEnd)
+	{
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		unsigned stop = WhitespaceMask(p) | (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_setzero_si128()));
+		if(stop != 0)
+			return std::min(p + FirstSetBit(stop), mEnd);
+		p += 16;
+	}
+	return mEnd;
+#else
+	while(p < mEnd && !IsSpace(*p))
+		++p;
+	return p;
+#endif
+}
+
+bool TextModelLoader::SkipPast(char c)
+{
+	while(mCursor < mEnd)
+	{
+		SkipWhitespace();
+		const char* end = TokenEnd(mCursor);
+		bool found = end - mCursor == 1 && *mCursor == c;
+		mCursor = end;
+		if(found)
+			return true;
+	}
+
+	return false;
+}
+
+bool TextModelLoader::NextFloat(float& value)
+{
+	SkipWhitespace();
+	std::from_chars_result result = std::from_chars(mCursor, mEnd, value);
+	if(result.ec != std::errc())
+		return false;
+
+	mCursor = result.ptr;
+	return true;
+}
+
+bool TextModelLoader::NextUInt(std::uint32_t& value)
+{
+	SkipWhitespace();
+	std::from_chars_result result = std::from_chars(mCursor, mEnd, value);
+	if(result.ec != std::errc())
+		return false;
+
+	mCursor = result.ptr;
+	return true;
+}
+
+bool TextModelLoader::NextLabeledUInt(std::uint32_t& value)
+{
+	// Skip the "Label:" token.
+	SkipWhitespace();
+	mCursor = TokenEnd(mCursor);
+
+	return NextUInt(value);
+}
@@ -0,0 +1,152 @@
+//***************************************************************************************
+// TextModelLoader.h
+//
+// Fast loader for the text model format used by Models/skull.txt and Models/car.txt:
+//
+//   VertexCount: N
+//   TriangleCount: M
+//   VertexList (pos, normal)
+//   { px py pz nx ny nz ... }
+//   TriangleList
+//   { i0 i1 i2 ... }
+//
+// The whole file is read with one call, whitespace is skipped 16 bytes at a time with
+// SSE2 compares, and numbers are converted with std::from_chars (no locale, no streams).
+// The file buffer and the output vectors may come from a scratch memory resource.
+//
+// LoadWithStreams is the original std::ifstream parser.  It is kept as the reference
+// the fast path is checked and timed against (Tests/TextModelLoaderTest.cpp and
+// Tests/TextModelLoaderBench.cpp).
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+class TextModelLoader
+{
+public:
+	///<summary>
+	/// The file buffer is allocated from scratch.
+	///</summary>
+	explicit TextModelLoader(std::pmr::memory_resource* scratch = std::pmr::get_default_resource()) :
+		mBuffer(scratch) {}
+
+	///<summary>
+	/// Reads the file into memory and parses the VertexCount/TriangleCount header.
+	///</summary>
+	bool Open(const std::wstring& filename);
+
+	std::uint32_t VertexCount()const { return mVertexCount; }
+	std::uint32_t TriangleCount()const { return mTriangleCount; }
+
+	///<summary>
+	/// Fills any vertex type that has XMFLOAT3-like Pos and Normal members.
+	/// Must be called before ReadIndices.
+	///</summary>
+	template<typename TVertex, typename TAlloc>
+	bool ReadVertices(std::vector<TVertex, TAlloc>& vertices)
+	{
+		if(!SkipPast('{'))
+			return false;
+
+		vertices.resize(mVertexCount);
+		for(std::uint32_t i = 0; i < mVertexCount; ++i)
+		{
+			TVertex& v = vertices[i];
+			if(!NextFloat(v.Pos.x) || !NextFloat(v.Pos.y) || !NextFloat(v.Pos.z) ||
+			   !NextFloat(v.Normal.x) || !NextFloat(v.Normal.y) || !NextFloat(v.Normal.z))
+				return false;
+		}
+
+		return SkipPast('}');
+	}
+
+	///<summary>
+	/// Fails if any index is not less than VertexCount().
+	///</summary>
+	template<typename TAlloc>
+	bool ReadIndices(std::vector<std::uint32_t, TAlloc>& indices)
+	{
+		indices.resize((std::size_t)mTriangleCount * 3);
+		return ReadIndices(indices.data(), indices.size());
+	}
+
+	///<summary>
+	/// Convenience wrapper that opens the file and reads both lists.
+	///</summary>
+	template<typename TVertex, typename TVertexAlloc, typename TIndexAlloc>
+	static bool Load(const std::wstring& filename, std::vector<TVertex, TVertexAlloc>& vertices,
+		std::vector<std::uint32_t, TIndexAlloc>& indices,
+		std::pmr::memory_resource* scratch = std::pmr::get_default_resource())
+	{
+		TextModelLoader loader(scratch);
+		return loader.Open(filename) && loader.ReadVertices(vertices) && loader.ReadIndices(indices);
+	}
+
+	///<summary>
+	/// Reference parser: reads the same format with operator>> on a std::ifstream and
+	/// applies the same index check.
+	///</summary>
+	template<typename TVertex, typename TVertexAlloc, typename TIndexAlloc>
+	static bool LoadWithStreams(const std::wstring& filename, std::vector<TVertex, TVertexAlloc>& vertices,
+		std::vector<std::uint32_t, TIndexAlloc>& indices)
+	{
+		std::ifstream fin;
+		if(!OpenStream(filename, fin))
+			return false;
+
+		std::uint32_t vCount = 0;
+		std::uint32_t tCount = 0;
+		std::string ignore;
+
+		fin >> ignore >> vCount;
+		fin >> ignore >> tCount;
+		fin >> ignore >> ignore >> ignore >> ignore;
+
+		vertices.resize(vCount);
+		for(std::uint32_t i = 0; i < vCount; ++i)
+		{
+			fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
+			fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
+		}
+
+		fin >> ignore;
+		fin >> ignore;
+		fin >> ignore;
+
+		indices.resize((std::size_t)tCount * 3);
+		for(std::size_t i = 0; i < indices.size(); ++i)
+		{
+			fin >> indices[i];
+			if(indices[i] >= vCount)
+				return false;
+		}
+
+		return !fin.fail();
+	}
+
+private:
+	static bool OpenStream(const std::wstring& filename, std::ifstream& fin);
+
+	bool ReadIndices(std::uint32_t* indices, std::size_t indexCount);
+	void SkipWhitespace();
+	const char* TokenEnd(const char* p)const;
+	bool SkipPast(char c);
+	bool NextFloat(float& value);
+	bool NextUInt(std::uint32_t& value);
+	bool NextLabeledUInt(std::uint32_t& value);
+
+private:
+	// Padded with zero bytes so 16-byte loads near the end stay in bounds.
+	std::pmr::vector<char> mBuffer;
+	const char* mCursor = nullptr;
+	const char* mEnd = nullptr;
+
+	std::uint32_t mVertexCount = 0;
+	std::uint32_t mTriangleCount = 0;
+};
@@ -0,0 +1,102 @@
+//***************************************************************************************
+// UploadHeap.h
+//
+// Per-frame upload memory for data the CPU rewrites every frame (pass and instance
+// data, or anything else a frame needs once).  Allocations are slices of
+// persistently mapped pages, 256-byte aligned by default so any slice can be bound as
+// a root constant buffer view.  Allocating is a bump of an offset; pages are added
+// when a frame needs more, and reused once the fence of the frame that wrote them has
+// completed.
+//
+// The paging is shared; implementations only create the memory for a new page.
+// DynamicUploadHeap uses UPLOAD-heap buffers, MemoryUploadHeap plain memory, so code
+// that fills per-frame data does not depend on a device.
+//
+// Usage per frame:
+//   Allocate() any number of times and write through CpuAddress,
+//   Submit(fence) after the frame's command lists have been executed and signalled,
+//   Retire(completedFence) before allocating for a later frame.
+//
+// A heap that is never submitted keeps every allocation, which suits buffers that
+// stay mapped across frames and are only partly rewritten.
+//***************************************************************************************
+
+#pragma once
+
+#include "LinearPageAllocator.h"
+#include <d3d12.h>
+#include <cstring>
+
+struct UploadAllocation
+{
+	std::uint8_t* CpuAddress = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS GpuAddress = 0;
+};
+
+class UploadHeap
+{
+public:
+	static const UINT64 ConstantBufferAlignment = 256;
+
+	explicit UploadHeap(UINT64 pageSize) :
+		mPages(pageSize)
+	{
+	}
+	UploadHeap(const UploadHeap& rhs) = delete;
+	UploadHeap& operator=(const UploadHeap& rhs) = delete;
+	virtual ~UploadHeap() = default;
+
+	///<summary>
+	/// Returns byteSize bytes valid until the fence passed to the next Submit completes.
+	/// The memory may be write-combined: write it sequentially and never read it.
+	///</summary>
+	UploadAllocation Allocate(UINT64 byteSize, UINT64 alignment = ConstantBufferAlignment)
+	{
+		LinearAllocation allocation = mPages.Allocate(byteSize, alignment);
+
+		// First use of this page: create its memory and keep it for the heap's lifetime.
+		if(allocation.Page == mPageMemory.size())
+			mPageMemory.push_back(CreatePage(mPages.PageSize(allocation.Page)));
+
+		const UploadAllocation& page = mPageMemory[allocation.Page];
+
+		UploadAllocation result;
+		result.CpuAddress = page.CpuAddress + allocation.Offset;
+		result.GpuAddress = page.GpuAddress + allocation.Offset;
+		return result;
+	}
+
+	///<summary>
+	/// Copies data into a constant-buffer-sized slice and returns its GPU address.
+	///</summary>
+	template<typename T>
+	D3D12_GPU_VIRTUAL_ADDRESS AllocateConstants(const T& data)
+	{
+		UploadAllocation allocation = Allocate(ConstantBufferByteSize(sizeof(T)));
+		std::memcpy(allocation.CpuAddress, &data, sizeof(T));
+		return allocation.GpuAddress;
+	}
+
+	void Submit(UINT64 fenceValue) { mPages.Submit(fenceValue); }
+	void Retire(UINT64 completedFenceValue) { mPages.Retire(completedFenceValue); }
+
+	UINT PageCount()const { return mPages.PageCount(); }
+	UINT OpenPageCount()const { return mPages.OpenPageCount(); }
+	UINT64 AllocatedBytes()const { return mPages.AllocatedBytes(); }
+	UINT64 ReservedBytes()const { return mPages.ReservedBytes(); }
+
+	static UINT64 ConstantBufferByteSize(UINT64 byteSize)
+	{
+		return (byteSize + ConstantBufferAlignment - 1) & ~(ConstantBufferAlignment - 1);
+	}
+
+protected:
+	///<summary>
+	/// Creates the memory of a new page of byteSize bytes, mapped for the heap's lifetime.
+	///</summary>
+	virtual UploadAllocation CreatePage(UINT64 byteSize) = 0;
+
+private:
+	LinearPageAllocator mPages;
+	std::vector<UploadAllocation> mPageMemory;
+};
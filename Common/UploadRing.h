@@ -0,0 +1,138 @@
+//***************************************************************************************
+// UploadRing.h
+//
+// Offset bookkeeping for a ring-allocated upload buffer.  It only hands out byte
+// offsets; it owns no GPU memory, so the packing, alignment and fence-gated retirement
+// rules can be exercised without a device.
+//
+// Usage per batch:
+//   Allocate() any number of times, record copies from the returned offsets,
+//   Submit(fence) once the batch's command list has been executed and signalled,
+//   Retire(completedFence) later to give the space back.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+class UploadRing
+{
+public:
+	static const std::uint64_t InvalidOffset = ~std::uint64_t(0);
+
+	explicit UploadRing(std::uint64_t capacity) :
+		mCapacity(capacity)
+	{
+	}
+
+	///<summary>
+	/// Returns the offset of byteSize bytes aligned to alignment (a power of two), or
+	/// InvalidOffset if the ring has no room until earlier batches are retired.
+	///</summary>
+	std::uint64_t Allocate(std::uint64_t byteSize, std::uint64_t alignment)
+	{
+		if(mUsedBytes == 0)
+		{
+			mHead = 0;
+			mTail = 0;
+		}
+		else if(mHead == mTail)
+		{
+			// Full: head has wrapped all the way around to the oldest live byte.
+			return InvalidOffset;
+		}
+
+		std::uint64_t offset = AlignUp(mHead, alignment);
+		std::uint64_t consumed = 0;
+
+		if(mHead >= mTail)
+		{
+			if(offset + byteSize <= mCapacity)
+			{
+				consumed = offset + byteSize - mHead;
+			}
+			else if(byteSize <= mTail)
+			{
+				// Skip the unusable space at the end and wrap to the front.
+				offset = 0;
+				consumed = (mCapacity - mHead) + byteSize;
+			}
+			else
+			{
+				return InvalidOffset;
+			}
+		}
+		else
+		{
+			if(offset + byteSize > mTail)
+				return InvalidOffset;
+
+			consumed = offset + byteSize - mHead;
+		}
+
+		mHead = offset + byteSize;
+		if(mHead == mCapacity)
+			mHead = 0;
+
+		mUsedBytes += consumed;
+		mPendingBytes += consumed;
+
+		return offset;
+	}
+
+	///<summary>
+	/// Tags every allocation made since the previous Submit with fenceValue.
+	///</summary>
+	void Submit(std::uint64_t fenceValue)
+	{
+		if(mPendingBytes == 0)
+			return;
+
+		mInFlight.push_back({ fenceValue, mHead, mPendingBytes });
+		mPendingBytes = 0;
+	}
+
+	///<summary>
+	/// Frees every submitted batch whose fence value is <= completedFenceValue.
+	///</summary>
+	void Retire(std::uint64_t completedFenceValue)
+	{
+		while(!mInFlight.empty() && mInFlight.front().FenceValue <= completedFenceValue)
+		{
+			mTail = mInFlight.front().EndOffset;
+			mUsedBytes -= mInFlight.front().ByteSize;
+			mInFlight.pop_front();
+		}
+	}
+
+	bool Empty()const { return mUsedBytes == 0; }
+	std::uint64_t Capacity()const { return mCapacity; }
+	std::uint64_t UsedBytes()const { return mUsedBytes; }
+
+private:
+	static std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+private:
+	struct Batch
+	{
+		std::uint64_t FenceValue;
+		std::uint64_t EndOffset;
+		std::uint64_t ByteSize;
+	};
+
+	std::uint64_t mCapacity = 0;
+
+	// Next free byte and oldest live byte.
+	std::uint64_t mHead = 0;
+	std::uint64_t mTail = 0;
+
+	// Includes alignment padding and space skipped when wrapping.
+	std::uint64_t mUsedBytes = 0;
+	std::uint64_t mPendingBytes = 0;
+
+	std::deque<Batch> mInFlight;
+};
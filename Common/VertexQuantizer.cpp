@@ -0,0 +1,188 @@
+//***************************************************************************************
+// VertexQuantizer.cpp
+//***************************************************************************************
+
+#include "VertexQuantizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DirectX;
+
+static_assert(sizeof(CompactVertexOct16) == 12, "CompactVertexOct16 must be 12 bytes.");
+static_assert(sizeof(CompactVertexOct8) == 8, "CompactVertexOct8 must be 8 bytes.");
+
+namespace
+{
+	float SignNotZero(float v)
+	{
+		return v >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	template<typename TInt>
+	TInt EncodeSnorm(float v, float maxValue)
+	{
+		v = std::min(std::max(v, -1.0f), 1.0f);
+		return static_cast<TInt>(std::lround(v * maxValue));
+	}
+
+	float DecodeSnorm(int v, float maxValue)
+	{
+		return std::max((float)v / maxValue, -1.0f);
+	}
+}
+
+std::uint32_t VertexQuantizer::Stride(VertexEncoding encoding)
+{
+	switch(encoding)
+	{
+	case VertexEncoding::CompactOct16: return sizeof(CompactVertexOct16);
+	case VertexEncoding::CompactOct8: return sizeof(CompactVertexOct8);
+	default: return 2 * sizeof(XMFLOAT3);
+	}
+}
+
+std::uint16_t VertexQuantizer::EncodePosition(float p, float center, float extent)
+{
+	if(extent <= 0.0f)
+		return 0x8000;
+
+	float t = (p - center) / extent * 0.5f + 0.5f;
+	t = std::min(std::max(t, 0.0f), 1.0f);
+	return static_cast<std::uint16_t>(std::lround(t * 65535.0f));
+}
+
+float VertexQuantizer::DecodePosition(std::uint16_t q, float center, float extent)
+{
+	return center + extent * ((float)q / 65535.0f * 2.0f - 1.0f);
+}
+
+XMFLOAT2 VertexQuantizer::OctEncode(const XMFLOAT3& n)
+{
+	// A zero normal has no direction; encode +z rather than dividing by zero.
+	float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+	if(l1 == 0.0f)
+		return XMFLOAT2(0.0f, 0.0f);
+
+	float invL1 = 1.0f / l1;
+	float x = n.x * invL1;
+	float y = n.y * invL1;
+
+	// Fold the lower hemisphere over the diagonals.
+	if(n.z < 0.0f)
+	{
+		float fx = (1.0f - std::fabs(y)) * SignNotZero(x);
+		float fy = (1.0f - std::fabs(x)) * SignNotZero(y);
+		x = fx;
+		y = fy;
+	}
+
+	return XMFLOAT2(x, y);
+}
+
+XMFLOAT3 VertexQuantizer::OctDecode(const XMFLOAT2& e)
+{
+	XMFLOAT3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+	if(n.z < 0.0f)
+	{
+		float x = (1.0f - std::fabs(n.y)) * SignNotZero(n.x);
+		float y = (1.0f - std::fabs(n.x)) * SignNotZero(n.y);
+		n.x = x;
+		n.y = y;
+	}
+
+	float invLength = 1.0f / std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+	return XMFLOAT3(n.x * invLength, n.y * invLength, n.z * invLength);
+}
+
+XMFLOAT3 VertexQuantizer::DecodePosition(const void* vertex, VertexEncoding encoding, const BoundingBox& bounds)
+{
+	if(encoding == VertexEncoding::Float)
+	{
+		XMFLOAT3 p;
+		std::memcpy(&p, vertex, sizeof(p));
+		return p;
+	}
+
+	std::uint16_t q[3];
+	std::memcpy(q, vertex, sizeof(q));
+
+	return XMFLOAT3(
+		DecodePosition(q[0], bounds.Center.x, bounds.Extents.x),
+		DecodePosition(q[1], bounds.Center.y, bounds.Extents.y),
+		DecodePosition(q[2], bounds.Center.z, bounds.Extents.z));
+}
+
+XMFLOAT3 VertexQuantizer::DecodeNormal(const void* vertex, VertexEncoding encoding)
+{
+	const std::uint8_t* bytes = static_cast<const std::uint8_t*>(vertex);
+
+	switch(encoding)
+	{
+	case VertexEncoding::CompactOct16:
+	{
+		std::int16_t e[2];
+		std::memcpy(e, bytes + offsetof(CompactVertexOct16, Normal), sizeof(e));
+		return OctDecode(XMFLOAT2(DecodeSnorm(e[0], 32767.0f), DecodeSnorm(e[1], 32767.0f)));
+	}
+	case VertexEncoding::CompactOct8:
+	{
+		std::int8_t e[2];
+		std::memcpy(e, bytes + offsetof(CompactVertexOct8, Normal), sizeof(e));
+		return OctDecode(XMFLOAT2(DecodeSnorm(e[0], 127.0f), DecodeSnorm(e[1], 127.0f)));
+	}
+	default:
+	{
+		XMFLOAT3 n;
+		std::memcpy(&n, bytes + sizeof(XMFLOAT3), sizeof(n));
+		return n;
+	}
+	}
+}
+
+void VertexQuantizer::EncodeOne(const XMFLOAT3& pos, const XMFLOAT3& normal,
+	const BoundingBox& bounds, VertexEncoding encoding, std::uint8_t* out)
+{
+	std::uint16_t q[3] =
+	{
+		EncodePosition(pos.x, bounds.Center.x, bounds.Extents.x),
+		EncodePosition(pos.y, bounds.Center.y, bounds.Extents.y),
+		EncodePosition(pos.z, bounds.Center.z, bounds.Extents.z),
+	};
+
+	XMFLOAT2 e = OctEncode(normal);
+
+	if(encoding == VertexEncoding::CompactOct16)
+	{
+		CompactVertexOct16 v = {};
+		std::memcpy(v.Pos, q, sizeof(q));
+		v.Normal[0] = EncodeSnorm<std::int16_t>(e.x, 32767.0f);
+		v.Normal[1] = EncodeSnorm<std::int16_t>(e.y, 32767.0f);
+		std::memcpy(out, &v, sizeof(v));
+	}
+	else if(encoding == VertexEncoding::CompactOct8)
+	{
+		CompactVertexOct8 v = {};
+		std::memcpy(v.Pos, q, sizeof(q));
+		v.Normal[0] = EncodeSnorm<std::int8_t>(e.x, 127.0f);
+		v.Normal[1] = EncodeSnorm<std::int8_t>(e.y, 127.0f);
+		std::memcpy(out, &v, sizeof(v));
+	}
+	else
+	{
+		std::memcpy(out, &pos, sizeof(pos));
+		std::memcpy(out + sizeof(pos), &normal, sizeof(normal));
+	}
+}
+
+float VertexQuantizer::AngleDegrees(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+	float la = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+	float lb = std::sqrt(b.x * b.x + b.y * b.y + b.z * b.z);
+	if(la == 0.0f || lb == 0.0f)
+		return 0.0f;
+
+	float c = (a.x * b.x + a.y * b.y + a.z * b.z) / (la * lb);
+	c = std::min(std::max(c, -1.0f), 1.0f);
+	return std::acos(c) * 57.2957795f;
+}
@@ -0,0 +1,113 @@
+//***************************************************************************************
+// VertexQuantizer.h
+//
+// Compact Pos/Normal vertex encodings:
+//
+//   CompactOct16 (12 bytes): position as 3 x unorm16 relative to the mesh bounds plus
+//                            one unused lane, normal octahedron-encoded as 2 x snorm16.
+//   CompactOct8  (8 bytes):  the same position, with the normal octahedron-encoded as
+//                            2 x snorm8 packed into the fourth position lane.
+//
+// A quantized position q decodes as Center + Extents * (q / 65535 * 2 - 1), using the
+// BoundingBox it was encoded against.  Encode reports the largest position and normal
+// error over the mesh so the loss can be checked per asset.  It reads any vertex type
+// with a VertexLayoutOf position and normal and only writes to dst, so it can encode
+// GeometryGenerator output straight into a mapped upload buffer.
+//***************************************************************************************
+
+#pragma once
+
+#include "VertexWriter.h"
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+enum class VertexEncoding
+{
+	Float,
+	CompactOct16,
+	CompactOct8,
+};
+
+struct CompactVertexOct16
+{
+	std::uint16_t Pos[4];
+	std::int16_t Normal[2];
+};
+
+struct CompactVertexOct8
+{
+	std::uint16_t Pos[3];
+	std::int8_t Normal[2];
+};
+
+struct QuantizeError
+{
+	// In the mesh's units.
+	float MaxPositionError = 0.0f;
+	float MaxNormalErrorDegrees = 0.0f;
+};
+
+class VertexQuantizer
+{
+public:
+	// Largest Stride(), the Float encoding's Pos and Normal.
+	static const std::uint32_t MaxStride = 2 * sizeof(DirectX::XMFLOAT3);
+
+	static std::uint32_t Stride(VertexEncoding encoding);
+
+	static std::uint16_t EncodePosition(float p, float center, float extent);
+	static float DecodePosition(std::uint16_t q, float center, float extent);
+
+	///<summary>
+	/// Octahedral mapping of a unit vector to [-1, 1]^2 and back.  A zero vector
+	/// encodes as +z.
+	///</summary>
+	static DirectX::XMFLOAT2 OctEncode(const DirectX::XMFLOAT3& n);
+	static DirectX::XMFLOAT3 OctDecode(const DirectX::XMFLOAT2& e);
+
+	static DirectX::XMFLOAT3 DecodePosition(const void* vertex, VertexEncoding encoding, const DirectX::BoundingBox& bounds);
+	static DirectX::XMFLOAT3 DecodeNormal(const void* vertex, VertexEncoding encoding);
+
+	///<summary>
+	/// Encodes count vertices into dst (count * Stride(encoding) bytes) relative to
+	/// bounds.  TVertex's VertexLayoutOf must have a position and a normal.
+	///</summary>
+	template<typename TVertex>
+	static QuantizeError Encode(const TVertex* src, size_t count, const DirectX::BoundingBox& bounds,
+		VertexEncoding encoding, void* dst)
+	{
+		using Layout = typename VertexLayoutOf<TVertex>::Type;
+
+		QuantizeError error;
+		std::uint8_t* out = static_cast<std::uint8_t*>(dst);
+		const std::uint32_t stride = Stride(encoding);
+
+		for(size_t i = 0; i < count; ++i, out += stride)
+		{
+			const DirectX::XMFLOAT3& pos = Layout::template Get<VertexSemantic::Position>(src[i]);
+			const DirectX::XMFLOAT3& normal = Layout::template Get<VertexSemantic::Normal>(src[i]);
+
+			// Measured on a local copy; dst may be write-combined memory.
+			std::uint8_t encoded[MaxStride];
+			EncodeOne(pos, normal, bounds, encoding, encoded);
+			std::memcpy(out, encoded, stride);
+
+			DirectX::XMFLOAT3 p = DecodePosition(encoded, encoding, bounds);
+			DirectX::XMFLOAT3 n = DecodeNormal(encoded, encoding);
+
+			float dp = std::fmax(std::fabs(p.x - pos.x), std::fmax(std::fabs(p.y - pos.y), std::fabs(p.z - pos.z)));
+			error.MaxPositionError = std::fmax(error.MaxPositionError, dp);
+			error.MaxNormalErrorDegrees = std::fmax(error.MaxNormalErrorDegrees, AngleDegrees(normal, n));
+		}
+
+		return error;
+	}
+
+private:
+	static void EncodeOne(const DirectX::XMFLOAT3& pos, const DirectX::XMFLOAT3& normal,
+		const DirectX::BoundingBox& bounds, VertexEncoding encoding, std::uint8_t* out);
+	static float AngleDegrees(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b);
+};
@@ -0,0 +1,186 @@
+//***************************************************************************************
+// VertexWriter.h
+//
+// Compile-time vertex layouts and a writer that converts between them.
+//
+// A VertexLayout lists the attributes of a vertex type by semantic, value type and byte
+// offset.  VertexLayoutOf<T> gives the layout of T: by default XMFLOAT3 Pos and Normal
+// members (the contract GeometryPacker and VertexQuantizer already place on TVertex),
+// with a specialization for GeometryGenerator::Vertex.
+//
+// VertexWriter<TDst, TSrc>::Write copies the attributes of the destination layout out
+// of source vertices, e.g. straight from GeometryGenerator output into a mapped upload
+// buffer, with no intermediate vector.  The copy plan is built at compile time;
+// attributes that are adjacent in both layouts are merged into one fixed-size move, so
+// Pos+Normal out of GeometryGenerator::Vertex is a single 24-byte copy per vertex that
+// the compiler lowers to an unaligned 16-byte SIMD move plus an 8-byte one.  The
+// destination is only written, never read, which suits write-combined memory.
+//***************************************************************************************
+
+#pragma once
+
+#include "GeometryGenerator.h"
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+enum class VertexSemantic
+{
+	Position,
+	Normal,
+	TangentU,
+	TexC,
+};
+
+template<VertexSemantic TSemantic, typename TValue, std::size_t TOffset>
+struct VertexAttribute
+{
+	static constexpr VertexSemantic Semantic = TSemantic;
+	static constexpr std::size_t Offset = TOffset;
+	using Value = TValue;
+};
+
+namespace VertexLayoutDetail
+{
+	template<VertexSemantic TSemantic, typename... TAttributes>
+	struct Find
+	{
+		using Type = void;
+	};
+
+	template<VertexSemantic TSemantic, typename TFirst, typename... TRest>
+	struct Find<TSemantic, TFirst, TRest...>
+	{
+		using Type = std::conditional_t<TFirst::Semantic == TSemantic, TFirst,
+			typename Find<TSemantic, TRest...>::Type>;
+	};
+}
+
+struct VertexCopyRun
+{
+	std::size_t DstOffset = 0;
+	std::size_t SrcOffset = 0;
+	std::size_t ByteSize = 0;
+};
+
+template<typename TVertex, typename... TAttributes>
+struct VertexLayout
+{
+	using Vertex = TVertex;
+
+	static constexpr std::size_t Stride = sizeof(TVertex);
+	static constexpr std::size_t AttributeCount = sizeof...(TAttributes);
+
+	template<VertexSemantic TSemantic>
+	using Attribute = typename VertexLayoutDetail::Find<TSemantic, TAttributes...>::Type;
+
+	template<VertexSemantic TSemantic>
+	static constexpr bool Has = !std::is_void<Attribute<TSemantic>>::value;
+
+	template<VertexSemantic TSemantic>
+	static const typename Attribute<TSemantic>::Value& Get(const TVertex& v)
+	{
+		using A = Attribute<TSemantic>;
+		return *reinterpret_cast<const typename A::Value*>(reinterpret_cast<const std::uint8_t*>(&v) + A::Offset);
+	}
+
+	///<summary>
+	/// One copy per attribute of this layout, taken from the same semantic in TSrcLayout.
+	///</summary>
+	template<typename TSrcLayout>
+	static constexpr std::array<VertexCopyRun, AttributeCount> CopyRunsFrom()
+	{
+		static_assert((TSrcLayout::template Has<TAttributes::Semantic> && ...),
+			"The source layout lacks an attribute of the destination layout.");
+		static_assert((std::is_same<typename TAttributes::Value,
+			typename TSrcLayout::template Attribute<TAttributes::Semantic>::Value>::value && ...),
+			"Attribute types differ between the source and destination layouts.");
+
+		return { VertexCopyRun{ TAttributes::Offset,
+			TSrcLayout::template Attribute<TAttributes::Semantic>::Offset,
+			sizeof(typename TAttributes::Value) }... };
+	}
+};
+
+template<typename TVertex>
+struct VertexLayoutOf
+{
+	using Type = VertexLayout<TVertex,
+		VertexAttribute<VertexSemantic::Position, DirectX::XMFLOAT3, offsetof(TVertex, Pos)>,
+		VertexAttribute<VertexSemantic::Normal, DirectX::XMFLOAT3, offsetof(TVertex, Normal)>>;
+};
+
+template<>
+struct VertexLayoutOf<GeometryGenerator::Vertex>
+{
+	using Type = VertexLayout<GeometryGenerator::Vertex,
+		VertexAttribute<VertexSemantic::Position, DirectX::XMFLOAT3, offsetof(GeometryGenerator::Vertex, Position)>,
+		VertexAttribute<VertexSemantic::Normal, DirectX::XMFLOAT3, offsetof(GeometryGenerator::Vertex, Normal)>,
+		VertexAttribute<VertexSemantic::TangentU, DirectX::XMFLOAT3, offsetof(GeometryGenerator::Vertex, TangentU)>,
+		VertexAttribute<VertexSemantic::TexC, DirectX::XMFLOAT2, offsetof(GeometryGenerator::Vertex, TexC)>>;
+};
+
+template<typename TDstLayout, typename TSrcLayout = typename VertexLayoutOf<GeometryGenerator::Vertex>::Type>
+class VertexWriter
+{
+public:
+	using SrcVertex = typename TSrcLayout::Vertex;
+
+	///<summary>
+	/// Writes count vertices (count * TDstLayout::Stride bytes) to dst.  Destination
+	/// bytes not covered by an attribute are left untouched.
+	///</summary>
+	static void Write(const SrcVertex* src, std::size_t count, void* dst)
+	{
+		std::uint8_t* out = static_cast<std::uint8_t*>(dst);
+		const std::uint8_t* in = reinterpret_cast<const std::uint8_t*>(src);
+
+		for(std::size_t i = 0; i < count; ++i, out += TDstLayout::Stride, in += TSrcLayout::Stride)
+			WriteOne(out, in, std::make_index_sequence<Plan.Count>());
+	}
+
+	///<summary>
+	/// Number of moves per vertex after merging adjacent attributes.
+	///</summary>
+	static constexpr std::size_t CopiesPerVertex() { return Plan.Count; }
+
+private:
+	struct CopyPlan
+	{
+		std::array<VertexCopyRun, TDstLayout::AttributeCount> Runs = {};
+		std::size_t Count = 0;
+	};
+
+	static constexpr CopyPlan BuildPlan()
+	{
+		const std::array<VertexCopyRun, TDstLayout::AttributeCount> runs = TDstLayout::template CopyRunsFrom<TSrcLayout>();
+
+		CopyPlan plan;
+		for(std::size_t a = 0; a < runs.size(); ++a)
+		{
+			VertexCopyRun* last = plan.Count > 0 ? &plan.Runs[plan.Count - 1] : nullptr;
+			if(last != nullptr &&
+				last->DstOffset + last->ByteSize == runs[a].DstOffset &&
+				last->SrcOffset + last->ByteSize == runs[a].SrcOffset)
+			{
+				last->ByteSize += runs[a].ByteSize;
+			}
+			else
+			{
+				plan.Runs[plan.Count++] = runs[a];
+			}
+		}
+
+		return plan;
+	}
+
+	template<std::size_t... TRun>
+	static void WriteOne(std::uint8_t* out, const std::uint8_t* in, std::index_sequence<TRun...>)
+	{
+		(std::memcpy(out + Plan.Runs[TRun].DstOffset, in + Plan.Runs[TRun].SrcOffset, Plan.Runs[TRun].ByteSize), ...);
+	}
+
+	static constexpr CopyPlan Plan = BuildPlan();
+};
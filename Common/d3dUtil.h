@@ -28,6 +28,7 @@
 #include "d3dx12.h"
 #include "DDSTextureLoader.h"
 #include "MathHelper.h"
+#include "SubmeshGeometry.h"
 
 extern const int gNumFrameResources;
 
@@ -142,21 +143,6 @@ public:
     int LineNumber = -1;
 };
 
-// Defines a subrange of geometry in a MeshGeometry.  This is for when multiple
-// geometries are stored in one vertex and index buffer.  It provides the offsets
-// and data needed to draw a subset of geometry stores in the vertex and index 
-// buffers so that we can implement the technique described by Figure 6.3.
-struct SubmeshGeometry
-{
-	UINT IndexCount = 0;
-	UINT StartIndexLocation = 0;
-	INT BaseVertexLocation = 0;
-
-    // Bounding box of the geometry defined by this submesh. 
-    // This is used in later chapters of the book.
-	DirectX::BoundingBox Bounds;
-};
-
 struct MeshGeometry
 {
 	// Give it a name so we can look it up by name.
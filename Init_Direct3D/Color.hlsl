@@ -4,11 +4,50 @@
 #include "Params.hlsl"
 #include "LightingUtil.hlsl"
 
+// COMPACT_VERTEX selects the vertex encoding (see VertexQuantizer.h):
+//   undefined : float3 position + float3 normal
+//   1         : unorm16 position + octahedral snorm16 normal
+//   2         : unorm16 position, octahedral snorm8 normal packed into the 4th lane
+#if defined(COMPACT_VERTEX)
+struct VertexIn
+{
+	uint4 PosQ : POSITION;
+#if COMPACT_VERTEX == 1
+	float2 NormalOct : NORMAL;
+#endif
+};
+#else
 struct VertexIn
 {
 	float3 PosL : POSITION;
 	float3 NormalL : NORMAL;
 };
+#endif
+
+float3 OctDecode(float2 e)
+{
+	float3 n = float3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+	if (n.z < 0.0f)
+		n.xy = (1.0f - abs(n.yx)) * (n.xy >= 0.0f ? 1.0f : -1.0f);
+	return normalize(n);
+}
+
+void DecodeVertex(VertexIn vin, out float3 posL, out float3 normalL)
+{
+#if defined(COMPACT_VERTEX)
+	posL = gQuantCenter + gQuantExtents * (float3(vin.PosQ.xyz) / 65535.0f * 2.0f - 1.0f);
+#if COMPACT_VERTEX == 1
+	normalL = OctDecode(vin.NormalOct);
+#else
+	// Sign-extend the two snorm8 bytes
+	int2 e = int2(vin.PosQ.w << 24, vin.PosQ.w << 16) >> 24;
+	normalL = OctDecode(max(float2(e) / 127.0f, -1.0f));
+#endif
+#else
+	posL = vin.PosL;
+	normalL = vin.NormalL;
+#endif
+}
 
 struct VertexOut
 {
@@ -17,14 +56,20 @@ struct VertexOut
 	float3 NormalW : NORMAL;
 };
 
-VertexOut VS(VertexIn vin)
+VertexOut VS(VertexIn vin, uint instanceID : SV_InstanceID)
 {
 	VertexOut vout;
 
-	float4 posW = mul(float4(vin.PosL, 1.0f), gWorld);
+	// SV_InstanceID does not include StartInstanceLocation, so the base comes from a root constant
+	float4x4 world = gInstanceData[gInstanceBase + instanceID].World;
+
+	float3 posL, normalL;
+	DecodeVertex(vin, posL, normalL);
+
+	float4 posW = mul(float4(posL, 1.0f), world);
 	vout.PosW = posW.xyz;
 	vout.PosH = mul(posW, gViewProj);
-	vout.NormalW = mul(vin.NormalL, (float3x3)gWorld);
+	vout.NormalW = mul(normalL, (float3x3)world);
 	return vout;
 }
 
@@ -33,16 +78,17 @@ float4 PS(VertexOut pin) : SV_Target
 	pin.NormalW = normalize(pin.NormalW);
 	float3 toEyeW = normalize(gEyePosW - pin.PosW);
 	
-	float4 ambient = gAmbientLight * gDiffuseAlbedo;
+	MaterialData matData = gMaterialData[gMaterialIndex];
+	float4 ambient = gAmbientLight * matData.DiffuseAlbedo;
 
-	const float shininess = 1.0f - gRoughness;
-	Material mat = { gDiffuseAlbedo, gFresnelR0, shininess };
+	const float shininess = 1.0f - matData.Roughness;
+	Material mat = { matData.DiffuseAlbedo, matData.FresnelR0, shininess };
 
 	float4 directLight = ComputeLighting(gLights, gLightCount, mat, pin.PosW, pin.NormalW, toEyeW);
 	//float4 pointLight = ComputePointLight(gLights[2], mat, pin.PosW, pin.NormalW, toEyeW);
 	
 	float4 litColor = ambient + directLight;
-	litColor.a = gDiffuseAlbedo.a;
+	litColor.a = matData.DiffuseAlbedo.a;
 
 	return litColor;
 }
@@ -221,6 +221,10 @@ LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		{
 			PostQuitMessage(0);
 		}
+		else
+		{
+			OnKeyUp(wParam);
+		}
 
 		return 0;
 	}
@@ -294,7 +298,8 @@ void D3DApp::CalculateFrameStats()
 
 		wstring windowText = mMainWndCaption +
 			L"    fps: " + fpsStr +
-			L"   mspf: " + mspfStr;
+			L"   mspf: " + mspfStr +
+			FrameStatsText();
 
 		SetWindowText(mhMainWnd, windowText.c_str());
 
@@ -421,7 +426,7 @@ void D3DApp::CreateSwapChain()
 
 void D3DApp::CreateCommandFence()
 {
-	ThrowIfFailed(md3dDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+	mFence = std::make_unique<D3D12FrameFence>(md3dDevice.Get(), mCommandQueue.Get());
 }
 
 void D3DApp::CreateDescriptorSize()
@@ -512,19 +517,7 @@ void D3DApp::CreateViewPort()
 
 void D3DApp::FlushCommandQueue()
 {
-	mCurrentFence++;
-
-	ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), mCurrentFence));
-
-	if (mFence->GetCompletedValue() < mCurrentFence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-
-		ThrowIfFailed(mFence->SetEventOnCompletion(mCurrentFence, eventHandle));
-
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	mFence->Flush();
 }
 
 bool D3DApp::Get4xMsaaState() const
@@ -7,6 +7,7 @@
 
 #include "../Common/d3dUtil.h"
 #include "../Common/GameTimer.h"
+#include "../Common/D3D12FrameFence.h"
 
 // Link necessary d3d12 libraries.
 #pragma comment(lib,"d3dcompiler.lib")
@@ -39,15 +40,17 @@ public:
 
 protected:
     virtual void OnResize();
+    virtual std::wstring FrameStatsText()const { return L""; }
     virtual void Update(const GameTimer& gt) = 0;
     virtual void DrawBegin(const GameTimer& gt) = 0;
     virtual void Draw(const GameTimer& gt) = 0;
     virtual void DrawEnd(const GameTimer& gt) = 0;
 
-    // Convenience overrides for handling mouse input.
+    // Convenience overrides for handling mouse and keyboard input.
     virtual void OnMouseDown(WPARAM btnState, int x, int y) { }
     virtual void OnMouseUp(WPARAM btnState, int x, int y) { }
     virtual void OnMouseMove(WPARAM btnState, int x, int y) { }
+    virtual void OnKeyUp(WPARAM key) { }
 
 protected:
     bool InitMainWindow();
@@ -102,8 +105,7 @@ protected:
     ComPtr<ID3D12Resource>              mSwapChainBuffer[SwapChainBufferCount];
 
     //潺  
-    ComPtr<ID3D12Fence>                 mFence;
-    UINT64                              mCurrentFence = 0;
+    std::unique_ptr<D3D12FrameFence>    mFence;
     
     // ũ 
     UINT                                mRtvDescriptorSize = 0;
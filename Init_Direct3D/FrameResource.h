@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../Common/MathHelper.h"
+#include "../Common/UploadHeap.h"
+#include <cstddef>
+using namespace DirectX;
+
+//  ڿ , SceneRenderer.cpp 
+extern const int gNumFrameResources;
+
+#define MAX_LIGHTS 16
+
+// νϽ  ,  /  Ʈ    ׸
+struct InstanceData
+{
+	XMFLOAT4X4 World = MathHelper::Identity4x4();
+};
+
+// ο츶 Ʈ  ѱ  (cbPerDraw)
+//  ̸ ġ ޽   Ѵ,   ۿ ε д´
+struct DrawConstants
+{
+	UINT InstanceBase = 0;
+	XMFLOAT3 QuantCenter = { 0.0f, 0.0f, 0.0f };
+	XMFLOAT3 QuantExtents = { 1.0f, 1.0f, 1.0f };
+	UINT MaterialIndex = 0;
+};
+
+//   , 256Ʈ    32Ʈ  ä
+struct MaterialData
+{
+	XMFLOAT4 DiffuseAlbedo = { 1.0f, 1.0f, 1.0f, 1.0f };
+	XMFLOAT3 FresnelR0 = { 0.01f, 0.01f, 0.01f };
+	float Roughness = 0.25f;
+};
+
+// Params.hlsl StructuredBuffer , cbPerDraw ġ ߳ ̴   д´
+static_assert(sizeof(InstanceData) == 64, "InstanceData must match the gInstanceData stride.");
+static_assert(sizeof(MaterialData) == 32, "MaterialData must match the gMaterialData stride.");
+static_assert(sizeof(DrawConstants) == 32, "DrawConstants must be the 8 root constants of cbPerDraw.");
+static_assert(offsetof(DrawConstants, MaterialIndex) == 28, "gMaterialIndex is the last of cbPerDraw's root constants.");
+
+// 
+struct LightInfo
+{
+	UINT LightType = 0;
+	XMFLOAT3 padding = { 0.0f, 0.0f, 0.0f };
+	XMFLOAT3 Strength = { 0.5f,  0.5f, 0.5f };
+	float FalloffStart = 1.0f;						//point / spot
+	XMFLOAT3 Direction = { 0.0f, -1.0f, 0.0f };		//direction / spot
+	float FalloffEnd = 10.0f;						//point / spot
+	XMFLOAT3 Position = { 0.0f, 0.0f, 0.0f };		//point / spot
+	float SpotPower = 64.0f;						//spot
+};
+
+//   
+struct PassConstants
+{
+	XMFLOAT4X4 View = MathHelper::Identity4x4();
+	XMFLOAT4X4 InvView = MathHelper::Identity4x4();
+	XMFLOAT4X4 Proj = MathHelper::Identity4x4();
+	XMFLOAT4X4 InvProj = MathHelper::Identity4x4();
+	XMFLOAT4X4 ViewProj = MathHelper::Identity4x4();
+	XMFLOAT4 AmbientLight = { 0.0f, 0.0f, 0.0f, 1.0f };
+	XMFLOAT3 EyePosW = { 0.0f, 0.0f, 0.0f };
+	UINT LightCount;
+	LightInfo Lights[MAX_LIGHTS];
+};
+
+//   ϴ  ʿ ڿ
+// GPU   óϴ  CPU ٸ  ڿ   Ѵ
+//  Ҵڴ CommandRecorderPool  ڿ ε  д
+struct FrameResource
+{
+	//  , ٲ  ٽ Ƿ Ӹ  Ҵ ʰ  Ѵ
+	UploadAllocation MaterialBuffer;
+};
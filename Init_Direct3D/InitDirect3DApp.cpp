@@ -21,6 +21,12 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,
         MessageBox(nullptr, e.ToString().c_str(), L"HR Failed", MB_OK);
         return 0;
     }
+    catch (std::exception& e)
+    {
+        // ̽  ڵ( , δ ) ǥ ܸ 
+        MessageBoxA(nullptr, e.what(), "Failed", MB_OK);
+        return 0;
+    }
 }
 
 InitDirect3DApp::InitDirect3DApp(HINSTANCE hInstance)
@@ -30,6 +36,9 @@ InitDirect3DApp::InitDirect3DApp(HINSTANCE hInstance)
 
 InitDirect3DApp::~InitDirect3DApp()
 {
+    // GPU     ڿ  ʵ 
+    if (md3dDevice != nullptr)
+        FlushCommandQueue();
 }
 
 bool InitDirect3DApp::Initialize()
@@ -37,18 +46,46 @@ bool InitDirect3DApp::Initialize()
     if (!D3DApp::Initialize())
         return false;
 
+    mInitRecorder.SetCommandList(mCommandList.Get());
+
     //ʱȭ ɵ غϱ    缳
     ThrowIfFailed(mCommandList->Reset(mCommandListAlloc.Get(), nullptr));
 
+    // ۾ 尡 ׸⸦   , Ҵڴ  ڿ  д
+    mRecorderPool = std::make_unique<D3D12RecorderPool>(md3dDevice.Get(), mCommandQueue.Get(), gNumFrameResources);
+
+    //   ۴ ⺻/ε  ڿ 
+    SceneResourceFactory factory;
+    factory.CreateGeometryUploader = [this](UINT64 stagingByteSize, bool keepStaging)
+    {
+        return std::unique_ptr<GeometryUploader>(
+            std::make_unique<StaticGeometryUploader>(md3dDevice.Get(), stagingByteSize, keepStaging));
+    };
+    factory.CreateUploadHeap = [this](UINT64 pageSize)
+    {
+        return std::unique_ptr<UploadHeap>(std::make_unique<DynamicUploadHeap>(md3dDevice.Get(), pageSize));
+    };
+
+    mScene = std::make_unique<SceneRenderer>(factory, *mFence, *mRecorderPool, mVertexEncoding);
+    mScene->Resize(mClientWidth, mClientHeight);
+
     //ʱȭ ɵ
+    {
+        // ذ  ĳ   Ƿ 鿡 ø   д
+        MeshCache cache;
+        std::pmr::vector<Vertex> skullVertices(&mScene->LoadScratch());
+        std::pmr::vector<std::uint32_t> skullIndices(&mScene->LoadScratch());
+        SceneModel skull;
+        bool hasSkull = LoadSkullModel(cache, skullVertices, skullIndices, skull);
+
+        mScene->Build(mInitRecorder, hasSkull ? &skull : nullptr);
+    }
+
     BuildInputLayout();
-    BuildGeometry();
-    BuildMaterials();
-    BuildRenderItem();
     BuildShader();
-    BuildConstantBuffer();
     BuildRootSignature();
     BuildPSO();
+    mScene->SetPipeline(mPSO.Get(), mRootSignature.Get());
     
     //ʱȭ ɵ 
     ThrowIfFailed(mCommandList->Close());
@@ -59,6 +96,10 @@ bool InitDirect3DApp::Initialize()
     //ʱȭ Ϸ ٸ
     FlushCommandQueue();
 
+    // 簡 Ƿ ʱȭ ¡ ۿ ε ӽ ޸ 
+    mScene->EndBuild();
+    LogBuild();
+
     return true;
 }
 
@@ -66,190 +107,67 @@ void InitDirect3DApp::OnResize()
 {
     D3DApp::OnResize();
 
-    //â ũⰡ ٲ  , Ⱦ ->  
-    XMMATRIX proj = XMMatrixPerspectiveFovLH(0.25f * MathHelper::Pi, AspectRatio(), 1.0f, 1000.0f);
-    XMStoreFloat4x4(&mProj, proj);
+    //  D3DApp::Initialize ù OnResize ڿ 
+    if (mScene != nullptr)
+        mScene->Resize(mClientWidth, mClientHeight);
 }
 
 void InitDirect3DApp::Update(const GameTimer& gt)
 {
-    //  ǥ  ǥ
-    UpdateCamera(gt);
-    UpdateObjectCB(gt);
-    UpdateMaterialCB(gt);
-    UpdatePassCB(gt);
+    mScene->SetCameraOrbit(mTheta, mPhi, mRadius);
+    mScene->Update();
 }
 
-void InitDirect3DApp::UpdateCamera(const GameTimer& gt)
+std::wstring InitDirect3DApp::FrameStatsText()const
 {
-    mEyePos.x = mRadius * sinf(mPhi) * cosf(mTheta);
-    mEyePos.z = mRadius * sinf(mPhi) * sinf(mTheta);
-    mEyePos.y = mRadius * cosf(mPhi);
-
-    // þ 
-    XMVECTOR pos = XMVectorSet(mEyePos.x, mEyePos.y, mEyePos.z, 1.0f);
-    XMVECTOR target = XMVectorZero();
-    XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-
-    XMMATRIX view = XMMatrixLookAtLH(pos, target, up);
-    XMStoreFloat4x4(&mView, view);
-}
-
-void InitDirect3DApp::UpdateObjectCB(const GameTimer& gt)
-{
-    //  Ʈ   
-    for (auto& item : mRenderItems)
-    {
-        XMMATRIX world = XMLoadFloat4x4(&item->World);
-
-        ObjectConstants objConstants;
-        XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
-        
-        UINT elementIndex = item->ObjCBIndex;
-        UINT elementByteSize = (sizeof(ObjectConstants) + 255) & ~255;
-        memcpy(&mObjectMappedData[elementIndex * elementByteSize], &objConstants, sizeof(ObjectConstants));
-    }
-}
-
-void InitDirect3DApp::UpdateMaterialCB(const GameTimer& gt)
-{
-    for (auto& item : mMaterials)
-    {
-        MaterialInfo* mat = item.second.get();
-
-        MaterialsConstants matConstants;
-        matConstants.DiffuseAlbedo = mat->DiffuseAlbedo;
-        matConstants.FresnelR0 = mat->FresnelR0;
-        matConstants.Roughness = mat->Roughness;
-
-        UINT elementIndex = mat->MatCBIndex;
-        UINT elementByteSize = (sizeof(MaterialsConstants) + 255) & ~255;
-        memcpy(&mMaterialMappedData[elementIndex * elementByteSize], &matConstants, sizeof(matConstants));
-    }
-}
-
-void InitDirect3DApp::UpdatePassCB(const GameTimer& gt)
-{
-    PassConstants mainPass;
-    XMMATRIX view = XMLoadFloat4x4(&mView);
-    XMMATRIX proj = XMLoadFloat4x4(&mProj);
-
-    XMMATRIX invView = XMMatrixInverse(&XMMatrixDeterminant(view), view);
-    XMMATRIX invProj = XMMatrixInverse(&XMMatrixDeterminant(proj), proj);
-    XMMATRIX viewProj = XMMatrixMultiply(view, proj);
-
-    XMStoreFloat4x4(&mainPass.View, XMMatrixTranspose(view));
-    XMStoreFloat4x4(&mainPass.InvView, XMMatrixTranspose(invView));
-    XMStoreFloat4x4(&mainPass.Proj, XMMatrixTranspose(proj));
-    XMStoreFloat4x4(&mainPass.InvProj, XMMatrixTranspose(invProj));
-    XMStoreFloat4x4(&mainPass.ViewProj, XMMatrixTranspose(viewProj));
-   
-    mainPass.AmbientLight = { 0.25f, 0.25f, 0.35f, 1.0f };
-    mainPass.EyePosW = mEyePos;
-    mainPass.LightCount = 11;
-
-    mainPass.Lights[0].LightType = 0;
-    mainPass.Lights[0].Direction = { 0.57735f, -0.57735f, 0.57735f };
-    mainPass.Lights[0].Strength = { 0.6f, 0.6f, 0.6f };
-    
-    for (int i = 0; i < 5; ++i)
-    {
-        mainPass.Lights[1 + i].LightType = 1;
-        mainPass.Lights[1 + i].Strength = {0.6f,0.6f,0.6f};
-        mainPass.Lights[1 + i].Position = XMFLOAT3(-5.0f, 3.5f, -10.0f + i * 5.0f);
-        mainPass.Lights[1 + i].FalloffStart = 2;
-        mainPass.Lights[1 + i].FalloffEnd = 5;
-    }
-
-    for (int i = 0; i < 5; ++i)
-    {
-        mainPass.Lights[6 + i].LightType = 1;
-        mainPass.Lights[6 + i].Strength = { 0.6f,0.6f,0.6f };
-        mainPass.Lights[6 + i].Position = XMFLOAT3(+5.0f, 3.5f, -10.0f + i * 5.0f);
-        mainPass.Lights[6 + i].FalloffStart = 2;
-        mainPass.Lights[6 + i].FalloffEnd = 5;
-    }
-
-    memcpy(&mPassMappedData[0], &mainPass, sizeof(PassConstants));
+    const FrameStats& stats = mScene->Stats();
+
+    return L"   cb bytes: " + std::to_wstring(stats.ConstantBytesWritten) +
+        L"   visible: " + std::to_wstring(stats.VisibleItems) +
+        L"   culled: " + std::to_wstring(stats.CulledItems) +
+        L"   draws: " + std::to_wstring(stats.DrawCalls) +
+        L"   instances: " + std::to_wstring(stats.Instances) +
+        L"   tris skipped: " + std::to_wstring(stats.TrianglesSkipped) + L"/" + std::to_wstring(stats.ClusterTriangles) +
+        L"   lod items: " + std::to_wstring(stats.LodItems) +
+        L"   indices: " + std::to_wstring(stats.IndicesSubmitted) +
+        L"   terrain chunks: " + std::to_wstring(stats.TerrainChunks) + L" (+" + std::to_wstring(stats.TerrainChunksLoaded) + L")" +
+        L"   state sets: " + std::to_wstring(stats.StateCommands) + L" (skipped " + std::to_wstring(stats.StateCommandsSkipped) + L")" +
+        L"   lists: " + std::to_wstring(stats.RecordedLists) +
+        L"   packed saved: " + std::to_wstring(stats.PaddingBytesSaved) +
+        L"   upload: " + std::to_wstring(stats.UploadBytes) + L" bytes in " + std::to_wstring(stats.UploadPages) + L" pages" +
+        (mScene->CaptureCommands() ?
+            L"   captured: " + std::to_wstring(stats.CapturedCommands) + L" cmds, " +
+            std::to_wstring(stats.CapturedDraws) + L" draws, " +
+            std::to_wstring(stats.CapturedStateChanges) + L" state, " +
+            std::to_wstring(stats.CapturedBarriers) + L" barriers, " +
+            std::to_wstring(stats.CapturedBytes) + L" bytes" :
+            std::wstring());
 }
 
 void InitDirect3DApp::DrawBegin(const GameTimer& gt)
 {
-    ThrowIfFailed(mCommandListAlloc->Reset());
-    ThrowIfFailed(mCommandList->Reset(mCommandListAlloc.Get(), nullptr));
-
-    mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(
-        CurrentBackBuffer(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
-    
-    mCommandList->RSSetViewports(1, &mScreenViewport);
-    mCommandList->RSSetScissorRects(1, &mScissorRect);
-
-    mCommandList->ClearRenderTargetView(CurrentBackBufferView(), Colors::LightSteelBlue, 0, nullptr);
-    mCommandList->ClearDepthStencilView(DepthStencilView(),
-        D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
-
-    mCommandList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
+    // غ (ε/ȯ/)  ׸ ϰ Բ Ѵ
 }
 
 void InitDirect3DApp::Draw(const GameTimer& gt)
 {
-    //   
-    mCommandList->SetPipelineState(mPSO.Get());
-
-    // Ʈ ñ״ó ε
-    mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
-
-    //    ε
-    D3D12_GPU_VIRTUAL_ADDRESS passCBAddress = mPassCB->GetGPUVirtualAddress();
-    mCommandList->SetGraphicsRootConstantBufferView(2, passCBAddress);
-
-    DrawRenderItems();
-}
-
-void InitDirect3DApp::DrawRenderItems()
-{
-    UINT objCBByteSize = (sizeof(ObjectConstants) + 255) & ~255;
-    UINT matCBByteSize = (sizeof(MaterialsConstants) + 255) & ~255;
-    
-    for (size_t i = 0; i < mRenderItems.size(); ++i)
-    {
-        auto item = mRenderItems[i].get();
-
-        // Ʈ    
-        D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = mObjectCB->GetGPUVirtualAddress();
-        objCBAddress += item->ObjCBIndex * objCBByteSize;
-        
-        mCommandList->SetGraphicsRootConstantBufferView(0, objCBAddress);
-
-        //     
-        D3D12_GPU_VIRTUAL_ADDRESS matCBAddress = mMaterialCB->GetGPUVirtualAddress();
-        matCBAddress += item->Mat->MatCBIndex * matCBByteSize;
-
-        mCommandList->SetGraphicsRootConstantBufferView(1, matCBAddress);
-
-        mCommandList->IASetVertexBuffers(0, 1, &item->Geo->VertexBufferView);
-        mCommandList->IASetIndexBuffer(&item->Geo->IndexBufferView);
-        mCommandList->IASetPrimitiveTopology(item->PrimitiveType);
-
-        mCommandList->DrawIndexedInstanced(item->Geo->IndexCount, 1, 0, 0, 0);
-    }
-
+    SceneFrameTarget target;
+    target.BackBuffer = CurrentBackBuffer();
+    target.RenderTarget = CurrentBackBufferView();
+    target.DepthStencil = DepthStencilView();
+    target.Viewport = mScreenViewport;
+    target.ScissorRect = mScissorRect;
+
+    mScene->Draw(target);
 }
 
 void InitDirect3DApp::DrawEnd(const GameTimer& gt)
 {
-    mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
-        D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
-
-    ThrowIfFailed(mCommandList->Close());
-
-    ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
-    mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-    
     ThrowIfFailed(mSwapChain->Present(0, 0));
     mCurrentBackBuffer = (mCurrentBackBuffer + 1) % SwapChainBufferCount;
 
-    FlushCommandQueue();
+    // ٸ ʰ 潺  ,   ڿ ٽ    ȮѴ
+    mScene->EndFrame();
 }
 
 void InitDirect3DApp::OnMouseDown(WPARAM btnState, int x, int y)
@@ -289,584 +207,134 @@ void InitDirect3DApp::OnMouseMove(WPARAM btnState, int x, int y)
     mLastMovesePos.y = y;
 }
 
-void InitDirect3DApp::BuildInputLayout()
-{
-    mInputLayout =
-    {
-        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
-    };
-}
-
-void InitDirect3DApp::BuildGeometry()
-{
-    BuildBoxGeometry();
-    BuildGridGeometry();
-    BuildSphereGeometry();
-    BuildCylinderGeometry();
-    BuildSkullGeometry();
-}
-
-void InitDirect3DApp::BuildBoxGeometry()
+void InitDirect3DApp::OnKeyUp(WPARAM key)
 {
-    GeometryGenerator geoGen;
-    GeometryGenerator::MeshData box = geoGen.CreateBox(1.5f, 0.5f, 1.5f, 3);
-
-    std::vector<Vertex> vertices(box.Vertices.size());
-
-    for (UINT i = 0; i < box.Vertices.size(); ++i)
-    {
-        vertices[i].Pos = box.Vertices[i].Position;
-        vertices[i].Normal = box.Vertices[i].Normal;
-    }
-
-    std::vector<std::uint16_t> indices;
-    indices.insert(indices.end(), std::begin(box.GetIndices16()), std::end(box.GetIndices16()));
-
-    auto geo = std::make_unique<GeometryInfo>();
-    geo->Name = "Box";
-    geo->VertexCount = (UINT)vertices.size();
-    const UINT vbByteSize = geo->VertexCount * sizeof(Vertex);
-
-    D3D12_HEAP_PROPERTIES heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(vbByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->VertexBuffer));
-    
-    void* vertexDataBuffer = nullptr;
-    CD3DX12_RANGE vertexRange(0, 0);
-    geo->VertexBuffer->Map(0, &vertexRange, &vertexDataBuffer);
-    memcpy(vertexDataBuffer, vertices.data(), vbByteSize);
-    geo->VertexBuffer->Unmap(0, nullptr);
-
-    geo->VertexBufferView.BufferLocation = geo->VertexBuffer->GetGPUVirtualAddress();
-    geo->VertexBufferView.StrideInBytes = sizeof(Vertex);
-    geo->VertexBufferView.SizeInBytes = vbByteSize;
-
-    //ε  
-    geo->IndexCount = (UINT)indices.size();
-    const UINT ibByteSize = geo->IndexCount * sizeof(std::uint16_t);
-
-    heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    desc = CD3DX12_RESOURCE_DESC::Buffer(ibByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->IndexBuffer));
-
-    void* indexDataBuffer = nullptr;
-    CD3DX12_RANGE indexRange(0, 0);
-    geo->IndexBuffer->Map(0, &indexRange, &indexDataBuffer);
-    memcpy(indexDataBuffer, indices.data(), ibByteSize);
-    geo->IndexBuffer->Unmap(0, nullptr);
-    
-    geo->IndexBufferView.BufferLocation = geo->IndexBuffer->GetGPUVirtualAddress();
-    geo->IndexBufferView.Format = DXGI_FORMAT_R16_UINT;
-    geo->IndexBufferView.SizeInBytes = ibByteSize;
-
-    mGeoMetries[geo->Name] = std::move(geo);
-
+    if (key == 'C')
+        mScene->SetCaptureCommands(!mScene->CaptureCommands());
 }
 
-void InitDirect3DApp::BuildGridGeometry()
-{
-    GeometryGenerator geoGen;
-    GeometryGenerator::MeshData grid = geoGen.CreateGrid(20.0f, 30.0f, 60, 40);
-
-    std::vector<Vertex> vertices(grid.Vertices.size());
-
-    for (UINT i = 0; i < grid.Vertices.size(); ++i)
-    {
-        vertices[i].Pos = grid.Vertices[i].Position;
-        vertices[i].Normal = grid.Vertices[i].Normal;
-    }
-
-    std::vector<std::uint16_t> indices;
-    indices.insert(indices.end(), std::begin(grid.GetIndices16()), std::end(grid.GetIndices16()));
-
-    auto geo = std::make_unique<GeometryInfo>();
-    geo->Name = "Grid";
-    geo->VertexCount = (UINT)vertices.size();
-    const UINT vbByteSize = geo->VertexCount * sizeof(Vertex);
-
-    D3D12_HEAP_PROPERTIES heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(vbByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->VertexBuffer));
-
-    void* vertexDataBuffer = nullptr;
-    CD3DX12_RANGE vertexRange(0, 0);
-    geo->VertexBuffer->Map(0, &vertexRange, &vertexDataBuffer);
-    memcpy(vertexDataBuffer, vertices.data(), vbByteSize);
-    geo->VertexBuffer->Unmap(0, nullptr);
-
-    geo->VertexBufferView.BufferLocation = geo->VertexBuffer->GetGPUVirtualAddress();
-    geo->VertexBufferView.StrideInBytes = sizeof(Vertex);
-    geo->VertexBufferView.SizeInBytes = vbByteSize;
-
-    //ε  
-    geo->IndexCount = (UINT)indices.size();
-    const UINT ibByteSize = geo->IndexCount * sizeof(std::uint16_t);
-
-    heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    desc = CD3DX12_RESOURCE_DESC::Buffer(ibByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->IndexBuffer));
-
-    void* indexDataBuffer = nullptr;
-    CD3DX12_RANGE indexRange(0, 0);
-    geo->IndexBuffer->Map(0, &indexRange, &indexDataBuffer);
-    memcpy(indexDataBuffer, indices.data(), ibByteSize);
-    geo->IndexBuffer->Unmap(0, nullptr);
-
-    geo->IndexBufferView.BufferLocation = geo->IndexBuffer->GetGPUVirtualAddress();
-    geo->IndexBufferView.Format = DXGI_FORMAT_R16_UINT;
-    geo->IndexBufferView.SizeInBytes = ibByteSize;
-
-    mGeoMetries[geo->Name] = std::move(geo);
-
-}
-
-void InitDirect3DApp::BuildSphereGeometry()
+void InitDirect3DApp::BuildInputLayout()
 {
-    GeometryGenerator geoGen;
-    GeometryGenerator::MeshData sphere = geoGen.CreateSphere(0.5f, 20, 20);
-
-    std::vector<Vertex> vertices(sphere.Vertices.size());
-
-    for (UINT i = 0; i < sphere.Vertices.size(); ++i)
+    switch (mVertexEncoding)
     {
-        vertices[i].Pos = sphere.Vertices[i].Position;
-        vertices[i].Normal = sphere.Vertices[i].Normal;
+    case VertexEncoding::CompactOct16:
+        // 12Ʈ: ġ unorm16 x3 (+̻ 1),  ȸü snorm16 x2
+        mInputLayout =
+        {
+            {"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UINT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+            {"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+        };
+        break;
+    case VertexEncoding::CompactOct8:
+        // 8Ʈ: ġ unorm16 x3,  ȸü snorm8 x2  ° п 
+        mInputLayout =
+        {
+            {"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UINT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+        };
+        break;
+    default:
+        mInputLayout =
+        {
+            {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+            {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+        };
+        break;
     }
-
-    std::vector<std::uint16_t> indices;
-    indices.insert(indices.end(), std::begin(sphere.GetIndices16()), std::end(sphere.GetIndices16()));
-
-    auto geo = std::make_unique<GeometryInfo>();
-    geo->Name = "Sphere";
-    geo->VertexCount = (UINT)vertices.size();
-    const UINT vbByteSize = geo->VertexCount * sizeof(Vertex);
-
-    D3D12_HEAP_PROPERTIES heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(vbByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->VertexBuffer));
-
-    void* vertexDataBuffer = nullptr;
-    CD3DX12_RANGE vertexRange(0, 0);
-    geo->VertexBuffer->Map(0, &vertexRange, &vertexDataBuffer);
-    memcpy(vertexDataBuffer, vertices.data(), vbByteSize);
-    geo->VertexBuffer->Unmap(0, nullptr);
-
-    geo->VertexBufferView.BufferLocation = geo->VertexBuffer->GetGPUVirtualAddress();
-    geo->VertexBufferView.StrideInBytes = sizeof(Vertex);
-    geo->VertexBufferView.SizeInBytes = vbByteSize;
-
-    //ε  
-    geo->IndexCount = (UINT)indices.size();
-    const UINT ibByteSize = geo->IndexCount * sizeof(std::uint16_t);
-
-    heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    desc = CD3DX12_RESOURCE_DESC::Buffer(ibByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->IndexBuffer));
-
-    void* indexDataBuffer = nullptr;
-    CD3DX12_RANGE indexRange(0, 0);
-    geo->IndexBuffer->Map(0, &indexRange, &indexDataBuffer);
-    memcpy(indexDataBuffer, indices.data(), ibByteSize);
-    geo->IndexBuffer->Unmap(0, nullptr);
-
-    geo->IndexBufferView.BufferLocation = geo->IndexBuffer->GetGPUVirtualAddress();
-    geo->IndexBufferView.Format = DXGI_FORMAT_R16_UINT;
-    geo->IndexBufferView.SizeInBytes = ibByteSize;
-
-    mGeoMetries[geo->Name] = std::move(geo);
 }
 
-void InitDirect3DApp::BuildCylinderGeometry()
+bool InitDirect3DApp::LoadSkullModel(MeshCache& cache, std::pmr::vector<Vertex>& vertices,
+    std::pmr::vector<std::uint32_t>& indices, SceneModel& model)
 {
-    GeometryGenerator geoGen;
-    GeometryGenerator::MeshData cylinder = geoGen.CreateCylinder(0.5f, 0.3f, 3.0f, 20, 20);
-
-    std::vector<Vertex> vertices(cylinder.Vertices.size());
-
-    for (UINT i = 0; i < cylinder.Vertices.size(); ++i)
+    const std::wstring cacheFile = L"../Models/skull.mesh";
+    const std::wstring sourceFile = L"../Models/skull.txt";
+
+    // ̳ʸ ĳð  Ľ  ε ͸ ״ 
+    // ޽÷  ε ޽÷, LOD  Ƿ ȭ/޽÷/LOD ٽ  ʴ´
+    if (cache.Open(cacheFile, sourceFile) &&
+        cache.Header().VertexStride == sizeof(Vertex) &&
+        cache.Header().IndexStride == sizeof(std::uint32_t))
     {
-        vertices[i].Pos = cylinder.Vertices[i].Position;
-        vertices[i].Normal = cylinder.Vertices[i].Normal;
+        model.Vertices = reinterpret_cast<const Vertex*>(cache.Vertices());
+        model.VertexCount = cache.Header().VertexCount;
+        model.Indices = reinterpret_cast<const std::uint32_t*>(cache.Indices());
+        model.IndexCount = cache.Header().IndexCount;
+        model.Meshlets = cache.Meshlets();
+        model.MeshletCount = cache.MeshletCount();
+
+        for (UINT level = 0; level < cache.LodCount(); ++level)
+        {
+            SceneModelLod& lod = model.Lods.emplace_back();
+            lod.Vertices = reinterpret_cast<const Vertex*>(cache.LodVertices(level));
+            lod.VertexCount = cache.Lod(level).VertexCount;
+            lod.Indices = reinterpret_cast<const std::uint32_t*>(cache.LodIndices(level));
+            lod.IndexCount = cache.Lod(level).IndexCount;
+            lod.Error = cache.Lod(level).Error;
+        }
+        return true;
     }
+    cache.Close();
 
-    std::vector<std::uint16_t> indices;
-    indices.insert(indices.end(), std::begin(cylinder.GetIndices16()), std::end(cylinder.GetIndices16()));
-
-    auto geo = std::make_unique<GeometryInfo>();
-    geo->Name = "Cylinder";
-    geo->VertexCount = (UINT)vertices.size();
-    const UINT vbByteSize = geo->VertexCount * sizeof(Vertex);
-
-    D3D12_HEAP_PROPERTIES heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(vbByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->VertexBuffer));
-
-    void* vertexDataBuffer = nullptr;
-    CD3DX12_RANGE vertexRange(0, 0);
-    geo->VertexBuffer->Map(0, &vertexRange, &vertexDataBuffer);
-    memcpy(vertexDataBuffer, vertices.data(), vbByteSize);
-    geo->VertexBuffer->Unmap(0, nullptr);
-
-    geo->VertexBufferView.BufferLocation = geo->VertexBuffer->GetGPUVirtualAddress();
-    geo->VertexBufferView.StrideInBytes = sizeof(Vertex);
-    geo->VertexBufferView.SizeInBytes = vbByteSize;
-
-    //ε  
-    geo->IndexCount = (UINT)indices.size();
-    const UINT ibByteSize = geo->IndexCount * sizeof(std::uint16_t);
-
-    heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    desc = CD3DX12_RESOURCE_DESC::Buffer(ibByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->IndexBuffer));
-
-    void* indexDataBuffer = nullptr;
-    CD3DX12_RANGE indexRange(0, 0);
-    geo->IndexBuffer->Map(0, &indexRange, &indexDataBuffer);
-    memcpy(indexDataBuffer, indices.data(), ibByteSize);
-    geo->IndexBuffer->Unmap(0, nullptr);
-
-    geo->IndexBufferView.BufferLocation = geo->IndexBuffer->GetGPUVirtualAddress();
-    geo->IndexBufferView.Format = DXGI_FORMAT_R16_UINT;
-    geo->IndexBufferView.SizeInBytes = ibByteSize;
-
-    mGeoMetries[geo->Name] = std::move(geo);
-}
-
-void InitDirect3DApp::BuildSkullGeometry()
-{
-    std::ifstream fin("../Models/skull.txt");
-    if (!fin)
+    if (!TextModelLoader::Load(sourceFile, vertices, indices, &mScene->LoadScratch()))
     {
         MessageBox(0, L"../Models/skull.txt not found.", 0, 0);
-        return;
+        return false;
     }
 
-    UINT vCount = 0;
-    UINT tCount = 0;
-    std::string ignore;
-    
-    fin >> ignore >> vCount;
-    fin >> ignore >> tCount;
-    fin >> ignore >> ignore >> ignore >> ignore;
+    // ȭ, ޽÷, LOD    ĳÿ ϹǷ  ʹ ٽ  ʿ䰡 
+    model = mScene->PrepareModel("Skull", vertices, indices);
 
-    std::vector<Vertex> vertices(vCount);
-    for (UINT i = 0; i < vCount; ++i)
-    {
-        fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-        fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-    }
+    BoundingBox bounds;
+    BoundingBox::CreateFromPoints(bounds, vertices.size(), &vertices[0].Pos, sizeof(Vertex));
 
-    fin >> ignore;
-    fin >> ignore;
-    fin >> ignore;
-    
-    std::vector<std::int32_t> indices(3 * tCount);
-    for (UINT i = 0; i < tCount; ++i)
+    std::vector<MeshCacheLodSource> lods(model.Lods.size());
+    for (size_t level = 0; level < lods.size(); ++level)
     {
-        fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
+        lods[level].Vertices = model.Lods[level].Vertices;
+        lods[level].VertexCount = model.Lods[level].VertexCount;
+        lods[level].Indices = model.Lods[level].Indices;
+        lods[level].IndexCount = model.Lods[level].IndexCount;
+        lods[level].Error = model.Lods[level].Error;
     }
 
-    auto geo = std::make_unique<GeometryInfo>();
-    geo->Name = "Skull";
-    geo->VertexCount = (UINT)vertices.size();
-    const UINT vbByteSize = geo->VertexCount * sizeof(Vertex);
-
-    D3D12_HEAP_PROPERTIES heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(vbByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->VertexBuffer));
-
-    void* vertexDataBuffer = nullptr;
-    CD3DX12_RANGE vertexRange(0, 0);
-    geo->VertexBuffer->Map(0, &vertexRange, &vertexDataBuffer);
-    memcpy(vertexDataBuffer, vertices.data(), vbByteSize);
-    geo->VertexBuffer->Unmap(0, nullptr);
-
-    geo->VertexBufferView.BufferLocation = geo->VertexBuffer->GetGPUVirtualAddress();
-    geo->VertexBufferView.StrideInBytes = sizeof(Vertex);
-    geo->VertexBufferView.SizeInBytes = vbByteSize;
-
-    //ε  
-    geo->IndexCount = (UINT)indices.size();
-    const UINT ibByteSize = geo->IndexCount * sizeof(std::int32_t);
-
-    heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    desc = CD3DX12_RESOURCE_DESC::Buffer(ibByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&geo->IndexBuffer));
-
-    void* indexDataBuffer = nullptr;
-    CD3DX12_RANGE indexRange(0, 0);
-    geo->IndexBuffer->Map(0, &indexRange, &indexDataBuffer);
-    memcpy(indexDataBuffer, indices.data(), ibByteSize);
-    geo->IndexBuffer->Unmap(0, nullptr);
-
-    geo->IndexBufferView.BufferLocation = geo->IndexBuffer->GetGPUVirtualAddress();
-    geo->IndexBufferView.Format = DXGI_FORMAT_R32_UINT;
-    geo->IndexBufferView.SizeInBytes = ibByteSize;
-
-    mGeoMetries[geo->Name] = std::move(geo);
-
-    fin.close();
-}
+    MeshCache::Write(cacheFile, sourceFile,
+        vertices.data(), sizeof(Vertex), (UINT)vertices.size(),
+        indices.data(), sizeof(std::uint32_t), (UINT)indices.size(),
+        bounds, model.Meshlets, model.MeshletCount, lods.data(), (UINT)lods.size());
 
-void InitDirect3DApp::BuildMaterials()
-{
-    UINT indexCount = 0;
-
-    auto green = std::make_unique<MaterialInfo>();
-    green->Name = "Green";
-    green->MatCBIndex = indexCount++;
-    green->DiffuseAlbedo = XMFLOAT4(Colors::ForestGreen);
-    green->FresnelR0 = XMFLOAT3(0.02f, 0.02f, 0.02f);
-    green->Roughness = 0.1f;
-    mMaterials[green->Name] = std::move(green);
-
-    auto blue = std::make_unique<MaterialInfo>();
-    blue->Name = "Blue";
-    blue->MatCBIndex = indexCount++;
-    blue->DiffuseAlbedo = XMFLOAT4(Colors::LightSteelBlue);
-    blue->FresnelR0 = XMFLOAT3(0.05f, 0.05f, 0.05f);
-    blue->Roughness = 0.3f;
-    mMaterials[blue->Name] = std::move(blue);
-
-
-    auto gray = std::make_unique<MaterialInfo>();
-    gray->Name = "Gray";
-    gray->MatCBIndex = indexCount++;
-    gray->DiffuseAlbedo = XMFLOAT4(Colors::LightGray);
-    gray->FresnelR0 = XMFLOAT3(0.02f, 0.02f, 0.02f);
-    gray->Roughness = 0.2f;
-    mMaterials[gray->Name] = std::move(gray);
-
-
-    auto skull = std::make_unique<MaterialInfo>();
-    skull->Name = "Skull";
-    skull->MatCBIndex = indexCount++;
-    skull->DiffuseAlbedo = XMFLOAT4(Colors::White);
-    skull->FresnelR0 = XMFLOAT3(0.05f, 0.05f, 0.05f);
-    skull->Roughness = 0.3f;
-    mMaterials[skull->Name] = std::move(skull);
+    return true;
 }
 
-void InitDirect3DApp::BuildRenderItem()
+void InitDirect3DApp::LogBuild()
 {
-    auto gridItem = std::make_unique<RenderItem>();
-    gridItem->ObjCBIndex = 0;
-    gridItem->World = MathHelper::Identity4x4();
-    gridItem->Geo = mGeoMetries["Grid"].get();
-    gridItem->Mat = mMaterials["Gray"].get();
-    gridItem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-    gridItem->IndexCount = gridItem->Geo->IndexCount;
-    mRenderItems.push_back(std::move(gridItem));
-
-    auto boxItem = std::make_unique<RenderItem>();
-    boxItem->ObjCBIndex = 1;
-    XMStoreFloat4x4(&boxItem->World, XMMatrixScaling(2.0f, 2.0f, 2.0f) * XMMatrixTranslation(0.0f, 0.5f, 0.0f));
-    boxItem->Geo = mGeoMetries["Box"].get();
-    boxItem->Mat = mMaterials["Blue"].get();
-    boxItem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-    boxItem->IndexCount = boxItem->Geo->IndexCount;
-    mRenderItems.push_back(std::move(boxItem));
-
-    //ذ
-    auto skullItem = std::make_unique<RenderItem>();
-    skullItem->ObjCBIndex = 2;
-    XMStoreFloat4x4(&skullItem->World, XMMatrixScaling(0.5f, 0.5f, 0.5f) * XMMatrixTranslation(0.0f, 1.f, 0.0f));
-    skullItem->Geo = mGeoMetries["Skull"].get();
-    skullItem->Mat = mMaterials["Skull"].get();
-    skullItem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-    skullItem->IndexCount = skullItem->Geo->IndexCount;
-    mRenderItems.push_back(std::move(skullItem));
-
-    UINT objCBIndex = 3;
-    for (int i = 0; i < 5; ++i)
+    for (const std::string& line : mScene->BuildLog())
     {
-        auto leftCylItem = std::make_unique<RenderItem>();
-        auto rightCylItem = std::make_unique<RenderItem>();
-        auto leftsphereItem = std::make_unique<RenderItem>();
-        auto rightsphereItem = std::make_unique<RenderItem>();
-
-        XMMATRIX leftCylWorld = XMMatrixTranslation(-5.0f, 1.5f, -10.0f + i * 5.0f);
-        XMMATRIX rightCylWorld = XMMatrixTranslation(+5.0f, 1.5f, -10.0f + i * 5.0f);
-
-        XMMATRIX leftsphereWorld = XMMatrixTranslation(-5.0f, 3.5f, -10.0f + i * 5.0f);
-        XMMATRIX rightsphereWorld = XMMatrixTranslation(+5.0f, 3.5f, -10.0f + i * 5.0f);
-
-        // Ǹ
-        XMStoreFloat4x4(&leftCylItem->World, leftCylWorld);
-        leftCylItem->ObjCBIndex = objCBIndex++;
-        leftCylItem->Geo = mGeoMetries["Cylinder"].get();
-        leftCylItem->Mat = mMaterials["Green"].get();
-        leftCylItem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-        leftCylItem->IndexCount = leftCylItem->Geo->IndexCount;
-        mRenderItems.push_back(std::move(leftCylItem));
-
-        // Ǹ
-        XMStoreFloat4x4(&rightCylItem->World, rightCylWorld);
-        rightCylItem->ObjCBIndex = objCBIndex++;
-        rightCylItem->Geo = mGeoMetries["Cylinder"].get();
-        rightCylItem->Mat = mMaterials["Green"].get();
-        rightCylItem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-        rightCylItem->IndexCount = rightCylItem->Geo->IndexCount;
-        mRenderItems.push_back(std::move(rightCylItem));
-
-        // Ǿ
-        XMStoreFloat4x4(&leftsphereItem->World, leftsphereWorld);
-        leftsphereItem->ObjCBIndex = objCBIndex++;
-        leftsphereItem->Geo = mGeoMetries["Sphere"].get();
-        leftsphereItem->Mat = mMaterials["Blue"].get();
-        leftsphereItem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-        leftsphereItem->IndexCount = leftsphereItem->Geo->IndexCount;
-        mRenderItems.push_back(std::move(leftsphereItem));
-
-        // Ǿ
-        XMStoreFloat4x4(&rightsphereItem->World, rightsphereWorld);
-        rightsphereItem->ObjCBIndex = objCBIndex++;
-        rightsphereItem->Geo = mGeoMetries["Sphere"].get();
-        rightsphereItem->Mat = mMaterials["Blue"].get();
-        rightsphereItem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-        rightsphereItem->IndexCount = rightsphereItem->Geo->IndexCount;
-        mRenderItems.push_back(std::move(rightsphereItem));
+        OutputDebugStringA(line.c_str());
+        OutputDebugStringA("\n");
     }
-
-
 }
 
 void InitDirect3DApp::BuildShader()
 {
-    mVSByteCode = d3dUtil::CompileShader(L"Color.hlsl", nullptr, "VS", "vs_5_0");
-    mPSByteCode = d3dUtil::CompileShader(L"Color.hlsl", nullptr, "PS", "ps_5_0");
-}
+    const D3D_SHADER_MACRO compact16[] = { { "COMPACT_VERTEX", "1" }, { nullptr, nullptr } };
+    const D3D_SHADER_MACRO compact8[] = { { "COMPACT_VERTEX", "2" }, { nullptr, nullptr } };
 
-void InitDirect3DApp::BuildConstantBuffer()
-{
-    //  Ʈ  
-    UINT size = sizeof(ObjectConstants);
-    mObjectByteSize = ((size + 255) & ~255) * mRenderItems.size();
-
-    D3D12_HEAP_PROPERTIES heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(mObjectByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&mObjectCB));
-
-    mObjectCB->Map(0, nullptr, reinterpret_cast<void**>(&mObjectMappedData));
-
-    //    
-    size = sizeof(MaterialsConstants);
-    mMaterialByteSize = ((size + 255) & ~255) * mMaterials.size();
-
-    heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    desc = CD3DX12_RESOURCE_DESC::Buffer(mMaterialByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&mMaterialCB));
-
-    mMaterialCB->Map(0, nullptr, reinterpret_cast<void**>(&mMaterialMappedData));
-
-    //   
-    size = sizeof(PassConstants);
-    mPassByteSize = ((size + 255) & ~255);
-    heapProperty = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    desc = CD3DX12_RESOURCE_DESC::Buffer(mPassByteSize);
-
-    md3dDevice->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &desc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&mPassCB));
-
-    mPassCB->Map(0, nullptr, reinterpret_cast<void**>(&mPassMappedData));
+    const D3D_SHADER_MACRO* defines = nullptr;
+    if (mVertexEncoding == VertexEncoding::CompactOct16)
+        defines = compact16;
+    else if (mVertexEncoding == VertexEncoding::CompactOct8)
+        defines = compact8;
+
+    mVSByteCode = d3dUtil::CompileShader(L"Color.hlsl", defines, "VS", "vs_5_0");
+    mPSByteCode = d3dUtil::CompileShader(L"Color.hlsl", defines, "PS", "ps_5_0");
 }
 
 void InitDirect3DApp::BuildRootSignature()
 {
-    CD3DX12_ROOT_PARAMETER param[3];
-    param[0].InitAsConstantBufferView(0); // 0 -> b0 :  Ʈ CBV
-    param[1].InitAsConstantBufferView(1); // 1 -> b1 :   CBV
+    CD3DX12_ROOT_PARAMETER param[4];
+    param[0].InitAsConstants(sizeof(DrawConstants) / 4, 0); // 0 -> b0 : νϽ  ġ, ȭ ,  ε Ʈ 
+    param[1].InitAsShaderResourceView(1); // 1 -> t1 :   SRV
     param[2].InitAsConstantBufferView(2); // 2 -> b2 :  CBV
+    param[3].InitAsShaderResourceView(0); // 3 -> t0 : νϽ  SRV
 
     D3D12_ROOT_SIGNATURE_DESC sigDesc = CD3DX12_ROOT_SIGNATURE_DESC(_countof(param), param);
     sigDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
@@ -22,17 +22,33 @@ struct Light
 	float SpotPower;
 };
 
-cbuffer cbPerObject : register(b0)
+struct InstanceData
 {
-	float4x4 gWorld;
+	float4x4 World;
 };
 
-cbuffer cbMaterial : register(b1)
+struct MaterialData
 {
-	float4 gDiffuseAlbedo;
-	float3 gFresnelR0;
-	float gRoughness;
-}
+	float4 DiffuseAlbedo;
+	float3 FresnelR0;
+	float Roughness;
+};
+
+// First instance of the current group in gInstanceData, the submesh bounds that
+// compact vertex positions were quantized against, and the group's entry in
+// gMaterialData
+cbuffer cbPerDraw : register(b0)
+{
+	uint gInstanceBase;
+	float3 gQuantCenter;
+	float3 gQuantExtents;
+	uint gMaterialIndex;
+};
+
+StructuredBuffer<InstanceData> gInstanceData : register(t0);
+
+// Tightly packed, 32 bytes per material instead of a 256-byte constant buffer each
+StructuredBuffer<MaterialData> gMaterialData : register(t1);
 
 cbuffer cbPass : register(b2)
 {
@@ -0,0 +1,985 @@
+#include "SceneRenderer.h"
+#include <DirectXColors.h>
+#include <cstdarg>
+#include <cstdio>
+#include <stdexcept>
+
+const int gNumFrameResources = 3;
+
+SceneRenderer::SceneRenderer(const SceneResourceFactory& factory, FrameFence& fence, CommandRecorderPool& lists,
+    VertexEncoding vertexEncoding)
+    : mFactory(factory), mFence(fence), mLists(lists), mVertexEncoding(vertexEncoding)
+{
+    //   Ͱ 밳    ũ, ġ   մ´
+    mFrameUploads = mFactory.CreateUploadHeap(256 * 1024);
+}
+
+SceneModel SceneRenderer::PrepareModel(const std::string& name, std::pmr::vector<Vertex>& vertices,
+    std::pmr::vector<std::uint32_t>& indices)
+{
+    PreparedModel& prepared = mPreparedModels.emplace_back();
+
+    //   : ȭ, ޽÷  ġ,  ε LOD
+    LogMeshReport(name, MeshOptimizer::Optimize(vertices, indices));
+    prepared.Meshlets = BuildMeshlets(name, &vertices[0].Pos, sizeof(Vertex), (UINT)vertices.size(),
+        indices.data(), (UINT)indices.size());
+    prepared.Lods = MeshSimplifier::BuildLodChain(&vertices[0].Pos, sizeof(Vertex),
+        (UINT)vertices.size(), indices.data(), indices.size());
+
+    SceneModel model;
+    model.Vertices = vertices.data();
+    model.VertexCount = (UINT)vertices.size();
+    model.Indices = indices.data();
+    model.IndexCount = (UINT)indices.size();
+    model.Meshlets = prepared.Meshlets.data();
+    model.MeshletCount = (UINT)prepared.Meshlets.size();
+
+    prepared.LodVertices.reserve(prepared.Lods.size());
+    prepared.LodIndices.reserve(prepared.Lods.size());
+    for (const MeshLod& lod : prepared.Lods)
+    {
+        // ε ٲǷ    ȭ  ʴ  
+        std::pmr::vector<Vertex>& lodVertices = prepared.LodVertices.emplace_back(vertices.begin(), vertices.end(), &mLoadScratch);
+        std::pmr::vector<std::uint32_t>& lodIndices = prepared.LodIndices.emplace_back(lod.Indices.begin(), lod.Indices.end(), &mLoadScratch);
+        MeshOptimizer::Optimize(lodVertices, lodIndices);
+
+        SceneModelLod& modelLod = model.Lods.emplace_back();
+        modelLod.Vertices = lodVertices.data();
+        modelLod.VertexCount = (UINT)lodVertices.size();
+        modelLod.Indices = lodIndices.data();
+        modelLod.IndexCount = (UINT)lodIndices.size();
+        modelLod.Error = lod.Error;
+    }
+
+    RecordLods(name, indices.size(), prepared.Lods);
+    return model;
+}
+
+void SceneRenderer::Build(CommandRecorder& recorder, const SceneModel* skull)
+{
+    BuildGeometry(skull);
+    BuildMaterials();
+    BuildRenderItem(skull != nullptr);
+    BuildFrameResources();
+
+    mGeometryUploader->Flush(recorder);
+}
+
+void SceneRenderer::EndBuild()
+{
+    // 簡 Ƿ ʱȭ ¡ ޸ ,  ۴ δ   ִ
+    mGeometryUploader->Submit(mFence.CurrentValue());
+    mGeometryUploader->Retire(mFence.CompletedValue());
+
+    // ε ӽ ޸𸮴  ̻  Ƿ   
+    LogScratchStats();
+    mPreparedModels.clear();
+    mLoadScratch.Reset();
+}
+
+void SceneRenderer::SetPipeline(ID3D12PipelineState* pso, ID3D12RootSignature* rootSignature)
+{
+    mPSO = pso;
+    mRootSignature = rootSignature;
+}
+
+void SceneRenderer::Resize(int width, int height)
+{
+    //â ũⰡ ٲ  , Ⱦ ->  
+    mClientHeight = height;
+
+    XMMATRIX proj = XMMatrixPerspectiveFovLH(0.25f * XM_PI, (float)width / (float)height, 1.0f, mFarPlane);
+    XMStoreFloat4x4(&mProj, proj);
+}
+
+void SceneRenderer::SetCameraOrbit(float theta, float phi, float radius)
+{
+    mTheta = theta;
+    mPhi = phi;
+    mRadius = radius;
+}
+
+void SceneRenderer::Update()
+{
+    //   ڿ ȯ, GPU   ڿ     
+    UINT64 waitFence = mFrameRing.Advance(mFence.CompletedValue());
+    mCurrFrameResource = mFrameResources[mFrameRing.CurrentIndex()].get();
+    if (waitFence != 0)
+        mFence.Wait(waitFence);
+
+    RetireGeometry(mFence.CompletedValue());
+    mFrameUploads->Retire(mFence.CompletedValue());
+
+    mFrameStats = FrameStats();
+
+    //  ǥ  ǥ
+    UpdateCamera();
+    UpdateTerrain();
+    UpdateVisibility();
+    UpdateLodSelection();
+    UpdateInstanceBuffer();
+    UpdateClusterCulling();
+    UpdateRenderQueue();
+    UpdateMaterialBuffer();
+    UpdatePassCB();
+}
+
+void SceneRenderer::UpdateCamera()
+{
+    mEyePos.x = mRadius * sinf(mPhi) * cosf(mTheta);
+    mEyePos.z = mRadius * sinf(mPhi) * sinf(mTheta);
+    mEyePos.y = mRadius * cosf(mPhi);
+
+    // þ 
+    XMVECTOR pos = XMVectorSet(mEyePos.x, mEyePos.y, mEyePos.z, 1.0f);
+    XMVECTOR target = XMVectorZero();
+    XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+
+    XMMATRIX view = XMMatrixLookAtLH(pos, target, up);
+    XMStoreFloat4x4(&mView, view);
+}
+
+void SceneRenderer::UpdateTerrain()
+{
+    // ī޶ ֺ ûũ ҷ ݰ   ûũ 
+    mTerrain.Update(mEyePos);
+
+    for (const TerrainChunkCoord& coord : mTerrain.Evicted())
+        EvictTerrainChunk(coord);
+    for (const TerrainChunk* chunk : mTerrain.Loaded())
+        LoadTerrainChunk(*chunk);
+
+    mFrameStats.TerrainChunks = mTerrain.Stats().Resident;
+    mFrameStats.TerrainChunksLoaded = mTerrain.Stats().Loaded;
+}
+
+void SceneRenderer::LoadTerrainChunk(const TerrainChunk& chunk)
+{
+    // ٸ Ͽ   ڵ ø,   ûũ   ȭ
+    //   ʿ Ӽ  ¡ ޸𸮿 ٷ 
+    const UINT stride = VertexQuantizer::Stride(mVertexEncoding);
+    const UINT vbByteSize = (UINT)chunk.Vertices.size() * stride;
+    StaticBuffer vertexBuffer = mTerrainUploader->CreateStaticBuffer(vbByteSize, [&](void* dst)
+    {
+        if (mVertexEncoding == VertexEncoding::Float)
+            VertexWriter<VertexLayoutOf<Vertex>::Type>::Write(chunk.Vertices.data(), chunk.Vertices.size(), dst);
+        else
+            VertexQuantizer::Encode(chunk.Vertices.data(), chunk.Vertices.size(), chunk.Bounds, mVertexEncoding, dst);
+    });
+
+    SubmeshGeometry submesh;
+    submesh.IndexCount = (UINT)mTerrain.Indices().size();
+    submesh.Bounds = chunk.Bounds;
+    BoundingSphere::CreateFromBoundingBox(submesh.Sphere, chunk.Bounds);
+
+    //  ûũ  ID   mGeometryDraws   ʰ Ѵ
+    UINT id;
+    if (!mFreeGeometryIds.empty())
+    {
+        id = mFreeGeometryIds.back();
+        mFreeGeometryIds.pop_back();
+    }
+    else
+    {
+        id = (UINT)mGeometryDraws.size();
+        mGeometryDraws.push_back(GeometryDraw());
+    }
+
+    GeometryDraw& draw = mGeometryDraws[id];
+    draw = GeometryDraw();
+    draw.VertexBufferView.BufferLocation = vertexBuffer.GpuAddress;
+    draw.VertexBufferView.StrideInBytes = stride;
+    draw.VertexBufferView.SizeInBytes = vbByteSize;
+    draw.IndexBufferView.BufferLocation = mTerrainIndexBuffer.GpuAddress;
+    draw.IndexBufferView.Format = DXGI_FORMAT_R16_UINT;
+    draw.IndexBufferView.SizeInBytes = (UINT)mTerrain.Indices().size() * sizeof(std::uint16_t);
+    draw.Parts.push_back(submesh);
+    draw.BufferId = id;
+
+    XMFLOAT4X4 world;
+    XMStoreFloat4x4(&world, XMMatrixTranslation(0.0f, mTerrainHeight, 0.0f));
+
+    TerrainChunkDraw chunkDraw;
+    chunkDraw.Handle = mScene.Add(world, chunk.Bounds, submesh.Sphere, id, mMaterials["Gray"]->MatCBIndex);
+    chunkDraw.GeometryId = id;
+    chunkDraw.VertexBuffer = vertexBuffer;
+    mTerrainChunks[TerrainStreamer::Key(chunk.Coord)] = chunkDraw;
+}
+
+void SceneRenderer::EvictTerrainChunk(TerrainChunkCoord coord)
+{
+    auto it = mTerrainChunks.find(TerrainStreamer::Key(coord));
+    if (it == mTerrainChunks.end())
+        return;
+
+    mScene.Remove(it->second.Handle);
+    mGeometryDraws[it->second.GeometryId] = GeometryDraw();
+    mFreeGeometryIds.push_back(it->second.GeometryId);
+
+    // ̹ Ӻʹ ׸ ,   ӱ ۸    ִ
+    mRetiredGeometry.push_back(std::make_pair(mFence.CurrentValue(), it->second.VertexBuffer));
+    mTerrainChunks.erase(it);
+}
+
+void SceneRenderer::RetireGeometry(UINT64 completedFence)
+{
+    // GPU   ¡ ޸𸮿  ûũ ۸ ȯ
+    mTerrainUploader->Retire(completedFence);
+
+    while (!mRetiredGeometry.empty() && mRetiredGeometry.front().first <= completedFence)
+    {
+        mTerrainUploader->ReleaseBuffer(mRetiredGeometry.front().second);
+        mRetiredGeometry.pop_front();
+    }
+}
+
+void SceneRenderer::UpdateVisibility()
+{
+    // ī޶ ü  Ʈ ׸ ʴ´
+    mCuller.SetCamera(XMLoadFloat4x4(&mView), XMLoadFloat4x4(&mProj));
+
+    CullStats stats = mCuller.Cull(mScene.WorldSpheres(), mScene.WorldBounds(), mScene.Size(), mVisible);
+    mFrameStats.VisibleItems = stats.Visible;
+    mFrameStats.CulledItems = stats.Culled;
+}
+
+void SceneRenderer::UpdateLodSelection()
+{
+    //   ȭ鿡 mLodPixelError ȼ Ϸ Ǵ  ģ LOD 
+    //   _22 Ÿ 1 ȭ  ݿ  
+    const float pixelsAtUnitDistance = mProj._22 * 0.5f * (float)mClientHeight;
+
+    const UINT count = mScene.Size();
+    const std::uint32_t* geometryIds = mScene.GeometryIds();
+    const XMFLOAT4X4* worlds = mScene.World();
+    const BoundingSphere* spheres = mScene.WorldSpheres();
+
+    mDrawGeometryIds.assign(geometryIds, geometryIds + count);
+
+    XMVECTOR eye = XMLoadFloat3(&mEyePos);
+    for (UINT i = 0; i < count; ++i)
+    {
+        const GeometryDraw& draw = mGeometryDraws[geometryIds[i]];
+        if (!mVisible[i] || draw.LodGeometryIds.empty())
+            continue;
+
+        //      Ÿ, (1.0)   
+        float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&spheres[i].Center) - eye)) - spheres[i].Radius;
+        distance = std::max(distance, 1.0f);
+
+        //  ޽ ̹Ƿ    ū   Ѵ
+        XMMATRIX world = XMLoadFloat4x4(&worlds[i]);
+        float scale = std::max(XMVectorGetX(XMVector3Length(world.r[0])),
+            std::max(XMVectorGetX(XMVector3Length(world.r[1])), XMVectorGetX(XMVector3Length(world.r[2]))));
+
+        for (size_t level = draw.LodGeometryIds.size(); level > 0; --level)
+        {
+            float pixels = draw.LodErrors[level - 1] * scale * pixelsAtUnitDistance / distance;
+            if (pixels <= mLodPixelError)
+            {
+                mDrawGeometryIds[i] = draw.LodGeometryIds[level - 1];
+                mFrameStats.LodItems++;
+                break;
+            }
+        }
+    }
+}
+
+void SceneRenderer::UpdateInstanceBuffer()
+{
+    // ̴ Ʈ / , ׷    νϽ ۿ ä
+    mBatcher.Build(mDrawGeometryIds.data(), mScene.MaterialIds(), mVisible.data(), mScene.Size());
+
+    UploadAllocation instances = mFrameUploads->Allocate((UINT64)mBatcher.InstanceCount() * sizeof(InstanceData));
+    mBatcher.PackWorlds(mScene.World(), reinterpret_cast<InstanceData*>(instances.CpuAddress));
+    mInstanceAddress = instances.GpuAddress;
+
+    mFrameStats.ConstantBytesWritten += mBatcher.InstanceCount() * sizeof(InstanceData);
+    mFrameStats.PaddingBytesSaved += mBatcher.InstanceCount() *
+        (UploadHeap::ConstantBufferByteSize(sizeof(InstanceData)) - sizeof(InstanceData));
+    mFrameStats.Instances = mBatcher.InstanceCount();
+}
+
+void SceneRenderer::UpdateClusterCulling()
+{
+    // ޽÷ ִ ޽ô ü ̳ ޸鸸 ̴ Ŭ͸   ε  ׸
+    mClusterCuller.SetView(mCuller.Planes(), mEyePos);
+    mClusterRanges.clear();
+
+    const std::vector<InstanceGroup>& groups = mBatcher.Groups();
+    mGroupClusterRanges.resize(groups.size());
+
+    ClusterCullStats stats;
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        const InstanceGroup& group = groups[i];
+        const GeometryDraw& draw = mGeometryDraws[group.GeometryId];
+
+        GroupClusterRanges& ranges = mGroupClusterRanges[i];
+        ranges.FirstRange = (UINT)mClusterRanges.size();
+        ranges.RangeCount = 0;
+
+        if (draw.Meshlets == nullptr)
+        {
+            mFrameStats.DrawCalls += (UINT)draw.Parts.size();
+            for (const SubmeshGeometry& part : draw.Parts)
+                mFrameStats.IndicesSubmitted += (UINT64)part.IndexCount * group.InstanceCount;
+            continue;
+        }
+
+        //  ׷ νϽ  ϳ  Ŭʹ ׸
+        ranges.RangeCount = mClusterCuller.Cull(draw.Meshlets->data(), (UINT)draw.Meshlets->size(),
+            mScene.World(), mBatcher.Order().data() + group.FirstInstance, group.InstanceCount,
+            mClusterRanges, stats);
+        mFrameStats.DrawCalls += ranges.RangeCount;
+        for (UINT r = 0; r < ranges.RangeCount; ++r)
+            mFrameStats.IndicesSubmitted += (UINT64)mClusterRanges[ranges.FirstRange + r].IndexCount * group.InstanceCount;
+    }
+
+    mFrameStats.ClusterTriangles = stats.Triangles;
+    mFrameStats.TrianglesSkipped = stats.TrianglesSkipped;
+}
+
+void SceneRenderer::UpdateRenderQueue()
+{
+    // νϽ ׷츶 PSO////   Ű  Ѵ
+    // °   ׷쳢   νϽ  տ ׸
+    const std::vector<InstanceGroup>& groups = mBatcher.Groups();
+    const std::vector<std::uint32_t>& order = mBatcher.Order();
+    const BoundingSphere* spheres = mScene.WorldSpheres();
+    XMVECTOR eye = XMLoadFloat3(&mEyePos);
+
+    mRenderQueue.Clear();
+    for (UINT g = 0; g < (UINT)groups.size(); ++g)
+    {
+        const InstanceGroup& group = groups[g];
+
+        float nearest = mFarPlane;
+        for (UINT k = 0; k < group.InstanceCount; ++k)
+        {
+            const BoundingSphere& sphere = spheres[order[group.FirstInstance + k]];
+            float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&sphere.Center) - eye)) - sphere.Radius;
+            nearest = std::min(nearest, distance);
+        }
+
+        std::uint64_t key = RenderSortKey::Make(0, mGeometryDraws[group.GeometryId].BufferId, group.GeometryId,
+            group.MaterialId, RenderSortKey::DepthBucket(nearest, mFarPlane));
+        mRenderQueue.Push(key, g);
+    }
+
+    mRenderQueue.Sort();
+
+    //   ׷츶  ο ,     ȴ
+    mRecordCosts.clear();
+    for (std::uint32_t i : mRenderQueue.Items())
+    {
+        const GeometryDraw& draw = mGeometryDraws[groups[i].GeometryId];
+        UINT drawsPerPart = draw.Meshlets != nullptr ? mGroupClusterRanges[i].RangeCount : 1;
+        mRecordCosts.push_back(1 + (UINT)draw.Parts.size() * drawsPerPart);
+    }
+}
+
+void SceneRenderer::UpdateMaterialBuffer()
+{
+    //   ڿ  ۿ ٲ  ,  ε ġ ƴ д
+    MaterialData* materialData = reinterpret_cast<MaterialData*>(mCurrFrameResource->MaterialBuffer.CpuAddress);
+    mMaterialBufferAddress = mCurrFrameResource->MaterialBuffer.GpuAddress;
+
+    for (auto& item : mMaterials)
+    {
+        MaterialInfo* mat = item.second.get();
+        if (mat->NumFramesDirty <= 0)
+            continue;
+
+        MaterialData matData;
+        matData.DiffuseAlbedo = mat->DiffuseAlbedo;
+        matData.FresnelR0 = mat->FresnelR0;
+        matData.Roughness = mat->Roughness;
+
+        materialData[mat->MatCBIndex] = matData;
+        mFrameStats.ConstantBytesWritten += sizeof(MaterialData);
+        mFrameStats.PaddingBytesSaved += UploadHeap::ConstantBufferByteSize(sizeof(MaterialData)) - sizeof(MaterialData);
+
+        mat->NumFramesDirty--;
+    }
+}
+
+void SceneRenderer::UpdatePassCB()
+{
+    PassConstants mainPass;
+    XMMATRIX view = XMLoadFloat4x4(&mView);
+    XMMATRIX proj = XMLoadFloat4x4(&mProj);
+
+    XMVECTOR viewDeterminant = XMMatrixDeterminant(view);
+    XMVECTOR projDeterminant = XMMatrixDeterminant(proj);
+    XMMATRIX invView = XMMatrixInverse(&viewDeterminant, view);
+    XMMATRIX invProj = XMMatrixInverse(&projDeterminant, proj);
+    XMMATRIX viewProj = XMMatrixMultiply(view, proj);
+
+    XMStoreFloat4x4(&mainPass.View, XMMatrixTranspose(view));
+    XMStoreFloat4x4(&mainPass.InvView, XMMatrixTranspose(invView));
+    XMStoreFloat4x4(&mainPass.Proj, XMMatrixTranspose(proj));
+    XMStoreFloat4x4(&mainPass.InvProj, XMMatrixTranspose(invProj));
+    XMStoreFloat4x4(&mainPass.ViewProj, XMMatrixTranspose(viewProj));
+
+    mainPass.AmbientLight = { 0.25f, 0.25f, 0.35f, 1.0f };
+    mainPass.EyePosW = mEyePos;
+    mainPass.LightCount = 11;
+
+    mainPass.Lights[0].LightType = 0;
+    mainPass.Lights[0].Direction = { 0.57735f, -0.57735f, 0.57735f };
+    mainPass.Lights[0].Strength = { 0.6f, 0.6f, 0.6f };
+
+    for (int i = 0; i < 5; ++i)
+    {
+        mainPass.Lights[1 + i].LightType = 1;
+        mainPass.Lights[1 + i].Strength = {0.6f,0.6f,0.6f};
+        mainPass.Lights[1 + i].Position = XMFLOAT3(-5.0f, 3.5f, -10.0f + i * 5.0f);
+        mainPass.Lights[1 + i].FalloffStart = 2;
+        mainPass.Lights[1 + i].FalloffEnd = 5;
+    }
+
+    for (int i = 0; i < 5; ++i)
+    {
+        mainPass.Lights[6 + i].LightType = 1;
+        mainPass.Lights[6 + i].Strength = { 0.6f,0.6f,0.6f };
+        mainPass.Lights[6 + i].Position = XMFLOAT3(+5.0f, 3.5f, -10.0f + i * 5.0f);
+        mainPass.Lights[6 + i].FalloffStart = 2;
+        mainPass.Lights[6 + i].FalloffEnd = 5;
+    }
+
+    mPassCBAddress = mFrameUploads->AllocateConstants(mainPass);
+    mFrameStats.ConstantBytesWritten += sizeof(PassConstants);
+}
+
+void SceneRenderer::Draw(const SceneFrameTarget& target)
+{
+    mTarget = target;
+
+    // GPU   ڿ   óǷ  Ҵڵ   ִ
+    mLists.BeginFrame((UINT)mFrameRing.CurrentIndex());
+
+    // ĵ ׷  ŭ   ,    ϳ غ
+    ParallelRecorder::Partition(mRecordCosts.data(), (std::uint32_t)mRecordCosts.size(),
+        mParallelRecorder.ThreadCount(), mMinDrawsPerList, mRecordRanges);
+
+    //  Ǯ   Ƿ   ⼭    
+    // غ (ε/ȯ/),  ,  (PRESENT ȯ) 
+    const UINT rangeCount = (UINT)mRecordRanges.size();
+    CommandRecorder& beginList = mLists.Acquire();
+    mRangeRecorders.resize(rangeCount);
+    for (UINT r = 0; r < rangeCount; ++r)
+        mRangeRecorders[r] = &mLists.Acquire();
+    CommandRecorder& endList = mLists.Acquire();
+
+    mRangeStateCaches.resize(rangeCount);
+    mCaptureRanges.resize(rangeCount);
+
+    DrawBegin(beginList);
+
+    mParallelRecorder.Record(mRecordRanges, mRangeRecorders.data(),
+        [this](std::uint32_t r, const RecordRange& range, CommandRecorder& recorder)
+        {
+            //  ڱ ĸó ۸ Ƿ ۾ 忡 ص ȴ
+            CommandRecorder& target = BeginRecording(mCaptureRanges[r], recorder);
+            RecordDrawRange(range, target, mRangeStateCaches[r]);
+            EndRecording(mCaptureRanges[r], recorder);
+        });
+
+    DrawEnd(endList);
+
+    mFrameStats.StateCommands = 0;
+    mFrameStats.StateCommandsSkipped = 0;
+    for (UINT r = 0; r < rangeCount; ++r)
+    {
+        mFrameStats.StateCommands += mRangeStateCaches[r].Stats().Issued();
+        mFrameStats.StateCommandsSkipped += mRangeStateCaches[r].Stats().Skipped();
+    }
+    mFrameStats.RecordedLists = rangeCount;
+
+    // غ ,  ,      
+    mLists.Submit();
+
+    if (mCaptureCommands)
+    {
+        AddCaptureStats(mCaptureBegin);
+        for (UINT r = 0; r < rangeCount; ++r)
+            AddCaptureStats(mCaptureRanges[r]);
+        AddCaptureStats(mCaptureEnd);
+    }
+}
+
+void SceneRenderer::DrawBegin(CommandRecorder& list)
+{
+    CommandRecorder& recorder = BeginRecording(mCaptureBegin, list);
+
+    // ̹ ӿ ҷ  ûũ ׸  ⺻  
+    mTerrainUploader->Flush(recorder);
+
+    D3D12_RESOURCE_BARRIER toRenderTarget = TransitionBarrier(mTarget.BackBuffer,
+        D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    recorder.ResourceBarrier(1, &toRenderTarget);
+
+    // Ʈ  Ÿ ׸  ڱ Ͽ Ѵ
+    recorder.ClearRenderTargetView(mTarget.RenderTarget, Colors::LightSteelBlue);
+    recorder.ClearDepthStencilView(mTarget.DepthStencil, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0);
+
+    EndRecording(mCaptureBegin, list);
+}
+
+void SceneRenderer::RecordDrawRange(const RecordRange& range, CommandRecorder& recorder, CommandStateCache& stateCache)
+{
+    //    ƹ µ  Ƿ  ó Ѵ
+    stateCache.Begin(&recorder);
+
+    recorder.RSSetViewport(mTarget.Viewport);
+    recorder.RSSetScissorRect(mTarget.ScissorRect);
+    recorder.OMSetRenderTarget(mTarget.RenderTarget, mTarget.DepthStencil);
+
+    //   
+    stateCache.SetPipelineState(mPSO);
+
+    // Ʈ ñ״ó ε
+    stateCache.SetGraphicsRootSignature(mRootSignature);
+
+    //    ε
+    stateCache.SetGraphicsRootConstantBufferView(2, mPassCBAddress);
+
+    // νϽ ,   ε
+    stateCache.SetGraphicsRootShaderResourceView(3, mInstanceAddress);
+    stateCache.SetGraphicsRootShaderResourceView(1, mMaterialBufferAddress);
+
+    //  /  Ʈ   νϽ ο ׸
+    //  Ű  ׸Ƿ  ׷  /  ĳð ɷ
+    const std::vector<InstanceGroup>& groups = mBatcher.Groups();
+    const std::vector<std::uint32_t>& items = mRenderQueue.Items();
+    for (std::uint32_t item = range.Begin; item < range.End; ++item)
+    {
+        std::uint32_t i = items[item];
+        const InstanceGroup& group = groups[i];
+        const GeometryDraw& draw = mGeometryDraws[group.GeometryId];
+
+        //νϽ  ȿ  ׷  ġ   ε
+        DrawConstants drawConstants;
+        drawConstants.InstanceBase = group.FirstInstance;
+        drawConstants.MaterialIndex = group.MaterialId;
+
+        stateCache.IASetVertexBuffer(draw.VertexBufferView);
+        stateCache.IASetIndexBuffer(draw.IndexBufferView);
+        stateCache.IASetPrimitiveTopology(draw.PrimitiveType);
+
+        for (const SubmeshGeometry& part : draw.Parts)
+        {
+            //  ġ Ʈ   ȭǾ ִ
+            drawConstants.QuantCenter = part.Bounds.Center;
+            drawConstants.QuantExtents = part.Bounds.Extents;
+            stateCache.SetGraphicsRoot32BitConstants(0, sizeof(DrawConstants) / 4, &drawConstants, 0);
+
+            if (draw.Meshlets == nullptr)
+            {
+                stateCache.DrawIndexedInstanced(part.IndexCount, group.InstanceCount,
+                    part.StartIndexLocation, part.BaseVertexLocation, 0);
+                continue;
+            }
+
+            //ø Ƴ Ŭ  ׸
+            const GroupClusterRanges& ranges = mGroupClusterRanges[i];
+            for (UINT r = 0; r < ranges.RangeCount; ++r)
+            {
+                const ClusterRange& cluster = mClusterRanges[ranges.FirstRange + r];
+                stateCache.DrawIndexedInstanced(cluster.IndexCount, group.InstanceCount,
+                    part.StartIndexLocation + cluster.StartIndex, part.BaseVertexLocation, 0);
+            }
+        }
+    }
+
+}
+
+void SceneRenderer::DrawEnd(CommandRecorder& list)
+{
+    //   ȯ  ׸  ڿ ; ϹǷ  Ͽ  
+    CommandRecorder& recorder = BeginRecording(mCaptureEnd, list);
+
+    D3D12_RESOURCE_BARRIER toPresent = TransitionBarrier(mTarget.BackBuffer,
+        D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+    recorder.ResourceBarrier(1, &toPresent);
+
+    EndRecording(mCaptureEnd, list);
+}
+
+void SceneRenderer::EndFrame()
+{
+    // ٸ ʰ 潺  ,   ڿ ٽ   ȮѴ
+    UINT64 fence = mFence.Signal();
+    mFrameRing.Signal(fence);
+
+    // ̹ ӿ  ûũ ¡   潺   ȯȴ
+    mTerrainUploader->Submit(fence);
+
+    // н//νϽ    潺   ٽ 
+    mFrameStats.UploadBytes = mFrameUploads->AllocatedBytes();
+    mFrameStats.UploadPages = mFrameUploads->OpenPageCount();
+    mFrameUploads->Submit(fence);
+}
+
+CommandRecorder& SceneRenderer::BeginRecording(MemoryCommandRecorder& capture, CommandRecorder& target)
+{
+    if (!mCaptureCommands)
+        return target;
+
+    capture.Clear();
+    return capture;
+}
+
+void SceneRenderer::EndRecording(const MemoryCommandRecorder& capture, CommandRecorder& target)
+{
+    // ޸𸮿       Ͽ ű
+    if (mCaptureCommands)
+        capture.Replay(target);
+}
+
+void SceneRenderer::AddCaptureStats(const MemoryCommandRecorder& capture)
+{
+    const CommandStreamStats& stats = capture.Stats();
+    mFrameStats.CapturedCommands += capture.CommandCount();
+    mFrameStats.CapturedDraws += stats.Draws;
+    mFrameStats.CapturedStateChanges += stats.StateChanges;
+    mFrameStats.CapturedBarriers += stats.Barriers;
+    mFrameStats.CapturedBytes += capture.ByteSize();
+}
+
+void SceneRenderer::BuildGeometry(const SceneModel* skull)
+{
+    //   ϳ /ε ۿ 
+    GeometryGenerator geoGen(&mJobs, &mLoadScratch);
+    GeometryPacker<Vertex> packer(&mLoadScratch);
+
+    GeometryGenerator::MeshData box = geoGen.CreateBox(1.5f, 0.5f, 1.5f, 3);
+    GeometryGenerator::MeshData grid = geoGen.CreateGrid(20.0f, 30.0f, 60, 40);
+    GeometryGenerator::MeshData sphere = geoGen.CreateSphere(0.5f, 20, 20);
+    GeometryGenerator::MeshData cylinder = geoGen.CreateCylinder(0.5f, 0.3f, 3.0f, 20, 20);
+
+    //  ĳ   ﰢ , ʺ    ġ
+    LogMeshReport("Box", MeshOptimizer::Optimize(box.Vertices, box.Indices32));
+    LogMeshReport("Grid", MeshOptimizer::Optimize(grid.Vertices, grid.Indices32));
+    LogMeshReport("Sphere", MeshOptimizer::Optimize(sphere.Vertices, sphere.Indices32));
+    LogMeshReport("Cylinder", MeshOptimizer::Optimize(cylinder.Vertices, cylinder.Indices32));
+
+    // Ŭ ø ޽÷ , ޽÷ ε ̾ ġ
+    mMeshlets["Box"] = BuildMeshlets("Box", &box.Vertices[0].Position, sizeof(GeometryGenerator::Vertex), (UINT)box.Vertices.size(),
+        box.Indices32.data(), (UINT)box.Indices32.size());
+    mMeshlets["Grid"] = BuildMeshlets("Grid", &grid.Vertices[0].Position, sizeof(GeometryGenerator::Vertex), (UINT)grid.Vertices.size(),
+        grid.Indices32.data(), (UINT)grid.Indices32.size());
+    mMeshlets["Sphere"] = BuildMeshlets("Sphere", &sphere.Vertices[0].Position, sizeof(GeometryGenerator::Vertex), (UINT)sphere.Vertices.size(),
+        sphere.Indices32.data(), (UINT)sphere.Indices32.size());
+    mMeshlets["Cylinder"] = BuildMeshlets("Cylinder", &cylinder.Vertices[0].Position, sizeof(GeometryGenerator::Vertex), (UINT)cylinder.Vertices.size(),
+        cylinder.Indices32.data(), (UINT)cylinder.Indices32.size());
+
+    packer.AddMesh("Box", box);
+    packer.AddMesh("Grid", grid);
+    packer.AddMesh("Sphere", sphere);
+    packer.AddMesh("Cylinder", cylinder);
+
+    //   ָ ̴  ܼȭ LOD Բ ´
+    BuildLods(packer, "Sphere", sphere);
+    BuildLods(packer, "Cylinder", cylinder);
+
+    // ذ  ҷ ѱ (ĳó PrepareModel ģ  ؽƮ)
+    if (skull != nullptr)
+        AddModel(packer, "Skull", *skull);
+
+    // /ε ʹ ϳ ε   ⺻  ۷   Ѵ
+    UINT64 terrainIndexStagingBytes = mTerrain.Indices().size() * sizeof(std::uint16_t) + 16;
+    mGeometryUploader = mFactory.CreateGeometryUploader(packer.StagingByteSize() + terrainIndexStagingBytes, false);
+
+    //  ûũ Ӹ ִ MaxLoadsPerUpdate ö  ڿ ŭ ĥ  ִ
+    // Ʈϴ   Ƿ  ¡ ۸  ʴ´
+    UINT64 chunkStagingBytes = (UINT64)mTerrain.VerticesPerChunk() * VertexQuantizer::Stride(mVertexEncoding) + 16;
+    mTerrainUploader = mFactory.CreateGeometryUploader(
+        (UINT64)(gNumFrameResources + 1) * mTerrain.MaxLoadsPerUpdate() * chunkStagingBytes, true);
+
+    // ε  Ŀ , ޽   ε κ 16Ʈ ϴ
+    mGeoMetries["Shapes"] = packer.Build(*mGeometryUploader, "Shapes", DXGI_FORMAT_UNKNOWN, mVertexEncoding);
+    LogQuantizeErrors(packer);
+
+    BuildTerrainIndexBuffer();
+}
+
+void SceneRenderer::BuildTerrainIndexBuffer()
+{
+    // ûũ   ̹Ƿ ε  ϳ Բ 
+    const std::vector<std::uint32_t>& indices = mTerrain.Indices();
+    if (mTerrain.VerticesPerChunk() > 0x10000)
+        throw std::invalid_argument("SceneRenderer::BuildTerrainIndexBuffer: chunk does not fit 16-bit indices.");
+
+    std::vector<std::uint16_t> indices16(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        indices16[i] = static_cast<std::uint16_t>(indices[i]);
+
+    mTerrainIndexBuffer = mGeometryUploader->CreateStaticBuffer(indices16.data(), indices16.size() * sizeof(std::uint16_t));
+}
+
+void SceneRenderer::Log(const char* format, ...)
+{
+    char text[256];
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    mBuildLog.push_back(text);
+}
+
+void SceneRenderer::LogScratchStats()
+{
+    const ScratchArenaStats& stats = mLoadScratch.Stats();
+
+    Log("Load scratch: peak %.2f MB in use, %.2f MB reserved in %u blocks, %llu allocations, %llu frees",
+        stats.PeakBytes / (1024.0 * 1024.0), stats.PeakReservedBytes / (1024.0 * 1024.0), stats.Blocks,
+        (unsigned long long)stats.Allocations, (unsigned long long)stats.Deallocations);
+}
+
+void SceneRenderer::LogMeshReport(const std::string& name, const MeshOptimizeReport& report)
+{
+    Log("%s: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f", name.c_str(),
+        report.Before.Acmr, report.After.Acmr, report.Before.Atvr, report.After.Atvr);
+}
+
+std::vector<Meshlet> SceneRenderer::BuildMeshlets(const std::string& name, const XMFLOAT3* positions, UINT positionStride,
+    UINT vertexCount, std::uint32_t* indices, UINT indexCount)
+{
+    std::vector<Meshlet> meshlets = MeshletBuilder::Build(positions, positionStride, vertexCount, indices, indexCount);
+
+    UINT cones = 0;
+    for (const Meshlet& meshlet : meshlets)
+        cones += meshlet.ConeCutoff <= 1.0f ? 1 : 0;
+
+    Log("%s: %u triangles -> %u meshlets (%u with a normal cone)", name.c_str(),
+        indexCount / 3, (UINT)meshlets.size(), cones);
+
+    return meshlets;
+}
+
+std::string SceneRenderer::LodName(const std::string& name, UINT level)
+{
+    return level == 0 ? name : name + "@lod" + std::to_string(level);
+}
+
+void SceneRenderer::BuildLods(GeometryPacker<Vertex>& packer, const std::string& name, const GeometryGenerator::MeshData& mesh)
+{
+    std::vector<MeshLod> lods = MeshSimplifier::BuildLodChain(&mesh.Vertices[0].Position, sizeof(GeometryGenerator::Vertex),
+        (UINT)mesh.Vertices.size(), mesh.Indices32.data(), mesh.Indices32.size());
+
+    for (size_t level = 0; level < lods.size(); ++level)
+    {
+        // ε ٲǷ    ȭ  ʴ  
+        GeometryGenerator::MeshData lodMesh(&mLoadScratch);
+        lodMesh.Vertices = mesh.Vertices;
+        lodMesh.Indices32.assign(lods[level].Indices.begin(), lods[level].Indices.end());
+        MeshOptimizer::Optimize(lodMesh.Vertices, lodMesh.Indices32);
+
+        packer.AddMesh(LodName(name, (UINT)level + 1), lodMesh);
+    }
+
+    RecordLods(name, mesh.Indices32.size(), lods);
+}
+
+void SceneRenderer::AddModel(GeometryPacker<Vertex>& packer, const std::string& name, const SceneModel& model)
+{
+    // ޽÷ LOD 𵨿    ״ 
+    mMeshlets[name].assign(model.Meshlets, model.Meshlets + model.MeshletCount);
+    packer.AddMesh(name, model.Vertices, model.VertexCount, model.Indices, model.IndexCount);
+
+    std::vector<float>& errors = mLodErrors[name];
+    errors.clear();
+
+    for (size_t level = 0; level < model.Lods.size(); ++level)
+    {
+        const SceneModelLod& lod = model.Lods[level];
+        packer.AddMesh(LodName(name, (UINT)level + 1), lod.Vertices, lod.VertexCount, lod.Indices, lod.IndexCount);
+        errors.push_back(lod.Error);
+    }
+}
+
+void SceneRenderer::RecordLods(const std::string& name, size_t baseIndexCount, const std::vector<MeshLod>& lods)
+{
+    std::vector<float>& errors = mLodErrors[name];
+    errors.clear();
+
+    for (size_t level = 0; level < lods.size(); ++level)
+    {
+        errors.push_back(lods[level].Error);
+
+        Log("%s lod%u: %u -> %u triangles, max error %.5f", name.c_str(), (UINT)level + 1,
+            (UINT)(baseIndexCount / 3), (UINT)(lods[level].Indices.size() / 3), lods[level].Error);
+    }
+}
+
+void SceneRenderer::LogQuantizeErrors(const GeometryPacker<Vertex>& packer)
+{
+    for (const auto& entry : packer.QuantizeErrors())
+    {
+        Log("%s: max position error %.6f, max normal error %.3f deg", entry.first.c_str(),
+            entry.second.MaxPositionError, entry.second.MaxNormalErrorDegrees);
+    }
+}
+
+void SceneRenderer::BuildMaterials()
+{
+    UINT indexCount = 0;
+
+    auto green = std::make_unique<MaterialInfo>();
+    green->Name = "Green";
+    green->MatCBIndex = indexCount++;
+    green->DiffuseAlbedo = XMFLOAT4(Colors::ForestGreen);
+    green->FresnelR0 = XMFLOAT3(0.02f, 0.02f, 0.02f);
+    green->Roughness = 0.1f;
+    mMaterials[green->Name] = std::move(green);
+
+    auto blue = std::make_unique<MaterialInfo>();
+    blue->Name = "Blue";
+    blue->MatCBIndex = indexCount++;
+    blue->DiffuseAlbedo = XMFLOAT4(Colors::LightSteelBlue);
+    blue->FresnelR0 = XMFLOAT3(0.05f, 0.05f, 0.05f);
+    blue->Roughness = 0.3f;
+    mMaterials[blue->Name] = std::move(blue);
+
+
+    auto gray = std::make_unique<MaterialInfo>();
+    gray->Name = "Gray";
+    gray->MatCBIndex = indexCount++;
+    gray->DiffuseAlbedo = XMFLOAT4(Colors::LightGray);
+    gray->FresnelR0 = XMFLOAT3(0.02f, 0.02f, 0.02f);
+    gray->Roughness = 0.2f;
+    mMaterials[gray->Name] = std::move(gray);
+
+
+    auto skull = std::make_unique<MaterialInfo>();
+    skull->Name = "Skull";
+    skull->MatCBIndex = indexCount++;
+    skull->DiffuseAlbedo = XMFLOAT4(Colors::White);
+    skull->FresnelR0 = XMFLOAT3(0.05f, 0.05f, 0.05f);
+    skull->Roughness = 0.3f;
+    mMaterials[skull->Name] = std::move(skull);
+}
+
+void SceneRenderer::BuildRenderItem(bool hasSkull)
+{
+    PackedGeometry* shapes = mGeoMetries["Shapes"].get();
+
+    AddRenderItem(shapes, "Grid", mMaterials["Gray"].get(), XMMatrixIdentity());
+    AddRenderItem(shapes, "Box", mMaterials["Blue"].get(),
+        XMMatrixScaling(2.0f, 2.0f, 2.0f) * XMMatrixTranslation(0.0f, 0.5f, 0.0f));
+
+    //ذ,  ҷ  
+    if (hasSkull)
+    {
+        AddRenderItem(shapes, "Skull", mMaterials["Skull"].get(),
+            XMMatrixScaling(0.5f, 0.5f, 0.5f) * XMMatrixTranslation(0.0f, 1.f, 0.0f));
+    }
+
+    for (int i = 0; i < 5; ++i)
+    {
+        XMMATRIX leftCylWorld = XMMatrixTranslation(-5.0f, 1.5f, -10.0f + i * 5.0f);
+        XMMATRIX rightCylWorld = XMMatrixTranslation(+5.0f, 1.5f, -10.0f + i * 5.0f);
+
+        XMMATRIX leftsphereWorld = XMMatrixTranslation(-5.0f, 3.5f, -10.0f + i * 5.0f);
+        XMMATRIX rightsphereWorld = XMMatrixTranslation(+5.0f, 3.5f, -10.0f + i * 5.0f);
+
+        // /  Ǹ
+        AddRenderItem(shapes, "Cylinder", mMaterials["Green"].get(), leftCylWorld);
+        AddRenderItem(shapes, "Cylinder", mMaterials["Green"].get(), rightCylWorld);
+
+        // /  Ǿ
+        AddRenderItem(shapes, "Sphere", mMaterials["Blue"].get(), leftsphereWorld);
+        AddRenderItem(shapes, "Sphere", mMaterials["Blue"].get(), rightsphereWorld);
+    }
+}
+
+RenderItem* SceneRenderer::AddRenderItem(PackedGeometry* geo, const std::string& submesh, MaterialInfo* mat, FXMMATRIX world)
+{
+    UINT id = GetGeometryId(geo, submesh);
+
+    // ø    ģ 
+    const std::vector<SubmeshGeometry>& parts = mGeometryDraws[id].Parts;
+    BoundingBox bounds = parts[0].Bounds;
+    BoundingSphere sphere = parts[0].Sphere;
+    for (size_t i = 1; i < parts.size(); ++i)
+    {
+        BoundingBox::CreateMerged(bounds, bounds, parts[i].Bounds);
+        BoundingSphere::CreateMerged(sphere, sphere, parts[i].Sphere);
+    }
+
+    XMFLOAT4X4 worldF;
+    XMStoreFloat4x4(&worldF, world);
+
+    auto item = std::make_unique<RenderItem>();
+    item->Handle = mScene.Add(worldF, bounds, sphere, id, mat->MatCBIndex);
+    item->Geo = geo;
+    item->Mat = mat;
+    item->GeometryId = id;
+
+    mRenderItems.push_back(std::move(item));
+    return mRenderItems.back().get();
+}
+
+UINT SceneRenderer::GetGeometryId(PackedGeometry* geo, const std::string& submesh)
+{
+    // ޽ø ó    ID ο
+    auto inserted = mGeometryIds.emplace(submesh, (UINT)mGeometryDraws.size());
+    UINT id = inserted.first->second;
+    if (inserted.second)
+    {
+        GeometryDraw draw;
+        draw.VertexBufferView = geo->VertexBufferView();
+        draw.IndexBufferView = geo->IndexBufferView();
+        draw.PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+
+        //   ϴ  ۿ ó ϵ  ID  ID  
+        draw.BufferId = mBufferIds.emplace(geo, id).first->second;
+
+        //   ޽ô "̸#k"   ׸
+        for (UINT part = 0; ; ++part)
+        {
+            auto it = geo->DrawArgs.find(GeometryPacker<Vertex>::PartName(submesh, part));
+            if (it == geo->DrawArgs.end())
+                break;
+            draw.Parts.push_back(it->second);
+        }
+
+        // ޽÷ ε ޽ ü ̶   ޽ÿ  ʴ´
+        auto meshlets = mMeshlets.find(submesh);
+        if (meshlets != mMeshlets.end() && draw.Parts.size() == 1)
+            draw.Meshlets = &meshlets->second;
+
+        mGeometryDraws.push_back(draw);
+
+        // LOD   ID ް,  ׸  ܰ  Ѵ
+        auto errors = mLodErrors.find(submesh);
+        if (errors != mLodErrors.end())
+        {
+            for (UINT level = 1; level <= errors->second.size(); ++level)
+            {
+                UINT lodId = GetGeometryId(geo, LodName(submesh, level));
+                mGeometryDraws[id].LodGeometryIds.push_back(lodId);
+                mGeometryDraws[id].LodErrors.push_back(errors->second[level - 1]);
+            }
+        }
+    }
+
+    return id;
+}
+
+void SceneRenderer::BuildFrameResources()
+{
+    //  ۴  ڿ   Ҵ  ,     ũ
+    const UINT materialBytes = (UINT)mMaterials.size() * sizeof(MaterialData);
+    mMaterialUploads = mFactory.CreateUploadHeap(UploadHeap::ConstantBufferByteSize(materialBytes) * gNumFrameResources);
+
+    for (int i = 0; i < gNumFrameResources; ++i)
+    {
+        mFrameResources.push_back(std::make_unique<FrameResource>());
+        mFrameResources.back()->MaterialBuffer = mMaterialUploads->Allocate(materialBytes);
+    }
+}
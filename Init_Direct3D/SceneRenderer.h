@@ -0,0 +1,433 @@
+#pragma once
+
+//    /, ̽  Ѵ
+// GPU ڿ SceneResourceFactory ,  CommandRecorderPool  ϱ⿡ ,
+//  ȭ FrameFence Ѵ.  D3D12 , 帮  ޸  ѱ
+
+#include "FrameResource.h"
+#include <deque>
+#include <functional>
+#include <string>
+#include "../Common/GeometryGenerator.h"
+#include "../Common/FrameRing.h"
+#include "../Common/FrameFence.h"
+#include "../Common/GeometryPacker.h"
+#include "../Common/MeshOptimizer.h"
+#include "../Common/SceneStore.h"
+#include "../Common/FrustumCuller.h"
+#include "../Common/JobSystem.h"
+#include "../Common/InstanceBatcher.h"
+#include "../Common/MeshletBuilder.h"
+#include "../Common/ClusterCuller.h"
+#include "../Common/MeshSimplifier.h"
+#include "../Common/TerrainStreamer.h"
+#include "../Common/ScratchArena.h"
+#include "../Common/RenderQueue.h"
+#include "../Common/CommandStateCache.h"
+#include "../Common/CommandRecorderPool.h"
+#include "../Common/MemoryCommandRecorder.h"
+#include "../Common/UploadHeap.h"
+#include "../Common/ParallelRecorder.h"
+using namespace DirectX;
+
+// 
+struct Vertex
+{
+	XMFLOAT3 Pos;
+	XMFLOAT3 Normal;
+};
+
+// 
+struct MaterialInfo
+{
+	std::string Name;
+
+	int MatCBIndex = -1;
+	int DiffuseSrvHeapIndex = -1;
+	int Texture_On = 0;
+
+	//  ٲ gNumFrameResources    ڿ  ۿ ݿǰ Ѵ
+	int NumFramesDirty = gNumFrameResources;
+
+	XMFLOAT4 DiffuseAlbedo = { 1.0f, 1.0f, 1.0f, 1.0f };
+	XMFLOAT3 FresnelR0 = { 0.01f, 0.01f, 0.01f };
+	float Roughness = 0.25f;
+
+};
+
+// Ʈ ü
+struct RenderItem
+{
+	RenderItem() = default;
+
+	//  , , / ID SceneStore ִ
+	SceneStore::Handle Handle;
+
+	PackedGeometry* Geo = nullptr;
+	MaterialInfo* Mat = nullptr;
+	UINT GeometryId = 0;
+};
+
+// ID ׸ 
+struct GeometryDraw
+{
+	//  ϰ  ִ /ε 
+	D3D12_VERTEX_BUFFER_VIEW VertexBufferView = {};
+	D3D12_INDEX_BUFFER_VIEW IndexBufferView = {};
+	D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+
+	//  /ε  ȿ ׸ 
+	// 16Ʈ ε   ޽ô  ϳ ִ
+	std::vector<SubmeshGeometry> Parts;
+
+	// Ŭ ø ޽÷,  ϳ ޽ø ( Parts ü ׸)
+	const std::vector<Meshlet>* Meshlets = nullptr;
+
+	// ܼȭ LOD  ID   ִ , 1ܰ ģ 
+	std::vector<UINT> LodGeometryIds;
+	std::vector<float> LodErrors;
+
+	//  Ű  ID,  /ε ۸  ϴ  
+	UINT BufferId = 0;
+};
+
+//νϽ ׷캰 ׸ Ŭ , mClusterRanges  ġ
+struct GroupClusterRanges
+{
+	UINT FirstRange = 0;
+	UINT RangeCount = 0;
+};
+
+//Ʈ   ûũ ϳ  ۿ  ڵ, ε ۴  ûũ Բ 
+struct TerrainChunkDraw
+{
+	StaticBuffer VertexBuffer;
+	SceneStore::Handle Handle;
+	UINT GeometryId = 0;
+};
+
+// 
+struct FrameStats
+{
+	// ̹ ӿ     ũ
+	UINT64 ConstantBytesWritten = 0;
+
+	// ü ø 
+	UINT VisibleItems = 0;
+	UINT CulledItems = 0;
+
+	// νϽ 
+	UINT DrawCalls = 0;
+	UINT Instances = 0;
+
+	// Ŭ ø  (޽÷ ִ ޽ ﰢ )
+	UINT64 ClusterTriangles = 0;
+	UINT64 TrianglesSkipped = 0;
+
+	// LOD  ,   ε 
+	UINT LodItems = 0;
+	UINT64 IndicesSubmitted = 0;
+
+	//    ûũ, ̹ ӿ ҷ ûũ
+	UINT TerrainChunks = 0;
+	UINT TerrainChunksLoaded = 0;
+
+	//        ̹  ¶  
+	UINT StateCommands = 0;
+	UINT StateCommandsSkipped = 0;
+
+	// ׸⸦     
+	UINT RecordedLists = 0;
+
+	//  ĸó   ä,  ü /ο/ /踮   Ʈ ũ
+	UINT CapturedCommands = 0;
+	UINT CapturedDraws = 0;
+	UINT CapturedStateChanges = 0;
+	UINT CapturedBarriers = 0;
+	UINT64 CapturedBytes = 0;
+
+	// νϽ/ ͸ 256Ʈ    ä Ƴ ũ
+	UINT64 PaddingBytesSaved = 0;
+
+	// ̹ ӿ ε  Ҵ ũ   
+	UINT64 UploadBytes = 0;
+	UINT UploadPages = 0;
+};
+
+//ҷ  ܼȭ LOD ϳ, /ε ȭ 
+struct SceneModelLod
+{
+	const Vertex* Vertices = nullptr;
+	UINT VertexCount = 0;
+	const std::uint32_t* Indices = nullptr;
+	UINT IndexCount = 0;
+	float Error = 0.0f;
+};
+
+//鿡  ҷ , SceneRenderer::PrepareModel ų ĳÿ ״ д´
+//ε ޽÷ ̰,  ޽÷ LOD ٽ  ʰ ״ 
+struct SceneModel
+{
+	const Vertex* Vertices = nullptr;
+	UINT VertexCount = 0;
+	const std::uint32_t* Indices = nullptr;
+	UINT IndexCount = 0;
+
+	const Meshlet* Meshlets = nullptr;
+	UINT MeshletCount = 0;
+	std::vector<SceneModelLod> Lods;
+};
+
+//  GPU ڿ
+struct SceneResourceFactory
+{
+	//   ۿ  ¡ 
+	std::function<std::unique_ptr<GeometryUploader>(UINT64 stagingByteSize, bool keepStaging)> CreateGeometryUploader;
+
+	//   Ǵ   ΰ  ε ޸
+	std::function<std::unique_ptr<UploadHeap>(UINT64 pageSize)> CreateUploadHeap;
+};
+
+// ׸ ,  ۴ PRESENT · ޾ PRESENT · ش
+struct SceneFrameTarget
+{
+	ID3D12Resource* BackBuffer = nullptr;
+	D3D12_CPU_DESCRIPTOR_HANDLE RenderTarget = {};
+	D3D12_CPU_DESCRIPTOR_HANDLE DepthStencil = {};
+	D3D12_VIEWPORT Viewport = {};
+	D3D12_RECT ScissorRect = {};
+};
+
+class SceneRenderer
+{
+public:
+	SceneRenderer(const SceneResourceFactory& factory, FrameFence& fence, CommandRecorderPool& lists,
+		VertexEncoding vertexEncoding);
+	SceneRenderer(const SceneRenderer& rhs) = delete;
+	SceneRenderer& operator=(const SceneRenderer& rhs) = delete;
+
+	// ʱȭ ߿  ޸, ҷ 𵨵 ⼭ Ҵϸ EndBuild   ȴ
+	ScratchArena& LoadScratch() { return mLoadScratch; }
+
+	// ҷ  ȭϰ ޽÷  ٲ  LOD ,  ĳÿ ״   ִ
+	// vertices/indices ڸ ٲ, ޽÷ LOD EndBuild   ִ
+	SceneModel PrepareModel(const std::string& name, std::pmr::vector<Vertex>& vertices,
+		std::pmr::vector<std::uint32_t>& indices);
+
+	// //Ʈ    縦 recorder Ѵ, skull  ذ 
+	void Build(CommandRecorder& recorder, const SceneModel* skull);
+
+	// Build    (潺 Flush ) ȣ, ¡ ε ޸𸮸 Ѵ
+	void EndBuild();
+
+	// ʱȭ  ޽ ȭ/޽÷/LOD/ȭ ,  پ
+	void LogMeshReport(const std::string& name, const MeshOptimizeReport& report);
+	const std::vector<std::string>& BuildLog()const { return mBuildLog; }
+
+	void SetPipeline(ID3D12PipelineState* pso, ID3D12RootSignature* rootSignature);
+	void Resize(int width, int height);
+	void SetCameraOrbit(float theta, float phi, float radius);
+
+	//       ޸𸮿     Ѵ
+	void SetCaptureCommands(bool capture) { mCaptureCommands = capture; }
+	bool CaptureCommands()const { return mCaptureCommands; }
+
+	//   ڿ Ѿ / ͸ Ѵ
+	void Update();
+
+	// غ , ׸  ,    Ѵ
+	void Draw(const SceneFrameTarget& target);
+
+	//   ڿ 潺 Ѵ, Present ڿ ȣ
+	void EndFrame();
+
+	const FrameStats& Stats()const { return mFrameStats; }
+
+private:
+	void UpdateCamera();
+	void UpdateTerrain();
+	void LoadTerrainChunk(const TerrainChunk& chunk);
+	void EvictTerrainChunk(TerrainChunkCoord coord);
+	void RetireGeometry(UINT64 completedFence);
+	void UpdateVisibility();
+	void UpdateLodSelection();
+	void UpdateInstanceBuffer();
+	void UpdateClusterCulling();
+	void UpdateRenderQueue();
+	void UpdateMaterialBuffer();
+	void UpdatePassCB();
+
+	void DrawBegin(CommandRecorder& list);
+	void RecordDrawRange(const RecordRange& range, CommandRecorder& recorder, CommandStateCache& stateCache);
+	void DrawEnd(CommandRecorder& list);
+	CommandRecorder& BeginRecording(MemoryCommandRecorder& capture, CommandRecorder& target);
+	void EndRecording(const MemoryCommandRecorder& capture, CommandRecorder& target);
+	void AddCaptureStats(const MemoryCommandRecorder& capture);
+
+	void BuildGeometry(const SceneModel* skull);
+	void BuildTerrainIndexBuffer();
+	void Log(const char* format, ...);
+	void LogScratchStats();
+	void LogQuantizeErrors(const GeometryPacker<Vertex>& packer);
+	std::vector<Meshlet> BuildMeshlets(const std::string& name, const XMFLOAT3* positions, UINT positionStride,
+		UINT vertexCount, std::uint32_t* indices, UINT indexCount);
+	void BuildLods(GeometryPacker<Vertex>& packer, const std::string& name, const GeometryGenerator::MeshData& mesh);
+	void AddModel(GeometryPacker<Vertex>& packer, const std::string& name, const SceneModel& model);
+	void RecordLods(const std::string& name, size_t baseIndexCount, const std::vector<MeshLod>& lods);
+	static std::string LodName(const std::string& name, UINT level);
+	void BuildMaterials();
+	void BuildRenderItem(bool hasSkull);
+	RenderItem* AddRenderItem(PackedGeometry* geo, const std::string& submesh, MaterialInfo* mat, FXMMATRIX world);
+	UINT GetGeometryId(PackedGeometry* geo, const std::string& submesh);
+	void BuildFrameResources();
+
+private:
+	SceneResourceFactory mFactory;
+	FrameFence& mFence;
+	CommandRecorderPool& mLists;
+
+	//  ڵ, ⺻  24Ʈ  ״
+	//   CompactOct16/CompactOct8 ٲ  Ҵ
+	VertexEncoding mVertexEncoding = VertexEncoding::Float;
+
+	//    ¿ Ʈ ñ״ó
+	ID3D12PipelineState* mPSO = nullptr;
+	ID3D12RootSignature* mRootSignature = nullptr;
+
+	// ʱȭ α
+	std::vector<std::string> mBuildLog;
+
+	//  ڿ 
+	std::vector<std::unique_ptr<FrameResource>> mFrameResources;
+	FrameResource* mCurrFrameResource = nullptr;
+	FrameRing mFrameRing = FrameRing(gNumFrameResources);
+
+	//   
+	std::unordered_map<std::string, std::unique_ptr<PackedGeometry>> mGeoMetries;
+
+	// ʱȭ     ε ¡ , 簡  ¡ ϰ ۴ 
+	std::unique_ptr<GeometryUploader> mGeometryUploader;
+
+	//  ûũ ε ¡ , ûũ ũ⿡  ۰ ΰ  Ѵ
+	std::unique_ptr<GeometryUploader> mTerrainUploader;
+
+	// ʱȭ ߿  ޽/ȯ , ʱȭ    
+	ScratchArena mLoadScratch;
+
+	//  ̸ -> ,  ۿ MatCBIndex  Ѵ
+	std::unordered_map<std::string, std::unique_ptr<MaterialInfo>> mMaterials;
+
+	// Ʈ Ʈ
+	std::vector<std::unique_ptr<RenderItem>> mRenderItems;
+
+	// Ʈ  //ID 迭  
+	SceneStore mScene;
+
+	// ޽ ̸ ->  ID,  ID -> ׸ 
+	std::unordered_map<std::string, UINT> mGeometryIds;
+	std::vector<GeometryDraw> mGeometryDraws;
+
+	// ø    ۾ ۾ 
+	JobSystem mJobs;
+
+	// ü ø, SceneStore  ε  
+	FrustumCuller mCuller = FrustumCuller(&mJobs);
+	std::vector<std::uint8_t> mVisible;
+
+	// ̴ Ʈ /  νϽ ׷ 
+	InstanceBatcher mBatcher;
+
+	// ī޶ ֺ  ûũ Ʈ, ûũ Ű ->  ۿ  ڵ
+	//  ûũ  ε ۸ 
+	TerrainStreamer mTerrain = TerrainStreamer(16.0f, 32, 96.0f, 128.0f, 4, &mJobs);
+	std::unordered_map<std::uint64_t, TerrainChunkDraw> mTerrainChunks;
+	StaticBuffer mTerrainIndexBuffer;
+
+	//  ٴ ڿ   ʵ   Ʒ д
+	float mTerrainHeight = -0.05f;
+
+	//  ûũ   ID,  ҷ ûũ Ѵ
+	std::vector<UINT> mFreeGeometryIds;
+
+	//  ûũ , ̹      ־ 潺   
+	std::deque<std::pair<UINT64, StaticBuffer>> mRetiredGeometry;
+
+	// ޽ ̸ -> LOD ܰ躰 , ̹ ӿ LOD ݿ Ʈ  ID
+	std::unordered_map<std::string, std::vector<float>> mLodErrors;
+	std::vector<std::uint32_t> mDrawGeometryIds;
+
+	//   ȭ鿡  ȼ  ϸ  ģ LOD 
+	float mLodPixelError = 1.0f;
+
+	// ޽ ̸ -> ޽÷, ׷츶  Ŭ ε 
+	std::unordered_map<std::string, std::vector<Meshlet>> mMeshlets;
+
+	// PrepareModel  ޽÷ LOD /ε, SceneModel ŰǷ EndBuild д
+	struct PreparedModel
+	{
+		std::vector<Meshlet> Meshlets;
+		std::vector<MeshLod> Lods;
+		std::vector<std::pmr::vector<Vertex>> LodVertices;
+		std::vector<std::pmr::vector<std::uint32_t>> LodIndices;
+	};
+	std::deque<PreparedModel> mPreparedModels;
+	ClusterCuller mClusterCuller;
+	std::vector<ClusterRange> mClusterRanges;
+	std::vector<GroupClusterRanges> mGroupClusterRanges;
+
+	// νϽ ׷   Ű  ׸, ̹  ´ ٽ  ʴ´
+	// PackedGeometry ->  Ű  ID ( ϸ,  ûũ  ID )
+	RenderQueue mRenderQueue;
+	std::unordered_map<PackedGeometry*, UINT> mBufferIds;
+
+	// ĵ ׷ ο      ۾ 帶  Ѵ
+	//   /ϱ/ ĳø ϳ ,     Ѵ
+	ParallelRecorder mParallelRecorder = ParallelRecorder(&mJobs);
+	std::vector<std::uint32_t> mRecordCosts;
+	std::vector<RecordRange> mRecordRanges;
+	std::vector<CommandRecorder*> mRangeRecorders;
+	std::vector<CommandStateCache> mRangeStateCaches;
+
+	//  ϳ  ּ ο , ̺      ũ
+	UINT mMinDrawsPerList = 64;
+
+	// н/νϽ ʹ   ε   Ҵ 
+	//    潺    ٽ 
+	std::unique_ptr<UploadHeap> mFrameUploads;
+
+	//  ڿ  ,  Ƿ Ҵ    ȴ
+	std::unique_ptr<UploadHeap> mMaterialUploads;
+	D3D12_GPU_VIRTUAL_ADDRESS mPassCBAddress = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS mMaterialBufferAddress = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS mInstanceAddress = 0;
+
+	// ̹  ׸ 
+	SceneFrameTarget mTarget;
+
+	//   ϸ ޸𸮿  Ѵ
+	bool mCaptureCommands = false;
+	MemoryCommandRecorder mCaptureBegin;
+	std::vector<MemoryCommandRecorder> mCaptureRanges;
+	MemoryCommandRecorder mCaptureEnd;
+
+	//   ,  Ű    Ÿ 
+	float mFarPlane = 1000.0f;
+
+	// ȭ , LOD  ȼ ٲ  
+	int mClientHeight = 600;
+
+	//þ /  
+	XMFLOAT4X4 mView = MathHelper::Identity4x4();
+	XMFLOAT4X4 mProj = MathHelper::Identity4x4();
+
+	//þ ġ
+	XMFLOAT3 mEyePos = { 0.0f, 0.0f, 0.0f };
+
+	// ǥ  ,  콺 Է ٲ۴
+	float mTheta = 1.5f * XM_PI;
+	float mPhi = XM_PIDIV4;
+	float mRadius = 5.0f;
+
+	// 
+	FrameStats mFrameStats;
+};
@@ -0,0 +1,49 @@
+//***************************************************************************************
+// BenchTimer.h
+//
+// Timing helpers for the benchmarks.  Each measurement runs the body a number of
+// times and keeps the fastest and the median run, which are less noisy than the mean
+// on a shared machine.  Benchmarks print a checksum of what they computed so the
+// work cannot be optimized away.
+//***************************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+struct BenchResult
+{
+	double BestMs = 0.0;
+	double MedianMs = 0.0;
+};
+
+template<typename TBody>
+BenchResult RunBench(int runs, TBody&& body)
+{
+	std::vector<double> times;
+	times.reserve(runs);
+
+	for(int i = 0; i < runs; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		body();
+		auto end = std::chrono::steady_clock::now();
+		times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+
+	std::sort(times.begin(), times.end());
+
+	BenchResult result;
+	result.BestMs = times.front();
+	result.MedianMs = times[times.size() / 2];
+	return result;
+}
+
+inline void PrintBench(const char* name, const BenchResult& result)
+{
+	std::printf("  %-36s best %9.3f ms   median %9.3f ms\n", name, result.BestMs, result.MedianMs);
+}
+
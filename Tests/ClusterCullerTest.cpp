@@ -0,0 +1,311 @@
+//***************************************************************************************
+// ClusterCullerTest.cpp
+//
+// Builds meshlets for the skull and a generated sphere and checks the limits, that the
+// reordered indices hold the same triangles, and that each bounding sphere contains
+// its meshlet's vertices.  Then culls the sphere's meshlets for a known view, the eye
+// on -z and a frustum plane at x = 0: clusters entirely behind the plane and clusters
+// that only face away must be rejected, and no cluster with a visible front-facing
+// triangle may be.  Finally checks that merging over gaps keeps every visible
+// meshlet, respects the range limit and reports the extra triangles.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/ClusterCuller.h"
+#include "../Common/GeometryGenerator.h"
+#include "../Common/TextModelLoader.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+
+using namespace DirectX;
+
+namespace
+{
+	struct ModelVertex
+	{
+		XMFLOAT3 Pos;
+		XMFLOAT3 Normal;
+	};
+
+	struct Mesh
+	{
+		std::vector<XMFLOAT3> Positions;
+		std::vector<std::uint32_t> Indices;
+	};
+
+	XMFLOAT3 Sub(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+	float Dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+	XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+
+	// Triangles with each rotated to start at its smallest index, which keeps the winding.
+	std::vector<std::array<std::uint32_t, 3>> TriangleSet(const std::vector<std::uint32_t>& indices)
+	{
+		std::vector<std::array<std::uint32_t, 3>> triangles;
+		for(std::size_t t = 0; t < indices.size(); t += 3)
+		{
+			std::array<std::uint32_t, 3> tri = { indices[t], indices[t + 1], indices[t + 2] };
+			std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+			triangles.push_back(tri);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	std::vector<Meshlet> BuildChecked(const char* name, Mesh& mesh)
+	{
+		const auto before = TriangleSet(mesh.Indices);
+
+		std::vector<Meshlet> meshlets = MeshletBuilder::Build(mesh.Positions.data(), sizeof(XMFLOAT3),
+			(std::uint32_t)mesh.Positions.size(), mesh.Indices.data(), mesh.Indices.size());
+
+		CHECK(!meshlets.empty());
+		CHECK(TriangleSet(mesh.Indices) == before);
+
+		std::uint32_t nextIndex = 0;
+		float worstOverhang = 0.0f;
+		for(const Meshlet& meshlet : meshlets)
+		{
+			// Contiguous ranges that cover the index buffer in order.
+			CHECK(meshlet.StartIndex == nextIndex);
+			nextIndex += meshlet.TriangleCount * 3;
+
+			CHECK(meshlet.TriangleCount > 0);
+			CHECK(meshlet.TriangleCount <= MeshletBuilder::MaxTriangles);
+			CHECK(meshlet.VertexCount <= MeshletBuilder::MaxVertices);
+
+			std::vector<std::uint32_t> unique(mesh.Indices.begin() + meshlet.StartIndex,
+				mesh.Indices.begin() + meshlet.StartIndex + meshlet.TriangleCount * 3);
+			std::sort(unique.begin(), unique.end());
+			unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+			CHECK(unique.size() == meshlet.VertexCount);
+
+			for(std::uint32_t v : unique)
+			{
+				XMFLOAT3 d = Sub(mesh.Positions[v], meshlet.Center);
+				float overhang = std::sqrt(Dot(d, d)) - meshlet.Radius;
+				worstOverhang = std::max(worstOverhang, overhang);
+			}
+		}
+		CHECK(nextIndex == mesh.Indices.size());
+		CHECK(worstOverhang <= 1e-4f * std::max(1.0f, meshlets[0].Radius));
+
+		std::printf("%s: %zu triangles -> %zu meshlets, worst sphere overhang %g\n", name,
+			mesh.Indices.size() / 3, meshlets.size(), worstOverhang);
+		return meshlets;
+	}
+
+	Mesh LoadSkull()
+	{
+		std::vector<ModelVertex> vertices;
+		Mesh mesh;
+		const std::string path = std::string(MODELS_DIR) + "/skull.txt";
+		bool loaded = TextModelLoader::Load(std::wstring(path.begin(), path.end()), vertices, mesh.Indices);
+		CHECK(loaded);
+		for(const ModelVertex& v : vertices)
+			mesh.Positions.push_back(v.Pos);
+		return mesh;
+	}
+
+	Mesh MakeSphere()
+	{
+		GeometryGenerator generator;
+		GeometryGenerator::MeshData sphere = generator.CreateSphere(1.0f, 64, 64);
+
+		Mesh mesh;
+		for(const GeometryGenerator::Vertex& v : sphere.Vertices)
+			mesh.Positions.push_back(v.Position);
+		mesh.Indices.assign(sphere.Indices32.begin(), sphere.Indices32.end());
+		return mesh;
+	}
+
+	// Kept meshlets from the ranges of one Cull with no gap merging.
+	std::vector<std::uint8_t> KeptMeshlets(const std::vector<Meshlet>& meshlets, const std::vector<ClusterRange>& ranges)
+	{
+		std::vector<std::uint8_t> kept(meshlets.size(), 0);
+		for(std::size_t i = 0; i < meshlets.size(); ++i)
+		{
+			for(const ClusterRange& range : ranges)
+			{
+				if(meshlets[i].StartIndex >= range.StartIndex &&
+					meshlets[i].StartIndex + meshlets[i].TriangleCount * 3 <= range.StartIndex + range.IndexCount)
+					kept[i] = 1;
+			}
+		}
+		return kept;
+	}
+
+	void TestKnownView(const Mesh& mesh, const std::vector<Meshlet>& meshlets)
+	{
+		// Everything within 100 units, cut by x >= 0.
+		const XMFLOAT4 planes[6] =
+		{
+			XMFLOAT4(1.0f, 0.0f, 0.0f, 0.0f),
+			XMFLOAT4(-1.0f, 0.0f, 0.0f, 100.0f),
+			XMFLOAT4(0.0f, 1.0f, 0.0f, 100.0f),
+			XMFLOAT4(0.0f, -1.0f, 0.0f, 100.0f),
+			XMFLOAT4(0.0f, 0.0f, 1.0f, 100.0f),
+			XMFLOAT4(0.0f, 0.0f, -1.0f, 100.0f),
+		};
+		const XMFLOAT3 eye(0.0f, 0.0f, -10.0f);
+
+		ClusterCuller culler;
+		culler.SetView(planes, eye);
+		culler.SetRangeLimits(0, 0);
+
+		const XMFLOAT4X4 world(
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f);
+		const std::uint32_t instance = 0;
+
+		std::vector<ClusterRange> ranges;
+		ClusterCullStats stats;
+		culler.Cull(meshlets.data(), (std::uint32_t)meshlets.size(), &world, &instance, 1, ranges, stats);
+		const std::vector<std::uint8_t> kept = KeptMeshlets(meshlets, ranges);
+
+		std::uint32_t shouldFrustumCull = 0;
+		std::uint32_t backFacing = 0;
+		std::uint32_t backFacingRejected = 0;
+		for(std::size_t i = 0; i < meshlets.size(); ++i)
+		{
+			const Meshlet& meshlet = meshlets[i];
+
+			// Bounding sphere entirely behind x = 0: must go.
+			if(meshlet.Center.x + meshlet.Radius < 0.0f)
+			{
+				CHECK(!kept[i]);
+				shouldFrustumCull++;
+			}
+
+			// A front-facing triangle with a vertex in front of the plane: must stay.
+			bool visible = false;
+			bool facesEye = false;
+			for(std::uint32_t t = 0; t < meshlet.TriangleCount; ++t)
+			{
+				const std::uint32_t* tri = &mesh.Indices[meshlet.StartIndex + t * 3];
+				const XMFLOAT3& p0 = mesh.Positions[tri[0]];
+				const XMFLOAT3& p1 = mesh.Positions[tri[1]];
+				const XMFLOAT3& p2 = mesh.Positions[tri[2]];
+				XMFLOAT3 n = Cross(Sub(p1, p0), Sub(p2, p0));
+
+				bool front = Dot(n, Sub(eye, p0)) > 1e-6f;
+				facesEye = facesEye || front;
+				visible = visible || (front && std::max(p0.x, std::max(p1.x, p2.x)) > 0.0f);
+			}
+			if(visible)
+				CHECK(kept[i]);
+
+			// Inside the frustum and only facing away.  The cone bounds the normals
+			// loosely, so it need not reject all of these, but it should most.
+			if(!facesEye && meshlet.Center.x - meshlet.Radius > 0.0f && meshlet.ConeCutoff <= 1.0f)
+			{
+				backFacing++;
+				backFacingRejected += kept[i] ? 0 : 1;
+			}
+		}
+		CHECK(backFacing > 0);
+		CHECK(backFacingRejected * 4 >= backFacing * 3);
+
+		CHECK(stats.Tested == meshlets.size());
+		CHECK(stats.FrustumCulled >= shouldFrustumCull);
+		CHECK(shouldFrustumCull > 0);
+		CHECK(stats.BackfaceCulled > 0);
+		CHECK(stats.GapTriangles == 0);
+
+		// About three quarters of the sphere is behind the plane or facing away.
+		CHECK(stats.TrianglesSkipped * 2 > stats.Triangles);
+
+		std::printf("known view: %zu ranges, %u frustum culled, %u backface culled (%u of %u back-facing), %llu of %llu triangles skipped\n",
+			ranges.size(), stats.FrustumCulled, stats.BackfaceCulled, backFacingRejected, backFacing,
+			(unsigned long long)stats.TrianglesSkipped, (unsigned long long)stats.Triangles);
+	}
+
+	void TestRangeLimits(const std::vector<Meshlet>& meshlets)
+	{
+		// Seen from the side with the lower half cut away, so the kept meshlets are
+		// scattered through the index buffer.
+		const XMFLOAT4 planes[6] =
+		{
+			XMFLOAT4(0.0f, 1.0f, 0.0f, 0.0f),
+			XMFLOAT4(-1.0f, 0.0f, 0.0f, 100.0f),
+			XMFLOAT4(1.0f, 0.0f, 0.0f, 100.0f),
+			XMFLOAT4(0.0f, -1.0f, 0.0f, 100.0f),
+			XMFLOAT4(0.0f, 0.0f, 1.0f, 100.0f),
+			XMFLOAT4(0.0f, 0.0f, -1.0f, 100.0f),
+		};
+		const XMFLOAT4X4 world(
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f);
+		const std::uint32_t instance = 0;
+
+		ClusterCuller culler;
+		culler.SetView(planes, XMFLOAT3(0.3f, 0.0f, -3.0f));
+
+		culler.SetRangeLimits(0, 0);
+		std::vector<ClusterRange> exact;
+		ClusterCullStats exactStats;
+		culler.Cull(meshlets.data(), (std::uint32_t)meshlets.size(), &world, &instance, 1, exact, exactStats);
+		const std::vector<std::uint8_t> kept = KeptMeshlets(meshlets, exact);
+		CHECK(exact.size() > 4);
+
+		for(std::uint32_t maxRanges : { 1u, 2u, 4u })
+		{
+			culler.SetRangeLimits(maxRanges, 0);
+			std::vector<ClusterRange> merged;
+			ClusterCullStats stats;
+			std::uint32_t count = culler.Cull(meshlets.data(), (std::uint32_t)meshlets.size(), &world, &instance, 1, merged, stats);
+
+			CHECK(count == merged.size());
+			CHECK(merged.size() == maxRanges);
+
+			// Still covers every meshlet the exact cull kept, and accounts for the rest.
+			std::vector<std::uint8_t> covered = KeptMeshlets(meshlets, merged);
+			std::uint64_t drawn = 0;
+			for(const ClusterRange& range : merged)
+				drawn += range.IndexCount / 3;
+			for(std::size_t i = 0; i < meshlets.size(); ++i)
+			{
+				if(kept[i])
+					CHECK(covered[i]);
+			}
+			CHECK(stats.Triangles - stats.TrianglesSkipped == drawn);
+			CHECK(stats.GapTriangles == exactStats.TrianglesSkipped - stats.TrianglesSkipped);
+			CHECK(stats.GapTriangles > 0);
+		}
+
+		// Gaps up to the threshold close without a range limit.
+		culler.SetRangeLimits(0, (std::uint32_t)(exactStats.Triangles));
+		std::vector<ClusterRange> one;
+		ClusterCullStats oneStats;
+		culler.Cull(meshlets.data(), (std::uint32_t)meshlets.size(), &world, &instance, 1, one, oneStats);
+		CHECK(one.size() == 1);
+
+		std::printf("range limits: %zu exact ranges -> 1 with %llu gap triangles\n", exact.size(),
+			(unsigned long long)oneStats.GapTriangles);
+	}
+}
+
+int main()
+{
+	Mesh skull = LoadSkull();
+	if(!skull.Indices.empty())
+		BuildChecked("Skull", skull);
+
+	Mesh sphere = MakeSphere();
+	std::vector<Meshlet> meshlets = BuildChecked("Sphere", sphere);
+
+	TestKnownView(sphere, meshlets);
+	TestRangeLimits(meshlets);
+
+	return TestResult("ClusterCullerTest");
+}
@@ -0,0 +1,110 @@
+//***************************************************************************************
+// DrawStream.h
+//
+// A synthetic sorted draw stream for the ParallelRecorder test and benchmark, and a
+// range recorder that binds state the way InitDirect3DApp::RecordDrawRange does:
+// pass-wide state once per range, then buffers, topology and root constants through
+// a CommandStateCache for every group.  Pipeline state and root signature pointers
+// are fake; they are only compared and stored, never dereferenced.
+//***************************************************************************************
+
+#pragma once
+
+#include "../Common/CommandStateCache.h"
+#include "../Common/ParallelRecorder.h"
+
+#include <random>
+#include <vector>
+
+struct DrawGroup
+{
+	std::uint32_t Geometry = 0;
+	std::uint32_t Material = 0;
+	std::uint32_t FirstInstance = 0;
+	std::uint32_t InstanceCount = 1;
+	std::uint32_t PartCount = 1;
+};
+
+struct DrawStream
+{
+	std::vector<D3D12_VERTEX_BUFFER_VIEW> VertexBuffers;
+	std::vector<D3D12_INDEX_BUFFER_VIEW> IndexBuffers;
+	std::vector<DrawGroup> Groups;
+
+	// Record cost of each group, as the app estimates it: one per draw.
+	std::vector<std::uint32_t> Costs;
+};
+
+// Groups sorted by geometry, so neighbouring groups share buffers as they do after the
+// render queue sort.
+inline DrawStream MakeDrawStream(std::uint32_t groupCount, std::uint32_t geometryCount, std::uint32_t seed)
+{
+	DrawStream stream;
+	for(std::uint32_t g = 0; g < geometryCount; ++g)
+	{
+		stream.VertexBuffers.push_back({ 0x10000000ull + g * 0x100000ull, 0x80000, 32 });
+		stream.IndexBuffers.push_back({ 0x80000000ull + g * 0x100000ull, 0x40000, DXGI_FORMAT_R16_UINT });
+	}
+
+	std::mt19937 rng(seed);
+	std::uint32_t firstInstance = 0;
+	for(std::uint32_t i = 0; i < groupCount; ++i)
+	{
+		DrawGroup group;
+		group.Geometry = (std::uint32_t)((std::uint64_t)i * geometryCount / groupCount);
+		group.Material = rng() % 16;
+		group.FirstInstance = firstInstance;
+		group.InstanceCount = 1 + rng() % 8;
+		group.PartCount = 1 + rng() % 3;
+		firstInstance += group.InstanceCount;
+
+		stream.Groups.push_back(group);
+		stream.Costs.push_back(group.PartCount);
+	}
+	return stream;
+}
+
+struct DrawPassState
+{
+	ID3D12PipelineState* Pso = reinterpret_cast<ID3D12PipelineState*>(0x1000);
+	ID3D12RootSignature* RootSignature = reinterpret_cast<ID3D12RootSignature*>(0x2000);
+	D3D12_GPU_VIRTUAL_ADDRESS PassCB = 0x3000000;
+	D3D12_GPU_VIRTUAL_ADDRESS Instances = 0x4000000;
+	D3D12_GPU_VIRTUAL_ADDRESS Materials = 0x5000000;
+	D3D12_VIEWPORT Viewport = { 0.0f, 0.0f, 800.0f, 600.0f, 0.0f, 1.0f };
+	D3D12_RECT Scissor = { 0, 0, 800, 600 };
+	D3D12_CPU_DESCRIPTOR_HANDLE RenderTarget = { 0x100 };
+	D3D12_CPU_DESCRIPTOR_HANDLE DepthStencil = { 0x200 };
+};
+
+inline void RecordDrawRange(const DrawStream& stream, const DrawPassState& pass, const RecordRange& range,
+	CommandRecorder& recorder, CommandStateCache& stateCache)
+{
+	stateCache.Begin(&recorder);
+
+	recorder.RSSetViewport(pass.Viewport);
+	recorder.RSSetScissorRect(pass.Scissor);
+	recorder.OMSetRenderTarget(pass.RenderTarget, pass.DepthStencil);
+
+	stateCache.SetPipelineState(pass.Pso);
+	stateCache.SetGraphicsRootSignature(pass.RootSignature);
+	stateCache.SetGraphicsRootConstantBufferView(2, pass.PassCB);
+	stateCache.SetGraphicsRootShaderResourceView(3, pass.Instances);
+	stateCache.SetGraphicsRootShaderResourceView(1, pass.Materials);
+
+	for(std::uint32_t i = range.Begin; i < range.End; ++i)
+	{
+		const DrawGroup& group = stream.Groups[i];
+
+		stateCache.IASetVertexBuffer(stream.VertexBuffers[group.Geometry]);
+		stateCache.IASetIndexBuffer(stream.IndexBuffers[group.Geometry]);
+		stateCache.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+		for(std::uint32_t part = 0; part < group.PartCount; ++part)
+		{
+			UINT constants[4] = { group.FirstInstance, group.Material, part, 0 };
+			stateCache.SetGraphicsRoot32BitConstants(0, 4, constants, 0);
+			stateCache.DrawIndexedInstanced(36 + part * 12, group.InstanceCount, part * 36, 0, 0);
+		}
+	}
+}
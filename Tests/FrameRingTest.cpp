@@ -0,0 +1,122 @@
+//***************************************************************************************
+// FrameRingTest.cpp
+//
+// Runs FrameRing against a simulated fence.  The simulated GPU executes submitted
+// frames in order, each taking a fixed time, and the fence value of a frame is its
+// number.  The CPU side follows the frame loop of InitDirect3DApp: Advance, wait if
+// told to, record, submit, Signal.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/FrameRing.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	// GPU timeline in simulated time units.  Frame n's fence value is n + 1.
+	class SimulatedFence
+	{
+	public:
+		explicit SimulatedFence(double gpuFrameTime) :
+			mGpuFrameTime(gpuFrameTime)
+		{
+		}
+
+		std::uint64_t Submit(double now)
+		{
+			double start = std::max(now, mGpuFreeAt);
+			mGpuFreeAt = start + mGpuFrameTime;
+			mCompletionTimes.push_back(mGpuFreeAt);
+			return mCompletionTimes.size();
+		}
+
+		std::uint64_t CompletedValue(double now)const
+		{
+			std::uint64_t value = 0;
+			while(value < mCompletionTimes.size() && mCompletionTimes[value] <= now)
+				++value;
+			return value;
+		}
+
+		double CompletionTime(std::uint64_t fenceValue)const { return mCompletionTimes[fenceValue - 1]; }
+		double GpuFreeAt()const { return mGpuFreeAt; }
+
+	private:
+		double mGpuFrameTime = 0.0;
+		double mGpuFreeAt = 0.0;
+		std::vector<double> mCompletionTimes;
+	};
+
+	struct SimulationResult
+	{
+		double TotalTime = 0.0;
+		int Waits = 0;
+		std::uint64_t MaxInFlight = 0;
+	};
+
+	SimulationResult Simulate(int ringSize, double cpuFrameTime, double gpuFrameTime, int frameCount)
+	{
+		FrameRing ring(ringSize);
+		SimulatedFence fence(gpuFrameTime);
+
+		// Frame whose resources each slot last held, -1 if none.
+		std::vector<int> slotFrame(ringSize, -1);
+
+		SimulationResult result;
+		double now = 0.0;
+
+		for(int frame = 0; frame < frameCount; ++frame)
+		{
+			std::uint64_t waitFence = ring.Advance(fence.CompletedValue(now));
+			if(waitFence != 0)
+			{
+				CHECK(waitFence > fence.CompletedValue(now));
+				now = fence.CompletionTime(waitFence);
+				++result.Waits;
+			}
+
+			// The GPU must be done with the frame that used this slot last.
+			int slot = ring.CurrentIndex();
+			if(slotFrame[slot] >= 0)
+				CHECK(fence.CompletedValue(now) >= (std::uint64_t)slotFrame[slot] + 1);
+			slotFrame[slot] = frame;
+
+			now += cpuFrameTime;
+			ring.Signal(fence.Submit(now));
+
+			result.MaxInFlight = std::max(result.MaxInFlight, (std::uint64_t)(frame + 1) - fence.CompletedValue(now));
+		}
+
+		result.TotalTime = fence.GpuFreeAt();
+		return result;
+	}
+}
+
+int main()
+{
+	const int frames = 1000;
+
+	// One slot: the CPU waits for every frame and the two never overlap.
+	SimulationResult single = Simulate(1, 4.0, 10.0, frames);
+	CHECK(single.Waits == frames - 1);
+	CHECK(single.TotalTime == frames * 14.0);
+	CHECK(single.MaxInFlight == 1);
+
+	// GPU bound: the CPU runs ahead by the ring size and the GPU is never idle.
+	for(int ringSize = 2; ringSize <= 4; ++ringSize)
+	{
+		SimulationResult gpuBound = Simulate(ringSize, 4.0, 10.0, frames);
+		CHECK(gpuBound.TotalTime == 4.0 + frames * 10.0);
+		CHECK(gpuBound.MaxInFlight <= (std::uint64_t)ringSize);
+		CHECK(gpuBound.Waits > 0);
+	}
+
+	// CPU bound: the GPU finishes each frame before the CPU laps it, so no waits.
+	SimulationResult cpuBound = Simulate(3, 10.0, 4.0, frames);
+	CHECK(cpuBound.Waits == 0);
+	CHECK(cpuBound.TotalTime == frames * 10.0 + 4.0);
+
+	return TestResult("FrameRingTest");
+}
@@ -0,0 +1,114 @@
+//***************************************************************************************
+// FrustumCullerBench.cpp
+//
+// Times FrustumCuller over 1, 2, 4... N threads at 100k and 1M objects, plus a scalar loop
+// with a sphere test followed by a box test as the single-threaded baseline.
+//
+// Usage: FrustumCullerBench [maxThreads]   (default: hardware threads)
+//***************************************************************************************
+
+#include "BenchTimer.h"
+#include "../Common/FrustumCuller.h"
+#include "../Common/JobSystem.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>
+
+using namespace DirectX;
+
+namespace
+{
+	bool ScalarVisible(const XMFLOAT4* planes, const BoundingSphere& sphere, const BoundingBox& box)
+	{
+		for(int p = 0; p < 6; ++p)
+		{
+			float d = sphere.Center.x * planes[p].x + sphere.Center.y * planes[p].y + sphere.Center.z * planes[p].z + planes[p].w;
+			if(d < -sphere.Radius)
+				return false;
+		}
+
+		for(int p = 0; p < 6; ++p)
+		{
+			float d = box.Center.x * planes[p].x + box.Center.y * planes[p].y + box.Center.z * planes[p].z + planes[p].w;
+			float r = box.Extents.x * std::fabs(planes[p].x) + box.Extents.y * std::fabs(planes[p].y) + box.Extents.z * std::fabs(planes[p].z);
+			if(d < -r)
+				return false;
+		}
+
+		return true;
+	}
+
+	void Compare(std::uint32_t count, std::uint32_t maxThreads)
+	{
+		const int runs = 15;
+
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> extent(0.5f, 4.0f);
+
+		std::vector<BoundingBox> boxes(count);
+		std::vector<BoundingSphere> spheres(count);
+		for(std::uint32_t i = 0; i < count; ++i)
+		{
+			boxes[i] = BoundingBox(XMFLOAT3(coord(rng), coord(rng) * 0.1f, coord(rng)), XMFLOAT3(extent(rng), extent(rng), extent(rng)));
+			BoundingSphere::CreateFromBoundingBox(spheres[i], boxes[i]);
+		}
+
+		XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 20.0f, -100.0f, 1.0f), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMMATRIX proj = XMMatrixPerspectiveFovLH(0.25f * XM_PI, 16.0f / 9.0f, 1.0f, 1000.0f);
+
+		std::vector<std::uint8_t> visible;
+		std::vector<std::uint32_t> visibleList;
+
+		FrustumCuller reference;
+		reference.SetCamera(view, proj);
+		std::uint32_t scalarVisible = 0;
+		BenchResult scalar = RunBench(runs, [&]()
+		{
+			visible.resize(count);
+			scalarVisible = 0;
+			for(std::uint32_t i = 0; i < count; ++i)
+			{
+				visible[i] = ScalarVisible(reference.Planes(), spheres[i], boxes[i]) ? 1 : 0;
+				scalarVisible += visible[i];
+			}
+		});
+
+		std::printf("%u objects, %u visible\n", count, scalarVisible);
+		PrintBench("scalar, 1 thread", scalar);
+
+		double oneThreadMs = 0.0;
+		for(std::uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+		{
+			std::unique_ptr<JobSystem> jobs = threads > 1 ? std::make_unique<JobSystem>((int)threads - 1) : nullptr;
+			FrustumCuller culler(jobs.get());
+			culler.SetCamera(view, proj);
+
+			CullStats stats;
+			BenchResult result = RunBench(runs, [&]() { stats = culler.Cull(spheres.data(), boxes.data(), count, visible, &visibleList); });
+			if(threads == 1)
+				oneThreadMs = result.MedianMs;
+
+			char name[64];
+			std::snprintf(name, sizeof(name), "FrustumCuller, %u thread%s", threads, threads > 1 ? "s" : "");
+			PrintBench(name, result);
+			std::printf("    %.2fx vs 1 thread, %u visible%s\n", oneThreadMs / result.MedianMs, stats.Visible,
+				stats.Visible == scalarVisible ? "" : " (DIFFERS from scalar)");
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::uint32_t maxThreads = argc > 1 ? (std::uint32_t)std::atoi(argv[1]) : std::thread::hardware_concurrency();
+	if(maxThreads == 0)
+		maxThreads = 1;
+
+	std::printf("up to %u threads, %u hardware threads\n", maxThreads, std::thread::hardware_concurrency());
+	Compare(100000, maxThreads);
+	Compare(1000000, maxThreads);
+	return 0;
+}
@@ -0,0 +1,134 @@
+//***************************************************************************************
+// FrustumCullerTest.cpp
+//
+// Checks the SSE culler against a scalar version of the same tests, for every worker
+// count and for counts that leave a short SIMD group at the end of a chunk, and checks
+// the planes extracted from a camera.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/FrustumCuller.h"
+#include "../Common/JobSystem.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+using namespace DirectX;
+
+namespace
+{
+	// Same tests and the same order of operations as FrustumCuller::CullChunk.
+	bool ReferenceVisible(const XMFLOAT4* planes, const BoundingSphere& sphere, const BoundingBox& box)
+	{
+		bool inside = true;
+		for(int p = 0; p < 6; ++p)
+		{
+			float d = (sphere.Center.x * planes[p].x + sphere.Center.y * planes[p].y) +
+				(sphere.Center.z * planes[p].z + planes[p].w);
+			if(d < -sphere.Radius)
+				return false;
+			if(!(d >= sphere.Radius))
+				inside = false;
+		}
+
+		if(inside)
+			return true;
+
+		for(int p = 0; p < 6; ++p)
+		{
+			float d = box.Center.x * planes[p].x + box.Center.y * planes[p].y + box.Center.z * planes[p].z + planes[p].w;
+			float r = box.Extents.x * std::fabs(planes[p].x) + box.Extents.y * std::fabs(planes[p].y) + box.Extents.z * std::fabs(planes[p].z);
+			if(d < -r)
+				return false;
+		}
+
+		return true;
+	}
+
+	void TestMatchesReference()
+	{
+		XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 5.0f, -40.0f, 1.0f), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMMATRIX proj = XMMatrixPerspectiveFovLH(0.25f * XM_PI, 16.0f / 9.0f, 1.0f, 200.0f);
+
+		std::mt19937 rng(99);
+		std::uniform_real_distribution<float> coord(-150.0f, 150.0f);
+		std::uniform_real_distribution<float> extent(0.1f, 8.0f);
+
+		const std::uint32_t maxCount = 5003;
+		std::vector<BoundingBox> boxes(maxCount);
+		std::vector<BoundingSphere> spheres(maxCount);
+		for(std::uint32_t i = 0; i < maxCount; ++i)
+		{
+			boxes[i] = BoundingBox(XMFLOAT3(coord(rng), coord(rng) * 0.2f, coord(rng)), XMFLOAT3(extent(rng), extent(rng), extent(rng)));
+			BoundingSphere::CreateFromBoundingBox(spheres[i], boxes[i]);
+		}
+
+		for(int workers = 0; workers <= 3; ++workers)
+		{
+			std::unique_ptr<JobSystem> jobs = workers > 0 ? std::make_unique<JobSystem>(workers) : nullptr;
+			FrustumCuller culler(jobs.get(), 130);
+			culler.SetCamera(view, proj);
+
+			for(std::uint32_t count : { 0u, 1u, 3u, 130u, 131u, 1000u, maxCount })
+			{
+				std::vector<std::uint8_t> visible;
+				std::vector<std::uint32_t> visibleList;
+				CullStats stats = culler.Cull(spheres.data(), boxes.data(), count, visible, &visibleList);
+
+				std::vector<std::uint32_t> expected;
+				for(std::uint32_t i = 0; i < count; ++i)
+				{
+					bool isVisible = ReferenceVisible(culler.Planes(), spheres[i], boxes[i]);
+					CHECK(visible[i] == (isVisible ? 1 : 0));
+					if(isVisible)
+						expected.push_back(i);
+				}
+
+				CHECK(visibleList == expected);
+				CHECK(stats.Visible == expected.size());
+				CHECK(stats.Visible + stats.Culled == count);
+				if(count == maxCount)
+					CHECK(stats.Visible > 0 && stats.Culled > 0);
+			}
+		}
+	}
+
+	void TestCameraPlanes()
+	{
+		// Camera at the origin looking down +z, near 1, far 100.
+		XMMATRIX view = XMMatrixLookAtLH(XMVectorZero(), XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMMATRIX proj = XMMatrixPerspectiveFovLH(0.5f * XM_PI, 1.0f, 1.0f, 100.0f);
+
+		FrustumCuller culler;
+		culler.SetCamera(view, proj);
+
+		const BoundingSphere spheres[] =
+		{
+			BoundingSphere(XMFLOAT3(0.0f, 0.0f, 50.0f), 1.0f),		// ahead
+			BoundingSphere(XMFLOAT3(0.0f, 0.0f, -5.0f), 1.0f),		// behind
+			BoundingSphere(XMFLOAT3(0.0f, 0.0f, 105.0f), 1.0f),	// past far
+			BoundingSphere(XMFLOAT3(0.0f, 0.0f, 100.5f), 1.0f),	// straddles far
+			BoundingSphere(XMFLOAT3(30.0f, 0.0f, 10.0f), 1.0f),	// left of the 90 degree cone's edge
+			BoundingSphere(XMFLOAT3(0.0f, -9.0f, 10.0f), 1.0f),	// just inside the bottom plane
+		};
+		const std::uint8_t expected[] = { 1, 0, 0, 1, 0, 1 };
+
+		std::vector<BoundingBox> boxes;
+		for(const BoundingSphere& s : spheres)
+			boxes.push_back(BoundingBox(s.Center, XMFLOAT3(s.Radius, s.Radius, s.Radius)));
+
+		std::vector<std::uint8_t> visible;
+		culler.Cull(spheres, boxes.data(), 6, visible);
+		for(int i = 0; i < 6; ++i)
+			CHECK(visible[i] == expected[i]);
+	}
+}
+
+int main()
+{
+	TestMatchesReference();
+	TestCameraPlanes();
+
+	return TestResult("FrustumCullerTest");
+}
@@ -0,0 +1,204 @@
+//***************************************************************************************
+// GeneratorReference.h
+//
+// The original CreateSphere and CreateCylinder, which grow their vectors with
+// push_back one vertex and index at a time.  Kept as the reference for the test and
+// the benchmark of the presized, row-parallel versions.
+//***************************************************************************************
+
+#pragma once
+
+#include "../Common/GeometryGenerator.h"
+
+#include <cmath>
+#include <vector>
+
+namespace GeneratorReference
+{
+	using Vertex = GeometryGenerator::Vertex;
+	using uint32 = std::uint32_t;
+
+	struct MeshData
+	{
+		std::vector<Vertex> Vertices;
+		std::vector<uint32> Indices32;
+	};
+
+	inline MeshData CreateSphere(float radius, uint32 sliceCount, uint32 stackCount)
+	{
+		using namespace DirectX;
+
+		MeshData meshData;
+
+		Vertex topVertex(0.0f, +radius, 0.0f, 0.0f, +1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+		Vertex bottomVertex(0.0f, -radius, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+
+		meshData.Vertices.push_back( topVertex );
+
+		float phiStep   = XM_PI/stackCount;
+		float thetaStep = 2.0f*XM_PI/sliceCount;
+
+		for(uint32 i = 1; i <= stackCount-1; ++i)
+		{
+			float phi = i*phiStep;
+
+			for(uint32 j = 0; j <= sliceCount; ++j)
+			{
+				float theta = j*thetaStep;
+
+				Vertex v;
+
+				v.Position.x = radius*sinf(phi)*cosf(theta);
+				v.Position.y = radius*cosf(phi);
+				v.Position.z = radius*sinf(phi)*sinf(theta);
+
+				v.TangentU.x = -radius*sinf(phi)*sinf(theta);
+				v.TangentU.y = 0.0f;
+				v.TangentU.z = +radius*sinf(phi)*cosf(theta);
+
+				XMVECTOR T = XMLoadFloat3(&v.TangentU);
+				XMStoreFloat3(&v.TangentU, XMVector3Normalize(T));
+
+				XMVECTOR p = XMLoadFloat3(&v.Position);
+				XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
+
+				v.TexC.x = theta / XM_2PI;
+				v.TexC.y = phi / XM_PI;
+
+				meshData.Vertices.push_back( v );
+			}
+		}
+
+		meshData.Vertices.push_back( bottomVertex );
+
+		for(uint32 i = 1; i <= sliceCount; ++i)
+		{
+			meshData.Indices32.push_back(0);
+			meshData.Indices32.push_back(i+1);
+			meshData.Indices32.push_back(i);
+		}
+
+		uint32 baseIndex = 1;
+		uint32 ringVertexCount = sliceCount + 1;
+		for(uint32 i = 0; i < stackCount-2; ++i)
+		{
+			for(uint32 j = 0; j < sliceCount; ++j)
+			{
+				meshData.Indices32.push_back(baseIndex + i*ringVertexCount + j);
+				meshData.Indices32.push_back(baseIndex + i*ringVertexCount + j+1);
+				meshData.Indices32.push_back(baseIndex + (i+1)*ringVertexCount + j);
+
+				meshData.Indices32.push_back(baseIndex + (i+1)*ringVertexCount + j);
+				meshData.Indices32.push_back(baseIndex + i*ringVertexCount + j+1);
+				meshData.Indices32.push_back(baseIndex + (i+1)*ringVertexCount + j+1);
+			}
+		}
+
+		uint32 southPoleIndex = (uint32)meshData.Vertices.size()-1;
+		baseIndex = southPoleIndex - ringVertexCount;
+
+		for(uint32 i = 0; i < sliceCount; ++i)
+		{
+			meshData.Indices32.push_back(southPoleIndex);
+			meshData.Indices32.push_back(baseIndex+i);
+			meshData.Indices32.push_back(baseIndex+i+1);
+		}
+
+		return meshData;
+	}
+
+	inline void BuildCylinderCap(float radius, float y, float normalY, float height, uint32 sliceCount, bool top, MeshData& meshData)
+	{
+		using namespace DirectX;
+
+		uint32 baseIndex = (uint32)meshData.Vertices.size();
+		float dTheta = 2.0f*XM_PI/sliceCount;
+
+		for(uint32 i = 0; i <= sliceCount; ++i)
+		{
+			float x = radius*cosf(i*dTheta);
+			float z = radius*sinf(i*dTheta);
+
+			float u = x/height + 0.5f;
+			float v = z/height + 0.5f;
+
+			meshData.Vertices.push_back( Vertex(x, y, z, 0.0f, normalY, 0.0f, 1.0f, 0.0f, 0.0f, u, v) );
+		}
+
+		meshData.Vertices.push_back( Vertex(0.0f, y, 0.0f, 0.0f, normalY, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.5f) );
+
+		uint32 centerIndex = (uint32)meshData.Vertices.size()-1;
+
+		for(uint32 i = 0; i < sliceCount; ++i)
+		{
+			meshData.Indices32.push_back(centerIndex);
+			meshData.Indices32.push_back(baseIndex + (top ? i+1 : i));
+			meshData.Indices32.push_back(baseIndex + (top ? i : i+1));
+		}
+	}
+
+	inline MeshData CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount)
+	{
+		using namespace DirectX;
+
+		MeshData meshData;
+
+		float stackHeight = height / stackCount;
+		float radiusStep = (topRadius - bottomRadius) / stackCount;
+
+		uint32 ringCount = stackCount+1;
+
+		for(uint32 i = 0; i < ringCount; ++i)
+		{
+			float y = -0.5f*height + i*stackHeight;
+			float r = bottomRadius + i*radiusStep;
+
+			float dTheta = 2.0f*XM_PI/sliceCount;
+			for(uint32 j = 0; j <= sliceCount; ++j)
+			{
+				Vertex vertex;
+
+				float c = cosf(j*dTheta);
+				float s = sinf(j*dTheta);
+
+				vertex.Position = XMFLOAT3(r*c, y, r*s);
+
+				vertex.TexC.x = (float)j/sliceCount;
+				vertex.TexC.y = 1.0f - (float)i/stackCount;
+
+				vertex.TangentU = XMFLOAT3(-s, 0.0f, c);
+
+				float dr = bottomRadius-topRadius;
+				XMFLOAT3 bitangent(dr*c, -height, dr*s);
+
+				XMVECTOR T = XMLoadFloat3(&vertex.TangentU);
+				XMVECTOR B = XMLoadFloat3(&bitangent);
+				XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
+				XMStoreFloat3(&vertex.Normal, N);
+
+				meshData.Vertices.push_back(vertex);
+			}
+		}
+
+		uint32 ringVertexCount = sliceCount+1;
+
+		for(uint32 i = 0; i < stackCount; ++i)
+		{
+			for(uint32 j = 0; j < sliceCount; ++j)
+			{
+				meshData.Indices32.push_back(i*ringVertexCount + j);
+				meshData.Indices32.push_back((i+1)*ringVertexCount + j);
+				meshData.Indices32.push_back((i+1)*ringVertexCount + j+1);
+
+				meshData.Indices32.push_back(i*ringVertexCount + j);
+				meshData.Indices32.push_back((i+1)*ringVertexCount + j+1);
+				meshData.Indices32.push_back(i*ringVertexCount + j+1);
+			}
+		}
+
+		BuildCylinderCap(topRadius, 0.5f*height, 1.0f, height, sliceCount, true, meshData);
+		BuildCylinderCap(bottomRadius, -0.5f*height, -1.0f, height, sliceCount, false, meshData);
+
+		return meshData;
+	}
+}
@@ -0,0 +1,121 @@
+//***************************************************************************************
+// GeometryGeneratorBench.cpp
+//
+// Times geosphere subdivision with shared edge midpoints against the original
+// Subdivide, which emits six vertices per split triangle, and the presized grid,
+// sphere and cylinder generators with and without a JobSystem against the original
+// push_back versions.
+//
+// Usage: GeometryGeneratorBench [threads]   (default: hardware threads)
+//***************************************************************************************
+
+#include "BenchTimer.h"
+#include "GeneratorReference.h"
+#include "SubdivideReference.h"
+#include "../Common/JobSystem.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+using namespace DirectX;
+
+namespace
+{
+	// The projection loop of CreateGeosphere.
+	void Project(std::vector<GeometryGenerator::Vertex>& vertices, float radius)
+	{
+		for(GeometryGenerator::Vertex& v : vertices)
+		{
+			XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&v.Position));
+			XMStoreFloat3(&v.Position, radius*n);
+			XMStoreFloat3(&v.Normal, n);
+
+			float theta = atan2f(v.Position.z, v.Position.x);
+			if(theta < 0.0f)
+				theta += XM_2PI;
+			float phi = acosf(v.Position.y / radius);
+
+			v.TexC.x = theta/XM_2PI;
+			v.TexC.y = phi/XM_PI;
+
+			v.TangentU.x = -radius*sinf(phi)*sinf(theta);
+			v.TangentU.y = 0.0f;
+			v.TangentU.z = +radius*sinf(phi)*cosf(theta);
+			XMStoreFloat3(&v.TangentU, XMVector3Normalize(XMLoadFloat3(&v.TangentU)));
+		}
+	}
+
+	void BenchSubdivide()
+	{
+		const int runs = 10;
+		std::printf("Geosphere, 6 subdivisions\n");
+
+		GeometryGenerator generator;
+		std::size_t vertexCount = 0;
+		BenchResult shared = RunBench(runs, [&]()
+		{
+			GeometryGenerator::MeshData mesh = generator.CreateGeosphere(1.0f, 6);
+			vertexCount = mesh.Vertices.size();
+		});
+
+		// Same 20-triangle start and projection as CreateGeosphere.
+		GeometryGenerator::MeshData base = generator.CreateGeosphere(1.0f, 0);
+		std::size_t refVertexCount = 0;
+		BenchResult reference = RunBench(runs, [&]()
+		{
+			std::vector<GeometryGenerator::Vertex> vertices(base.Vertices.begin(), base.Vertices.end());
+			std::vector<std::uint32_t> indices(base.Indices32.begin(), base.Indices32.end());
+			for(int i = 0; i < 6; ++i)
+				SubdivideReference::Subdivide(vertices, indices);
+			Project(vertices, 1.0f);
+			refVertexCount = vertices.size();
+		});
+
+		PrintBench("CreateGeosphere (shared midpoints)", shared);
+		PrintBench("original Subdivide", reference);
+		std::printf("    %zu vs %zu vertices, %.1fx faster\n", vertexCount, refVertexCount,
+			reference.MedianMs / shared.MedianMs);
+	}
+
+	void BenchGeneration(std::uint32_t threads)
+	{
+		const int runs = 5;
+		const std::uint32_t n = 1024;
+		std::printf("Generation, %u x %u, pool of %u threads\n", n, n, threads);
+
+		JobSystem jobs((int)threads - 1);
+		GeometryGenerator serial;
+		GeometryGenerator parallel(&jobs);
+
+		std::size_t sink = 0;
+		auto run = [&](const char* name, auto&& create)
+		{
+			PrintBench(name, RunBench(runs, [&]() { sink += create().Vertices.size(); }));
+		};
+
+		run("grid, presized", [&]() { return serial.CreateGrid(100.0f, 100.0f, n, n); });
+		run("grid, presized + pool", [&]() { return parallel.CreateGrid(100.0f, 100.0f, n, n); });
+
+		run("sphere, original", [&]() { return GeneratorReference::CreateSphere(1.0f, n, n); });
+		run("sphere, presized", [&]() { return serial.CreateSphere(1.0f, n, n); });
+		run("sphere, presized + pool", [&]() { return parallel.CreateSphere(1.0f, n, n); });
+
+		run("cylinder, original", [&]() { return GeneratorReference::CreateCylinder(1.0f, 0.5f, 2.0f, n, n); });
+		run("cylinder, presized", [&]() { return serial.CreateCylinder(1.0f, 0.5f, 2.0f, n, n); });
+		run("cylinder, presized + pool", [&]() { return parallel.CreateCylinder(1.0f, 0.5f, 2.0f, n, n); });
+
+		std::printf("    checksum %zu\n", sink);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::uint32_t threads = argc > 1 ? (std::uint32_t)std::atoi(argv[1]) : std::thread::hardware_concurrency();
+	if(threads == 0)
+		threads = 1;
+
+	BenchSubdivide();
+	BenchGeneration(threads);
+	return 0;
+}
@@ -0,0 +1,182 @@
+//***************************************************************************************
+// GeometryGeneratorTest.cpp
+//
+// Subdivision: the edge-sharing Subdivide must produce the same triangles as the
+// original one (compared as position soups) while creating each edge midpoint once,
+// so geospheres and subdivided boxes have the closed-form vertex counts and every
+// interior edge is shared by exactly two triangles.
+//
+// Generation: presized, row-parallel grids, spheres and cylinders must be identical
+// with and without a JobSystem, and spheres and cylinders identical to the original
+// push_back versions.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "GeneratorReference.h"
+#include "SubdivideReference.h"
+#include "../Common/JobSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+using namespace DirectX;
+
+namespace
+{
+	bool SamePosition(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		return std::memcmp(&a, &b, sizeof(XMFLOAT3)) == 0;
+	}
+
+	template<typename TVertices, typename TIndices>
+	bool SameTriangles(const TVertices& vertices, const TIndices& indices,
+		const std::vector<GeometryGenerator::Vertex>& refVertices, const std::vector<std::uint32_t>& refIndices)
+	{
+		if(indices.size() != refIndices.size())
+			return false;
+
+		for(std::size_t i = 0; i < indices.size(); ++i)
+		{
+			if(!SamePosition(vertices[indices[i]].Position, refVertices[refIndices[i]].Position))
+				return false;
+		}
+		return true;
+	}
+
+	// Number of triangles using each undirected edge.
+	std::map<std::pair<std::uint32_t, std::uint32_t>, int> EdgeUse(const std::pmr::vector<std::uint32_t>& indices)
+	{
+		std::map<std::pair<std::uint32_t, std::uint32_t>, int> uses;
+		for(std::size_t t = 0; t < indices.size(); t += 3)
+		{
+			for(int e = 0; e < 3; ++e)
+			{
+				std::uint32_t a = indices[t + e];
+				std::uint32_t b = indices[t + (e + 1) % 3];
+				uses[std::make_pair(std::min(a, b), std::max(a, b))]++;
+			}
+		}
+		return uses;
+	}
+
+	void TestGeosphere()
+	{
+		GeometryGenerator generator;
+
+		// The same icosahedron CreateGeosphere starts from.
+		const float X = 0.525731f;
+		const float Z = 0.850651f;
+		const XMFLOAT3 pos[12] =
+		{
+			XMFLOAT3(-X, 0.0f, Z),  XMFLOAT3(X, 0.0f, Z),
+			XMFLOAT3(-X, 0.0f, -Z), XMFLOAT3(X, 0.0f, -Z),
+			XMFLOAT3(0.0f, Z, X),   XMFLOAT3(0.0f, Z, -X),
+			XMFLOAT3(0.0f, -Z, X),  XMFLOAT3(0.0f, -Z, -X),
+			XMFLOAT3(Z, X, 0.0f),   XMFLOAT3(-Z, X, 0.0f),
+			XMFLOAT3(Z, -X, 0.0f),  XMFLOAT3(-Z, -X, 0.0f)
+		};
+		const std::uint32_t k[60] =
+		{
+			1,4,0,  4,9,0,  4,5,9,  8,5,4,  1,8,4,
+			1,10,8, 10,3,8, 8,3,5,  3,2,5,  3,7,2,
+			3,10,7, 10,6,7, 6,11,7, 6,0,11, 6,1,0,
+			10,1,6, 11,0,9, 2,11,9, 5,2,9,  11,2,7
+		};
+
+		std::vector<GeometryGenerator::Vertex> refVertices(12);
+		for(int i = 0; i < 12; ++i)
+			refVertices[i] = GeometryGenerator::Vertex(pos[i], XMFLOAT3(0, 0, 0), XMFLOAT3(0, 0, 0), XMFLOAT2(0, 0));
+		std::vector<std::uint32_t> refIndices(k, k + 60);
+
+		for(std::uint32_t n = 0; n <= 6; ++n)
+		{
+			if(n > 0)
+				SubdivideReference::Subdivide(refVertices, refIndices);
+
+			// CreateGeosphere projects every vertex onto the sphere after subdividing.
+			std::vector<GeometryGenerator::Vertex> projected = refVertices;
+			for(GeometryGenerator::Vertex& v : projected)
+				XMStoreFloat3(&v.Position, 2.0f * XMVector3Normalize(XMLoadFloat3(&v.Position)));
+
+			GeometryGenerator::MeshData mesh = generator.CreateGeosphere(2.0f, n);
+
+			std::uint32_t scale = 1u << (2 * n);
+			CHECK(mesh.Vertices.size() == 10 * scale + 2);
+			CHECK(mesh.Indices32.size() == 3 * 20 * scale);
+			CHECK(SameTriangles(mesh.Vertices, mesh.Indices32, projected, refIndices));
+
+			// Closed: every edge has two triangles, and V - E + F = 2.
+			auto uses = EdgeUse(mesh.Indices32);
+			bool allShared = true;
+			for(const auto& use : uses)
+				allShared = allShared && use.second == 2;
+			CHECK(allShared);
+			CHECK((long)mesh.Vertices.size() - (long)uses.size() + (long)mesh.Indices32.size() / 3 == 2);
+		}
+	}
+
+	void TestBox()
+	{
+		GeometryGenerator generator;
+		GeometryGenerator::MeshData base = generator.CreateBox(1.0f, 2.0f, 3.0f, 0);
+
+		std::vector<GeometryGenerator::Vertex> refVertices(base.Vertices.begin(), base.Vertices.end());
+		std::vector<std::uint32_t> refIndices(base.Indices32.begin(), base.Indices32.end());
+
+		for(std::uint32_t n = 1; n <= 4; ++n)
+		{
+			SubdivideReference::Subdivide(refVertices, refIndices);
+			GeometryGenerator::MeshData mesh = generator.CreateBox(1.0f, 2.0f, 3.0f, n);
+
+			// The faces do not share vertices, so each becomes a (2^n+1)^2 grid.
+			std::uint32_t side = (1u << n) + 1;
+			CHECK(mesh.Vertices.size() == 6 * side * side);
+			CHECK(SameTriangles(mesh.Vertices, mesh.Indices32, refVertices, refIndices));
+
+			// Interior edges are shared; only the 4 * (side-1) edges around each face are not.
+			auto uses = EdgeUse(mesh.Indices32);
+			std::uint32_t border = 0;
+			for(const auto& use : uses)
+			{
+				CHECK(use.second == 1 || use.second == 2);
+				border += use.second == 1;
+			}
+			CHECK(border == 6 * 4 * (side - 1));
+		}
+	}
+	template<typename TMesh, typename TOther>
+	bool SameMesh(const TMesh& a, const TOther& b)
+	{
+		return a.Vertices.size() == b.Vertices.size() &&
+			std::equal(a.Indices32.begin(), a.Indices32.end(), b.Indices32.begin(), b.Indices32.end()) &&
+			std::memcmp(a.Vertices.data(), b.Vertices.data(), a.Vertices.size() * sizeof(GeometryGenerator::Vertex)) == 0;
+	}
+
+	void TestParallelGeneration()
+	{
+		JobSystem jobs(3);
+		GeometryGenerator serial;
+		GeometryGenerator parallel(&jobs);
+
+		// Sizes chosen so the rows do not split evenly into chunks.
+		CHECK(SameMesh(serial.CreateGrid(160.0f, 160.0f, 401, 299), parallel.CreateGrid(160.0f, 160.0f, 401, 299)));
+
+		GeometryGenerator::MeshData sphere = parallel.CreateSphere(0.5f, 501, 397);
+		CHECK(SameMesh(sphere, serial.CreateSphere(0.5f, 501, 397)));
+		CHECK(SameMesh(sphere, GeneratorReference::CreateSphere(0.5f, 501, 397)));
+
+		GeometryGenerator::MeshData cylinder = parallel.CreateCylinder(0.5f, 0.3f, 3.0f, 403, 299);
+		CHECK(SameMesh(cylinder, serial.CreateCylinder(0.5f, 0.3f, 3.0f, 403, 299)));
+		CHECK(SameMesh(cylinder, GeneratorReference::CreateCylinder(0.5f, 0.3f, 3.0f, 403, 299)));
+	}
+}
+
+int main()
+{
+	TestGeosphere();
+	TestBox();
+	TestParallelGeneration();
+
+	return TestResult("GeometryGeneratorTest");
+}
@@ -0,0 +1,299 @@
+//***************************************************************************************
+// GeometryPackerTest.cpp
+//
+// Packs a mesh with more than 65536 vertices between two small ones, builds it with
+// each index format through a MemoryGeometryUploader whose copies are carried out,
+// and draws every submesh back out of the buffers: the 16-bit build splits the large
+// mesh into "name#k" parts of at most 65536 vertices, duplicating the vertices on part
+// boundaries, and the parts' BaseVertexLocation draws give back the original triangles
+// in order.  Also checks which format DXGI_FORMAT_UNKNOWN picks on either side of its
+// cost rule, and that a 16-bit build with an index out of range throws.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/GeometryPacker.h"
+#include "../Common/MemoryCommandRecorder.h"
+#include "../Common/MemoryGeometryUploader.h"
+
+#include <cstring>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	struct TestVertex
+	{
+		XMFLOAT3 Pos;
+		XMFLOAT3 Normal;
+	};
+
+	struct TestMesh
+	{
+		std::vector<TestVertex> Vertices;
+		std::vector<std::uint32_t> Indices;
+	};
+
+	// Records like any MemoryCommandRecorder, and also carries out buffer copies at once:
+	// MemoryGeometryUploader's resources are the addresses of their memory.
+	class CopyingRecorder : public MemoryCommandRecorder
+	{
+	public:
+		void CopyBufferRegion(ID3D12Resource* dest, UINT64 destOffset, ID3D12Resource* src, UINT64 srcOffset, UINT64 byteSize)override
+		{
+			std::memcpy(reinterpret_cast<std::uint8_t*>(dest) + destOffset, reinterpret_cast<const std::uint8_t*>(src) + srcOffset, (size_t)byteSize);
+			MemoryCommandRecorder::CopyBufferRegion(dest, destOffset, src, srcOffset, byteSize);
+		}
+	};
+
+	// Every vertex has a distinct position, so triangles can be compared by position.
+	TestMesh MakeGrid(UINT columns, UINT rows, float y)
+	{
+		TestMesh mesh;
+		for(UINT r = 0; r < rows; ++r)
+			for(UINT c = 0; c < columns; ++c)
+				mesh.Vertices.push_back({ XMFLOAT3((float)c, y, (float)r), XMFLOAT3(0.0f, 1.0f, 0.0f) });
+
+		for(UINT r = 0; r + 1 < rows; ++r)
+		{
+			for(UINT c = 0; c + 1 < columns; ++c)
+			{
+				std::uint32_t i = r * columns + c;
+				mesh.Indices.insert(mesh.Indices.end(), { i, i + columns, i + 1, i + 1, i + columns, i + columns + 1 });
+			}
+		}
+		return mesh;
+	}
+
+	// Triangles over random vertices: splitting it duplicates most vertices.
+	TestMesh MakeScattered(UINT vertexCount, UINT triangleCount)
+	{
+		TestMesh mesh = MakeGrid(vertexCount, 1, 0.0f);
+		mesh.Indices.clear();
+
+		std::mt19937 rng(5);
+		std::uniform_int_distribution<std::uint32_t> dist(0, vertexCount - 1);
+		for(UINT i = 0; i < 3 * triangleCount; ++i)
+			mesh.Indices.push_back(dist(rng));
+		return mesh;
+	}
+
+	void Add(GeometryPacker<TestVertex>& packer, const std::string& name, const TestMesh& mesh)
+	{
+		packer.AddMesh(name, mesh.Vertices.data(), (UINT)mesh.Vertices.size(), mesh.Indices.data(), (UINT)mesh.Indices.size());
+	}
+
+	struct Built
+	{
+		std::unique_ptr<PackedGeometry> Geo;
+		std::vector<TestVertex> Vertices;
+		std::vector<std::uint32_t> Indices;
+	};
+
+	// Builds with indexFormat and reads the buffers back after the copies.
+	Built Build(GeometryPacker<TestVertex>& packer, DXGI_FORMAT indexFormat)
+	{
+		MemoryGeometryUploader uploader(packer.StagingByteSize(indexFormat));
+		CopyingRecorder recorder;
+
+		Built built;
+		built.Geo = packer.Build(uploader, "Test", indexFormat);
+		uploader.Flush(recorder);
+		CHECK(recorder.Stats().Copies == 2);
+
+		const PackedGeometry& geo = *built.Geo;
+		CHECK(geo.VertexByteStride == sizeof(TestVertex));
+		built.Vertices.resize(geo.VertexBufferByteSize / sizeof(TestVertex));
+		std::memcpy(built.Vertices.data(), geo.VertexBuffer.Resource, geo.VertexBufferByteSize);
+
+		if(geo.IndexFormat == DXGI_FORMAT_R16_UINT)
+		{
+			const std::uint16_t* indices16 = reinterpret_cast<const std::uint16_t*>(geo.IndexBuffer.Resource);
+			built.Indices.assign(indices16, indices16 + geo.IndexBufferByteSize / sizeof(std::uint16_t));
+		}
+		else
+		{
+			const std::uint32_t* indices32 = reinterpret_cast<const std::uint32_t*>(geo.IndexBuffer.Resource);
+			built.Indices.assign(indices32, indices32 + geo.IndexBufferByteSize / sizeof(std::uint32_t));
+		}
+		return built;
+	}
+
+	bool SamePosition(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+
+	// Draws the parts of name in order, as DrawIndexedInstanced would, and checks they
+	// give back mesh's triangles.  Returns the number of parts.
+	UINT CheckDraws(const Built& built, const std::string& name, const TestMesh& mesh)
+	{
+		size_t sourceIndex = 0;
+		UINT parts = 0;
+		for(;; ++parts)
+		{
+			auto it = built.Geo->DrawArgs.find(GeometryPacker<TestVertex>::PartName(name, parts));
+			if(it == built.Geo->DrawArgs.end())
+				break;
+
+			const SubmeshGeometry& draw = it->second;
+			CHECK(draw.BaseVertexLocation >= 0);
+			CHECK(draw.StartIndexLocation + draw.IndexCount <= built.Indices.size());
+
+			for(UINT i = 0; i < draw.IndexCount && sourceIndex < mesh.Indices.size(); ++i, ++sourceIndex)
+			{
+				std::uint32_t index = built.Indices[draw.StartIndexLocation + i];
+				if(built.Geo->IndexFormat == DXGI_FORMAT_R16_UINT)
+					CHECK(index <= 0xffff);
+
+				size_t vertex = (size_t)draw.BaseVertexLocation + index;
+				CHECK(vertex < built.Vertices.size());
+				if(vertex < built.Vertices.size())
+					CHECK(SamePosition(built.Vertices[vertex].Pos, mesh.Vertices[mesh.Indices[sourceIndex]].Pos));
+			}
+		}
+
+		// Every triangle was drawn exactly once.
+		CHECK(sourceIndex == mesh.Indices.size());
+		return parts;
+	}
+
+	void TestSplit()
+	{
+		const TestMesh small = MakeGrid(4, 3, -1.0f);
+		const TestMesh big = MakeGrid(300, 300, 0.0f);
+		const TestMesh tail = MakeGrid(5, 5, 1.0f);
+		CHECK(big.Vertices.size() > GeometryPacker<TestVertex>::MaxVerticesPerPart16);
+
+		GeometryPacker<TestVertex> packer;
+		Add(packer, "Small", small);
+		Add(packer, "Big", big);
+		Add(packer, "Tail", tail);
+
+		// 32-bit: stored as added, one draw per mesh.
+		Built built32 = Build(packer, DXGI_FORMAT_R32_UINT);
+		CHECK(built32.Geo->IndexFormat == DXGI_FORMAT_R32_UINT);
+		CHECK(built32.Geo->DrawArgs.size() == 3);
+		CHECK(built32.Vertices.size() == small.Vertices.size() + big.Vertices.size() + tail.Vertices.size());
+		CHECK(CheckDraws(built32, "Small", small) == 1);
+		CHECK(CheckDraws(built32, "Big", big) == 1);
+		CHECK(CheckDraws(built32, "Tail", tail) == 1);
+
+		// 16-bit: the big mesh is split into two parts, the small ones are left alone.
+		Built built16 = Build(packer, DXGI_FORMAT_R16_UINT);
+		CHECK(built16.Geo->IndexFormat == DXGI_FORMAT_R16_UINT);
+		CHECK(CheckDraws(built16, "Small", small) == 1);
+		CHECK(CheckDraws(built16, "Big", big) == 2);
+		CHECK(CheckDraws(built16, "Tail", tail) == 1);
+		CHECK(built16.Geo->DrawArgs.size() == 4);
+		CHECK(built16.Geo->DrawArgs.count("Big#1") == 1);
+		CHECK(built16.Geo->DrawArgs.count("Big#2") == 0);
+
+		// Each part addresses at most 65536 vertices, and the part boundary's vertices
+		// appear in both parts.
+		const SubmeshGeometry& part0 = built16.Geo->DrawArgs["Big"];
+		const SubmeshGeometry& part1 = built16.Geo->DrawArgs["Big#1"];
+		const SubmeshGeometry& tailDraw = built16.Geo->DrawArgs["Tail"];
+		const size_t part0Vertices = part1.BaseVertexLocation - part0.BaseVertexLocation;
+		const size_t part1Vertices = tailDraw.BaseVertexLocation - part1.BaseVertexLocation;
+		CHECK(part0Vertices <= GeometryPacker<TestVertex>::MaxVerticesPerPart16);
+		CHECK(part1Vertices <= GeometryPacker<TestVertex>::MaxVerticesPerPart16);
+		CHECK(part0.IndexCount + part1.IndexCount == big.Indices.size());
+
+		std::set<std::pair<float, float>> inPart0;
+		for(size_t v = 0; v < part0Vertices; ++v)
+			inPart0.insert({ built16.Vertices[part0.BaseVertexLocation + v].Pos.x, built16.Vertices[part0.BaseVertexLocation + v].Pos.z });
+		size_t shared = 0;
+		for(size_t v = 0; v < part1Vertices; ++v)
+			shared += inPart0.count({ built16.Vertices[part1.BaseVertexLocation + v].Pos.x, built16.Vertices[part1.BaseVertexLocation + v].Pos.z });
+		CHECK(shared > 0);
+		CHECK(part0Vertices + part1Vertices == big.Vertices.size() + shared);
+		CHECK(built16.Vertices.size() == built32.Vertices.size() + shared);
+
+		// Each part's bounds cover only its own vertices.
+		CHECK(part0.Bounds.Center.z + part0.Bounds.Extents.z < part1.Bounds.Center.z + part1.Bounds.Extents.z);
+
+		// Unknown: the duplicated vertices cost far less than the 16-bit indices save.
+		const UINT64 added = (UINT64)(built16.Vertices.size() - built32.Vertices.size()) * sizeof(TestVertex);
+		const UINT64 saved = (UINT64)built32.Indices.size() * (sizeof(std::uint32_t) - sizeof(std::uint16_t));
+		CHECK(added < saved);
+		Built chosen = Build(packer, DXGI_FORMAT_UNKNOWN);
+		CHECK(chosen.Geo->IndexFormat == DXGI_FORMAT_R16_UINT);
+		CHECK(CheckDraws(chosen, "Big", big) == 2);
+	}
+
+	void TestCostChoice()
+	{
+		// Scattered triangles: each part needs most of the vertices again, so 32-bit
+		// indices are cheaper and Unknown keeps the mesh whole.
+		const TestMesh scattered = MakeScattered(100000, 60000);
+
+		GeometryPacker<TestVertex> packer;
+		Add(packer, "Scattered", scattered);
+
+		Built built16 = Build(packer, DXGI_FORMAT_R16_UINT);
+		Built built32 = Build(packer, DXGI_FORMAT_R32_UINT);
+		CHECK(CheckDraws(built16, "Scattered", scattered) > 1);
+		CHECK(CheckDraws(built32, "Scattered", scattered) == 1);
+
+		const UINT64 added = (UINT64)(built16.Vertices.size() - built32.Vertices.size()) * sizeof(TestVertex);
+		const UINT64 saved = (UINT64)built32.Indices.size() * (sizeof(std::uint32_t) - sizeof(std::uint16_t));
+		CHECK(added >= saved);
+
+		Built chosen = Build(packer, DXGI_FORMAT_UNKNOWN);
+		CHECK(chosen.Geo->IndexFormat == DXGI_FORMAT_R32_UINT);
+		CHECK(CheckDraws(chosen, "Scattered", scattered) == 1);
+
+		// Vertices no triangle uses are dropped by the split, so it can come out smaller
+		// than the arena; that is no cost at all.
+		TestMesh padded = MakeGrid(300, 300, 0.0f);
+		const TestMesh unused = MakeGrid(100, 100, 5.0f);
+		padded.Vertices.insert(padded.Vertices.end(), unused.Vertices.begin(), unused.Vertices.end());
+
+		GeometryPacker<TestVertex> paddedPacker;
+		Add(paddedPacker, "Padded", padded);
+		Built paddedChosen = Build(paddedPacker, DXGI_FORMAT_UNKNOWN);
+		CHECK(paddedChosen.Geo->IndexFormat == DXGI_FORMAT_R16_UINT);
+		CHECK(paddedChosen.Vertices.size() < padded.Vertices.size());
+		CHECK(CheckDraws(paddedChosen, "Padded", padded) == 2);
+
+		// With nothing to split Unknown is always 16-bit.
+		GeometryPacker<TestVertex> smallPacker;
+		Add(smallPacker, "Small", MakeGrid(10, 10, 0.0f));
+		CHECK(Build(smallPacker, DXGI_FORMAT_UNKNOWN).Geo->IndexFormat == DXGI_FORMAT_R16_UINT);
+	}
+
+	void TestOutOfRange()
+	{
+		// A mesh that indexes past its own vertices cannot be split; forcing 16-bit
+		// indices reports it rather than truncating.
+		TestMesh bad = MakeGrid(4, 4, 0.0f);
+		bad.Indices[5] = 70000;
+
+		GeometryPacker<TestVertex> packer;
+		Add(packer, "Bad", bad);
+
+		MemoryGeometryUploader uploader(packer.StagingByteSize(DXGI_FORMAT_R16_UINT));
+		bool threw = false;
+		try
+		{
+			packer.Build(uploader, "Bad", DXGI_FORMAT_R16_UINT);
+		}
+		catch(const std::logic_error&)
+		{
+			threw = true;
+		}
+		CHECK(threw);
+	}
+}
+
+int main()
+{
+	TestSplit();
+	TestCostChoice();
+	TestOutOfRange();
+
+	return TestResult("GeometryPackerTest");
+}
@@ -0,0 +1,180 @@
+//***************************************************************************************
+// DirectXCollision.h (headless stand-in)
+//
+// BoundingBox and BoundingSphere with the members the device-free Common modules use.
+// See DirectXMath.h in this directory.  CreateFromPoints for spheres uses Ritter's
+// method like the real header, so radii are close but not bit-identical to it.
+//***************************************************************************************
+
+#pragma once
+
+#include "DirectXMath.h"
+#include <algorithm>
+#include <cfloat>
+
+namespace DirectX
+{
+	struct BoundingBox
+	{
+		XMFLOAT3 Center = { 0.0f, 0.0f, 0.0f };
+		XMFLOAT3 Extents = { 1.0f, 1.0f, 1.0f };
+
+		BoundingBox() = default;
+		constexpr BoundingBox(const XMFLOAT3& center, const XMFLOAT3& extents) :
+			Center(center), Extents(extents)
+		{
+		}
+
+		void Transform(BoundingBox& out, FXMMATRIX m)const
+		{
+			// Center moves with the matrix; extents are the absolute 3x3 applied to them.
+			XMVECTOR c = XMVector3Transform(XMLoadFloat3(&Center), m);
+			XMVECTOR e = XMVectorZero();
+			for(int i = 0; i < 3; ++i)
+			{
+				XMVECTOR row = m.r[i];
+				XMVECTOR absRow = XMVECTOR{ std::fabs(row[0]), std::fabs(row[1]), std::fabs(row[2]), 0.0f };
+				e += (&Extents.x)[i] * absRow;
+			}
+
+			XMStoreFloat3(&out.Center, c);
+			XMStoreFloat3(&out.Extents, e);
+		}
+
+		static void CreateFromPoints(BoundingBox& out, FXMVECTOR pt1, FXMVECTOR pt2)
+		{
+			XMVECTOR lo = XMVECTOR{ std::min(pt1[0], pt2[0]), std::min(pt1[1], pt2[1]), std::min(pt1[2], pt2[2]), 0.0f };
+			XMVECTOR hi = XMVECTOR{ std::max(pt1[0], pt2[0]), std::max(pt1[1], pt2[1]), std::max(pt1[2], pt2[2]), 0.0f };
+			XMStoreFloat3(&out.Center, (lo + hi) * 0.5f);
+			XMStoreFloat3(&out.Extents, (hi - lo) * 0.5f);
+		}
+
+		static void CreateFromPoints(BoundingBox& out, std::size_t count, const XMFLOAT3* points, std::size_t stride)
+		{
+			XMFLOAT3 lo(FLT_MAX, FLT_MAX, FLT_MAX);
+			XMFLOAT3 hi(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				const XMFLOAT3& p = *reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const std::uint8_t*>(points) + i * stride);
+				lo = XMFLOAT3(std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z));
+				hi = XMFLOAT3(std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z));
+			}
+			CreateFromPoints(out, XMLoadFloat3(&lo), XMLoadFloat3(&hi));
+		}
+
+		static void CreateMerged(BoundingBox& out, const BoundingBox& a, const BoundingBox& b)
+		{
+			XMVECTOR ca = XMLoadFloat3(&a.Center), ea = XMLoadFloat3(&a.Extents);
+			XMVECTOR cb = XMLoadFloat3(&b.Center), eb = XMLoadFloat3(&b.Extents);
+			XMVECTOR loA = ca - ea, hiA = ca + ea, loB = cb - eb, hiB = cb + eb;
+			CreateFromPoints(out,
+				XMVECTOR{ std::min(loA[0], loB[0]), std::min(loA[1], loB[1]), std::min(loA[2], loB[2]), 0.0f },
+				XMVECTOR{ std::max(hiA[0], hiB[0]), std::max(hiA[1], hiB[1]), std::max(hiA[2], hiB[2]), 0.0f });
+		}
+	};
+
+	struct BoundingSphere
+	{
+		XMFLOAT3 Center = { 0.0f, 0.0f, 0.0f };
+		float Radius = 1.0f;
+
+		BoundingSphere() = default;
+		constexpr BoundingSphere(const XMFLOAT3& center, float radius) :
+			Center(center), Radius(radius)
+		{
+		}
+
+		void Transform(BoundingSphere& out, FXMMATRIX m)const
+		{
+			// The radius scales by the longest basis vector.
+			float scale = 0.0f;
+			for(int i = 0; i < 3; ++i)
+				scale = std::max(scale, XMVectorGetX(XMVector3Length(m.r[i])));
+
+			XMStoreFloat3(&out.Center, XMVector3Transform(XMLoadFloat3(&Center), m));
+			out.Radius = Radius * scale;
+		}
+
+		static void CreateFromBoundingBox(BoundingSphere& out, const BoundingBox& box)
+		{
+			out.Center = box.Center;
+			out.Radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&box.Extents)));
+		}
+
+		static void CreateFromPoints(BoundingSphere& out, std::size_t count, const XMFLOAT3* points, std::size_t stride)
+		{
+			auto point = [&](std::size_t i)
+			{
+				return XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const std::uint8_t*>(points) + i * stride));
+			};
+
+			// Start from the most separated pair of axis extremes, then grow to cover
+			// every point.
+			std::size_t minIndex[3] = { 0, 0, 0 };
+			std::size_t maxIndex[3] = { 0, 0, 0 };
+			for(std::size_t i = 1; i < count; ++i)
+			{
+				XMVECTOR p = point(i);
+				for(int a = 0; a < 3; ++a)
+				{
+					if(p[a] < point(minIndex[a])[a]) minIndex[a] = i;
+					if(p[a] > point(maxIndex[a])[a]) maxIndex[a] = i;
+				}
+			}
+
+			XMVECTOR lo = point(minIndex[0]);
+			XMVECTOR hi = point(maxIndex[0]);
+			float best = XMVectorGetX(XMVector3Length(hi - lo));
+			for(int a = 1; a < 3; ++a)
+			{
+				float d = XMVectorGetX(XMVector3Length(point(maxIndex[a]) - point(minIndex[a])));
+				if(d > best)
+				{
+					best = d;
+					lo = point(minIndex[a]);
+					hi = point(maxIndex[a]);
+				}
+			}
+
+			XMVECTOR center = (lo + hi) * 0.5f;
+			float radius = best * 0.5f;
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				XMVECTOR delta = point(i) - center;
+				float d = XMVectorGetX(XMVector3Length(delta));
+				if(d > radius)
+				{
+					float newRadius = (radius + d) * 0.5f;
+					center += delta * ((newRadius - radius) / d);
+					radius = newRadius;
+				}
+			}
+
+			XMStoreFloat3(&out.Center, center);
+			out.Radius = radius;
+		}
+
+		static void CreateMerged(BoundingSphere& out, const BoundingSphere& a, const BoundingSphere& b)
+		{
+			XMVECTOR centerA = XMLoadFloat3(&a.Center);
+			XMVECTOR delta = XMLoadFloat3(&b.Center) - centerA;
+			float d = XMVectorGetX(XMVector3Length(delta));
+
+			// One sphere already contains the other.
+			if(a.Radius >= d + b.Radius)
+			{
+				out = a;
+				return;
+			}
+			if(b.Radius >= d + a.Radius)
+			{
+				out = b;
+				return;
+			}
+
+			float radius = (a.Radius + b.Radius + d) * 0.5f;
+			XMStoreFloat3(&out.Center, centerA + delta * ((radius - a.Radius) / d));
+			out.Radius = radius;
+		}
+	};
+}
@@ -0,0 +1,28 @@
+//***************************************************************************************
+// DirectXColors.h (headless stand-in)
+//
+// The named colors the sample's scene uses, with the real header's values.
+//***************************************************************************************
+
+#pragma once
+
+#include "DirectXMath.h"
+
+namespace DirectX
+{
+	struct XMVECTORF32
+	{
+		float f[4];
+
+		operator XMVECTOR()const { return XMVECTOR{ f[0], f[1], f[2], f[3] }; }
+		operator const float*()const { return f; }
+	};
+
+	namespace Colors
+	{
+		constexpr XMVECTORF32 ForestGreen = { { 0.133333340f, 0.545098066f, 0.133333340f, 1.000000000f } };
+		constexpr XMVECTORF32 LightGray = { { 0.827451050f, 0.827451050f, 0.827451050f, 1.000000000f } };
+		constexpr XMVECTORF32 LightSteelBlue = { { 0.690196097f, 0.768627524f, 0.870588303f, 1.000000000f } };
+		constexpr XMVECTORF32 White = { { 1.000000000f, 1.000000000f, 1.000000000f, 1.000000000f } };
+	}
+}
@@ -0,0 +1,305 @@
+//***************************************************************************************
+// DirectXMath.h (headless stand-in)
+//
+// Scalar stand-in for the subset of DirectXMath used by the device-free Common
+// modules and the CPU tests, so they build where the Windows SDK is not available.
+// Only used when building Tests off Windows; on Windows the real header is found
+// first.  Types match the real layouts; functions follow the documented semantics
+// but are not tuned, so benchmarks should be read relative to each other.
+//***************************************************************************************
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#define XM_CALLCONV
+
+namespace DirectX
+{
+	constexpr float XM_PI = 3.141592654f;
+	constexpr float XM_2PI = 6.283185307f;
+	constexpr float XM_1DIVPI = 0.318309886f;
+	constexpr float XM_PIDIV2 = 1.570796327f;
+	constexpr float XM_PIDIV4 = 0.785398163f;
+
+	inline constexpr float XMConvertToRadians(float degrees) { return degrees * (XM_PI / 180.0f); }
+
+	// GCC/Clang vector extension: +, -, * and scalar broadcast work like the
+	// DirectXMath operator overloads.
+	typedef float XMVECTOR __attribute__((vector_size(16)));
+	typedef const XMVECTOR FXMVECTOR;
+	typedef const XMVECTOR GXMVECTOR;
+	typedef const XMVECTOR HXMVECTOR;
+	typedef const XMVECTOR& CXMVECTOR;
+
+	struct XMMATRIX
+	{
+		XMVECTOR r[4];
+	};
+
+	typedef const XMMATRIX FXMMATRIX;
+	typedef const XMMATRIX& CXMMATRIX;
+
+	struct XMFLOAT2
+	{
+		float x, y;
+
+		XMFLOAT2() = default;
+		constexpr XMFLOAT2(float _x, float _y) : x(_x), y(_y) {}
+	};
+
+	struct XMFLOAT3
+	{
+		float x, y, z;
+
+		XMFLOAT3() = default;
+		constexpr XMFLOAT3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+	};
+
+	struct XMFLOAT4
+	{
+		float x, y, z, w;
+
+		XMFLOAT4() = default;
+		constexpr XMFLOAT4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+		explicit XMFLOAT4(const float* p) : x(p[0]), y(p[1]), z(p[2]), w(p[3]) {}
+	};
+
+	struct XMFLOAT4X4
+	{
+		union
+		{
+			struct
+			{
+				float _11, _12, _13, _14;
+				float _21, _22, _23, _24;
+				float _31, _32, _33, _34;
+				float _41, _42, _43, _44;
+			};
+			float m[4][4];
+		};
+
+		XMFLOAT4X4() = default;
+		constexpr XMFLOAT4X4(float m00, float m01, float m02, float m03,
+			float m10, float m11, float m12, float m13,
+			float m20, float m21, float m22, float m23,
+			float m30, float m31, float m32, float m33) :
+			_11(m00), _12(m01), _13(m02), _14(m03),
+			_21(m10), _22(m11), _23(m12), _24(m13),
+			_31(m20), _32(m21), _33(m22), _34(m23),
+			_41(m30), _42(m31), _43(m32), _44(m33)
+		{
+		}
+
+		float operator()(std::size_t row, std::size_t column)const { return m[row][column]; }
+		float& operator()(std::size_t row, std::size_t column) { return m[row][column]; }
+	};
+
+	inline XMVECTOR XMVectorSet(float x, float y, float z, float w) { return XMVECTOR{ x, y, z, w }; }
+	inline XMVECTOR XMVectorReplicate(float value) { return XMVECTOR{ value, value, value, value }; }
+	inline XMVECTOR XMVectorZero() { return XMVECTOR{ 0.0f, 0.0f, 0.0f, 0.0f }; }
+
+	inline float XMVectorGetX(FXMVECTOR v) { return v[0]; }
+	inline float XMVectorGetY(FXMVECTOR v) { return v[1]; }
+	inline float XMVectorGetZ(FXMVECTOR v) { return v[2]; }
+	inline float XMVectorGetW(FXMVECTOR v) { return v[3]; }
+
+	inline XMVECTOR XMLoadFloat2(const XMFLOAT2* p) { return XMVECTOR{ p->x, p->y, 0.0f, 0.0f }; }
+	inline XMVECTOR XMLoadFloat3(const XMFLOAT3* p) { return XMVECTOR{ p->x, p->y, p->z, 0.0f }; }
+	inline XMVECTOR XMLoadFloat4(const XMFLOAT4* p) { return XMVECTOR{ p->x, p->y, p->z, p->w }; }
+
+	inline void XMStoreFloat2(XMFLOAT2* p, FXMVECTOR v) { p->x = v[0]; p->y = v[1]; }
+	inline void XMStoreFloat3(XMFLOAT3* p, FXMVECTOR v) { p->x = v[0]; p->y = v[1]; p->z = v[2]; }
+	inline void XMStoreFloat4(XMFLOAT4* p, FXMVECTOR v) { p->x = v[0]; p->y = v[1]; p->z = v[2]; p->w = v[3]; }
+
+	inline XMMATRIX XMLoadFloat4x4(const XMFLOAT4X4* p)
+	{
+		XMMATRIX m;
+		for(int i = 0; i < 4; ++i)
+			m.r[i] = XMVECTOR{ p->m[i][0], p->m[i][1], p->m[i][2], p->m[i][3] };
+		return m;
+	}
+
+	inline void XMStoreFloat4x4(XMFLOAT4X4* p, FXMMATRIX m)
+	{
+		for(int i = 0; i < 4; ++i)
+			for(int j = 0; j < 4; ++j)
+				p->m[i][j] = m.r[i][j];
+	}
+
+	inline XMVECTOR XMVectorAdd(FXMVECTOR a, FXMVECTOR b) { return a + b; }
+	inline XMVECTOR XMVectorSubtract(FXMVECTOR a, FXMVECTOR b) { return a - b; }
+	inline XMVECTOR XMVectorMultiply(FXMVECTOR a, FXMVECTOR b) { return a * b; }
+	inline XMVECTOR XMVectorScale(FXMVECTOR v, float s) { return v * s; }
+
+	inline XMVECTOR XMVector3Dot(FXMVECTOR a, FXMVECTOR b)
+	{
+		return XMVectorReplicate(a[0] * b[0] + a[1] * b[1] + a[2] * b[2]);
+	}
+
+	inline XMVECTOR XMVector3Length(FXMVECTOR v)
+	{
+		return XMVectorReplicate(std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]));
+	}
+
+	inline XMVECTOR XMVector3Normalize(FXMVECTOR v)
+	{
+		float length = XMVectorGetX(XMVector3Length(v));
+		return length > 0.0f ? v / length : XMVectorZero();
+	}
+
+	inline XMVECTOR XMVector3Cross(FXMVECTOR a, FXMVECTOR b)
+	{
+		return XMVECTOR{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0], 0.0f };
+	}
+
+	inline XMVECTOR XMPlaneNormalize(FXMVECTOR p)
+	{
+		float length = XMVectorGetX(XMVector3Length(p));
+		return length > 0.0f ? p / length : XMVectorZero();
+	}
+
+	inline XMVECTOR XMVector4Transform(FXMVECTOR v, FXMMATRIX m)
+	{
+		return v[0] * m.r[0] + v[1] * m.r[1] + v[2] * m.r[2] + v[3] * m.r[3];
+	}
+
+	inline XMVECTOR XMVector3Transform(FXMVECTOR v, FXMMATRIX m)
+	{
+		return v[0] * m.r[0] + v[1] * m.r[1] + v[2] * m.r[2] + m.r[3];
+	}
+
+	inline XMVECTOR XMVector3TransformCoord(FXMVECTOR v, FXMMATRIX m)
+	{
+		XMVECTOR r = XMVector3Transform(v, m);
+		return r / r[3];
+	}
+
+	inline XMVECTOR XMVector3TransformNormal(FXMVECTOR v, FXMMATRIX m)
+	{
+		return v[0] * m.r[0] + v[1] * m.r[1] + v[2] * m.r[2];
+	}
+
+	inline XMMATRIX XMMatrixIdentity()
+	{
+		return { { XMVECTOR{ 1, 0, 0, 0 }, XMVECTOR{ 0, 1, 0, 0 }, XMVECTOR{ 0, 0, 1, 0 }, XMVECTOR{ 0, 0, 0, 1 } } };
+	}
+
+	inline XMMATRIX XMMatrixTranslation(float x, float y, float z)
+	{
+		return { { XMVECTOR{ 1, 0, 0, 0 }, XMVECTOR{ 0, 1, 0, 0 }, XMVECTOR{ 0, 0, 1, 0 }, XMVECTOR{ x, y, z, 1 } } };
+	}
+
+	inline XMMATRIX XMMatrixScaling(float x, float y, float z)
+	{
+		return { { XMVECTOR{ x, 0, 0, 0 }, XMVECTOR{ 0, y, 0, 0 }, XMVECTOR{ 0, 0, z, 0 }, XMVECTOR{ 0, 0, 0, 1 } } };
+	}
+
+	inline XMMATRIX XMMatrixRotationY(float angle)
+	{
+		float s = std::sin(angle);
+		float c = std::cos(angle);
+		return { { XMVECTOR{ c, 0, -s, 0 }, XMVECTOR{ 0, 1, 0, 0 }, XMVECTOR{ s, 0, c, 0 }, XMVECTOR{ 0, 0, 0, 1 } } };
+	}
+
+	inline XMMATRIX XMMatrixLookAtLH(FXMVECTOR eye, FXMVECTOR focus, FXMVECTOR up)
+	{
+		XMVECTOR r2 = XMVector3Normalize(focus - eye);
+		XMVECTOR r0 = XMVector3Normalize(XMVector3Cross(up, r2));
+		XMVECTOR r1 = XMVector3Cross(r2, r0);
+		XMVECTOR negEye = -eye;
+
+		float d0 = XMVectorGetX(XMVector3Dot(r0, negEye));
+		float d1 = XMVectorGetX(XMVector3Dot(r1, negEye));
+		float d2 = XMVectorGetX(XMVector3Dot(r2, negEye));
+
+		return { {
+			XMVECTOR{ r0[0], r1[0], r2[0], 0.0f },
+			XMVECTOR{ r0[1], r1[1], r2[1], 0.0f },
+			XMVECTOR{ r0[2], r1[2], r2[2], 0.0f },
+			XMVECTOR{ d0, d1, d2, 1.0f } } };
+	}
+
+	inline XMMATRIX XMMatrixPerspectiveFovLH(float fovAngleY, float aspectRatio, float nearZ, float farZ)
+	{
+		float height = std::cos(0.5f * fovAngleY) / std::sin(0.5f * fovAngleY);
+		float width = height / aspectRatio;
+		float range = farZ / (farZ - nearZ);
+
+		return { {
+			XMVECTOR{ width, 0.0f, 0.0f, 0.0f },
+			XMVECTOR{ 0.0f, height, 0.0f, 0.0f },
+			XMVECTOR{ 0.0f, 0.0f, range, 1.0f },
+			XMVECTOR{ 0.0f, 0.0f, -range * nearZ, 0.0f } } };
+	}
+
+	inline XMMATRIX XMMatrixMultiply(FXMMATRIX a, CXMMATRIX b)
+	{
+		XMMATRIX m;
+		for(int i = 0; i < 4; ++i)
+			m.r[i] = XMVector4Transform(a.r[i], b);
+		return m;
+	}
+
+	inline XMMATRIX operator*(FXMMATRIX a, CXMMATRIX b) { return XMMatrixMultiply(a, b); }
+
+	inline XMMATRIX XMMatrixTranspose(FXMMATRIX m)
+	{
+		XMMATRIX t;
+		for(int i = 0; i < 4; ++i)
+			t.r[i] = XMVECTOR{ m.r[0][i], m.r[1][i], m.r[2][i], m.r[3][i] };
+		return t;
+	}
+
+	// Cofactor expansion; the determinant is replicated into every lane as in DirectXMath.
+	inline void XMMatrixCofactors(FXMMATRIX m, float c[4][4])
+	{
+		for(int i = 0; i < 4; ++i)
+		{
+			for(int j = 0; j < 4; ++j)
+			{
+				float minor[3][3];
+				for(int r = 0, mr = 0; r < 4; ++r)
+				{
+					if(r == i)
+						continue;
+					for(int k = 0, mk = 0; k < 4; ++k)
+					{
+						if(k != j)
+							minor[mr][mk++] = m.r[r][k];
+					}
+					++mr;
+				}
+
+				float det3 = minor[0][0] * (minor[1][1] * minor[2][2] - minor[1][2] * minor[2][1]) -
+					minor[0][1] * (minor[1][0] * minor[2][2] - minor[1][2] * minor[2][0]) +
+					minor[0][2] * (minor[1][0] * minor[2][1] - minor[1][1] * minor[2][0]);
+				c[i][j] = ((i + j) & 1) ? -det3 : det3;
+			}
+		}
+	}
+
+	inline XMVECTOR XMMatrixDeterminant(FXMMATRIX m)
+	{
+		float c[4][4];
+		XMMatrixCofactors(m, c);
+		return XMVectorReplicate(m.r[0][0] * c[0][0] + m.r[0][1] * c[0][1] + m.r[0][2] * c[0][2] + m.r[0][3] * c[0][3]);
+	}
+
+	inline XMMATRIX XMMatrixInverse(XMVECTOR* determinant, FXMMATRIX m)
+	{
+		float c[4][4];
+		XMMatrixCofactors(m, c);
+		float det = m.r[0][0] * c[0][0] + m.r[0][1] * c[0][1] + m.r[0][2] * c[0][2] + m.r[0][3] * c[0][3];
+		if(determinant)
+			*determinant = XMVectorReplicate(det);
+
+		// Inverse is the adjugate (transposed cofactors) over the determinant.
+		XMMATRIX inverse;
+		for(int i = 0; i < 4; ++i)
+			inverse.r[i] = XMVECTOR{ c[0][i], c[1][i], c[2][i], c[3][i] } / det;
+		return inverse;
+	}
+}
@@ -0,0 +1,10 @@
+//***************************************************************************************
+// Windows.h (headless stand-in)
+//
+// MathHelper.h includes <Windows.h> but only needs rand() from it.  Only used when
+// building Tests off Windows.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdlib>
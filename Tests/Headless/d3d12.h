@@ -0,0 +1,156 @@
+//***************************************************************************************
+// d3d12.h (headless stand-in)
+//
+// The plain-data D3D12 types that CommandRecorder and the device-free recorders use,
+// with the same names, members and enumerator values as the Windows SDK.  Interfaces
+// are declared but not defined: off Windows they are only ever opaque pointers.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+typedef int BOOL;
+typedef int INT;
+typedef unsigned int UINT;
+typedef std::uint8_t UINT8;
+typedef std::uint16_t UINT16;
+typedef std::uint64_t UINT64;
+typedef std::int32_t LONG;
+typedef float FLOAT;
+typedef std::size_t SIZE_T;
+
+struct ID3D12PipelineState;
+struct ID3D12RootSignature;
+struct ID3D12Resource;
+
+enum DXGI_FORMAT
+{
+	DXGI_FORMAT_UNKNOWN = 0,
+	DXGI_FORMAT_R32G32B32_FLOAT = 6,
+	DXGI_FORMAT_R32_UINT = 42,
+	DXGI_FORMAT_R16_UINT = 57,
+};
+
+enum D3D_PRIMITIVE_TOPOLOGY
+{
+	D3D_PRIMITIVE_TOPOLOGY_UNDEFINED = 0,
+	D3D_PRIMITIVE_TOPOLOGY_POINTLIST = 1,
+	D3D_PRIMITIVE_TOPOLOGY_LINELIST = 2,
+	D3D_PRIMITIVE_TOPOLOGY_LINESTRIP = 3,
+	D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST = 4,
+	D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP = 5,
+};
+typedef D3D_PRIMITIVE_TOPOLOGY D3D12_PRIMITIVE_TOPOLOGY;
+
+typedef UINT64 D3D12_GPU_VIRTUAL_ADDRESS;
+
+struct D3D12_CPU_DESCRIPTOR_HANDLE
+{
+	SIZE_T ptr;
+};
+
+struct D3D12_VERTEX_BUFFER_VIEW
+{
+	D3D12_GPU_VIRTUAL_ADDRESS BufferLocation;
+	UINT SizeInBytes;
+	UINT StrideInBytes;
+};
+
+struct D3D12_INDEX_BUFFER_VIEW
+{
+	D3D12_GPU_VIRTUAL_ADDRESS BufferLocation;
+	UINT SizeInBytes;
+	DXGI_FORMAT Format;
+};
+
+struct D3D12_VIEWPORT
+{
+	FLOAT TopLeftX;
+	FLOAT TopLeftY;
+	FLOAT Width;
+	FLOAT Height;
+	FLOAT MinDepth;
+	FLOAT MaxDepth;
+};
+
+struct RECT
+{
+	LONG left;
+	LONG top;
+	LONG right;
+	LONG bottom;
+};
+typedef RECT D3D12_RECT;
+
+enum D3D12_CLEAR_FLAGS
+{
+	D3D12_CLEAR_FLAG_DEPTH = 0x1,
+	D3D12_CLEAR_FLAG_STENCIL = 0x2,
+};
+
+inline D3D12_CLEAR_FLAGS operator|(D3D12_CLEAR_FLAGS a, D3D12_CLEAR_FLAGS b)
+{
+	return (D3D12_CLEAR_FLAGS)((int)a | (int)b);
+}
+
+enum D3D12_RESOURCE_STATES
+{
+	D3D12_RESOURCE_STATE_COMMON = 0,
+	D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER = 0x1,
+	D3D12_RESOURCE_STATE_INDEX_BUFFER = 0x2,
+	D3D12_RESOURCE_STATE_RENDER_TARGET = 0x4,
+	D3D12_RESOURCE_STATE_DEPTH_WRITE = 0x10,
+	D3D12_RESOURCE_STATE_COPY_DEST = 0x400,
+	D3D12_RESOURCE_STATE_COPY_SOURCE = 0x800,
+	D3D12_RESOURCE_STATE_GENERIC_READ = 0xac3,
+	D3D12_RESOURCE_STATE_PRESENT = 0,
+};
+
+enum D3D12_RESOURCE_BARRIER_TYPE
+{
+	D3D12_RESOURCE_BARRIER_TYPE_TRANSITION = 0,
+	D3D12_RESOURCE_BARRIER_TYPE_ALIASING = 1,
+	D3D12_RESOURCE_BARRIER_TYPE_UAV = 2,
+};
+
+enum D3D12_RESOURCE_BARRIER_FLAGS
+{
+	D3D12_RESOURCE_BARRIER_FLAG_NONE = 0,
+	D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY = 0x1,
+	D3D12_RESOURCE_BARRIER_FLAG_END_ONLY = 0x2,
+};
+
+#define D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES 0xffffffff
+
+struct D3D12_RESOURCE_TRANSITION_BARRIER
+{
+	ID3D12Resource* pResource;
+	UINT Subresource;
+	D3D12_RESOURCE_STATES StateBefore;
+	D3D12_RESOURCE_STATES StateAfter;
+};
+
+struct D3D12_RESOURCE_ALIASING_BARRIER
+{
+	ID3D12Resource* pResourceBefore;
+	ID3D12Resource* pResourceAfter;
+};
+
+struct D3D12_RESOURCE_UAV_BARRIER
+{
+	ID3D12Resource* pResource;
+};
+
+struct D3D12_RESOURCE_BARRIER
+{
+	D3D12_RESOURCE_BARRIER_TYPE Type;
+	D3D12_RESOURCE_BARRIER_FLAGS Flags;
+	union
+	{
+		D3D12_RESOURCE_TRANSITION_BARRIER Transition;
+		D3D12_RESOURCE_ALIASING_BARRIER Aliasing;
+		D3D12_RESOURCE_UAV_BARRIER UAV;
+	};
+};
@@ -0,0 +1,149 @@
+//***************************************************************************************
+// HeadlessFrames.cpp
+//
+// Runs the sample's SceneRenderer without a device: the scene is built from the same
+// generators and the skull model, then Update+Draw run for a number of frames while
+// the camera orbits outwards, so terrain chunks stream in and out.  Command lists go
+// to a MemoryRecorderPool, uploads to memory, and a MemoryFence completes frames two
+// submissions late like a GPU running behind.
+//
+// Prints, per frame, the lists submitted, draws, state changes, barriers, copies and
+// command stream bytes, next to the scene's own counts.  As a test it also checks
+// that the recorded draws match the scene's draw count, that every frame ends in the
+// PRESENT transition, and that capture mode (odd frames) replays the same stream.
+//
+// Usage: HeadlessFrames [frames]   (default 12)
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Init_Direct3D/SceneRenderer.h"
+#include "../Common/MemoryGeometryUploader.h"
+#include "../Common/MemoryRecorderPool.h"
+#include "../Common/MemoryUploadHeap.h"
+#include "../Common/TextModelLoader.h"
+
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+	// Any distinct non-null values; nothing dereferences them without a device.
+	ID3D12PipelineState* const FakePso = reinterpret_cast<ID3D12PipelineState*>(std::uintptr_t(0x1000));
+	ID3D12RootSignature* const FakeRootSignature = reinterpret_cast<ID3D12RootSignature*>(std::uintptr_t(0x2000));
+	ID3D12Resource* const FakeBackBuffer = reinterpret_cast<ID3D12Resource*>(std::uintptr_t(0x3000));
+
+	SceneFrameTarget MakeTarget(int width, int height)
+	{
+		SceneFrameTarget target;
+		target.BackBuffer = FakeBackBuffer;
+		target.RenderTarget.ptr = 0x4000;
+		target.DepthStencil.ptr = 0x5000;
+		target.Viewport = { 0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f };
+		target.ScissorRect = { 0, 0, width, height };
+		return target;
+	}
+
+	bool EndsWithPresent(const MemoryRecorderPool& pool)
+	{
+		if(pool.ListCount() == 0)
+			return false;
+
+		// The last list holds exactly the RENDER_TARGET -> PRESENT transition.
+		const CommandStreamStats& stats = pool.List(pool.ListCount() - 1).Stats();
+		return stats.Barriers == 1 && stats.Draws == 0 && stats.StateChanges == 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int frameCount = argc > 1 ? std::atoi(argv[1]) : 12;
+	const int width = 800;
+	const int height = 600;
+
+	SceneResourceFactory factory;
+	factory.CreateGeometryUploader = [](UINT64 stagingByteSize, bool keepStaging)
+	{
+		return std::unique_ptr<GeometryUploader>(std::make_unique<MemoryGeometryUploader>(stagingByteSize, keepStaging));
+	};
+	factory.CreateUploadHeap = [](UINT64 pageSize)
+	{
+		return std::unique_ptr<UploadHeap>(std::make_unique<MemoryUploadHeap>(pageSize));
+	};
+
+	MemoryFence fence(2);
+	MemoryRecorderPool lists;
+	// The app defaults to Float; the compact encoding is opted into here so the run
+	// covers the quantized path.
+	SceneRenderer scene(factory, fence, lists, VertexEncoding::CompactOct16);
+	scene.Resize(width, height);
+	scene.SetPipeline(FakePso, FakeRootSignature);
+
+	{
+		// Same preparation as the app's uncached path: load, then optimize and build the
+		// meshlets and LODs once.
+		std::pmr::vector<Vertex> vertices(&scene.LoadScratch());
+		std::pmr::vector<std::uint32_t> indices(&scene.LoadScratch());
+		const std::string skullPath = std::string(MODELS_DIR) + "/skull.txt";
+		bool hasSkull = TextModelLoader::Load(std::wstring(skullPath.begin(), skullPath.end()), vertices, indices, &scene.LoadScratch());
+		CHECK(hasSkull);
+
+		SceneModel skull;
+		if(hasSkull)
+			skull = scene.PrepareModel("Skull", vertices, indices);
+
+		MemoryCommandRecorder init;
+		scene.Build(init, hasSkull ? &skull : nullptr);
+		std::printf("build: %u copies, %u barriers, %llu bytes\n", init.Stats().Copies, init.Stats().Barriers,
+			(unsigned long long)init.ByteSize());
+		CHECK(init.Stats().Copies > 0);
+	}
+
+	fence.Flush();
+	scene.EndBuild();
+
+	for(const std::string& line : scene.BuildLog())
+		std::printf("  %s\n", line.c_str());
+
+	std::printf("\n%5s %6s %6s %6s %6s %6s %6s %9s %8s %8s %7s %7s\n", "frame", "radius", "lists", "draws", "state",
+		"barrs", "copies", "bytes", "visible", "culled", "chunks", "loaded");
+
+	const SceneFrameTarget target = MakeTarget(width, height);
+	float theta = 1.5f * XM_PI;
+	for(int frame = 0; frame < frameCount; ++frame)
+	{
+		// Orbit while moving out to the app's maximum zoom, so chunks stream in and out.
+		theta += 0.35f;
+		const float radius = 5.0f + (150.0f - 5.0f) * (float)frame / (float)std::max(frameCount - 1, 1);
+		scene.SetCameraOrbit(theta, XM_PIDIV4, radius);
+
+		const bool capture = (frame & 1) != 0;
+		scene.SetCaptureCommands(capture);
+
+		scene.Update();
+		scene.Draw(target);
+		scene.EndFrame();
+
+		const SubmittedFrameStats& submitted = lists.Submitted();
+		const FrameStats& stats = scene.Stats();
+		std::printf("%5d %6.1f %6u %6u %6u %6u %6u %9llu %8u %8u %7u %7u%s\n", frame, radius, submitted.Lists,
+			submitted.Stream.Draws, submitted.Stream.StateChanges, submitted.Stream.Barriers, submitted.Stream.Copies,
+			(unsigned long long)submitted.Bytes, stats.VisibleItems, stats.CulledItems, stats.TerrainChunks,
+			stats.TerrainChunksLoaded, capture ? "  (captured)" : "");
+
+		CHECK(submitted.Lists == stats.RecordedLists + 2);
+		CHECK(submitted.Stream.Draws == stats.DrawCalls);
+		CHECK(stats.TerrainChunksLoaded == 0 || submitted.Stream.Copies > 0);
+		CHECK(EndsWithPresent(lists));
+
+		if(capture)
+		{
+			CHECK(stats.CapturedCommands == submitted.Commands);
+			CHECK(stats.CapturedDraws == submitted.Stream.Draws);
+			CHECK(stats.CapturedBytes == submitted.Bytes);
+		}
+	}
+
+	CHECK(fence.CurrentValue() == (UINT64)frameCount + 1);
+
+	return TestResult("HeadlessFrames");
+}
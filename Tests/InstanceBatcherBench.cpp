@@ -0,0 +1,68 @@
+//***************************************************************************************
+// InstanceBatcherBench.cpp
+//
+// Times InstanceBatcher::Build plus PackWorlds for scenes of repeated shapes and
+// reports how many draws the groups replace.
+//***************************************************************************************
+
+#include "BenchTimer.h"
+#include "../Common/InstanceBatcher.h"
+
+#include <random>
+
+using namespace DirectX;
+
+namespace
+{
+	struct Instance
+	{
+		XMFLOAT4X4 World;
+		std::uint32_t MaterialIndex;
+	};
+
+	void Run(std::uint32_t count, std::uint32_t geometryCount, std::uint32_t materialCount)
+	{
+		const int runs = 15;
+
+		std::mt19937 rng(11);
+		std::uniform_int_distribution<std::uint32_t> geometry(0, geometryCount - 1);
+		std::uniform_int_distribution<std::uint32_t> material(0, materialCount - 1);
+		std::uniform_int_distribution<std::uint32_t> coin(0, 1);
+
+		std::vector<std::uint32_t> geometryIds(count), materialIds(count);
+		std::vector<std::uint8_t> visible(count);
+		std::vector<XMFLOAT4X4> worlds(count);
+		for(std::uint32_t i = 0; i < count; ++i)
+		{
+			geometryIds[i] = geometry(rng);
+			materialIds[i] = material(rng);
+			visible[i] = (std::uint8_t)coin(rng);
+			XMStoreFloat4x4(&worlds[i], XMMatrixTranslation((float)i, 0.0f, 0.0f));
+		}
+
+		InstanceBatcher batcher;
+		std::vector<Instance> instances(count);
+
+		double checksum = 0.0;
+		BenchResult result = RunBench(runs, [&]()
+		{
+			batcher.Build(geometryIds.data(), materialIds.data(), visible.data(), count);
+			batcher.PackWorlds(worlds.data(), instances.data());
+			checksum = instances[batcher.InstanceCount() - 1].World._14;
+		});
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "%u objects, %u x %u keys", count, geometryCount, materialCount);
+		PrintBench(name, result);
+		std::printf("    %u visible draws -> %zu instanced draws (checksum %.0f)\n",
+			batcher.InstanceCount(), batcher.Groups().size(), checksum);
+	}
+}
+
+int main()
+{
+	Run(10000, 4, 8);
+	Run(100000, 4, 8);
+	Run(100000, 64, 64);
+	return 0;
+}
@@ -0,0 +1,147 @@
+//***************************************************************************************
+// InstanceBatcherTest.cpp
+//
+// Checks the instance groups against a straightforward grouping by first appearance,
+// with enough distinct keys to rehash the group table, and checks that rebuilding
+// with the scratch arrays from the previous frame gives the same result.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/InstanceBatcher.h"
+
+#include <map>
+#include <random>
+
+using namespace DirectX;
+
+namespace
+{
+	struct Instance
+	{
+		XMFLOAT4X4 World;
+		std::uint32_t MaterialIndex;
+	};
+
+	void CheckGroups(const InstanceBatcher& batcher, const std::vector<std::uint32_t>& geometryIds,
+		const std::vector<std::uint32_t>& materialIds, const std::vector<std::uint8_t>* visible)
+	{
+		// Reference: groups in order of their first visible object, objects in dense order.
+		std::map<std::pair<std::uint32_t, std::uint32_t>, std::size_t> groupOf;
+		std::vector<std::vector<std::uint32_t>> expected;
+		for(std::uint32_t i = 0; i < (std::uint32_t)geometryIds.size(); ++i)
+		{
+			if(visible != nullptr && !(*visible)[i])
+				continue;
+
+			auto key = std::make_pair(geometryIds[i], materialIds[i]);
+			auto it = groupOf.find(key);
+			if(it == groupOf.end())
+			{
+				it = groupOf.emplace(key, expected.size()).first;
+				expected.emplace_back();
+			}
+			expected[it->second].push_back(i);
+		}
+
+		const std::vector<InstanceGroup>& groups = batcher.Groups();
+		CHECK(groups.size() == expected.size());
+		if(groups.size() != expected.size())
+			return;
+
+		std::uint32_t first = 0;
+		for(std::size_t g = 0; g < groups.size(); ++g)
+		{
+			CHECK(groups[g].FirstInstance == first);
+			CHECK(groups[g].InstanceCount == expected[g].size());
+			CHECK(groups[g].GeometryId == geometryIds[expected[g][0]]);
+			CHECK(groups[g].MaterialId == materialIds[expected[g][0]]);
+
+			for(std::uint32_t k = 0; k < groups[g].InstanceCount; ++k)
+				CHECK(batcher.Order()[first + k] == expected[g][k]);
+
+			first += groups[g].InstanceCount;
+		}
+		CHECK(batcher.InstanceCount() == first);
+	}
+
+	void TestGrouping()
+	{
+		const std::uint32_t count = 20000;
+
+		std::mt19937 rng(3);
+		std::uniform_int_distribution<std::uint32_t> geometry(0, 39);
+		std::uniform_int_distribution<std::uint32_t> material(0, 24);
+		std::uniform_int_distribution<std::uint32_t> coin(0, 2);
+
+		std::vector<std::uint32_t> geometryIds(count), materialIds(count);
+		std::vector<std::uint8_t> visible(count);
+		for(std::uint32_t i = 0; i < count; ++i)
+		{
+			// Runs of equal keys exercise the cached last lookup.
+			if(i > 0 && coin(rng) == 0)
+			{
+				geometryIds[i] = geometryIds[i - 1];
+				materialIds[i] = materialIds[i - 1];
+			}
+			else
+			{
+				geometryIds[i] = geometry(rng);
+				materialIds[i] = material(rng);
+			}
+			visible[i] = coin(rng) != 0;
+		}
+
+		InstanceBatcher batcher;
+		batcher.Build(geometryIds.data(), materialIds.data(), nullptr, count);
+		CheckGroups(batcher, geometryIds, materialIds, nullptr);
+		CHECK(batcher.Groups().size() > 500);
+
+		batcher.Build(geometryIds.data(), materialIds.data(), visible.data(), count);
+		CheckGroups(batcher, geometryIds, materialIds, &visible);
+
+		// A frame with nothing visible, then the full set again.
+		std::vector<std::uint8_t> none(count, 0);
+		batcher.Build(geometryIds.data(), materialIds.data(), none.data(), count);
+		CHECK(batcher.Groups().empty() && batcher.InstanceCount() == 0);
+
+		batcher.Build(geometryIds.data(), materialIds.data(), visible.data(), count);
+		CheckGroups(batcher, geometryIds, materialIds, &visible);
+	}
+
+	void TestPackWorlds()
+	{
+		std::vector<XMFLOAT4X4> worlds(5);
+		for(std::uint32_t i = 0; i < 5; ++i)
+		{
+			for(int r = 0; r < 4; ++r)
+				for(int c = 0; c < 4; ++c)
+					worlds[i].m[r][c] = (float)(i * 100 + r * 10 + c);
+		}
+
+		const std::uint32_t geometryIds[] = { 1, 2, 1, 2, 1 };
+		const std::uint32_t materialIds[] = { 0, 0, 0, 0, 0 };
+
+		InstanceBatcher batcher;
+		batcher.Build(geometryIds, materialIds, nullptr, 5);
+
+		std::vector<Instance> instances(batcher.InstanceCount());
+		batcher.PackWorlds(worlds.data(), instances.data());
+
+		// Group {0, 2, 4} then {1, 3}.
+		const std::uint32_t order[] = { 0, 2, 4, 1, 3 };
+		for(std::uint32_t k = 0; k < 5; ++k)
+		{
+			for(int r = 0; r < 4; ++r)
+				for(int c = 0; c < 4; ++c)
+					CHECK(instances[k].World.m[r][c] == worlds[order[k]].m[c][r]);
+		}
+	}
+}
+
+int main()
+{
+	TestGrouping();
+	TestPackWorlds();
+
+	return TestResult("InstanceBatcherTest");
+}
@@ -0,0 +1,244 @@
+//***************************************************************************************
+// LinearPageAllocatorTest.cpp
+//
+// Checks LinearPageAllocator's paging: 256-byte slices that never overlap, chaining to
+// a new page when a request does not fit, a page of its own for a request larger than
+// a page and the reuse of that page once it is retired, and that Submit/Retire hand a
+// page out again only after the fence of the frame that wrote it has completed.  The
+// last part drives it like a frame loop with the GPU two frames behind.  Also checks
+// the slices MemoryUploadHeap returns on top of it.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/LinearPageAllocator.h"
+#include "../Common/MemoryUploadHeap.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+	const std::uint64_t PageSize = 4096;
+	const std::uint64_t SliceAlignment = 256;
+
+	struct Range
+	{
+		std::uint64_t Begin;
+		std::uint64_t End;
+	};
+
+	// Ranges handed out per page since the last Submit.
+	using PageRanges = std::map<std::uint32_t, std::vector<Range>>;
+
+	// Allocates and checks the result against the page's bounds and earlier ranges.
+	LinearAllocation CheckedAllocate(LinearPageAllocator& pages, PageRanges& ranges, std::uint64_t byteSize, std::uint64_t alignment)
+	{
+		const std::uint32_t pageCount = pages.PageCount();
+		LinearAllocation allocation = pages.Allocate(byteSize, alignment);
+
+		// A new page is always the next index.
+		CHECK(allocation.Page <= pageCount);
+		CHECK(allocation.Page < pages.PageCount());
+		CHECK(allocation.Offset % alignment == 0);
+		CHECK(allocation.Offset + byteSize <= pages.PageSize(allocation.Page));
+
+		std::vector<Range>& used = ranges[allocation.Page];
+		for(const Range& r : used)
+			CHECK(allocation.Offset >= r.End || allocation.Offset + byteSize <= r.Begin);
+		used.push_back({ allocation.Offset, allocation.Offset + byteSize });
+
+		return allocation;
+	}
+
+	void TestSliceAlignment()
+	{
+		LinearPageAllocator pages(PageSize);
+		PageRanges ranges;
+
+		// Odd sizes, so every slice after the first starts misaligned without padding.
+		for(std::uint64_t size : { 1, 200, 256, 257, 1000, 13, 4096, 77, 3000 })
+			CheckedAllocate(pages, ranges, size, SliceAlignment);
+
+		CHECK(pages.AllocatedBytes() == 1 + 200 + 256 + 257 + 1000 + 13 + 4096 + 77 + 3000);
+
+		// The same through the heap: CPU and GPU addresses of every slice are aligned.
+		MemoryUploadHeap heap(PageSize);
+		for(int i = 0; i < 100; ++i)
+		{
+			UploadAllocation allocation = heap.Allocate(1 + i * 37);
+			CHECK(reinterpret_cast<std::uintptr_t>(allocation.CpuAddress) % SliceAlignment == 0);
+			CHECK(allocation.GpuAddress % SliceAlignment == 0);
+		}
+		CHECK(UploadHeap::ConstantBufferByteSize(1) == 256);
+		CHECK(UploadHeap::ConstantBufferByteSize(256) == 256);
+		CHECK(UploadHeap::ConstantBufferByteSize(257) == 512);
+	}
+
+	void TestChaining()
+	{
+		LinearPageAllocator pages(1024);
+		PageRanges ranges;
+
+		CHECK(CheckedAllocate(pages, ranges, 600, SliceAlignment).Page == 0);
+
+		// 600 rounds up to 768, and 768 + 200 still fits.
+		LinearAllocation fits = CheckedAllocate(pages, ranges, 200, SliceAlignment);
+		CHECK(fits.Page == 0 && fits.Offset == 768);
+
+		// The next aligned offset is the end of the page: chain to a new one.
+		LinearAllocation chained = CheckedAllocate(pages, ranges, 100, SliceAlignment);
+		CHECK(chained.Page == 1 && chained.Offset == 0);
+		CHECK(pages.PageCount() == 2);
+		CHECK(pages.OpenPageCount() == 2);
+
+		// A request of exactly a page fills one.
+		LinearAllocation whole = CheckedAllocate(pages, ranges, 1024, SliceAlignment);
+		CHECK(whole.Page == 2 && whole.Offset == 0);
+		CHECK(pages.PageSize(2) == 1024);
+		CHECK(pages.ReservedBytes() == 3 * 1024);
+	}
+
+	void TestLargePages()
+	{
+		LinearPageAllocator pages(1024);
+		PageRanges ranges;
+
+		LinearAllocation small = CheckedAllocate(pages, ranges, 100, SliceAlignment);
+
+		// Larger than a page: a page of its own, rounded up to whole pages.
+		LinearAllocation large = CheckedAllocate(pages, ranges, 3000, SliceAlignment);
+		CHECK(large.Page == 1 && large.Offset == 0);
+		CHECK(pages.PageSize(large.Page) == 3072);
+
+		// The current page is left as it was.
+		LinearAllocation next = CheckedAllocate(pages, ranges, 100, SliceAlignment);
+		CHECK(next.Page == small.Page && next.Offset == 256);
+		CHECK(pages.OpenPageCount() == 2);
+
+		pages.Submit(1);
+		pages.Retire(1);
+		ranges.clear();
+
+		// A retired large page is reused for a request it can hold, from the large-page
+		// free list; small requests never take it.
+		LinearAllocation reusedSmall = CheckedAllocate(pages, ranges, 100, SliceAlignment);
+		CHECK(reusedSmall.Page == small.Page);
+		LinearAllocation reused = CheckedAllocate(pages, ranges, 2500, SliceAlignment);
+		CHECK(reused.Page == large.Page);
+		CHECK(pages.PageCount() == 2);
+
+		// One it cannot hold gets a new page.
+		LinearAllocation larger = CheckedAllocate(pages, ranges, 5000, SliceAlignment);
+		CHECK(larger.Page == 2);
+		CHECK(pages.PageSize(larger.Page) == 5120);
+
+		// Large pages are kept for reuse, never released: after they retire the
+		// reserved size still counts them.
+		pages.Submit(2);
+		pages.Retire(2);
+		ranges.clear();
+		CHECK(pages.ReservedBytes() == 1024 + 3072 + 5120);
+
+		// A large request takes the first free large page that fits.
+		LinearAllocation again = CheckedAllocate(pages, ranges, 3000, SliceAlignment);
+		CHECK(again.Page == large.Page || again.Page == larger.Page);
+		CHECK(pages.PageCount() == 3);
+	}
+
+	void TestSubmitRetire()
+	{
+		LinearPageAllocator pages(1024);
+		PageRanges ranges;
+
+		for(int i = 0; i < 5; ++i)
+			CheckedAllocate(pages, ranges, 512, SliceAlignment);
+		std::set<std::uint32_t> frame1;
+		for(const auto& entry : ranges)
+			frame1.insert(entry.first);
+		CHECK(frame1.size() == 3);
+
+		pages.Submit(1);
+		CHECK(pages.OpenPageCount() == 0);
+		CHECK(pages.AllocatedBytes() == 0);
+		ranges.clear();
+
+		// Fence 1 has not completed: nothing of frame 1 is handed out again.
+		pages.Retire(0);
+		for(int i = 0; i < 5; ++i)
+		{
+			LinearAllocation allocation = CheckedAllocate(pages, ranges, 512, SliceAlignment);
+			CHECK(frame1.count(allocation.Page) == 0);
+		}
+		CHECK(pages.PageCount() == 6);
+		pages.Submit(2);
+		ranges.clear();
+
+		// Once it has, frame 1's pages come back and no new page is needed.
+		pages.Retire(1);
+		for(int i = 0; i < 5; ++i)
+		{
+			LinearAllocation allocation = CheckedAllocate(pages, ranges, 512, SliceAlignment);
+			CHECK(frame1.count(allocation.Page) == 1);
+		}
+		CHECK(pages.PageCount() == 6);
+
+		// Submitting with nothing allocated is harmless.
+		pages.Submit(3);
+		pages.Submit(4);
+		pages.Retire(4);
+		CHECK(pages.PageCount() == 6);
+	}
+
+	void TestFrameLoop()
+	{
+		LinearPageAllocator pages(PageSize);
+		std::mt19937 rng(3);
+		std::uniform_int_distribution<int> sizeDist(1, 1500);
+		std::uniform_int_distribution<int> countDist(0, 20);
+
+		// Page -> fence of the frame that wrote it, for pages still in flight.
+		std::map<std::uint32_t, std::uint64_t> inFlight;
+		const std::uint64_t lag = 2;
+
+		for(std::uint64_t fence = 1; fence <= 300; ++fence)
+		{
+			const std::uint64_t completed = fence > lag ? fence - lag - 1 : 0;
+			pages.Retire(completed);
+			for(auto it = inFlight.begin(); it != inFlight.end();)
+				it = it->second <= completed ? inFlight.erase(it) : std::next(it);
+
+			PageRanges ranges;
+			const int count = countDist(rng);
+			for(int i = 0; i < count; ++i)
+			{
+				// Now and then a request larger than a page.
+				std::uint64_t size = (i % 17 == 16) ? PageSize + sizeDist(rng) * 4 : sizeDist(rng);
+				LinearAllocation allocation = CheckedAllocate(pages, ranges, size, SliceAlignment);
+				CHECK(inFlight.count(allocation.Page) == 0);
+			}
+
+			CHECK(pages.OpenPageCount() == ranges.size());
+			pages.Submit(fence);
+			for(const auto& entry : ranges)
+				inFlight[entry.first] = fence;
+		}
+
+		// Steady state: the pages of the frames in flight plus the large pages kept for
+		// reuse, far fewer than one page per frame.
+		CHECK(pages.PageCount() < 60);
+	}
+}
+
+int main()
+{
+	TestSliceAlignment();
+	TestChaining();
+	TestLargePages();
+	TestSubmitRetire();
+	TestFrameLoop();
+
+	return TestResult("LinearPageAllocatorTest");
+}
@@ -0,0 +1,66 @@
+//***************************************************************************************
+// MeshOptimizerBench.cpp
+//
+// Times MeshOptimizer::Optimize on the shipped models and reports ACMR/ATVR before
+// and after for FIFO caches of 16, 24 and 32 entries.
+//***************************************************************************************
+
+#include "BenchTimer.h"
+#include "../Common/MeshOptimizer.h"
+#include "../Common/TextModelLoader.h"
+
+#include <string>
+
+namespace
+{
+	struct Float3
+	{
+		float x, y, z;
+	};
+
+	struct ModelVertex
+	{
+		Float3 Pos;
+		Float3 Normal;
+	};
+
+	void Run(const char* name)
+	{
+		const int runs = 10;
+
+		std::vector<ModelVertex> vertices;
+		std::vector<std::uint32_t> indices;
+		std::string path = std::string(MODELS_DIR) + "/" + name;
+		if(!TextModelLoader::Load(std::wstring(path.begin(), path.end()), vertices, indices))
+		{
+			std::printf("cannot load %s\n", path.c_str());
+			return;
+		}
+
+		std::vector<ModelVertex> optimizedVertices;
+		std::vector<std::uint32_t> optimizedIndices;
+		BenchResult result = RunBench(runs, [&]()
+		{
+			optimizedVertices = vertices;
+			optimizedIndices = indices;
+			MeshOptimizer::Optimize(optimizedVertices, optimizedIndices);
+		});
+
+		std::printf("%s: %zu vertices, %zu triangles\n", name, vertices.size(), indices.size() / 3);
+		PrintBench("Optimize", result);
+
+		for(std::uint32_t cacheSize : { 16u, 24u, 32u })
+		{
+			VertexCacheStats before = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), (std::uint32_t)vertices.size(), cacheSize);
+			VertexCacheStats after = MeshOptimizer::AnalyzeVertexCache(optimizedIndices.data(), optimizedIndices.size(), (std::uint32_t)optimizedVertices.size(), cacheSize);
+			std::printf("    FIFO %2u: ACMR %.3f -> %.3f   ATVR %.3f -> %.3f\n", cacheSize, before.Acmr, after.Acmr, before.Atvr, after.Atvr);
+		}
+	}
+}
+
+int main()
+{
+	Run("skull.txt");
+	Run("car.txt");
+	return 0;
+}
@@ -0,0 +1,119 @@
+//***************************************************************************************
+// MeshOptimizerTest.cpp
+//
+// Optimizes the shipped models and a copy of the skull with its triangles shuffled,
+// and checks that the optimized meshes hold the same triangles, never have a higher
+// ACMR than the input, and have vertices in first-use order.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/MeshOptimizer.h"
+#include "../Common/TextModelLoader.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace
+{
+	struct Float3
+	{
+		float x, y, z;
+	};
+
+	struct ModelVertex
+	{
+		Float3 Pos;
+		Float3 Normal;
+	};
+
+	using Triangle = std::array<float, 9>;
+
+	// Triangles as sorted position triples, rotated so each starts at its smallest
+	// vertex; renumbering vertices and reordering triangles leave this unchanged.
+	std::vector<Triangle> TriangleSet(const std::vector<ModelVertex>& vertices, const std::vector<std::uint32_t>& indices)
+	{
+		std::vector<Triangle> triangles;
+		for(std::size_t t = 0; t < indices.size(); t += 3)
+		{
+			std::array<Float3, 3> p = { vertices[indices[t]].Pos, vertices[indices[t + 1]].Pos, vertices[indices[t + 2]].Pos };
+
+			int first = 0;
+			for(int k = 1; k < 3; ++k)
+			{
+				if(std::memcmp(&p[k], &p[first], sizeof(Float3)) < 0)
+					first = k;
+			}
+
+			Triangle tri;
+			for(int k = 0; k < 3; ++k)
+				std::memcpy(&tri[k * 3], &p[(first + k) % 3], sizeof(Float3));
+			triangles.push_back(tri);
+		}
+
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	MeshOptimizeReport CheckOptimize(const char* name, std::vector<ModelVertex> vertices, std::vector<std::uint32_t> indices)
+	{
+		std::vector<Triangle> before = TriangleSet(vertices, indices);
+
+		MeshOptimizeReport report = MeshOptimizer::Optimize(vertices, indices);
+		std::printf("  %-16s ACMR %.3f -> %.3f   ATVR %.3f -> %.3f\n", name,
+			report.Before.Acmr, report.After.Acmr, report.Before.Atvr, report.After.Atvr);
+
+		CHECK(report.After.Acmr <= report.Before.Acmr);
+		CHECK(report.After.Atvr >= 1.0f);
+		CHECK(TriangleSet(vertices, indices) == before);
+
+		// First-use order: each index is at most one past the largest seen so far.
+		std::uint32_t next = 0;
+		bool firstUse = true;
+		for(std::uint32_t i : indices)
+		{
+			firstUse = firstUse && i <= next;
+			if(i == next)
+				++next;
+		}
+		CHECK(firstUse);
+		CHECK(next == vertices.size());
+
+		return report;
+	}
+
+	bool Load(const char* name, std::vector<ModelVertex>& vertices, std::vector<std::uint32_t>& indices)
+	{
+		std::string path = std::string(MODELS_DIR) + "/" + name;
+		return TextModelLoader::Load(std::wstring(path.begin(), path.end()), vertices, indices);
+	}
+}
+
+int main()
+{
+	std::vector<ModelVertex> skullVertices, carVertices;
+	std::vector<std::uint32_t> skullIndices, carIndices;
+	CHECK(Load("skull.txt", skullVertices, skullIndices));
+	CHECK(Load("car.txt", carVertices, carIndices));
+
+	CheckOptimize("skull.txt", skullVertices, skullIndices);
+	CheckOptimize("car.txt", carVertices, carIndices);
+
+	// Shuffled triangles and an unreferenced vertex: the reorder has to do the work.
+	std::vector<std::array<std::uint32_t, 3>> triangles(skullIndices.size() / 3);
+	std::memcpy(triangles.data(), skullIndices.data(), skullIndices.size() * sizeof(std::uint32_t));
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937(17));
+
+	std::vector<std::uint32_t> shuffled(skullIndices.size());
+	std::memcpy(shuffled.data(), triangles.data(), shuffled.size() * sizeof(std::uint32_t));
+
+	std::vector<ModelVertex> withUnused = skullVertices;
+	withUnused.push_back(ModelVertex());
+
+	MeshOptimizeReport report = CheckOptimize("skull shuffled", withUnused, shuffled);
+	CHECK(report.After.Acmr < 0.5f * report.Before.Acmr);
+
+	return TestResult("MeshOptimizerTest");
+}
@@ -0,0 +1,51 @@
+//***************************************************************************************
+// MeshSimplifierBench.cpp
+//
+// Times a three-level LOD chain for Models/skull.txt, including the error measurement
+// of every level.
+//***************************************************************************************
+
+#include "BenchTimer.h"
+#include "../Common/MeshSimplifier.h"
+#include "../Common/TextModelLoader.h"
+
+#include <string>
+
+using namespace DirectX;
+
+namespace
+{
+	struct ModelVertex
+	{
+		XMFLOAT3 Pos;
+		XMFLOAT3 Normal;
+	};
+}
+
+int main()
+{
+	const int runs = 5;
+
+	std::vector<ModelVertex> vertices;
+	std::vector<std::uint32_t> indices;
+	std::string path = std::string(MODELS_DIR) + "/skull.txt";
+	if(!TextModelLoader::Load(std::wstring(path.begin(), path.end()), vertices, indices))
+	{
+		std::printf("cannot load %s\n", path.c_str());
+		return 1;
+	}
+
+	std::vector<MeshLod> lods;
+	BenchResult result = RunBench(runs, [&]()
+	{
+		lods = MeshSimplifier::BuildLodChain(&vertices[0].Pos, sizeof(ModelVertex),
+			(std::uint32_t)vertices.size(), indices.data(), indices.size());
+	});
+
+	std::printf("skull.txt: %zu triangles\n", indices.size() / 3);
+	PrintBench("BuildLodChain, 3 levels", result);
+	for(const MeshLod& lod : lods)
+		std::printf("    %6zu triangles, error %.4f\n", lod.Indices.size() / 3, lod.Error);
+
+	return 0;
+}
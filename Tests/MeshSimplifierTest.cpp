@@ -0,0 +1,223 @@
+//***************************************************************************************
+// MeshSimplifierTest.cpp
+//
+// Checks the LOD chains: triangle counts shrink by the requested factor, the results
+// are valid index lists, open borders and seams are kept, and the reported error
+// matches a brute-force distance from every original vertex to the simplified
+// surface.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/GeometryGenerator.h"
+#include "../Common/MeshSimplifier.h"
+#include "../Common/TextModelLoader.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <set>
+#include <string>
+
+using namespace DirectX;
+
+namespace
+{
+	struct ModelVertex
+	{
+		XMFLOAT3 Pos;
+		XMFLOAT3 Normal;
+	};
+
+	XMVECTOR ClosestPointOnTriangle(FXMVECTOR p, FXMVECTOR a, FXMVECTOR b, GXMVECTOR c)
+	{
+		// Project onto the plane, and fall back to the nearest edge if that lies outside.
+		XMVECTOR n = XMVector3Normalize(XMVector3Cross(b - a, c - a));
+		XMVECTOR q = p - XMVector3Dot(p - a, n) * n;
+
+		XMVECTOR corners[3] = { a, b, c };
+		bool inside = true;
+		for(int e = 0; e < 3; ++e)
+		{
+			XMVECTOR u = corners[(e + 1) % 3] - corners[e];
+			if(XMVectorGetX(XMVector3Dot(XMVector3Cross(u, q - corners[e]), n)) < 0.0f)
+				inside = false;
+		}
+		if(inside)
+			return q;
+
+		XMVECTOR best = a;
+		float bestDist = FLT_MAX;
+		for(int e = 0; e < 3; ++e)
+		{
+			XMVECTOR s = corners[e];
+			XMVECTOR u = corners[(e + 1) % 3] - s;
+			float t = XMVectorGetX(XMVector3Dot(p - s, u)) / std::max(XMVectorGetX(XMVector3Dot(u, u)), 1e-20f);
+			XMVECTOR onEdge = s + std::min(1.0f, std::max(0.0f, t)) * u;
+			float d = XMVectorGetX(XMVector3Length(p - onEdge));
+			if(d < bestDist)
+			{
+				bestDist = d;
+				best = onEdge;
+			}
+		}
+		return best;
+	}
+
+	float BruteForceError(const std::vector<XMFLOAT3>& positions, const std::vector<std::uint32_t>& indices)
+	{
+		float error = 0.0f;
+		for(const XMFLOAT3& pos : positions)
+		{
+			XMVECTOR p = XMLoadFloat3(&pos);
+			float nearest = FLT_MAX;
+			for(std::size_t t = 0; t < indices.size(); t += 3)
+			{
+				XMVECTOR q = ClosestPointOnTriangle(p, XMLoadFloat3(&positions[indices[t]]),
+					XMLoadFloat3(&positions[indices[t + 1]]), XMLoadFloat3(&positions[indices[t + 2]]));
+				nearest = std::min(nearest, XMVectorGetX(XMVector3Length(p - q)));
+			}
+			error = std::max(error, nearest);
+		}
+		return error;
+	}
+
+	bool ValidTriangles(const std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+	{
+		if(indices.size() % 3 != 0)
+			return false;
+
+		for(std::size_t t = 0; t < indices.size(); t += 3)
+		{
+			std::uint32_t a = indices[t], b = indices[t + 1], c = indices[t + 2];
+			if(a >= vertexCount || b >= vertexCount || c >= vertexCount || a == b || b == c || a == c)
+				return false;
+		}
+		return true;
+	}
+
+	std::set<std::pair<std::uint32_t, std::uint32_t>> BorderEdges(const std::vector<std::uint32_t>& indices)
+	{
+		// A directed edge without its reverse is on a border.
+		std::set<std::pair<std::uint32_t, std::uint32_t>> edges, border;
+		for(std::size_t t = 0; t < indices.size(); t += 3)
+			for(int e = 0; e < 3; ++e)
+				edges.insert(std::make_pair(indices[t + e], indices[t + (e + 1) % 3]));
+
+		for(const auto& edge : edges)
+		{
+			if(edges.count(std::make_pair(edge.second, edge.first)) == 0)
+				border.insert(edge);
+		}
+		return border;
+	}
+
+	template<typename TMesh>
+	std::vector<XMFLOAT3> Positions(const TMesh& mesh)
+	{
+		std::vector<XMFLOAT3> positions;
+		for(const auto& v : mesh.Vertices)
+			positions.push_back(v.Position);
+		return positions;
+	}
+
+	void TestSkullChain()
+	{
+		std::vector<ModelVertex> vertices;
+		std::vector<std::uint32_t> indices;
+		std::string path = std::string(MODELS_DIR) + "/skull.txt";
+		CHECK(TextModelLoader::Load(std::wstring(path.begin(), path.end()), vertices, indices));
+
+		std::vector<MeshLod> lods = MeshSimplifier::BuildLodChain(&vertices[0].Pos, sizeof(ModelVertex),
+			(std::uint32_t)vertices.size(), indices.data(), indices.size());
+
+		CHECK(lods.size() == 3);
+
+		std::size_t previous = indices.size();
+		float previousError = 0.0f;
+		for(const MeshLod& lod : lods)
+		{
+			std::printf("  skull lod: %zu triangles, error %.4f\n", lod.Indices.size() / 3, lod.Error);
+
+			CHECK(lod.Indices.size() <= previous / 2 + 3);
+			CHECK(lod.Indices.size() >= previous * 4 / 10);
+			CHECK(ValidTriangles(lod.Indices, vertices.size()));
+			CHECK(lod.Error >= previousError);
+
+			previous = lod.Indices.size();
+			previousError = lod.Error;
+		}
+	}
+
+	void TestErrorMatchesBruteForce()
+	{
+		GeometryGenerator generator;
+		GeometryGenerator::MeshData sphere = generator.CreateGeosphere(1.0f, 3);
+		std::vector<XMFLOAT3> positions = Positions(sphere);
+		std::vector<std::uint32_t> indices(sphere.Indices32.begin(), sphere.Indices32.end());
+
+		std::vector<MeshLod> lods = MeshSimplifier::BuildLodChain(positions.data(), sizeof(XMFLOAT3),
+			(std::uint32_t)positions.size(), indices.data(), indices.size());
+		CHECK(!lods.empty());
+
+		for(const MeshLod& lod : lods)
+		{
+			CHECK(ValidTriangles(lod.Indices, positions.size()));
+
+			// Closed input stays closed.
+			CHECK(BorderEdges(lod.Indices).empty());
+
+			float expected = BruteForceError(positions, lod.Indices);
+			CHECK(std::fabs(lod.Error - expected) <= 1e-5f + 1e-3f * expected);
+		}
+
+		std::vector<std::uint32_t> result;
+		float error = MeshSimplifier::Simplify(positions.data(), sizeof(XMFLOAT3), (std::uint32_t)positions.size(),
+			indices.data(), indices.size(), indices.size() / 4, FLT_MAX, result);
+		CHECK(result.size() <= indices.size() / 4);
+		CHECK(std::fabs(error - BruteForceError(positions, result)) <= 1e-5f + 1e-3f * error);
+	}
+
+	void TestOpenBorder()
+	{
+		// A bumpy grid: the outline must survive every level unchanged.
+		GeometryGenerator generator;
+		GeometryGenerator::MeshData grid = generator.CreateGrid(10.0f, 10.0f, 33, 33);
+		std::vector<XMFLOAT3> positions = Positions(grid);
+		for(XMFLOAT3& p : positions)
+			p.y = 0.3f * std::sin(p.x) * std::cos(0.7f * p.z);
+		std::vector<std::uint32_t> indices(grid.Indices32.begin(), grid.Indices32.end());
+
+		auto border = BorderEdges(indices);
+		std::vector<MeshLod> lods = MeshSimplifier::BuildLodChain(positions.data(), sizeof(XMFLOAT3),
+			(std::uint32_t)positions.size(), indices.data(), indices.size());
+		CHECK(!lods.empty());
+
+		for(const MeshLod& lod : lods)
+		{
+			CHECK(ValidTriangles(lod.Indices, positions.size()));
+			CHECK(BorderEdges(lod.Indices) == border);
+		}
+	}
+
+	void TestSeamsLocked()
+	{
+		// Every box corner is split into three vertices with different normals.
+		GeometryGenerator generator;
+		GeometryGenerator::MeshData box = generator.CreateBox(1.0f, 1.0f, 1.0f, 0);
+		std::vector<XMFLOAT3> positions = Positions(box);
+		std::vector<std::uint32_t> indices(box.Indices32.begin(), box.Indices32.end());
+
+		CHECK(MeshSimplifier::BuildLodChain(positions.data(), sizeof(XMFLOAT3),
+			(std::uint32_t)positions.size(), indices.data(), indices.size()).empty());
+	}
+}
+
+int main()
+{
+	TestSkullChain();
+	TestErrorMatchesBruteForce();
+	TestOpenBorder();
+	TestSeamsLocked();
+
+	return TestResult("MeshSimplifierTest");
+}
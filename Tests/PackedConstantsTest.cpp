@@ -0,0 +1,174 @@
+//***************************************************************************************
+// PackedConstantsTest.cpp
+//
+// Checks the packed per-object and per-material data against the shader and against
+// the 256-byte constant buffers it replaced.  InstanceData and MaterialData must be
+// exactly the stride of the StructuredBuffers Params.hlsl declares for them, and
+// DrawConstants must lay out like cbPerDraw; both are read from the shader source.
+// Then N objects and M materials are written both ways through MemoryUploadHeap, and
+// the bytes saved must be what SceneRenderer reports as PaddingBytesSaved.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/MemoryUploadHeap.h"
+#include "../Init_Direct3D/FrameResource.h"
+
+#include <cctype>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct HlslMember
+	{
+		std::string Name;
+		std::uint32_t Size;
+	};
+
+	std::string ReadShader()
+	{
+		std::ifstream file(SHADERS_DIR "/Params.hlsl");
+		std::stringstream text;
+		text << file.rdbuf();
+		return text.str();
+	}
+
+	// Members of the struct or cbuffer called name, in declaration order.  Only the
+	// scalar, vector and matrix types these declarations use are known; anything else
+	// has size 0 and fails the checks below.
+	std::vector<HlslMember> ParseMembers(const std::string& shader, const std::string& name)
+	{
+		static const std::map<std::string, std::uint32_t> sizes = {
+			{ "float", 4 }, { "uint", 4 }, { "int", 4 },
+			{ "float2", 8 }, { "float3", 12 }, { "float4", 16 }, { "float4x4", 64 } };
+
+		std::vector<HlslMember> members;
+		// The name followed by whitespace, so InstanceData does not match InstanceDataEx.
+		size_t at = shader.find(name);
+		while(at != std::string::npos && !std::isspace((unsigned char)shader[at + name.size()]))
+			at = shader.find(name, at + 1);
+		size_t open = shader.find('{', at);
+		size_t close = shader.find('}', open);
+		if(at == std::string::npos || open == std::string::npos || close == std::string::npos)
+			return members;
+
+		std::stringstream body(shader.substr(open + 1, close - open - 1));
+		std::string line;
+		while(std::getline(body, line, ';'))
+		{
+			std::stringstream tokens(line);
+			std::string type, member;
+			if(!(tokens >> type >> member))
+				continue;
+			auto size = sizes.find(type);
+			members.push_back({ member, size != sizes.end() ? size->second : 0 });
+		}
+		return members;
+	}
+
+	// A StructuredBuffer element is packed tightly: its stride is the sum of its members.
+	std::uint32_t StructuredStride(const std::vector<HlslMember>& members)
+	{
+		std::uint32_t stride = 0;
+		for(const HlslMember& m : members)
+			stride += m.Size;
+		return stride;
+	}
+
+	// cbuffer packing: a member never straddles a 16-byte register, and a matrix starts
+	// on one.  Returns each member's offset.
+	std::map<std::string, std::uint32_t> ConstantBufferOffsets(const std::vector<HlslMember>& members, std::uint32_t& size)
+	{
+		std::map<std::string, std::uint32_t> offsets;
+		std::uint32_t offset = 0;
+		for(const HlslMember& m : members)
+		{
+			if(m.Size > 16 || offset / 16 != (offset + m.Size - 1) / 16)
+				offset = (offset + 15) & ~15u;
+			offsets[m.Name] = offset;
+			offset += m.Size;
+		}
+		size = offset;
+		return offsets;
+	}
+
+	void TestShaderLayout()
+	{
+		const std::string shader = ReadShader();
+		CHECK(!shader.empty());
+
+		std::vector<HlslMember> instance = ParseMembers(shader, "struct InstanceData");
+		std::vector<HlslMember> material = ParseMembers(shader, "struct MaterialData");
+		CHECK(instance.size() == 1);
+		CHECK(material.size() == 3);
+		CHECK(StructuredStride(instance) == sizeof(InstanceData));
+		CHECK(StructuredStride(material) == sizeof(MaterialData));
+
+		std::vector<HlslMember> perDraw = ParseMembers(shader, "cbuffer cbPerDraw");
+		CHECK(perDraw.size() == 4);
+		std::uint32_t perDrawSize = 0;
+		std::map<std::string, std::uint32_t> offsets = ConstantBufferOffsets(perDraw, perDrawSize);
+		CHECK(perDrawSize == sizeof(DrawConstants));
+		CHECK(offsets["gInstanceBase"] == offsetof(DrawConstants, InstanceBase));
+		CHECK(offsets["gQuantCenter"] == offsetof(DrawConstants, QuantCenter));
+		CHECK(offsets["gQuantExtents"] == offsetof(DrawConstants, QuantExtents));
+		CHECK(offsets["gMaterialIndex"] == offsetof(DrawConstants, MaterialIndex));
+	}
+
+	void CheckPacking(std::uint32_t objects, std::uint32_t materials)
+	{
+		const std::uint64_t pageSize = 64 * 1024;
+
+		// One slice for all instances and one for all materials, as SceneRenderer does.
+		MemoryUploadHeap packed(pageSize);
+		std::vector<InstanceData> instances(objects);
+		std::vector<MaterialData> materialData(materials);
+		if(objects > 0)
+			std::memcpy(packed.Allocate(objects * sizeof(InstanceData)).CpuAddress, instances.data(), objects * sizeof(InstanceData));
+		if(materials > 0)
+			std::memcpy(packed.Allocate(materials * sizeof(MaterialData)).CpuAddress, materialData.data(), materials * sizeof(MaterialData));
+
+		// A 256-byte constant buffer per object and per material.
+		MemoryUploadHeap slots(pageSize);
+		for(const InstanceData& instance : instances)
+			slots.AllocateConstants(instance);
+		for(const MaterialData& material : materialData)
+			slots.AllocateConstants(material);
+
+		const std::uint64_t packedBytes = objects * 64ull + materials * 32ull;
+		const std::uint64_t slotBytes = (objects + materials) * 256ull;
+		CHECK(packed.AllocatedBytes() == packedBytes);
+		CHECK(slots.AllocatedBytes() == slotBytes);
+
+		// SceneRenderer's PaddingBytesSaved for the same frame.
+		const std::uint64_t reported =
+			objects * (UploadHeap::ConstantBufferByteSize(sizeof(InstanceData)) - sizeof(InstanceData)) +
+			materials * (UploadHeap::ConstantBufferByteSize(sizeof(MaterialData)) - sizeof(MaterialData));
+		CHECK(slots.AllocatedBytes() - packed.AllocatedBytes() == reported);
+
+		// The pages behind them shrink with the bytes, up to a page of rounding.
+		CHECK(packed.ReservedBytes() <= slots.ReservedBytes());
+		CHECK(packed.ReservedBytes() <= packedBytes + 2 * pageSize);
+	}
+
+	void TestPackedBytes()
+	{
+		CheckPacking(0, 0);
+		CheckPacking(1, 1);
+		CheckPacking(7, 3);
+		CheckPacking(1000, 20);
+		CheckPacking(10000, 256);
+	}
+}
+
+int main()
+{
+	TestShaderLayout();
+	TestPackedBytes();
+
+	return TestResult("PackedConstantsTest");
+}
@@ -0,0 +1,81 @@
+//***************************************************************************************
+// ParallelRecorderBench.cpp
+//
+// Times recording a sorted draw stream into MemoryCommandRecorders through
+// ParallelRecorder, on one thread and on a JobSystem with 2..N threads, with one range
+// per thread.  Also reports what splitting costs in extra state commands.
+//
+// Usage: ParallelRecorderBench [threads]   (default: hardware threads)
+//***************************************************************************************
+
+#include "BenchTimer.h"
+#include "DrawStream.h"
+#include "../Common/JobSystem.h"
+#include "../Common/MemoryCommandRecorder.h"
+
+#include <cstdlib>
+#include <thread>
+
+namespace
+{
+	void BenchRecord(std::uint32_t groupCount, std::uint32_t threads)
+	{
+		DrawStream stream = MakeDrawStream(groupCount, 1 + groupCount / 50, 1);
+		DrawPassState pass;
+
+		std::printf("%u groups\n", groupCount);
+		for(std::uint32_t t = 1; t <= threads; t *= 2)
+		{
+			JobSystem jobs((int)t - 1);
+			ParallelRecorder recorder(t > 1 ? &jobs : nullptr);
+
+			std::vector<RecordRange> ranges;
+			ParallelRecorder::Partition(stream.Costs.data(), groupCount, t, 0, ranges);
+
+			std::vector<MemoryCommandRecorder> lists(ranges.size());
+			std::vector<CommandStateCache> caches(ranges.size());
+			std::vector<CommandRecorder*> ptrs;
+			for(MemoryCommandRecorder& list : lists)
+				ptrs.push_back(&list);
+
+			BenchResult result = RunBench(20, [&]()
+			{
+				// Cleared lists keep their capacity, as the app's allocators do.
+				for(MemoryCommandRecorder& list : lists)
+					list.Clear();
+
+				recorder.Record(ranges, ptrs.data(),
+					[&](std::uint32_t r, const RecordRange& range, CommandRecorder& target)
+					{
+						RecordDrawRange(stream, pass, range, target, caches[r]);
+					});
+			});
+
+			UINT draws = 0;
+			UINT stateChanges = 0;
+			size_t bytes = 0;
+			for(const MemoryCommandRecorder& list : lists)
+			{
+				draws += list.Stats().Draws;
+				stateChanges += list.Stats().StateChanges;
+				bytes += list.ByteSize();
+			}
+
+			char name[64];
+			std::snprintf(name, sizeof(name), "record, %u thread(s), %zu list(s)", t, ranges.size());
+			PrintBench(name, result);
+			std::printf("    %u draws, %u state changes, %zu bytes\n", draws, stateChanges, bytes);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::uint32_t threads = argc > 1 ? (std::uint32_t)std::atoi(argv[1]) : std::thread::hardware_concurrency();
+	if(threads == 0)
+		threads = 1;
+
+	BenchRecord(10000, threads);
+	BenchRecord(100000, threads);
+	return 0;
+}
@@ -0,0 +1,351 @@
+//***************************************************************************************
+// ParallelRecorderTest.cpp
+//
+// Checks Partition (full contiguous coverage, range count limits, balance) and that
+// recording a draw stream in ranges on several threads, then replaying the ranges in
+// order, draws exactly what one thread recording the whole stream draws, with the same
+// state bound at every draw.  Each range is a new command list, so the replay forgets
+// all bound state between ranges as the GPU would.  Also checks that Replay reproduces
+// a MemoryCommandRecorder stream byte for byte.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "DrawStream.h"
+#include "../Common/JobSystem.h"
+#include "../Common/MemoryCommandRecorder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// Everything a draw depends on, as bound when it was issued.
+	struct DrawRecord
+	{
+		std::uint64_t Pso;
+		std::uint64_t RootSignature;
+		std::uint64_t RootDescriptors[4];
+		std::uint64_t Constants[4];
+		std::uint64_t VertexBuffer;
+		std::uint64_t IndexBuffer;
+		std::uint64_t Topology;
+		std::uint64_t Viewport;
+		std::uint64_t RenderTarget;
+		std::uint64_t DepthStencil;
+		std::uint64_t Args[5];
+
+		bool operator==(const DrawRecord& rhs)const { return std::memcmp(this, &rhs, sizeof(DrawRecord)) == 0; }
+	};
+
+	// Tracks bound state like a command list and logs it at every draw.
+	class DrawLogRecorder : public CommandRecorder
+	{
+	public:
+		void BeginList() { mState = DrawRecord(); }
+		const std::vector<DrawRecord>& Draws()const { return mDraws; }
+
+		void SetPipelineState(ID3D12PipelineState* pso)override { mState.Pso = (std::uint64_t)pso; }
+		void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)override
+		{
+			mState.RootSignature = (std::uint64_t)rootSignature;
+			std::fill(std::begin(mState.RootDescriptors), std::end(mState.RootDescriptors), 0);
+			std::fill(std::begin(mState.Constants), std::end(mState.Constants), 0);
+		}
+		void SetGraphicsRootConstantBufferView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)override
+		{
+			mState.RootDescriptors[rootParameter] = address;
+		}
+		void SetGraphicsRootShaderResourceView(UINT rootParameter, D3D12_GPU_VIRTUAL_ADDRESS address)override
+		{
+			mState.RootDescriptors[rootParameter] = address;
+		}
+		void SetGraphicsRoot32BitConstants(UINT, UINT count, const void* data, UINT destOffset)override
+		{
+			const UINT* values = (const UINT*)data;
+			for(UINT i = 0; i < count; ++i)
+				mState.Constants[destOffset + i] = values[i];
+		}
+
+		void IASetVertexBuffer(const D3D12_VERTEX_BUFFER_VIEW& view)override { mState.VertexBuffer = view.BufferLocation; }
+		void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view)override { mState.IndexBuffer = view.BufferLocation; }
+		void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)override { mState.Topology = topology; }
+
+		void RSSetViewport(const D3D12_VIEWPORT& viewport)override { mState.Viewport = (std::uint64_t)viewport.Width; }
+		void RSSetScissorRect(const D3D12_RECT&)override {}
+		void OMSetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, D3D12_CPU_DESCRIPTOR_HANDLE depthStencil)override
+		{
+			mState.RenderTarget = renderTarget.ptr;
+			mState.DepthStencil = depthStencil.ptr;
+		}
+
+		void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)override
+		{
+			DrawRecord draw = mState;
+			draw.Args[0] = indexCount;
+			draw.Args[1] = instanceCount;
+			draw.Args[2] = startIndex;
+			draw.Args[3] = (std::uint64_t)(std::int64_t)baseVertex;
+			draw.Args[4] = startInstance;
+			mDraws.push_back(draw);
+		}
+
+		void ResourceBarrier(UINT, const D3D12_RESOURCE_BARRIER*)override {}
+		void ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE, const FLOAT[4])override {}
+		void ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_CLEAR_FLAGS, FLOAT, UINT8)override {}
+		void CopyBufferRegion(ID3D12Resource*, UINT64, ID3D12Resource*, UINT64, UINT64)override {}
+
+	private:
+		DrawRecord mState = {};
+		std::vector<DrawRecord> mDraws;
+	};
+
+	void CheckPartition(const std::vector<std::uint32_t>& costs, std::uint32_t maxRanges, std::uint32_t minCost)
+	{
+		std::vector<RecordRange> ranges;
+		ParallelRecorder::Partition(costs.data(), (std::uint32_t)costs.size(), maxRanges, minCost, ranges);
+
+		const std::uint32_t count = (std::uint32_t)costs.size();
+		if(count == 0)
+		{
+			CHECK(ranges.empty());
+			return;
+		}
+
+		std::uint64_t total = 0;
+		std::uint32_t maxCost = 0;
+		for(std::uint32_t cost : costs)
+		{
+			total += cost;
+			maxCost = std::max(maxCost, cost);
+		}
+
+		// The count Partition aims for.
+		std::uint64_t target = std::max(1u, maxRanges);
+		if(minCost > 0)
+			target = std::min<std::uint64_t>(target, std::max<std::uint64_t>(1, total / minCost));
+		target = std::min<std::uint64_t>(target, count);
+
+		CHECK(!ranges.empty());
+		CHECK(ranges.size() <= target);
+		CHECK(ranges.front().Begin == 0);
+		CHECK(ranges.back().End == count);
+		for(std::size_t r = 0; r < ranges.size(); ++r)
+		{
+			CHECK(ranges[r].Begin < ranges[r].End);
+			if(r > 0)
+				CHECK(ranges[r].Begin == ranges[r - 1].End);
+
+			// No range is more than one item over an equal share.
+			std::uint64_t cost = 0;
+			for(std::uint32_t i = ranges[r].Begin; i < ranges[r].End; ++i)
+				cost += costs[i];
+			CHECK(cost * target <= total + (std::uint64_t)maxCost * target);
+		}
+	}
+
+	void TestPartition()
+	{
+		std::mt19937 rng(7);
+		for(std::uint32_t count : { 0u, 1u, 2u, 5u, 100u, 1000u })
+		{
+			std::vector<std::uint32_t> uniform(count, 3);
+			std::vector<std::uint32_t> random(count);
+			std::vector<std::uint32_t> skewed(count, 1);
+			for(std::uint32_t& cost : random)
+				cost = rng() % 20;
+			if(count > 0)
+				skewed[count / 2] = 10 * count;
+
+			for(std::uint32_t maxRanges : { 0u, 1u, 2u, 3u, 8u, 64u })
+			{
+				for(std::uint32_t minCost : { 0u, 1u, 50u, 1000000u })
+				{
+					CheckPartition(uniform, maxRanges, minCost);
+					CheckPartition(random, maxRanges, minCost);
+					CheckPartition(skewed, maxRanges, minCost);
+				}
+			}
+		}
+
+		// Equal costs split into exactly the requested count, and a floor on the cost per
+		// range lowers it.
+		std::vector<std::uint32_t> costs(100, 1);
+		std::vector<RecordRange> ranges;
+		ParallelRecorder::Partition(costs.data(), 100, 4, 0, ranges);
+		CHECK(ranges.size() == 4);
+		for(const RecordRange& range : ranges)
+			CHECK(range.End - range.Begin == 25);
+
+		ParallelRecorder::Partition(costs.data(), 100, 8, 40, ranges);
+		CHECK(ranges.size() == 2);
+
+		ParallelRecorder::Partition(costs.data(), 100, 8, 1000, ranges);
+		CHECK(ranges.size() == 1);
+	}
+
+	std::vector<DrawRecord> ReplayLists(const std::vector<MemoryCommandRecorder>& lists)
+	{
+		DrawLogRecorder log;
+		for(const MemoryCommandRecorder& list : lists)
+		{
+			log.BeginList();
+			list.Replay(log);
+		}
+		return log.Draws();
+	}
+
+	void TestParallelRecord(std::uint32_t workerCount, std::uint32_t groupCount, std::uint32_t minCost)
+	{
+		DrawStream stream = MakeDrawStream(groupCount, 1 + groupCount / 20, groupCount);
+		DrawPassState pass;
+
+		// Reference: the whole stream in one list on this thread.
+		std::vector<MemoryCommandRecorder> single(1);
+		CommandStateCache singleCache;
+		RecordDrawRange(stream, pass, { 0, groupCount }, single[0], singleCache);
+		std::vector<DrawRecord> expected = ReplayLists(single);
+
+		// More ranges than threads, so threads take several ranges each.
+		JobSystem jobs((int)workerCount);
+		std::vector<RecordRange> ranges;
+		ParallelRecorder::Partition(stream.Costs.data(), groupCount, 3 * jobs.ThreadCount(), minCost, ranges);
+
+		auto recordAll = [&](ParallelRecorder& recorder, std::vector<MemoryCommandRecorder>& lists)
+		{
+			lists.assign(ranges.size(), MemoryCommandRecorder());
+			std::vector<CommandStateCache> caches(ranges.size());
+			std::vector<CommandRecorder*> ptrs;
+			for(MemoryCommandRecorder& list : lists)
+				ptrs.push_back(&list);
+
+			recorder.Record(ranges, ptrs.data(),
+				[&](std::uint32_t r, const RecordRange& range, CommandRecorder& target)
+				{
+					RecordDrawRange(stream, pass, range, target, caches[r]);
+				});
+		};
+
+		ParallelRecorder parallel(&jobs);
+		std::vector<MemoryCommandRecorder> parallelLists;
+		recordAll(parallel, parallelLists);
+
+		ParallelRecorder serial;
+		std::vector<MemoryCommandRecorder> serialLists;
+		recordAll(serial, serialLists);
+
+		// Same draws with the same state bound, in the same order.
+		std::vector<DrawRecord> actual = ReplayLists(parallelLists);
+		CHECK(actual.size() == expected.size());
+		CHECK(actual == expected);
+
+		// Whichever thread recorded a range, its commands are identical.
+		CHECK(parallelLists.size() == serialLists.size());
+		for(std::size_t r = 0; r < parallelLists.size() && r < serialLists.size(); ++r)
+			CHECK(parallelLists[r].Stream() == serialLists[r].Stream());
+
+		// Each list rebinds what its draws need, so splitting only adds state changes.  An
+		// empty stream records no lists at all.
+		UINT draws = 0;
+		UINT stateChanges = 0;
+		for(const MemoryCommandRecorder& list : parallelLists)
+		{
+			draws += list.Stats().Draws;
+			stateChanges += list.Stats().StateChanges;
+		}
+		CHECK(draws == single[0].Stats().Draws);
+		CHECK(ranges.empty() == (groupCount == 0));
+		if(!ranges.empty())
+			CHECK(stateChanges >= single[0].Stats().StateChanges);
+	}
+
+	void TestStateCache()
+	{
+		// Sorted by geometry, a range binds each vertex buffer once per run of a geometry.
+		DrawStream stream = MakeDrawStream(500, 20, 3);
+		DrawPassState pass;
+
+		MemoryCommandRecorder list;
+		CommandStateCache cache;
+		RecordDrawRange(stream, pass, { 100, 400 }, list, cache);
+
+		UINT geometryRuns = 0;
+		for(std::uint32_t i = 100; i < 400; ++i)
+		{
+			if(i == 100 || stream.Groups[i].Geometry != stream.Groups[i - 1].Geometry)
+				geometryRuns++;
+		}
+
+		const CommandStateStats& stats = cache.Stats();
+		CHECK(stats.VertexBuffers.Issued == geometryRuns);
+		CHECK(stats.IndexBuffers.Issued == geometryRuns);
+		CHECK(stats.Topologies.Issued == 1);
+		CHECK(stats.VertexBuffers.Issued + stats.VertexBuffers.Skipped == 300);
+		CHECK(stats.PipelineStates.Issued == 1);
+		CHECK(stats.RootDescriptors.Issued == 3);
+		CHECK(stats.Draws == list.Stats().Draws);
+
+		// The 3 viewport/scissor/target commands bypass the cache.
+		CHECK(list.Stats().StateChanges == stats.Issued() + 3);
+	}
+
+	void TestReplay()
+	{
+		MemoryCommandRecorder original;
+		DrawStream stream = MakeDrawStream(50, 5, 11);
+		CommandStateCache cache;
+		RecordDrawRange(stream, DrawPassState(), { 0, 50 }, original, cache);
+
+		// A barrier call longer than one stored command is split.
+		std::vector<D3D12_RESOURCE_BARRIER> barriers(150);
+		for(std::size_t i = 0; i < barriers.size(); ++i)
+		{
+			barriers[i] = {};
+			barriers[i].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+			barriers[i].Transition.pResource = reinterpret_cast<ID3D12Resource*>(0x100 + i);
+			barriers[i].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+			barriers[i].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+			barriers[i].Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
+		}
+		original.ResourceBarrier((UINT)barriers.size(), barriers.data());
+
+		const FLOAT color[4] = { 0.1f, 0.2f, 0.3f, 1.0f };
+		original.ClearRenderTargetView({ 1 }, color);
+		original.ClearDepthStencilView({ 2 }, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0);
+		original.CopyBufferRegion(reinterpret_cast<ID3D12Resource*>(0x10), 64,
+			reinterpret_cast<ID3D12Resource*>(0x20), 128, 4096);
+
+		MemoryCommandRecorder copy;
+		original.Replay(copy);
+
+		CHECK(copy.Stream() == original.Stream());
+		CHECK(copy.CommandCount() == original.CommandCount());
+		CHECK(copy.Stats().Draws == original.Stats().Draws);
+		CHECK(copy.Stats().StateChanges == original.Stats().StateChanges);
+		CHECK(copy.Stats().Barriers == 150);
+		CHECK(copy.Stats().Clears == 2);
+		CHECK(copy.Stats().Copies == 1);
+
+		original.Clear();
+		CHECK(original.ByteSize() == 0);
+		CHECK(original.CommandCount() == 0);
+	}
+}
+
+int main()
+{
+	TestPartition();
+
+	for(std::uint32_t workers : { 0u, 1u, 3u })
+	{
+		for(std::uint32_t groups : { 0u, 1u, 7u, 1000u })
+		{
+			TestParallelRecord(workers, groups, 0);
+			TestParallelRecord(workers, groups, 64);
+		}
+	}
+
+	TestStateCache();
+	TestReplay();
+
+	return TestResult("ParallelRecorderTest");
+}
@@ -0,0 +1,196 @@
+//***************************************************************************************
+// RenderQueueTest.cpp
+//
+// Checks RenderQueue's radix sort against std::stable_sort on the same (key, item)
+// pairs, including many equal keys, so the order of items with equal keys must match
+// too; that passes over bytes every key shares are skipped; that RenderSortKey::Make
+// puts each field in its bits and masks values wider than them; and that DepthBucket
+// never decreases with distance and clamps at both ends.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/RenderQueue.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Pushes the pairs, sorts, and compares with std::stable_sort by key.
+	void CheckSort(const std::vector<std::pair<std::uint64_t, std::uint32_t>>& pairs, std::uint32_t expectedPasses)
+	{
+		RenderQueue queue;
+		for(const auto& p : pairs)
+			queue.Push(p.first, p.second);
+		queue.Sort();
+
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> expected = pairs;
+		std::stable_sort(expected.begin(), expected.end(),
+			[](const auto& a, const auto& b) { return a.first < b.first; });
+
+		CHECK(queue.Size() == pairs.size());
+		CHECK(queue.Stats().Items == pairs.size());
+		CHECK(queue.Stats().SortPasses == expectedPasses);
+
+		bool same = true;
+		for(size_t i = 0; i < expected.size(); ++i)
+			same &= queue.Keys()[i] == expected[i].first && queue.Items()[i] == expected[i].second;
+		CHECK(same);
+	}
+
+	void TestStableOrder()
+	{
+		std::mt19937_64 rng(1);
+
+		// Full 64-bit keys: every byte differs somewhere, so all eight passes run.
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> pairs;
+		for(std::uint32_t i = 0; i < 5000; ++i)
+			pairs.push_back({ rng(), i });
+		CheckSort(pairs, 8);
+
+		// Few distinct keys spread over the whole word: long runs of equal keys keep
+		// their push order.
+		const std::uint64_t distinct[] = { 0x0123456789abcdefull, 0xfedcba9876543210ull, 0x0123456789abcdeeull, 0 };
+		pairs.clear();
+		for(std::uint32_t i = 0; i < 3000; ++i)
+			pairs.push_back({ distinct[rng() % 4], i });
+		CheckSort(pairs, 8);
+
+		// Made from scene-like fields.
+		pairs.clear();
+		for(std::uint32_t i = 0; i < 2000; ++i)
+		{
+			std::uint64_t key = RenderSortKey::Make((std::uint32_t)(rng() % 2), (std::uint32_t)(rng() % 3),
+				(std::uint32_t)(rng() % 20), (std::uint32_t)(rng() % 8), (std::uint32_t)(rng() % 65536));
+			pairs.push_back({ key, i });
+		}
+		RenderQueue queue;
+		for(const auto& p : pairs)
+			queue.Push(p.first, p.second);
+		queue.Sort();
+		CHECK(std::is_sorted(queue.Keys().begin(), queue.Keys().end()));
+	}
+
+	void TestSkippedPasses()
+	{
+		std::mt19937 rng(2);
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> pairs;
+
+		// Only the depth field varies: its two bytes are the only passes.
+		for(std::uint32_t i = 0; i < 1000; ++i)
+			pairs.push_back({ RenderSortKey::Make(1, 7, 3, 5, rng() % 65536), i });
+		CheckSort(pairs, 2);
+
+		// Depth varies only in its low byte.
+		pairs.clear();
+		for(std::uint32_t i = 0; i < 1000; ++i)
+			pairs.push_back({ RenderSortKey::Make(1, 7, 3, 5, rng() % 256), i });
+		CheckSort(pairs, 1);
+
+		// Geometry (bits 28..43) varies only in its low bits, depth in its low byte:
+		// bytes 3 and 0.
+		pairs.clear();
+		for(std::uint32_t i = 0; i < 1000; ++i)
+			pairs.push_back({ RenderSortKey::Make(0, 0, rng() % 16, 0, rng() % 256), i });
+		CheckSort(pairs, 2);
+
+		// Every key equal: nothing moves, and the push order stands.
+		pairs.clear();
+		for(std::uint32_t i = 0; i < 100; ++i)
+			pairs.push_back({ 42, i });
+		CheckSort(pairs, 0);
+
+		// Nothing, or a single item, is already sorted.
+		RenderQueue queue;
+		queue.Sort();
+		CHECK(queue.Stats().SortPasses == 0);
+		queue.Push(5, 9);
+		queue.Sort();
+		CHECK(queue.Stats().SortPasses == 0 && queue.Items()[0] == 9);
+
+		// Clear resets the items and the stats.
+		queue.Clear();
+		CHECK(queue.Size() == 0 && queue.Stats().Items == 0);
+	}
+
+	void TestMake()
+	{
+		using Key = RenderSortKey;
+		CHECK(Key::PipelineBits + Key::BufferBits + Key::GeometryBits + Key::MaterialBits + Key::DepthBits == 64);
+
+		// Each field lands in its own bits.
+		const std::uint32_t depthShift = 0;
+		const std::uint32_t materialShift = depthShift + Key::DepthBits;
+		const std::uint32_t geometryShift = materialShift + Key::MaterialBits;
+		const std::uint32_t bufferShift = geometryShift + Key::GeometryBits;
+		const std::uint32_t pipelineShift = bufferShift + Key::BufferBits;
+		CHECK(Key::Make(1, 0, 0, 0, 0) == 1ull << pipelineShift);
+		CHECK(Key::Make(0, 1, 0, 0, 0) == 1ull << bufferShift);
+		CHECK(Key::Make(0, 0, 1, 0, 0) == 1ull << geometryShift);
+		CHECK(Key::Make(0, 0, 0, 1, 0) == 1ull << materialShift);
+		CHECK(Key::Make(0, 0, 0, 0, 1) == 1ull);
+
+		// All ones fill the key exactly.
+		CHECK(Key::Make(~0u, ~0u, ~0u, ~0u, ~0u) == ~0ull);
+
+		// Values wider than a field are masked and never spill into the next field up.
+		CHECK(Key::Make(0, 0, 0, 0, 0x10000) == 0);
+		CHECK(Key::Make(0, 0, 0, 0x1000, 0) == 0);
+		CHECK(Key::Make(0, 0, 0x10000 | 3, 0, 0) == Key::Make(0, 0, 3, 0, 0));
+		CHECK(Key::Make(0, 0x1ffff, 0, 0, 0) == Key::Make(0, 0xffff, 0, 0, 0));
+		CHECK(Key::Make(0x13, 0, 0, 0, 0) == Key::Make(3, 0, 0, 0, 0));
+		CHECK(Key::Make(0, 0, 0, 0xfff, 0xffff) < Key::Make(0, 0, 1, 0, 0));
+
+		// More significant fields win regardless of the ones below them.
+		CHECK(Key::Make(0, 0xffff, 0xffff, 0xfff, 0xffff) < Key::Make(1, 0, 0, 0, 0));
+		CHECK(Key::Make(2, 3, 0xffff, 0xfff, 0xffff) < Key::Make(2, 4, 0, 0, 0));
+		CHECK(Key::Make(2, 3, 4, 0xfff, 0xffff) < Key::Make(2, 3, 5, 0, 0));
+		CHECK(Key::Make(2, 3, 4, 5, 0xffff) < Key::Make(2, 3, 4, 6, 0));
+	}
+
+	void TestDepthBucket()
+	{
+		const float farDistance = 1000.0f;
+		const std::uint32_t maxBucket = (1u << RenderSortKey::DepthBits) - 1;
+
+		// Never decreasing with distance, over a range finer than a bucket.
+		std::uint32_t previous = 0;
+		bool monotonic = true;
+		for(int i = 0; i <= 200000; ++i)
+		{
+			std::uint32_t bucket = RenderSortKey::DepthBucket(i * (farDistance / 200000.0f), farDistance);
+			monotonic &= bucket >= previous;
+			previous = bucket;
+		}
+		CHECK(monotonic);
+
+		// Clamped at both ends, and nearer is smaller.
+		CHECK(RenderSortKey::DepthBucket(0.0f, farDistance) == 0);
+		CHECK(RenderSortKey::DepthBucket(-5.0f, farDistance) == 0);
+		CHECK(RenderSortKey::DepthBucket(farDistance, farDistance) == maxBucket);
+		CHECK(RenderSortKey::DepthBucket(10.0f * farDistance, farDistance) == maxBucket);
+		CHECK(RenderSortKey::DepthBucket(1.0f, farDistance) < RenderSortKey::DepthBucket(2.0f, farDistance));
+
+		// Degenerate ranges and NaN do not produce garbage.
+		CHECK(RenderSortKey::DepthBucket(5.0f, 0.0f) == 0);
+		CHECK(RenderSortKey::DepthBucket(5.0f, -1.0f) == 0);
+		CHECK(RenderSortKey::DepthBucket(std::nanf(""), farDistance) == 0);
+
+		// Distance order survives into the key for items that share all state.
+		CHECK(RenderSortKey::Make(1, 2, 3, 4, RenderSortKey::DepthBucket(10.0f, farDistance)) <
+			RenderSortKey::Make(1, 2, 3, 4, RenderSortKey::DepthBucket(11.0f, farDistance)));
+	}
+}
+
+int main()
+{
+	TestStableOrder();
+	TestSkippedPasses();
+	TestMake();
+	TestDepthBucket();
+
+	return TestResult("RenderQueueTest");
+}
@@ -0,0 +1,209 @@
+//***************************************************************************************
+// SceneStoreBench.cpp
+//
+// Compares the per-frame passes over SceneStore with the same passes over the layout
+// it replaced: a vector of individually allocated RenderItems, each holding its world
+// matrix, bounds and draw data together.  The old items get the bounds fields the
+// culling pass needs so both layouts do the same work.
+//
+// Two passes are timed separately: moving every object (world matrix plus world
+// bounds), and culling the spheres against a box of six planes while packing the
+// transposed world and material of the visible objects into an instance array.  The old layout is run in allocation order
+// and in shuffled order, as after sorting items by material.
+//***************************************************************************************
+
+#include "BenchTimer.h"
+#include "../Common/SceneStore.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+using namespace DirectX;
+
+namespace
+{
+	// RenderItem before SceneStore, plus bounds.
+	struct OldRenderItem
+	{
+		std::uint32_t ObjCBIndex = 0;
+		int NumFramesDirty = 3;
+		XMFLOAT4X4 World;
+		int PrimitiveType = 4;
+		void* Geo = nullptr;
+		void* Mat = nullptr;
+		std::uint32_t MaterialId = 0;
+		std::uint32_t IndexCount = 0;
+		std::uint32_t StartIndexLocation = 0;
+		int BaseVertexLocation = 0;
+		BoundingBox LocalBounds;
+		BoundingBox WorldBounds;
+		BoundingSphere LocalSphere;
+		BoundingSphere WorldSphere;
+	};
+
+	struct PackedInstance
+	{
+		XMFLOAT4X4 World;
+		std::uint32_t MaterialIndex;
+	};
+
+	const XMFLOAT4 gPlanes[6] =
+	{
+		XMFLOAT4(1.0f, 0.0f, 0.0f, 50.0f), XMFLOAT4(-1.0f, 0.0f, 0.0f, 50.0f),
+		XMFLOAT4(0.0f, 1.0f, 0.0f, 50.0f), XMFLOAT4(0.0f, -1.0f, 0.0f, 50.0f),
+		XMFLOAT4(0.0f, 0.0f, 1.0f, 50.0f), XMFLOAT4(0.0f, 0.0f, -1.0f, 50.0f),
+	};
+
+	bool Visible(const BoundingSphere& sphere)
+	{
+		for(const XMFLOAT4& p : gPlanes)
+		{
+			if(sphere.Center.x * p.x + sphere.Center.y * p.y + sphere.Center.z * p.z + p.w < -sphere.Radius)
+				return false;
+		}
+		return true;
+	}
+
+	XMFLOAT4X4 WorldAt(const XMFLOAT3& pos, float t)
+	{
+		XMFLOAT4X4 world;
+		XMStoreFloat4x4(&world, XMMatrixTranslation(pos.x + t, pos.y, pos.z));
+		return world;
+	}
+
+	double Checksum(const std::vector<PackedInstance>& instances)
+	{
+		double sum = 0.0;
+		for(const PackedInstance& instance : instances)
+			sum += instance.World._14 + instance.World._24 + instance.World._34 + instance.MaterialIndex;
+		return sum;
+	}
+
+	void MoveSoA(SceneStore& scene, const std::vector<SceneStore::Handle>& handles,
+		const std::vector<XMFLOAT3>& positions, float t)
+	{
+		for(std::size_t i = 0; i < handles.size(); ++i)
+			scene.SetWorld(handles[i], WorldAt(positions[i], t));
+	}
+
+	double CullSoA(const SceneStore& scene, std::vector<PackedInstance>& out)
+	{
+		out.clear();
+		const BoundingSphere* spheres = scene.WorldSpheres();
+		const XMFLOAT4X4* worlds = scene.World();
+		const std::uint32_t* materials = scene.MaterialIds();
+		for(std::uint32_t i = 0; i < scene.Size(); ++i)
+		{
+			if(!Visible(spheres[i]))
+				continue;
+
+			PackedInstance instance;
+			XMStoreFloat4x4(&instance.World, XMMatrixTranspose(XMLoadFloat4x4(&worlds[i])));
+			instance.MaterialIndex = materials[i];
+			out.push_back(instance);
+		}
+
+		return Checksum(out);
+	}
+
+	void MoveAoS(const std::vector<OldRenderItem*>& items, const std::vector<XMFLOAT3>& positions, float t)
+	{
+		for(OldRenderItem* item : items)
+		{
+			item->World = WorldAt(positions[item->ObjCBIndex], t);
+
+			XMMATRIX world = XMLoadFloat4x4(&item->World);
+			item->LocalBounds.Transform(item->WorldBounds, world);
+			item->LocalSphere.Transform(item->WorldSphere, world);
+			item->NumFramesDirty = 3;
+		}
+	}
+
+	double CullAoS(const std::vector<OldRenderItem*>& items, std::vector<PackedInstance>& out)
+	{
+		out.clear();
+		for(const OldRenderItem* item : items)
+		{
+			if(!Visible(item->WorldSphere))
+				continue;
+
+			PackedInstance instance;
+			XMStoreFloat4x4(&instance.World, XMMatrixTranspose(XMLoadFloat4x4(&item->World)));
+			instance.MaterialIndex = item->MaterialId;
+			out.push_back(instance);
+		}
+
+		return Checksum(out);
+	}
+
+	void Compare(std::uint32_t objectCount)
+	{
+		const int runs = 15;
+
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+
+		std::vector<XMFLOAT3> positions(objectCount);
+		for(XMFLOAT3& p : positions)
+			p = XMFLOAT3(coord(rng), coord(rng), coord(rng));
+
+		const BoundingBox localBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+		BoundingSphere localSphere;
+		BoundingSphere::CreateFromBoundingBox(localSphere, localBox);
+
+		SceneStore scene;
+		std::vector<SceneStore::Handle> handles;
+		std::vector<std::unique_ptr<OldRenderItem>> owned;
+		for(std::uint32_t i = 0; i < objectCount; ++i)
+		{
+			handles.push_back(scene.Add(WorldAt(positions[i], 0.0f), localBox, localSphere, i % 5, i % 7));
+
+			auto item = std::make_unique<OldRenderItem>();
+			item->ObjCBIndex = i;
+			item->MaterialId = i % 7;
+			item->LocalBounds = localBox;
+			item->LocalSphere = localSphere;
+			owned.push_back(std::move(item));
+		}
+
+		std::vector<OldRenderItem*> items;
+		for(auto& item : owned)
+			items.push_back(item.get());
+
+		std::vector<OldRenderItem*> shuffled = items;
+		std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+		std::vector<PackedInstance> out;
+		out.reserve(objectCount);
+
+		const float t = 0.5f;
+		double soaSum = 0.0, aosSum = 0.0, shuffledSum = 0.0;
+
+		BenchResult soaMove = RunBench(runs, [&]() { MoveSoA(scene, handles, positions, t); });
+		BenchResult soaCull = RunBench(runs, [&]() { soaSum = CullSoA(scene, out); });
+		std::size_t visible = out.size();
+
+		BenchResult aosMove = RunBench(runs, [&]() { MoveAoS(items, positions, t); });
+		BenchResult aosCull = RunBench(runs, [&]() { aosSum = CullAoS(items, out); });
+
+		BenchResult shuffledMove = RunBench(runs, [&]() { MoveAoS(shuffled, positions, t); });
+		BenchResult shuffledCull = RunBench(runs, [&]() { shuffledSum = CullAoS(shuffled, out); });
+
+		std::printf("%u objects, %zu visible (checksums %s)\n", objectCount, visible,
+			soaSum == aosSum && soaSum == shuffledSum ? "match" : "DIFFER");
+		PrintBench("move: SceneStore (SoA)", soaMove);
+		PrintBench("move: RenderItem pointers", aosMove);
+		PrintBench("move: RenderItem pointers, shuffled", shuffledMove);
+		PrintBench("cull+pack: SceneStore (SoA)", soaCull);
+		PrintBench("cull+pack: RenderItem pointers", aosCull);
+		PrintBench("cull+pack: RenderItem pointers, shuf.", shuffledCull);
+	}
+}
+
+int main()
+{
+	Compare(10000);
+	Compare(100000);
+	return 0;
+}
@@ -0,0 +1,177 @@
+//***************************************************************************************
+// ScratchArenaTest.cpp
+//
+// Checks ScratchArena's alignment, the rewind of its newest allocation, the block of
+// its own that oversized requests get, and the stats it reports (which the sample
+// logs after loading), against an upstream resource that counts what it hands out.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/ScratchArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	class CountingResource : public std::pmr::memory_resource
+	{
+	public:
+		int Outstanding = 0;
+		std::size_t OutstandingBytes = 0;
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment)override
+		{
+			Outstanding++;
+			OutstandingBytes += bytes;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)override
+		{
+			Outstanding--;
+			OutstandingBytes -= bytes;
+			std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other)const noexcept override { return this == &other; }
+	};
+
+	bool IsAligned(const void* p, std::size_t alignment)
+	{
+		return (reinterpret_cast<std::uintptr_t>(p) & (alignment - 1)) == 0;
+	}
+
+	void TestAlignment()
+	{
+		CountingResource upstream;
+		ScratchArena arena(4096, &upstream);
+
+		for(std::size_t alignment = 1; alignment <= 256; alignment *= 2)
+		{
+			// An odd-sized allocation first, so the cursor is misaligned for the next one.
+			(void)arena.allocate(3, 1);
+			void* p = arena.allocate(40, alignment);
+			CHECK(IsAligned(p, alignment));
+		}
+
+		// Padding is counted as in use.
+		const std::uint64_t before = arena.Stats().BytesInUse;
+		(void)arena.allocate(1, 1);
+		(void)arena.allocate(8, 64);
+		CHECK(arena.Stats().BytesInUse >= before + 1 + 8);
+		CHECK(arena.Stats().BytesInUse <= before + 1 + 8 + 63);
+	}
+
+	void TestRewind()
+	{
+		CountingResource upstream;
+		ScratchArena arena(4096, &upstream);
+
+		void* a = arena.allocate(5, 1);
+		const std::uint64_t afterA = arena.Stats().BytesInUse;
+
+		// Freeing the newest allocation gives back exactly what it took, padding included,
+		// so repeating the pair never moves BytesInUse or PeakBytes.
+		void* b = arena.allocate(100, 64);
+		const std::uint64_t peak = arena.Stats().PeakBytes;
+		for(int i = 0; i < 100; ++i)
+		{
+			arena.deallocate(b, 100, 64);
+			CHECK(arena.Stats().BytesInUse == afterA);
+
+			void* again = arena.allocate(100, 64);
+			CHECK(again == b);
+			b = again;
+		}
+		CHECK(arena.Stats().PeakBytes == peak);
+
+		// Only the newest allocation rewinds; freeing an older one is counted and ignored.
+		arena.deallocate(b, 100, 64);
+		void* c = arena.allocate(16, 16);
+		arena.deallocate(a, 5, 1);
+		CHECK(arena.Stats().BytesInUse > afterA);
+		void* d = arena.allocate(16, 16);
+		CHECK(d != c);
+		CHECK(arena.Stats().Deallocations == 102);
+
+		// A second free of the same pointer does not rewind twice.
+		arena.deallocate(d, 16, 16);
+		const std::uint64_t inUse = arena.Stats().BytesInUse;
+		arena.deallocate(d, 16, 16);
+		CHECK(arena.Stats().BytesInUse == inUse);
+	}
+
+	void TestOversized()
+	{
+		CountingResource upstream;
+		ScratchArena arena(4096, &upstream);
+
+		(void)arena.allocate(64, 16);
+		CHECK(arena.Stats().Blocks == 1);
+
+		// Larger than a block: it gets a block of its own, sized to fit with its alignment.
+		void* big = arena.allocate(10000, 256);
+		CHECK(IsAligned(big, 256));
+		CHECK(arena.Stats().Blocks == 2);
+		CHECK(arena.Stats().ReservedBytes >= 4096 + 10000);
+		CHECK(upstream.Outstanding == 2);
+		CHECK(upstream.OutstandingBytes == arena.Stats().ReservedBytes);
+
+		// The whole range is usable, and the big block can still be rewound.
+		std::fill((char*)big, (char*)big + 10000, 0x5a);
+		const std::uint64_t inUse = arena.Stats().BytesInUse;
+		arena.deallocate(big, 10000, 256);
+		CHECK(arena.Stats().BytesInUse < inUse);
+
+		// pmr containers draw from it like any other resource.
+		std::pmr::vector<int> values(&arena);
+		for(int i = 0; i < 5000; ++i)
+			values.push_back(i);
+		CHECK(values[4999] == 4999);
+	}
+
+	void TestReset()
+	{
+		CountingResource upstream;
+		ScratchArena arena(4096, &upstream);
+
+		for(int i = 0; i < 10; ++i)
+			(void)arena.allocate(1000, 8);
+		const ScratchArenaStats before = arena.Stats();
+		CHECK(before.Allocations == 10);
+		CHECK(before.Blocks >= 3);
+		CHECK(before.PeakBytes == before.BytesInUse);
+
+		arena.Reset();
+		const ScratchArenaStats& after = arena.Stats();
+		CHECK(after.BytesInUse == 0);
+		CHECK(after.ReservedBytes == 0);
+		CHECK(after.Blocks == 0);
+		CHECK(after.Resets == 1);
+		CHECK(upstream.Outstanding == 0);
+
+		// Peaks and counts are kept across Reset for the log.
+		CHECK(after.PeakBytes == before.PeakBytes);
+		CHECK(after.PeakReservedBytes == before.PeakReservedBytes);
+		CHECK(after.Allocations == 10);
+
+		// The arena is usable again after Reset.
+		void* p = arena.allocate(32, 32);
+		CHECK(IsAligned(p, 32));
+		CHECK(arena.Stats().BytesInUse >= 32);
+		CHECK(arena.Stats().Allocations == 11);
+	}
+}
+
+int main()
+{
+	TestAlignment();
+	TestRewind();
+	TestOversized();
+	TestReset();
+
+	return TestResult("ScratchArenaTest");
+}
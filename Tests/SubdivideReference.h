@@ -0,0 +1,79 @@
+//***************************************************************************************
+// SubdivideReference.h
+//
+// The original GeometryGenerator::Subdivide, which emits all six vertices of every
+// split triangle and so duplicates each shared edge midpoint.  Kept as the reference
+// for the test and the benchmark of the edge-sharing version.
+//***************************************************************************************
+
+#pragma once
+
+#include "../Common/GeometryGenerator.h"
+
+#include <vector>
+
+namespace SubdivideReference
+{
+	using Vertex = GeometryGenerator::Vertex;
+
+	inline Vertex MidPoint(const Vertex& v0, const Vertex& v1)
+	{
+		using namespace DirectX;
+
+		XMVECTOR p0 = XMLoadFloat3(&v0.Position);
+		XMVECTOR p1 = XMLoadFloat3(&v1.Position);
+
+		XMVECTOR n0 = XMLoadFloat3(&v0.Normal);
+		XMVECTOR n1 = XMLoadFloat3(&v1.Normal);
+
+		XMVECTOR tan0 = XMLoadFloat3(&v0.TangentU);
+		XMVECTOR tan1 = XMLoadFloat3(&v1.TangentU);
+
+		XMVECTOR tex0 = XMLoadFloat2(&v0.TexC);
+		XMVECTOR tex1 = XMLoadFloat2(&v1.TexC);
+
+		XMVECTOR pos = 0.5f*(p0 + p1);
+		XMVECTOR normal = XMVector3Normalize(0.5f*(n0 + n1));
+		XMVECTOR tangent = XMVector3Normalize(0.5f*(tan0+tan1));
+		XMVECTOR tex = 0.5f*(tex0 + tex1);
+
+		Vertex v;
+		XMStoreFloat3(&v.Position, pos);
+		XMStoreFloat3(&v.Normal, normal);
+		XMStoreFloat3(&v.TangentU, tangent);
+		XMStoreFloat2(&v.TexC, tex);
+
+		return v;
+	}
+
+	inline void Subdivide(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices)
+	{
+		std::vector<Vertex> inputVertices;
+		std::vector<std::uint32_t> inputIndices;
+		inputVertices.swap(vertices);
+		inputIndices.swap(indices);
+
+		std::uint32_t numTris = (std::uint32_t)inputIndices.size()/3;
+		for(std::uint32_t i = 0; i < numTris; ++i)
+		{
+			Vertex v0 = inputVertices[ inputIndices[i*3+0] ];
+			Vertex v1 = inputVertices[ inputIndices[i*3+1] ];
+			Vertex v2 = inputVertices[ inputIndices[i*3+2] ];
+
+			Vertex m0 = MidPoint(v0, v1);
+			Vertex m1 = MidPoint(v1, v2);
+			Vertex m2 = MidPoint(v0, v2);
+
+			vertices.push_back(v0); // 0
+			vertices.push_back(v1); // 1
+			vertices.push_back(v2); // 2
+			vertices.push_back(m0); // 3
+			vertices.push_back(m1); // 4
+			vertices.push_back(m2); // 5
+
+			const std::uint32_t local[12] = { 0, 3, 5,  3, 4, 5,  5, 4, 2,  3, 1, 4 };
+			for(std::uint32_t k : local)
+				indices.push_back(i*6 + k);
+		}
+	}
+}
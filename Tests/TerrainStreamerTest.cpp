@@ -0,0 +1,237 @@
+//***************************************************************************************
+// TerrainStreamerTest.cpp
+//
+// Drives TerrainStreamer along a simulated camera path and checks every Update against
+// an independent model of what should be resident: loads stay within the load radius,
+// nearest first and capped per Update; evictions happen only beyond the evict radius;
+// the resident set and the stats agree with the loads and evictions reported.  Also
+// checks that the gap between the radii stops a viewer moving back and forth over a
+// boundary from loading and evicting the same chunks, and that chunk bounds cover
+// their vertices.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/TerrainStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+using namespace DirectX;
+
+namespace
+{
+	const float ChunkSize = 16.0f;
+	const std::uint32_t QuadsPerSide = 4;
+	const float LoadRadius = 40.0f;
+	const float EvictRadius = 56.0f;
+	const std::uint32_t MaxLoads = 4;
+
+	// Distance in the xz-plane from p to the chunk's square, as the header defines it.
+	float ChunkDistance(TerrainChunkCoord coord, const XMFLOAT3& p)
+	{
+		float minX = coord.X * ChunkSize, minZ = coord.Z * ChunkSize;
+		float dx = std::max(std::max(minX - p.x, p.x - (minX + ChunkSize)), 0.0f);
+		float dz = std::max(std::max(minZ - p.z, p.z - (minZ + ChunkSize)), 0.0f);
+		return std::sqrt(dx * dx + dz * dz);
+	}
+
+	// Chunks within radius of p that are not in resident.
+	std::vector<float> MissingDistances(const std::unordered_set<std::uint64_t>& resident, const XMFLOAT3& p, float radius)
+	{
+		std::vector<float> distances;
+		const int reach = (int)std::ceil(radius / ChunkSize) + 1;
+		const int cx = (int)std::floor(p.x / ChunkSize), cz = (int)std::floor(p.z / ChunkSize);
+		for(int z = cz - reach; z <= cz + reach; ++z)
+		{
+			for(int x = cx - reach; x <= cx + reach; ++x)
+			{
+				TerrainChunkCoord coord = { x, z };
+				float d = ChunkDistance(coord, p);
+				if(d <= radius && resident.count(TerrainStreamer::Key(coord)) == 0)
+					distances.push_back(d);
+			}
+		}
+		return distances;
+	}
+
+	// Runs one Update and checks it against the model; resident is the model's set.
+	void CheckedUpdate(TerrainStreamer& streamer, std::unordered_set<std::uint64_t>& resident, const XMFLOAT3& p)
+	{
+		streamer.Update(p);
+
+		for(TerrainChunkCoord coord : streamer.Evicted())
+		{
+			CHECK(ChunkDistance(coord, p) > EvictRadius);
+			CHECK(resident.erase(TerrainStreamer::Key(coord)) == 1);
+			CHECK(streamer.Find(coord) == nullptr);
+		}
+
+		// Nothing within the evict radius may go, and nothing beyond it may stay.
+		for(std::uint64_t key : resident)
+		{
+			TerrainChunkCoord coord = { (std::int32_t)(key >> 32), (std::int32_t)(std::uint32_t)key };
+			CHECK(ChunkDistance(coord, p) <= EvictRadius);
+			CHECK(streamer.Find(coord) != nullptr);
+		}
+
+		const std::vector<const TerrainChunk*>& loaded = streamer.Loaded();
+		CHECK(loaded.size() <= MaxLoads);
+
+		float previous = 0.0f;
+		for(const TerrainChunk* chunk : loaded)
+		{
+			float d = ChunkDistance(chunk->Coord, p);
+			CHECK(d <= LoadRadius);
+			CHECK(d >= previous);
+			previous = d;
+
+			CHECK(resident.insert(TerrainStreamer::Key(chunk->Coord)).second);
+			CHECK(streamer.Find(chunk->Coord) == chunk);
+			CHECK(chunk->Vertices.size() == streamer.VerticesPerChunk());
+		}
+
+		// Whatever is still missing is no nearer than what was loaded, and is only left
+		// because the cap was reached.
+		std::vector<float> missing = MissingDistances(resident, p, LoadRadius);
+		if(!missing.empty())
+		{
+			CHECK(loaded.size() == MaxLoads);
+			CHECK(*std::min_element(missing.begin(), missing.end()) >= previous);
+		}
+
+		const TerrainStreamStats& stats = streamer.Stats();
+		CHECK(stats.Resident == resident.size());
+		CHECK(stats.Loaded == loaded.size());
+		CHECK(stats.Evicted == streamer.Evicted().size());
+		CHECK(stats.Resident <= streamer.MaxResidentChunks());
+		CHECK(stats.PeakResident >= stats.Resident);
+		CHECK(stats.ResidentBytes == (std::uint64_t)stats.Resident * streamer.VerticesPerChunk() * sizeof(GeometryGenerator::Vertex));
+	}
+
+	void TestCameraPath()
+	{
+		TerrainStreamer streamer(ChunkSize, QuadsPerSide, LoadRadius, EvictRadius, MaxLoads);
+		std::unordered_set<std::uint64_t> resident;
+
+		// Out along a diagonal, round a circle, and back through the origin, including
+		// negative coordinates and a fast jump that needs several Updates to fill in.
+		std::vector<XMFLOAT3> path;
+		for(int i = 0; i <= 60; ++i)
+			path.push_back(XMFLOAT3(i * 3.0f, 10.0f, i * 2.0f));
+		for(int i = 0; i <= 90; ++i)
+		{
+			float angle = i * (XM_2PI / 90.0f);
+			path.push_back(XMFLOAT3(180.0f * std::cos(angle), 10.0f, 120.0f + 180.0f * std::sin(angle)));
+		}
+		for(int i = 0; i <= 60; ++i)
+			path.push_back(XMFLOAT3(180.0f - i * 6.0f, 10.0f, 120.0f - i * 6.0f));
+		path.push_back(XMFLOAT3(-1000.0f, 10.0f, 500.0f));
+		for(int i = 0; i < 10; ++i)
+			path.push_back(path.back());
+
+		for(const XMFLOAT3& p : path)
+			CheckedUpdate(streamer, resident, p);
+
+		const TerrainStreamStats& stats = streamer.Stats();
+		CHECK(stats.TotalLoaded - stats.TotalEvicted == stats.Resident);
+		CHECK(stats.TotalEvicted > 0);
+
+		// After the jump the viewer stood still long enough to fill the load radius.
+		CHECK(MissingDistances(resident, path.back(), LoadRadius).empty());
+		CHECK(stats.Loaded == 0);
+	}
+
+	void TestConvergence()
+	{
+		TerrainStreamer streamer(ChunkSize, QuadsPerSide, LoadRadius, EvictRadius, MaxLoads);
+		std::unordered_set<std::uint64_t> resident;
+
+		// A standing viewer fills its load radius MaxLoads chunks per Update.
+		const XMFLOAT3 p(5.0f, 0.0f, -7.0f);
+		const size_t inRange = MissingDistances(resident, p, LoadRadius).size();
+
+		int updates = 0;
+		do
+		{
+			CheckedUpdate(streamer, resident, p);
+			++updates;
+		} while(!streamer.Loaded().empty());
+
+		CHECK(resident.size() == inRange);
+		// Full Updates, a partial one, then one that finds nothing left to load.
+		CHECK(updates == (int)((inRange + MaxLoads - 1) / MaxLoads) + 1);
+	}
+
+	// Oscillates the viewer by amplitude along x and returns the chunks loaded and
+	// evicted after the first few Updates.
+	std::uint64_t OscillationTraffic(float evictRadius, float amplitude)
+	{
+		TerrainStreamer streamer(ChunkSize, QuadsPerSide, LoadRadius, evictRadius, 64);
+
+		for(int i = 0; i < 4; ++i)
+			streamer.Update(XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+		const std::uint64_t before = streamer.Stats().TotalLoaded + streamer.Stats().TotalEvicted;
+		for(int i = 0; i < 20; ++i)
+			streamer.Update(XMFLOAT3((i & 1) ? amplitude : 0.0f, 0.0f, 0.0f));
+		return streamer.Stats().TotalLoaded + streamer.Stats().TotalEvicted - before;
+	}
+
+	void TestHysteresis()
+	{
+		// With equal radii, moving back and forth across a chunk boundary reloads and
+		// evicts the edge chunks on every step.
+		CHECK(OscillationTraffic(LoadRadius, 10.0f) >= 20);
+
+		// With the evict radius further out by more than the step, the first move
+		// loads the new edge chunks and nothing happens after that.
+		CHECK(OscillationTraffic(EvictRadius, 10.0f) < OscillationTraffic(LoadRadius, 10.0f));
+
+		TerrainStreamer streamer(ChunkSize, QuadsPerSide, LoadRadius, EvictRadius, 64);
+		streamer.Update(XMFLOAT3(0.0f, 0.0f, 0.0f));
+		streamer.Update(XMFLOAT3(10.0f, 0.0f, 0.0f));
+		const std::uint64_t settled = streamer.Stats().TotalLoaded + streamer.Stats().TotalEvicted;
+		for(int i = 0; i < 20; ++i)
+			streamer.Update(XMFLOAT3((i & 1) ? 10.0f : 0.0f, 0.0f, 0.0f));
+		CHECK(streamer.Stats().TotalLoaded + streamer.Stats().TotalEvicted == settled);
+		CHECK(streamer.Stats().TotalEvicted == 0);
+
+		// An evict radius below the load radius is raised to it.
+		CHECK(OscillationTraffic(LoadRadius - 20.0f, 10.0f) == OscillationTraffic(LoadRadius, 10.0f));
+	}
+
+	void TestBounds()
+	{
+		TerrainStreamer streamer(ChunkSize, QuadsPerSide, LoadRadius, EvictRadius, 64);
+		streamer.Update(XMFLOAT3(-20.0f, 0.0f, 33.0f));
+		CHECK(!streamer.Loaded().empty());
+
+		for(const TerrainChunk* chunk : streamer.Loaded())
+		{
+			const BoundingBox& box = chunk->Bounds;
+			for(const GeometryGenerator::Vertex& v : chunk->Vertices)
+			{
+				CHECK(std::fabs(v.Position.x - box.Center.x) <= box.Extents.x + 1e-4f);
+				CHECK(std::fabs(v.Position.y - box.Center.y) <= box.Extents.y + 1e-4f);
+				CHECK(std::fabs(v.Position.z - box.Center.z) <= box.Extents.z + 1e-4f);
+			}
+
+			// The box is exactly the chunk's square.
+			CHECK(std::fabs(box.Center.x - (chunk->Coord.X + 0.5f) * ChunkSize) < 1e-4f);
+			CHECK(std::fabs(box.Center.z - (chunk->Coord.Z + 0.5f) * ChunkSize) < 1e-4f);
+			CHECK(std::fabs(box.Extents.x - 0.5f * ChunkSize) < 1e-4f);
+			CHECK(std::fabs(box.Extents.z - 0.5f * ChunkSize) < 1e-4f);
+		}
+	}
+}
+
+int main()
+{
+	TestCameraPath();
+	TestConvergence();
+	TestHysteresis();
+	TestBounds();
+
+	return TestResult("TerrainStreamerTest");
+}
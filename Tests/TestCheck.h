@@ -0,0 +1,37 @@
+//***************************************************************************************
+// TestCheck.h
+//
+// Minimal checks for the CPU-only tests.  A failed CHECK prints the expression and
+// keeps going so one run reports every failure; main returns TestResult(), which is
+// non-zero if anything failed.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdio>
+
+inline int& TestFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+#define CHECK(expr)                                                                 \
+	do                                                                              \
+	{                                                                               \
+		if(!(expr))                                                                 \
+		{                                                                           \
+			std::fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+			TestFailures()++;                                                       \
+		}                                                                           \
+	} while(0)
+
+inline int TestResult(const char* name)
+{
+	if(TestFailures() == 0)
+		std::printf("%s: passed\n", name);
+	else
+		std::printf("%s: %d checks failed\n", name, TestFailures());
+
+	return TestFailures() == 0 ? 0 : 1;
+}
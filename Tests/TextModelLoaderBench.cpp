@@ -0,0 +1,77 @@
+//***************************************************************************************
+// TextModelLoaderBench.cpp
+//
+// Times the SSE2/from_chars text model loader against the std::ifstream reference
+// parser on Models/skull.txt.
+//***************************************************************************************
+
+#include "BenchTimer.h"
+#include "../Common/TextModelLoader.h"
+
+#include <string>
+
+namespace
+{
+	struct Float3
+	{
+		float x, y, z;
+	};
+
+	struct ModelVertex
+	{
+		Float3 Pos;
+		Float3 Normal;
+	};
+
+	double Checksum(const std::vector<ModelVertex>& vertices, const std::vector<std::uint32_t>& indices)
+	{
+		double sum = 0.0;
+		for(const ModelVertex& v : vertices)
+			sum += v.Pos.x + v.Pos.y + v.Pos.z + v.Normal.x + v.Normal.y + v.Normal.z;
+		for(std::uint32_t i : indices)
+			sum += i;
+		return sum;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::string name = argc > 1 ? argv[1] : std::string(MODELS_DIR) + "/skull.txt";
+	const std::wstring path(name.begin(), name.end());
+	const int runs = 10;
+
+	std::vector<ModelVertex> vertices;
+	std::vector<std::uint32_t> indices;
+	if(!TextModelLoader::Load(path, vertices, indices))
+	{
+		std::printf("cannot load %s\n", name.c_str());
+		return 1;
+	}
+
+	std::ifstream file(name, std::ios::binary | std::ios::ate);
+	const double megabytes = (double)file.tellg() / (1024.0 * 1024.0);
+
+	std::printf("%s: %zu vertices, %zu triangles, %.2f MB\n", name.c_str(), vertices.size(), indices.size() / 3, megabytes);
+
+	double fastSum = 0.0;
+	BenchResult fast = RunBench(runs, [&]()
+	{
+		TextModelLoader::Load(path, vertices, indices);
+		fastSum = Checksum(vertices, indices);
+	});
+
+	double streamSum = 0.0;
+	BenchResult stream = RunBench(runs, [&]()
+	{
+		TextModelLoader::LoadWithStreams(path, vertices, indices);
+		streamSum = Checksum(vertices, indices);
+	});
+
+	PrintBench("TextModelLoader::Load", fast);
+	PrintBench("TextModelLoader::LoadWithStreams", stream);
+	std::printf("  throughput %.1f MB/s vs %.1f MB/s, %.1fx faster (checksums %s)\n",
+		megabytes / (fast.MedianMs / 1000.0), megabytes / (stream.MedianMs / 1000.0),
+		stream.MedianMs / fast.MedianMs, fastSum == streamSum ? "match" : "DIFFER");
+
+	return fastSum == streamSum ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+//***************************************************************************************
+// TextModelLoaderTest.cpp
+//
+// Checks the fast text model loader against the stream reference parser on the
+// shipped models, and that both reject bad input.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/TextModelLoader.h"
+
+#include <cstring>
+#include <string>
+
+namespace
+{
+	struct Float3
+	{
+		float x, y, z;
+	};
+
+	struct ModelVertex
+	{
+		Float3 Pos;
+		Float3 Normal;
+	};
+
+	std::wstring ModelPath(const char* name)
+	{
+		std::string path = std::string(MODELS_DIR) + "/" + name;
+		return std::wstring(path.begin(), path.end());
+	}
+
+	std::wstring WriteTempModel(const char* name, const char* text)
+	{
+		std::FILE* file = std::fopen(name, "wb");
+		std::fputs(text, file);
+		std::fclose(file);
+		return std::wstring(name, name + std::strlen(name));
+	}
+
+	void CheckMatchesReference(const char* name)
+	{
+		std::vector<ModelVertex> vertices, refVertices;
+		std::vector<std::uint32_t> indices, refIndices;
+
+		CHECK(TextModelLoader::Load(ModelPath(name), vertices, indices));
+		CHECK(TextModelLoader::LoadWithStreams(ModelPath(name), refVertices, refIndices));
+
+		CHECK(!vertices.empty() && !indices.empty());
+		CHECK(vertices.size() == refVertices.size());
+		CHECK(indices.size() == refIndices.size());
+
+		// from_chars and operator>> must round the same decimal to the same float.
+		if(vertices.size() == refVertices.size())
+			CHECK(std::memcmp(vertices.data(), refVertices.data(), vertices.size() * sizeof(ModelVertex)) == 0);
+		CHECK(indices == refIndices);
+	}
+
+	void CheckRejected(const char* name, const char* text)
+	{
+		std::wstring path = WriteTempModel(name, text);
+
+		std::vector<ModelVertex> vertices;
+		std::vector<std::uint32_t> indices;
+		CHECK(!TextModelLoader::Load(path, vertices, indices));
+		CHECK(!TextModelLoader::LoadWithStreams(path, vertices, indices));
+
+		std::remove(name);
+	}
+}
+
+int main()
+{
+	CheckMatchesReference("skull.txt");
+	CheckMatchesReference("car.txt");
+
+	// Index 3 is past the three vertices.
+	CheckRejected("bad_index.txt",
+		"VertexCount: 3\nTriangleCount: 1\nVertexList (pos, normal)\n{\n"
+		"0 0 0 0 1 0\n1 0 0 0 1 0\n0 1 0 0 1 0\n}\nTriangleList\n{\n0 1 3\n}\n");
+
+	// The triangle list ends early.
+	CheckRejected("truncated.txt",
+		"VertexCount: 3\nTriangleCount: 2\nVertexList (pos, normal)\n{\n"
+		"0 0 0 0 1 0\n1 0 0 0 1 0\n0 1 0 0 1 0\n}\nTriangleList\n{\n0 1 2\n");
+
+	return TestResult("TextModelLoaderTest");
+}
@@ -0,0 +1,218 @@
+//***************************************************************************************
+// UploadRingTest.cpp
+//
+// Drives UploadRing the way StaticGeometryUploader does, against a fake device whose
+// copy queue reads the staging memory only when a batch's fence completes.  If the
+// ring handed out bytes that a batch still in flight has not been copied from yet,
+// the destination buffers end up with the wrong contents.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/UploadRing.h"
+
+#include <cstring>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// Staging memory plus a copy queue that completes one fence at a time and copies
+	// each batch into its destinations only then, as a GPU running behind would.
+	class FakeDevice
+	{
+	public:
+		explicit FakeDevice(std::uint64_t stagingSize) :
+			Staging(stagingSize, 0)
+		{
+		}
+
+		void CopyBuffer(std::vector<std::uint8_t>* dst, std::uint64_t srcOffset, std::uint64_t byteSize)
+		{
+			mRecorded.push_back({ dst, srcOffset, byteSize });
+		}
+
+		std::uint64_t ExecuteAndSignal()
+		{
+			++mFence;
+			for(const Copy& copy : mRecorded)
+				mQueued.push_back({ mFence, copy });
+			mRecorded.clear();
+			return mFence;
+		}
+
+		// Completes the oldest outstanding fence.
+		void Step()
+		{
+			if(mCompleted == mFence)
+				return;
+
+			++mCompleted;
+			while(!mQueued.empty() && mQueued.front().Fence <= mCompleted)
+			{
+				const Copy& copy = mQueued.front().Work;
+				copy.Dst->assign(Staging.begin() + copy.SrcOffset, Staging.begin() + copy.SrcOffset + copy.ByteSize);
+				mQueued.pop_front();
+			}
+		}
+
+		std::uint64_t CompletedFence()const { return mCompleted; }
+		std::uint64_t InFlight()const { return mFence - mCompleted; }
+
+		std::vector<std::uint8_t> Staging;
+
+	private:
+		struct Copy
+		{
+			std::vector<std::uint8_t>* Dst;
+			std::uint64_t SrcOffset;
+			std::uint64_t ByteSize;
+		};
+
+		struct QueuedCopy
+		{
+			std::uint64_t Fence;
+			Copy Work;
+		};
+
+		std::vector<Copy> mRecorded;
+		std::deque<QueuedCopy> mQueued;
+		std::uint64_t mFence = 0;
+		std::uint64_t mCompleted = 0;
+	};
+
+	void TestAllocate()
+	{
+		UploadRing ring(1024);
+
+		CHECK(ring.Allocate(100, 4) == 0);
+		CHECK(ring.Allocate(100, 256) == 256);
+		CHECK(ring.UsedBytes() == 356);
+
+		// Does not fit before the end and the front is still live.
+		CHECK(ring.Allocate(700, 4) == UploadRing::InvalidOffset);
+		CHECK(ring.Allocate(2048, 4) == UploadRing::InvalidOffset);
+
+		ring.Submit(1);
+		ring.Retire(0);
+		CHECK(ring.UsedBytes() == 356);
+		ring.Retire(1);
+		CHECK(ring.Empty());
+
+		// An empty ring restarts at the front.
+		CHECK(ring.Allocate(1024, 4) == 0);
+		CHECK(ring.Allocate(1, 1) == UploadRing::InvalidOffset);
+	}
+
+	void TestWrap()
+	{
+		UploadRing ring(1000);
+
+		CHECK(ring.Allocate(400, 4) == 0);
+		ring.Submit(1);
+		CHECK(ring.Allocate(400, 4) == 400);
+		ring.Submit(2);
+		ring.Retire(1);
+
+		// 200 bytes left at the end; the request skips them and wraps to the front.
+		CHECK(ring.Allocate(300, 4) == 0);
+		CHECK(ring.UsedBytes() == 400 + 200 + 300);
+
+		// Only the 100 bytes before the live batch at 400 remain.
+		CHECK(ring.Allocate(101, 4) == UploadRing::InvalidOffset);
+		CHECK(ring.Allocate(100, 4) == 300);
+		CHECK(ring.Allocate(1, 1) == UploadRing::InvalidOffset);
+
+		ring.Submit(3);
+		ring.Retire(3);
+		CHECK(ring.Empty());
+	}
+
+	// Uploads many buffers of random size and alignment through a ring much smaller
+	// than their total, with up to three batches in flight.
+	void TestFakeDevice()
+	{
+		const std::uint64_t capacity = 64 * 1024;
+		const std::uint32_t uploadCount = 4000;
+		const std::uint64_t maxInFlight = 3;
+
+		FakeDevice device(capacity);
+		UploadRing ring(capacity);
+
+		std::vector<std::vector<std::uint8_t>> dst(uploadCount);
+		std::vector<std::vector<std::uint8_t>> expected(uploadCount);
+
+		std::mt19937 rng(1234);
+		std::uniform_int_distribution<std::uint32_t> sizeDist(1, 8 * 1024);
+		std::uniform_int_distribution<std::uint32_t> alignDist(0, 9);
+		std::uniform_int_distribution<std::uint32_t> batchDist(1, 12);
+
+		std::uint64_t totalBytes = 0;
+		std::uint32_t stalls = 0;
+		std::uint32_t batchLeft = batchDist(rng);
+
+		for(std::uint32_t i = 0; i < uploadCount; ++i)
+		{
+			std::uint64_t byteSize = sizeDist(rng);
+			std::uint64_t alignment = std::uint64_t(1) << alignDist(rng);
+
+			std::uint64_t offset = ring.Allocate(byteSize, alignment);
+			while(offset == UploadRing::InvalidOffset)
+			{
+				// Flush what is recorded, then wait for the oldest batch.
+				ring.Submit(device.ExecuteAndSignal());
+				device.Step();
+				ring.Retire(device.CompletedFence());
+				++stalls;
+
+				offset = ring.Allocate(byteSize, alignment);
+			}
+
+			CHECK(offset % alignment == 0);
+			CHECK(offset + byteSize <= capacity);
+
+			expected[i].resize(byteSize);
+			for(std::uint64_t b = 0; b < byteSize; ++b)
+				expected[i][b] = (std::uint8_t)(rng() & 0xff);
+
+			std::memcpy(device.Staging.data() + offset, expected[i].data(), byteSize);
+			device.CopyBuffer(&dst[i], offset, byteSize);
+			totalBytes += byteSize;
+
+			if(--batchLeft == 0)
+			{
+				ring.Submit(device.ExecuteAndSignal());
+				while(device.InFlight() > maxInFlight)
+					device.Step();
+				ring.Retire(device.CompletedFence());
+				batchLeft = batchDist(rng);
+			}
+		}
+
+		ring.Submit(device.ExecuteAndSignal());
+		while(device.InFlight() > 0)
+			device.Step();
+		ring.Retire(device.CompletedFence());
+
+		CHECK(ring.Empty());
+		CHECK(totalBytes > 10 * capacity);
+		CHECK(stalls > 0);
+
+		std::uint32_t corrupted = 0;
+		for(std::uint32_t i = 0; i < uploadCount; ++i)
+		{
+			if(dst[i] != expected[i])
+				++corrupted;
+		}
+		CHECK(corrupted == 0);
+	}
+}
+
+int main()
+{
+	TestAllocate();
+	TestWrap();
+	TestFakeDevice();
+
+	return TestResult("UploadRingTest");
+}
@@ -0,0 +1,239 @@
+//***************************************************************************************
+// VertexQuantizerTest.cpp
+//
+// Checks VertexQuantizer's encodings: positions round trip to within half a unorm16
+// step of the bounds and clamp outside them, a flat axis encodes as the midpoint, the
+// octahedral normals keep the sign of every component in each octant (also through
+// the snorm8 of CompactOct8), a zero normal encodes as +z without poisoning the error
+// report, and the error Encode reports for a mesh is the largest one measured per
+// vertex.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/VertexQuantizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	struct TestVertex
+	{
+		XMFLOAT3 Pos;
+		XMFLOAT3 Normal;
+	};
+
+	const VertexEncoding CompactEncodings[] = { VertexEncoding::CompactOct16, VertexEncoding::CompactOct8 };
+
+	float AngleDegrees(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		float la = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+		float lb = std::sqrt(b.x * b.x + b.y * b.y + b.z * b.z);
+		float c = (a.x * b.x + a.y * b.y + a.z * b.z) / (la * lb);
+		return std::acos(std::min(std::max(c, -1.0f), 1.0f)) * 57.2957795f;
+	}
+
+	XMFLOAT3 Normalize(const XMFLOAT3& v)
+	{
+		float invLength = 1.0f / std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+		return XMFLOAT3(v.x * invLength, v.y * invLength, v.z * invLength);
+	}
+
+	// Encodes one vertex and decodes it again.
+	TestVertex RoundTrip(const TestVertex& v, const BoundingBox& bounds, VertexEncoding encoding)
+	{
+		std::uint8_t encoded[VertexQuantizer::MaxStride];
+		VertexQuantizer::Encode(&v, 1, bounds, encoding, encoded);
+
+		TestVertex decoded;
+		decoded.Pos = VertexQuantizer::DecodePosition(encoded, encoding, bounds);
+		decoded.Normal = VertexQuantizer::DecodeNormal(encoded, encoding);
+		return decoded;
+	}
+
+	void TestStride()
+	{
+		CHECK(VertexQuantizer::Stride(VertexEncoding::Float) == 24);
+		CHECK(VertexQuantizer::Stride(VertexEncoding::CompactOct16) == 12);
+		CHECK(VertexQuantizer::Stride(VertexEncoding::CompactOct8) == 8);
+		CHECK(VertexQuantizer::MaxStride == 24);
+	}
+
+	void TestPositions()
+	{
+		const float center = -3.0f;
+		const float extent = 7.5f;
+		const float halfStep = extent / 65535.0f;
+
+		// The ends of the range are exact and the centre is the middle code.
+		CHECK(VertexQuantizer::EncodePosition(center - extent, center, extent) == 0);
+		CHECK(VertexQuantizer::EncodePosition(center + extent, center, extent) == 65535);
+		CHECK(VertexQuantizer::DecodePosition(std::uint16_t(0), center, extent) == center - extent);
+		CHECK(VertexQuantizer::DecodePosition(std::uint16_t(65535), center, extent) == center + extent);
+
+		// Anything in between rounds to the nearest code.
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> dist(center - extent, center + extent);
+		for(int i = 0; i < 10000; ++i)
+		{
+			float p = dist(rng);
+			float q = VertexQuantizer::DecodePosition(VertexQuantizer::EncodePosition(p, center, extent), center, extent);
+			CHECK(std::fabs(q - p) <= halfStep * 1.01f);
+		}
+
+		// Outside the bounds it clamps rather than wrapping.
+		CHECK(VertexQuantizer::EncodePosition(center - 2.0f * extent, center, extent) == 0);
+		CHECK(VertexQuantizer::EncodePosition(center + 2.0f * extent, center, extent) == 65535);
+
+		// A zero-extent axis (a flat mesh) encodes as the midpoint and decodes exactly.
+		CHECK(VertexQuantizer::EncodePosition(4.0f, 4.0f, 0.0f) == 0x8000);
+		CHECK(VertexQuantizer::EncodePosition(-1.0f, 4.0f, 0.0f) == 0x8000);
+		CHECK(VertexQuantizer::DecodePosition(std::uint16_t(0x8000), 4.0f, 0.0f) == 4.0f);
+
+		const BoundingBox flat(XMFLOAT3(0.0f, 2.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 1.0f));
+		for(VertexEncoding encoding : CompactEncodings)
+		{
+			TestVertex v = { XMFLOAT3(0.25f, 2.0f, -0.5f), XMFLOAT3(0.0f, 1.0f, 0.0f) };
+			TestVertex decoded = RoundTrip(v, flat, encoding);
+			CHECK(decoded.Pos.y == 2.0f);
+			CHECK(std::fabs(decoded.Pos.x - 0.25f) <= 1.01f / 65535.0f);
+			CHECK(std::fabs(decoded.Pos.z + 0.5f) <= 1.01f / 65535.0f);
+		}
+
+		// Float keeps the vertex as it is.
+		TestVertex v = { XMFLOAT3(1.0f / 3.0f, -2.0f, 9.0f), Normalize(XMFLOAT3(1.0f, 2.0f, 3.0f)) };
+		TestVertex decoded = RoundTrip(v, flat, VertexEncoding::Float);
+		CHECK(std::memcmp(&decoded, &v, sizeof(v)) == 0);
+	}
+
+	void TestNormals()
+	{
+		// Every octant, the axes and directions on the octahedron's edges, where the
+		// lower hemisphere folds over the diagonals.
+		std::vector<XMFLOAT3> normals;
+		for(int sx = -1; sx <= 1; sx += 2)
+			for(int sy = -1; sy <= 1; sy += 2)
+				for(int sz = -1; sz <= 1; sz += 2)
+				{
+					normals.push_back(Normalize(XMFLOAT3(sx * 0.3f, sy * 0.5f, sz * 0.8f)));
+					normals.push_back(Normalize(XMFLOAT3(sx * 0.9f, sy * 0.2f, sz * 0.1f)));
+					normals.push_back(Normalize(XMFLOAT3(sx * 1.0f, sy * 1.0f, sz * 0.02f)));
+				}
+		for(int s = -1; s <= 1; s += 2)
+		{
+			normals.push_back(XMFLOAT3((float)s, 0.0f, 0.0f));
+			normals.push_back(XMFLOAT3(0.0f, (float)s, 0.0f));
+			normals.push_back(XMFLOAT3(0.0f, 0.0f, (float)s));
+		}
+
+		const BoundingBox bounds(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+		for(VertexEncoding encoding : CompactEncodings)
+		{
+			const float maxError = encoding == VertexEncoding::CompactOct16 ? 0.01f : 1.5f;
+			for(const XMFLOAT3& n : normals)
+			{
+				// The unquantized mapping is exact up to rounding.
+				CHECK(AngleDegrees(VertexQuantizer::OctDecode(VertexQuantizer::OctEncode(n)), n) < 0.01f);
+
+				TestVertex v = { XMFLOAT3(0.0f, 0.0f, 0.0f), n };
+				XMFLOAT3 decoded = RoundTrip(v, bounds, encoding).Normal;
+				CHECK(AngleDegrees(decoded, n) <= maxError);
+
+				// Components that are clearly non-zero keep their sign.
+				for(int a = 0; a < 3; ++a)
+				{
+					float expected = (&n.x)[a];
+					float actual = (&decoded.x)[a];
+					if(std::fabs(expected) > 0.05f)
+						CHECK((expected > 0.0f) == (actual > 0.0f));
+					else
+						CHECK(std::fabs(actual) < 0.05f);
+				}
+			}
+		}
+
+		// A zero normal has no direction: it encodes as +z, and counts as no error.
+		XMFLOAT2 e = VertexQuantizer::OctEncode(XMFLOAT3(0.0f, 0.0f, 0.0f));
+		CHECK(e.x == 0.0f && e.y == 0.0f);
+		for(VertexEncoding encoding : CompactEncodings)
+		{
+			TestVertex v = { XMFLOAT3(0.5f, 0.5f, 0.5f), XMFLOAT3(0.0f, 0.0f, 0.0f) };
+			XMFLOAT3 decoded = RoundTrip(v, bounds, encoding).Normal;
+			CHECK(decoded.x == 0.0f && decoded.y == 0.0f && decoded.z == 1.0f);
+
+			std::uint8_t encoded[VertexQuantizer::MaxStride];
+			QuantizeError error = VertexQuantizer::Encode(&v, 1, bounds, encoding, encoded);
+			CHECK(error.MaxNormalErrorDegrees == 0.0f);
+			CHECK(!std::isnan(error.MaxPositionError));
+		}
+	}
+
+	void TestErrorReport()
+	{
+		// A random mesh in an off-centre box; the report is the worst vertex.
+		std::mt19937 rng(11);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		const BoundingBox bounds(XMFLOAT3(10.0f, -4.0f, 2.0f), XMFLOAT3(3.0f, 0.5f, 8.0f));
+
+		std::vector<TestVertex> vertices(2000);
+		for(TestVertex& v : vertices)
+		{
+			v.Pos = XMFLOAT3(bounds.Center.x + unit(rng) * bounds.Extents.x, bounds.Center.y + unit(rng) * bounds.Extents.y,
+				bounds.Center.z + unit(rng) * bounds.Extents.z);
+			v.Normal = Normalize(XMFLOAT3(unit(rng), unit(rng), unit(rng)));
+		}
+
+		for(VertexEncoding encoding : CompactEncodings)
+		{
+			const std::uint32_t stride = VertexQuantizer::Stride(encoding);
+			std::vector<std::uint8_t> encoded(vertices.size() * stride);
+			QuantizeError error = VertexQuantizer::Encode(vertices.data(), vertices.size(), bounds, encoding, encoded.data());
+
+			float maxPosition = 0.0f;
+			float maxNormal = 0.0f;
+			for(size_t i = 0; i < vertices.size(); ++i)
+			{
+				XMFLOAT3 p = VertexQuantizer::DecodePosition(&encoded[i * stride], encoding, bounds);
+				XMFLOAT3 n = VertexQuantizer::DecodeNormal(&encoded[i * stride], encoding);
+				maxPosition = std::max(maxPosition, std::fabs(p.x - vertices[i].Pos.x));
+				maxPosition = std::max(maxPosition, std::fabs(p.y - vertices[i].Pos.y));
+				maxPosition = std::max(maxPosition, std::fabs(p.z - vertices[i].Pos.z));
+				maxNormal = std::max(maxNormal, AngleDegrees(vertices[i].Normal, n));
+			}
+
+			CHECK(error.MaxPositionError == maxPosition);
+			CHECK(std::fabs(error.MaxNormalErrorDegrees - maxNormal) < 1e-3f);
+
+			// Half a step of the widest axis bounds the position error.
+			CHECK(error.MaxPositionError > 0.0f);
+			CHECK(error.MaxPositionError <= 8.0f / 65535.0f * 1.01f);
+			CHECK(error.MaxNormalErrorDegrees > 0.0f);
+		}
+
+		// The 8-bit normal is the coarser one.
+		std::vector<std::uint8_t> encoded(vertices.size() * VertexQuantizer::MaxStride);
+		QuantizeError oct16 = VertexQuantizer::Encode(vertices.data(), vertices.size(), bounds, VertexEncoding::CompactOct16, encoded.data());
+		QuantizeError oct8 = VertexQuantizer::Encode(vertices.data(), vertices.size(), bounds, VertexEncoding::CompactOct8, encoded.data());
+		CHECK(oct8.MaxNormalErrorDegrees > oct16.MaxNormalErrorDegrees);
+		CHECK(oct8.MaxPositionError == oct16.MaxPositionError);
+
+		// Float is lossless.
+		QuantizeError exact = VertexQuantizer::Encode(vertices.data(), vertices.size(), bounds, VertexEncoding::Float, encoded.data());
+		CHECK(exact.MaxPositionError == 0.0f);
+		CHECK(std::memcmp(encoded.data(), vertices.data(), vertices.size() * sizeof(TestVertex)) == 0);
+	}
+}
+
+int main()
+{
+	TestStride();
+	TestPositions();
+	TestNormals();
+	TestErrorReport();
+
+	return TestResult("VertexQuantizerTest");
+}
@@ -0,0 +1,124 @@
+//***************************************************************************************
+// VertexWriterTest.cpp
+//
+// Checks VertexWriter's compile-time copy plan: attributes adjacent in both layouts are
+// merged, so Pos+Normal out of GeometryGenerator::Vertex is one move per vertex, and
+// attributes that are not stay separate moves.  The output is compared byte for byte
+// with a per-field copy, and destination bytes no attribute covers are left as they
+// were.
+//***************************************************************************************
+
+#include "TestCheck.h"
+#include "../Common/VertexWriter.h"
+
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	struct PosNormal
+	{
+		XMFLOAT3 Pos;
+		XMFLOAT3 Normal;
+	};
+
+	// Normal first, with a lane of padding after each attribute.
+	struct Padded
+	{
+		XMFLOAT3 Normal;
+		float Pad0;
+		XMFLOAT3 Pos;
+		float Pad1;
+	};
+
+	using PosNormalWriter = VertexWriter<VertexLayoutOf<PosNormal>::Type>;
+	using PaddedWriter = VertexWriter<VertexLayoutOf<Padded>::Type>;
+	using GeneratorLayout = VertexLayoutOf<GeometryGenerator::Vertex>::Type;
+	using GeneratorWriter = VertexWriter<GeneratorLayout, GeneratorLayout>;
+
+	// The plan is fixed at compile time.
+	static_assert(PosNormalWriter::CopiesPerVertex() == 1, "Pos+Normal should merge into one move.");
+	static_assert(PaddedWriter::CopiesPerVertex() == 2, "Attributes apart in the destination stay separate.");
+	static_assert(GeneratorWriter::CopiesPerVertex() == 1, "A layout copied to itself is one move.");
+
+	std::vector<GeometryGenerator::Vertex> RandomVertices(size_t count)
+	{
+		std::mt19937 rng(9);
+		std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+		std::vector<GeometryGenerator::Vertex> vertices(count);
+		for(GeometryGenerator::Vertex& v : vertices)
+		{
+			v = GeometryGenerator::Vertex(dist(rng), dist(rng), dist(rng), dist(rng), dist(rng), dist(rng),
+				dist(rng), dist(rng), dist(rng), dist(rng), dist(rng));
+		}
+		return vertices;
+	}
+
+	void TestPosNormal()
+	{
+		CHECK(PosNormalWriter::CopiesPerVertex() == 1);
+
+		const std::vector<GeometryGenerator::Vertex> src = RandomVertices(1001);
+
+		std::vector<PosNormal> written(src.size());
+		PosNormalWriter::Write(src.data(), src.size(), written.data());
+
+		std::vector<PosNormal> expected(src.size());
+		for(size_t i = 0; i < src.size(); ++i)
+		{
+			expected[i].Pos = src[i].Position;
+			expected[i].Normal = src[i].Normal;
+		}
+
+		CHECK(std::memcmp(written.data(), expected.data(), src.size() * sizeof(PosNormal)) == 0);
+	}
+
+	void TestPadded()
+	{
+		CHECK(PaddedWriter::CopiesPerVertex() == 2);
+
+		const std::vector<GeometryGenerator::Vertex> src = RandomVertices(257);
+
+		// The padding lanes keep their sentinel: the writer only writes attributes.
+		const float sentinel = -12345.0f;
+		std::vector<Padded> written(src.size(), Padded{ {}, sentinel, {}, sentinel });
+		PaddedWriter::Write(src.data(), src.size(), written.data());
+
+		for(size_t i = 0; i < src.size(); ++i)
+		{
+			CHECK(std::memcmp(&written[i].Pos, &src[i].Position, sizeof(XMFLOAT3)) == 0);
+			CHECK(std::memcmp(&written[i].Normal, &src[i].Normal, sizeof(XMFLOAT3)) == 0);
+			CHECK(written[i].Pad0 == sentinel);
+			CHECK(written[i].Pad1 == sentinel);
+		}
+	}
+
+	void TestWholeVertex()
+	{
+		CHECK(GeneratorWriter::CopiesPerVertex() == 1);
+
+		const std::vector<GeometryGenerator::Vertex> src = RandomVertices(100);
+		std::vector<GeometryGenerator::Vertex> written(src.size());
+		GeneratorWriter::Write(src.data(), src.size(), written.data());
+
+		CHECK(std::memcmp(written.data(), src.data(), src.size() * sizeof(GeometryGenerator::Vertex)) == 0);
+
+		// Get reads each attribute at its layout offset.
+		CHECK(GeneratorLayout::Get<VertexSemantic::TexC>(src[7]).x == src[7].TexC.x);
+		CHECK(GeneratorLayout::Get<VertexSemantic::TangentU>(src[7]).z == src[7].TangentU.z);
+		CHECK(VertexLayoutOf<Padded>::Type::Has<VertexSemantic::Normal>);
+		CHECK(!VertexLayoutOf<Padded>::Type::Has<VertexSemantic::TexC>);
+	}
+}
+
+int main()
+{
+	TestPosNormal();
+	TestPadded();
+	TestWholeVertex();
+
+	return TestResult("VertexWriterTest");
+}